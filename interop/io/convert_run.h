@@ -0,0 +1,86 @@
+/** Rewrite the InterOp files of a run folder in the latest lossless format versions
+ *
+ * Archived runs are often stored in older layout versions, which take slower paths when loaded, for example the
+ * legacy Q-score binning applied to version 4 q-metrics. Converting a run once lets every later load take the fast
+ * path.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include "interop/constants/enums.h"
+#include "interop/util/cstdint.h"
+#include "interop/io/stream_exceptions.h"
+#include "interop/util/xml_exceptions.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Description of a single InterOp file visited by the converter
+     */
+    struct converted_interop
+    {
+        /** Constructor
+         *
+         * @param file path to the InterOp file
+         * @param metric_group metric group of the file
+         */
+        converted_interop(const std::string& file="",
+                          const constants::metric_group metric_group=constants::UnknownMetricGroup) :
+                filename(file),
+                group(metric_group),
+                source_version(0),
+                target_version(0),
+                record_count(0)
+        {}
+        /** Test if the file was rewritten
+         *
+         * @return true if the file was rewritten
+         */
+        bool is_rewritten()const
+        {
+            return source_version != target_version;
+        }
+        /** Path to the InterOp file */
+        std::string filename;
+        /** Metric group of the file */
+        constants::metric_group group;
+        /** Version of the file before conversion */
+        ::int16_t source_version;
+        /** Version of the file after conversion */
+        ::int16_t target_version;
+        /** Number of metrics written */
+        size_t record_count;
+    };
+    /** Vector of converted InterOp files */
+    typedef std::vector<converted_interop> converted_interop_vector;
+
+    /** Rewrite every InterOp file of a run folder in the latest version that stores all of its data
+     *
+     * A file is rewritten only when a newer version keeps every field of the old one, so extraction, tile and
+     * corrected intensity metrics keep their version, and unbinned q-metrics move to version 6 at most. Legacy
+     * version 4 q-metrics that require binning are binned with the bins a loader would assign, using the instrument
+     * from RunParameters.xml, and are then written in the latest version.
+     *
+     * Records are streamed from the old file to a temporary file, which then replaces the old one, so memory does
+     * not grow with file size (except for multi-record formats) and an interrupted conversion leaves the old file
+     * intact. Each file is converted by an independent task, and tasks run in parallel.
+     *
+     * @param run_folder run folder path
+     * @param converted destination description of each InterOp file found, in a fixed order
+     * @param thread_count number of threads used to convert files
+     */
+    void convert_run(const std::string& run_folder,
+                     converted_interop_vector& converted,
+                     const size_t thread_count=1) throw(xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception);
+}}}
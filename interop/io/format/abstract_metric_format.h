@@ -10,6 +10,7 @@
 
 #include <iosfwd>
 #include "interop/util/cstdint.h"
+#include "interop/util/progress.h"
 #include "interop/model/metric_base/metric_set.h"
 
 namespace illumina { namespace interop { namespace io
@@ -29,6 +30,18 @@ namespace illumina { namespace interop { namespace io
         typedef typename Metric::header_type header_t;
         /** ID type */
         typedef typename metric_t::id_t id_t;
+        /** Result of reading a single record */
+        enum record_status
+        {
+            /** No record was left in the stream */
+            EndOfRecords,
+            /** The record was read and dropped */
+            SkippedRecord,
+            /** The record was merged into the current metric */
+            MergedRecord,
+            /** The record starts a new metric */
+            NewRecord
+        };
 
         /** Destructor
          */
@@ -59,10 +72,12 @@ namespace illumina { namespace interop { namespace io
          * @param in input stream
          * @param metric_set destination set of metrics
          * @param file_size number of bytes in the file
+         * @param progress progress token checked between chunks of records, may be null
          */
         virtual void read_metrics(std::istream& in,
                                   model::metric_base::metric_set<Metric>& metric_set,
-                                  const size_t file_size)=0;
+                                  const size_t file_size,
+                                  util::progress_token* progress)=0;
         /** Read only the header of a metric set
          *
          * @param in input stream
@@ -70,6 +85,24 @@ namespace illumina { namespace interop { namespace io
          * @return number of bytes read
          */
         virtual size_t read_header(std::istream& in, model::metric_base::metric_set<Metric>& metric_set)=0;
+        /** Read the next record into a metric, decoding it in place
+         *
+         * The header must already be read. For a multi-record format, a record with the same id as `metric` is
+         * merged into it, if `merge` is true. Any other record is decoded into `next`, which a multi-record format
+         * first resets from the header. For a single-record format, `metric` and `next` may be the same metric.
+         *
+         * @param in input stream
+         * @param header header read from the stream
+         * @param metric metric holding the records merged so far
+         * @param next destination of a record that starts a new metric
+         * @param merge true if records with the same id should be merged into `metric`
+         * @return whether the record was merged, started a new metric or was skipped, or the stream ended
+         */
+        virtual record_status read_next_record(std::istream& in,
+                                               header_t& header,
+                                               metric_t& metric,
+                                               metric_t& next,
+                                               const bool merge)=0;
 
         /** Write a metric record to the given output stream
          *
@@ -79,6 +112,18 @@ namespace illumina { namespace interop { namespace io
          */
         virtual void write_metric(std::ostream &out, const metric_t &metric, const header_t &header) = 0;
 
+        /** Encode a metric record directly into a memory buffer
+         *
+         * Only formats with one record per metric support this, since their records have a fixed size. The buffer
+         * must hold `record_size(header)` bytes.
+         *
+         * @param buffer destination buffer
+         * @param metric interop metric data to write
+         * @param header interop metric header data to write
+         * @return false if the format does not support encoding into a buffer, and nothing was written
+         */
+        virtual bool write_record(char* buffer, const metric_t &metric, const header_t &header) = 0;
+
         /** Write the header for a set of metric records to the given output stream
          *
          * @param out output stream to write the binary InterOp file data
@@ -23,7 +23,9 @@ namespace illumina { namespace interop { namespace io
             /** Version of the format */
             VERSION = V,
             /** Flag indicating whether metric is split into multiple records in the InterOp file */
-            MULTI_RECORD=MultiRecord
+            MULTI_RECORD=MultiRecord,
+            /** Flag indicating whether the layout decodes a whole file of records with decode_records */
+            BULK_DECODE=0
         };
         /** Define a record size type */
         typedef ::uint8_t record_size_t;
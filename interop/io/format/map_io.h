@@ -16,6 +16,7 @@
 #pragma once
 
 #include "interop/io/format/stream_util.h"
+#include "interop/util/fixed_vector.h"
 #include "interop/util/length_of.h"
 
 namespace illumina { namespace interop { namespace io
@@ -27,6 +28,12 @@ namespace illumina { namespace interop { namespace io
     void copy_from(std::ostream &, const Source &, const Destination &)
     { }
 
+    /** Place holder that does not perform a copy
+     */
+    template<typename Source, typename Destination>
+    void copy_from(output_cursor &, const Source &, const Destination &)
+    { }
+
     /** Copy from source to destination
      *
      * @param dst destination
@@ -259,6 +266,64 @@ namespace illumina { namespace interop { namespace io
 
 
 
+    /** Read an array of values of type ReadType from the given input stream into an inline array
+     *
+     * @param in input stream
+     * @param vals destination array of values
+     * @param n number of values to read
+     * @return number of bytes read from the stream
+     */
+    template<typename ReadType, typename ValueType, size_t N>
+    std::streamsize stream_map(std::istream &in, util::fixed_vector<ValueType, N>&vals, const size_t n)
+    {
+        if(n > N) INTEROP_THROW(bad_format_exception, "Number of values " << n << " exceeds the limit " << N);
+        vals.resize(n);
+        INTEROP_ASSERTMSG(!vals.empty(), "n="<<n);
+        return read_array_helper<ReadType,ValueType>::read_array_from_stream(in, &vals.front(), n);
+    }
+
+    /** Read an array of values of type ReadType from the given input buffer into an inline array
+     *
+     * @param in input buffer
+     * @param vals destination array of values
+     * @param n number of values to read
+     * @return number of bytes read from the buffer
+     */
+    template<typename ReadType, typename ValueType, size_t N>
+    std::streamsize stream_map(char*& in, util::fixed_vector<ValueType, N>&vals, const size_t n)
+    {
+        if(n > N) INTEROP_THROW(bad_format_exception, "Number of values " << n << " exceeds the limit " << N);
+        vals.resize(n);
+        INTEROP_ASSERT(!vals.empty());
+        return read_array_helper<ReadType,ValueType>::read_array_from_stream(in, &vals.front(), n);
+    }
+
+    /** Read an array of values of type ReadType from the given input stream into an inline array
+     *
+     * @param in input stream
+     * @param vals destination array of values
+     * @param n number of values to read
+     * @return number of bytes read from the stream
+     */
+    template<typename ReadType, typename ValueType, size_t N>
+    std::streamsize padded_stream_map(std::istream &in, util::fixed_vector<ValueType, N>&vals, const size_t n, const ReadType)
+    {
+        return stream_map<ReadType>(in, vals, n);
+    }
+
+    /** Read an array of values of type ReadType from the given input buffer into an inline array
+     *
+     * @param in input buffer
+     * @param vals destination array of values
+     * @param n number of values to read
+     * @return number of bytes read from the buffer
+     */
+    template<typename ReadType, typename ValueType, size_t N>
+    std::streamsize padded_stream_map(char*& in, util::fixed_vector<ValueType, N>&vals, const size_t n, const ReadType)
+    {
+        return stream_map<ReadType>(in, vals, n);
+    }
+
     /** Read an array of values of type ReadType from the given input stream
      *
      * TODO: create more efficient buffered version
@@ -335,7 +400,7 @@ namespace illumina { namespace interop { namespace io
     std::streamsize stream_map(std::ostream &out, const ValueType val)
     {
         write_binary(out, static_cast<WriteType>(val));
-        return out.tellp();
+        return static_cast<std::streamsize>(sizeof(WriteType));
     }
 
     /** Write a string to the given output stream
@@ -349,7 +414,7 @@ namespace illumina { namespace interop { namespace io
     inline std::streamsize stream_map(std::ostream &out, const std::string &str)
     {
         write_binary(out, str);
-        return out.tellp();
+        return static_cast<std::streamsize>(sizeof(::uint16_t) + str.size());
     }
 
     /** Write an array of values of type ReadType to the given output stream
@@ -372,7 +437,7 @@ namespace illumina { namespace interop { namespace io
             WriteType write_val = static_cast<WriteType>(vals[i]);
             write_binary(out, write_val);
         }
-        return out.tellp();
+        return static_cast<std::streamsize>(n * sizeof(WriteType));
     }
 
     /** Write an array of values of type ReadType to the given output stream
@@ -388,16 +453,17 @@ namespace illumina { namespace interop { namespace io
     template<typename WriteType, typename ValueType>
     std::streamsize padded_stream_map(std::ostream &out, const ValueType &vals, const size_t n, const WriteType pad)
     {
-        for (size_t i = 0; i < util::length_of(vals); i++)
+        size_t count = 0;
+        for (size_t i = 0; i < util::length_of(vals); i++, count++)
         {
             WriteType write_val = static_cast<WriteType>(vals[i]);
             write_binary(out, write_val);
         }
-        for (size_t i = util::length_of(vals); i < n; i++)
+        for (size_t i = util::length_of(vals); i < n; i++, count++)
         {
             write_binary(out, pad);
         }
-        return out.tellp();
+        return static_cast<std::streamsize>(count * sizeof(WriteType));
     }
 
     /** Write an array of values of type ReadType to the given output stream
@@ -421,7 +487,83 @@ namespace illumina { namespace interop { namespace io
             WriteType write_val = static_cast<WriteType>(vals[offset + i]);
             write_binary(out, write_val);
         }
-        return out.tellp();
+        return static_cast<std::streamsize>(n * sizeof(WriteType));
+    }
+
+    /** Write a value of type WriteType to the given memory buffer
+     *
+     * @param out output cursor
+     * @param val source value
+     * @return number of bytes written to the buffer
+     */
+    template<typename WriteType, typename ValueType>
+    std::streamsize stream_map(output_cursor &out, const ValueType val)
+    {
+        write_binary(out, static_cast<WriteType>(val));
+        return static_cast<std::streamsize>(sizeof(WriteType));
+    }
+
+    /** Write a string to the given memory buffer
+     *
+     * @param out output cursor
+     * @param str source string
+     * @return number of bytes written to the buffer
+     */
+    inline std::streamsize stream_map(output_cursor &out, const std::string &str)
+    {
+        write_binary(out, str);
+        return static_cast<std::streamsize>(sizeof(::uint16_t) + str.size());
+    }
+
+    /** Write an array of values of type WriteType to the given memory buffer
+     *
+     * @param out output cursor
+     * @param vals source array of values
+     * @param n number of values in array
+     * @return number of bytes written to the buffer
+     */
+    template<typename WriteType, typename ValueType>
+    std::streamsize stream_map(output_cursor &out, const ValueType &vals, const size_t n)
+    {
+        return stream_map<WriteType>(out, vals, 0, n);
+    }
+
+    /** Write an array of values of type WriteType to the given memory buffer, padding it to n values
+     *
+     * @param out output cursor
+     * @param vals source array of values
+     * @param n number of values to write
+     * @param pad value written past the end of vals
+     * @return number of bytes written to the buffer
+     */
+    template<typename WriteType, typename ValueType>
+    std::streamsize padded_stream_map(output_cursor &out, const ValueType &vals, const size_t n, const WriteType pad)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < util::length_of(vals); i++, count++)
+            write_binary(out, static_cast<WriteType>(vals[i]));
+        for (size_t i = util::length_of(vals); i < n; i++, count++)
+            write_binary(out, pad);
+        return static_cast<std::streamsize>(count * sizeof(WriteType));
+    }
+
+    /** Write an array of values of type WriteType to the given memory buffer
+     *
+     * @param out output cursor
+     * @param vals source array of values
+     * @param offset starting index of values to write in vals
+     * @param n number of values to write
+     * @return number of bytes written to the buffer
+     */
+    template<typename WriteType, typename ValueType>
+    std::streamsize stream_map(output_cursor &out, const ValueType &vals, const size_t offset, const size_t n)
+    {
+        INTEROP_ASSERT(util::length_of(vals) >= (offset+n));
+        if(util::length_of(vals) < (offset+n))
+            INTEROP_THROW(bad_format_exception, "Write bug: Number of values is less than expected!");
+        for (size_t i = 0; i < n; i++)
+            write_binary(out, static_cast<WriteType>(vals[offset + i]));
+        return static_cast<std::streamsize>(n * sizeof(WriteType));
     }
 
     /** Placeholder that does nothing
@@ -12,7 +12,9 @@
 #endif
 
 
+#include <algorithm>
 #include "interop/util/exception.h"
+#include "interop/util/progress.h"
 #include "interop/io/format/abstract_metric_format.h"
 #include "interop/io/format/generic_layout.h"
 #include "interop/io/format/stream_util.h"
@@ -34,6 +36,8 @@ namespace illumina { namespace interop { namespace io
         typedef typename Metric::id_t id_t;
         typedef model::metric_base::metric_set<Metric> metric_set_t;
         typedef typename metric_set_t::offset_map_t offset_map_t;
+        typedef abstract_metric_format<Metric> base_t;
+        typedef typename base_t::record_status record_status;
     public:
         /** Define the metric type */
         typedef Metric metric_t;
@@ -70,6 +74,17 @@ namespace illumina { namespace interop { namespace io
             write_binary(out, metric_id);
             Layout::map_stream(out, metric, header, false);
         }
+        /** Encode a metric record directly into a memory buffer
+         *
+         * @param buffer destination buffer, which must hold `record_size(header)` bytes
+         * @param metric a metric to write
+         * @param header metric set header
+         * @return false for a multi-record format, which is not written
+         */
+        bool write_record(char* buffer, const metric_t &metric, const header_t &header)
+        {
+            return write_record(buffer, metric, header, int_constant_type<Layout::MULTI_RECORD>::null());
+        }
         /** Read the header into a metric set
          *
          * @param in input stream
@@ -89,43 +104,167 @@ namespace illumina { namespace interop { namespace io
          * @param in input stream
          * @param metric_set destination set of metrics
          * @param file_size size of the file
+         * @param progress progress token checked between chunks of records, may be null
          */
-        void read_metrics(std::istream& in, metric_set_t& metric_set, const size_t file_size)
+        void read_metrics(std::istream& in,
+                          metric_set_t& metric_set,
+                          const size_t file_size,
+                          util::progress_token* progress)
         {
+            const constants::metric_group group = static_cast<constants::metric_group>(Metric::TYPE);
             const std::streamsize record_size = read_header_impl(in, metric_set);
             offset_map_t& metric_offset_map = metric_set.offset_map();
+            id_t last_id = max_id(metric_offset_map);
             metric_t metric(metric_set);
-            if(file_size > 0 && !Layout::MULTI_RECORD)
+            size_t chunk = 0;
+            ::uint64_t bytes_reported = 0;
+            try
             {
-                const size_t record_count = static_cast<size_t>((file_size-header_size(metric_set))/record_size);
-                metric_set.resize(metric_set.size()+record_count);
-                std::vector<char> buffer(static_cast<size_t>(record_size));
-                INTEROP_ASSERT(!buffer.empty());
-                while (in)
+                if(file_size > 0 && !Layout::MULTI_RECORD)
                 {
-                    char *in_ptr = &buffer.front();
-                    in.read(in_ptr, record_size);
-                    const std::streamsize count = in.gcount();
-                    try
+                    const size_t record_count = static_cast<size_t>((file_size-header_size(metric_set))/record_size);
+                    metric_set.resize(metric_set.size()+record_count);
+                    // Records have a fixed size, so a whole chunk is read at once and its size is checked once
+                    const size_t chunk_records = std::max(static_cast<size_t>(1),
+                                                          std::min(record_count,
+                                                                   static_cast<size_t>(
+                                                                           util::progress_token::RecordChunk)));
+                    std::vector<char> buffer(static_cast<size_t>(record_size)*chunk_records);
+                    INTEROP_ASSERT(!buffer.empty());
+                    while (in)
                     {
-                        if (!test_stream(in, metric_offset_map, count, record_size)) break;
-                        read_record(in_ptr, metric_set, metric_offset_map, metric, record_size);
+                        in.read(&buffer.front(), static_cast<std::streamsize>(buffer.size()));
+                        const std::streamsize count = in.gcount();
+                        const size_t whole_records = static_cast<size_t>(count / record_size);
+                        char *in_ptr = &buffer.front();
+                        for(size_t i=0;i<whole_records;++i)
+                            read_record(in_ptr, metric_set, metric_offset_map, metric, record_size, last_id);
+                        chunk += whole_records;
+                        if(progress != 0 && chunk >= util::progress_token::RecordChunk)
+                            report_chunk(progress, group, record_size, chunk, bytes_reported);
+                        if (!test_stream(in, metric_offset_map, count % record_size, record_size)) break;
                     }
-                    catch(const incomplete_file_exception& ex)
+                }
+                else if(file_size > 0 && Layout::BULK_DECODE)
+                {
+                    read_bulk(in,
+                              metric_set,
+                              file_size-header_size(metric_set),
+                              record_size,
+                              progress,
+                              chunk,
+                              bytes_reported,
+                              int_constant_type<Layout::BULK_DECODE>::null());
+                }
+                else
+                {
+                    while (in)
                     {
-                        metric_set.trim(metric_offset_map.size());
-                        throw ex;
+                        read_record(in, metric_set, metric_offset_map, metric, record_size, last_id);
+                        if(progress != 0 && ++chunk == util::progress_token::RecordChunk)
+                            report_chunk(progress, group, record_size, chunk, bytes_reported);
                     }
                 }
             }
+            catch(const incomplete_file_exception&)
+            {
+                metric_set.trim(metric_offset_map.size());
+                throw;
+            }
+            catch(const util::operation_cancelled_exception&)
+            {
+                metric_set.trim(metric_offset_map.size());
+                throw;
+            }
+            metric_set.trim(metric_offset_map.size());
+            if(progress != 0)
+                progress->update(group, file_size > bytes_reported ? file_size - bytes_reported : 0, chunk);
+        }
+        /** Report a chunk of records to the progress token
+         *
+         * @param progress progress token
+         * @param group metric group
+         * @param record_size number of bytes in each record
+         * @param chunk number of records in the chunk, zeroed on return
+         * @param bytes_reported total number of bytes reported, updated on return
+         */
+        static void report_chunk(util::progress_token* progress,
+                                 const constants::metric_group group,
+                                 const std::streamsize record_size,
+                                 size_t& chunk,
+                                 ::uint64_t& bytes_reported)
+        {
+            const ::uint64_t bytes = static_cast< ::uint64_t >(chunk) * static_cast< ::uint64_t >(record_size);
+            bytes_reported += bytes;
+            const size_t records = chunk;
+            chunk = 0;
+            progress->update(group, bytes, records);
+        }
+        /** Read the next record into a metric, decoding it in place
+         *
+         * The header must already be read. For a multi-record format, a record with the same id as `metric` is
+         * merged into it, if `merge` is true. Any other record is decoded into `next`, which a multi-record format
+         * first resets from the header. For a single-record format, `metric` and `next` may be the same metric.
+         *
+         * @param in input stream
+         * @param header header read from the stream
+         * @param metric metric holding the records merged so far
+         * @param next destination of a record that starts a new metric
+         * @param merge true if records with the same id should be merged into `metric`
+         * @return whether the record was merged, started a new metric or was skipped, or the stream ended
+         */
+        record_status read_next_record(std::istream& in,
+                                       header_t& header,
+                                       metric_t& metric,
+                                       metric_t& next,
+                                       const bool merge)
+        {
+            if (in.peek() == std::char_traits<char>::eof()) return base_t::EndOfRecords;
+            const std::streamsize record_size = Layout::compute_size(header);
+            metric_id_t id;
+            std::streamsize count = read_binary_with_count(in, id);
+            record_status status = base_t::NewRecord;
+            if (in.fail())
+            {
+                status = base_t::EndOfRecords;
+            }
+            else if (!Layout::is_valid(id))
+            {
+                count += Layout::map_stream(in, next, header, true);
+                status = base_t::SkippedRecord;
+            }
             else
             {
-                while (in)
+                next.set_base(id);
+                if (Layout::MULTI_RECORD && merge && next.id() == metric.id())
                 {
-                    read_record(in, metric_set, metric_offset_map, metric, record_size);
+                    count += Layout::map_stream(in, metric, header, false);
+                    status = base_t::MergedRecord;
+                }
+                else
+                {
+                    if (Layout::MULTI_RECORD)
+                    {
+                        next = metric_t(header);
+                        next.set_base(id);
+                    }
+                    count += Layout::map_stream(in, next, header, true);
+                    if (!in.fail() && Layout::skip_metric(next)) status = base_t::SkippedRecord;
                 }
             }
-            metric_set.trim(metric_offset_map.size());
+            if (in.fail() || count != record_size)
+            {
+                if (in.fail())
+                    INTEROP_THROW(incomplete_file_exception, "Insufficient data read from the file, got: " << count
+                                                             << " != expected: " << record_size << " for "
+                                                             << Metric::prefix() <<  " "  << Metric::suffix()
+                                                             <<  " v" << Layout::VERSION);
+                INTEROP_THROW(bad_format_exception, "Record does not match expected size! for "
+                                                     << Metric::prefix() <<  " "  << Metric::suffix()  <<  " v"
+                                                     << Layout::VERSION << " count=" << count << " != "
+                                                     << " record_size: " << record_size);
+            }
+            return status;
         }
         /** Read a metric set from the given input stream
          *
@@ -230,7 +369,76 @@ namespace illumina { namespace interop { namespace io
             return Layout::compute_buffer_size(metric_set);
         }
 
+        bool write_record(char* buffer, const metric_t &metric, const header_t &header, is_single_record_t)
+        {
+            output_cursor out(buffer);
+            metric_id_t metric_id;
+            metric_id.set(metric);
+            write_binary(out, metric_id);
+            Layout::map_stream(out, metric, header, false);
+            INTEROP_ASSERT(static_cast<size_t>(out.position - buffer) == record_size(header));
+            return true;
+        }
+        bool write_record(char*, const metric_t &, const header_t &, is_multi_record_t)
+        {
+            return false;
+        }
+
     private:
+        typedef typename int_constant_type<0>::pointer_t is_record_decode_t;
+        typedef typename int_constant_type<1>::pointer_t is_bulk_decode_t;
+        static void read_bulk(std::istream&,
+                              metric_set_t&,
+                              const size_t,
+                              const std::streamsize,
+                              util::progress_token*,
+                              size_t&,
+                              ::uint64_t&,
+                              is_record_decode_t)
+        {
+        }
+        /** Read every record of the file into one buffer, and decode it with the layout
+         *
+         * @param in input stream
+         * @param metric_set destination set of metrics
+         * @param body_size number of bytes in the file after the header
+         * @param record_size number of bytes in each record
+         * @param progress progress token checked between chunks of records, may be null
+         * @param chunk number of records not yet reported
+         * @param bytes_reported total number of bytes reported
+         */
+        static void read_bulk(std::istream& in,
+                              metric_set_t& metric_set,
+                              const size_t body_size,
+                              const std::streamsize record_size,
+                              util::progress_token* progress,
+                              size_t& chunk,
+                              ::uint64_t& bytes_reported,
+                              is_bulk_decode_t)
+        {
+            std::vector<char> buffer(std::max(body_size, static_cast<size_t>(1)));
+            in.read(&buffer.front(), static_cast<std::streamsize>(body_size));
+            const std::streamsize count = in.gcount();
+            const size_t whole_records = static_cast<size_t>(count / record_size);
+            const size_t chunk_records = util::progress_token::RecordChunk;
+            char* in_ptr = &buffer.front();
+            for(size_t first=0;first<whole_records;first+=chunk_records)
+            {
+                const size_t n = std::min(chunk_records, whole_records-first);
+                Layout::decode_records(in_ptr, n, metric_set, metric_set.offset_map());
+                chunk += n;
+                if(progress != 0) report_chunk(progress, constants::metric_group(Metric::TYPE), record_size, chunk,
+                                               bytes_reported);
+            }
+            if(count % record_size != 0 || metric_set.offset_map().empty())
+            {
+                INTEROP_THROW(incomplete_file_exception, "Insufficient data read from the file, got: "
+                                                         << count % record_size
+                                                         << " != expected: " << record_size << " for "
+                                                         << Metric::prefix() <<  " "  << Metric::suffix()  <<  " v"
+                                                         << Layout::VERSION);
+            }
+        }
         static bool test_stream(std::istream& in,
                          const offset_map_t& metric_offset_map,
                          const std::streamsize count,
@@ -248,12 +456,37 @@ namespace illumina { namespace interop { namespace io
         }
         static bool test_stream(const char*, const offset_map_t&, const std::streamsize, const std::streamsize)
         {return true;}
+        /** Find the largest id in the offset map
+         *
+         * @param metric_offset_map map from a metric id to its offset in the metric set
+         * @return largest id, or 0 if the map is empty
+         */
+        static id_t max_id(const offset_map_t& metric_offset_map)
+        {
+            id_t last_id = 0;
+            for(typename offset_map_t::const_iterator it = metric_offset_map.begin();it != metric_offset_map.end();++it)
+                last_id = std::max(last_id, it->first);
+            return last_id;
+        }
+        /** Read a single record into the metric set
+         *
+         * Files are usually written in id order, so a record with an id larger than any seen before is appended to
+         * the offset map without searching it.
+         *
+         * @param in input stream or buffer
+         * @param metric_set destination set of metrics
+         * @param metric_offset_map map from a metric id to its offset in the metric set
+         * @param metric scratch metric
+         * @param record_size number of bytes in each record
+         * @param last_id largest id in the offset map, updated on return
+         */
         template<typename InputStream>
         static void read_record(InputStream& in,
                                 model::metric_base::metric_set<Metric>& metric_set,
                                 offset_map_t& metric_offset_map,
                                 metric_t& metric,
-                                const std::streamsize record_size)
+                                const std::streamsize record_size,
+                                id_t& last_id)
         {
             metric_id_t id;
             const std::streamsize read_byte_count = read_binary_with_count (in, id);
@@ -264,7 +497,10 @@ namespace illumina { namespace interop { namespace io
                 // simplifiy all this logic
             {
                 metric.set_base(id);// TODO replace with static call
-                if (metric_offset_map.find(metric.id()) == metric_offset_map.end())
+                const id_t metric_id = metric.id();
+                const typename offset_map_t::iterator offset_it =
+                        metric_id > last_id ? metric_offset_map.end() : metric_offset_map.find(metric_id);
+                if (offset_it == metric_offset_map.end())
                 {
                     const size_t offset = metric_offset_map.size();
                     if(offset>= metric_set.size()) metric_set.resize(offset+1);
@@ -275,11 +511,16 @@ namespace illumina { namespace interop { namespace io
                     {
                         metric_set.resize(offset);
                     }
-                    else metric_offset_map[metric.id()] = offset;
+                    else
+                    {
+                        metric_offset_map.insert(metric_offset_map.end(),
+                                                 typename offset_map_t::value_type(metric_id, offset));
+                        last_id = std::max(last_id, metric_id);
+                    }
                 }
                 else
                 {
-                    const size_t offset = metric_offset_map[metric.id()];
+                    const size_t offset = offset_it->second;
                     INTEROP_ASSERTMSG(metric_set[offset].lane() != 0, offset);
                     count += Layout::map_stream(in, metric_set[offset], metric_set, false);
                     INTEROP_ASSERT(metric_set[offset].id()>0);
@@ -35,6 +35,40 @@ namespace illumina { namespace interop { namespace io
             {
                 this->setg(begin, begin, end);
             }
+            /** Point the stream at a new char buffer
+             *
+             * @param begin start iterator for a char buffer
+             * @param end end iterator for a char buffer
+             */
+            void reset(char *begin, char *end)
+            {
+                this->setg(begin, begin, end);
+            }
+        };
+        /** Fixed size memory buffer for an output stream
+         *
+         * This class is used to encode directly into a pre-sized binary byte buffer. Writing past the end of the
+         * buffer fails the stream.
+         */
+        struct output_membuf : std::streambuf
+        {
+            /** Constructor
+             *
+             * @param begin start iterator for a char buffer
+             * @param end end iterator for a char buffer
+             */
+            output_membuf(char *begin, char *end)
+            {
+                this->setp(begin, end);
+            }
+            /** Get the number of bytes written
+             *
+             * @return number of bytes written
+             */
+            size_t size()const
+            {
+                return static_cast<size_t>(this->pptr() - this->pbase());
+            }
         };
     }
 }}}
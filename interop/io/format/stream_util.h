@@ -207,6 +207,90 @@ namespace illumina { namespace interop { namespace io
         if (len > 0) write_binary(out, const_cast<char *>(str.c_str()), len);
     }
 
+    /** Cursor over a memory buffer that binary records are encoded into
+     *
+     * Mapping a layout over this cursor copies each field directly into the buffer, without the per-call overhead
+     * of a std::ostream. The caller must size the buffer for the records written.
+     */
+    struct output_cursor
+    {
+        /** Constructor
+         *
+         * @param buffer start of the destination buffer
+         */
+        explicit output_cursor(char* buffer) : position(buffer){}
+        /** Test if the cursor can be written to, like testing a stream
+         *
+         * @return non-null if the cursor can be written to
+         */
+        operator const void*()const
+        {
+            return position;
+        }
+        /** Next byte to write */
+        char* position;
+    };
+
+    /** Write an array of data to a memory buffer
+     *
+     * @param out output cursor
+     * @param buffer array of data
+     * @param n number of elements in the array
+     */
+    template<class T>
+    void write_binary(output_cursor &out, const T *buffer, const size_t n)
+    {
+        std::memcpy(out.position, reinterpret_cast<const char *>(buffer), n * sizeof(T));
+        out.position += n * sizeof(T);
+    }
+
+    /** Write a value as binary data to a memory buffer
+     *
+     * @param out output cursor
+     * @param buffer value
+     */
+    template<class T>
+    void write_binary(output_cursor &out, const T &buffer)
+    {
+        write_binary(out, &buffer, 1);
+    }
+
+    /** Write an vector of data to a memory buffer
+     *
+     * @param out output cursor
+     * @param buffer vector of data
+     * @param n number of elements in the vector
+     */
+    template<class T>
+    void write_binary(output_cursor &out, const std::vector<T> &buffer, const size_t n)
+    {
+        if(buffer.empty())return;
+        write_binary(out, &buffer.front(), n);
+    }
+
+    /** Write an vector of data to a memory buffer
+     *
+     * @param out output cursor
+     * @param buffer vector of data
+     */
+    template<class T>
+    void write_binary(output_cursor &out, const std::vector<T> &buffer)
+    {
+        write_binary(out, buffer, buffer.size());
+    }
+
+    /** Write string data to a memory buffer
+     *
+     * @param out output cursor
+     * @param str string buffer
+     */
+    inline void write_binary(output_cursor &out, const std::string &str)
+    {
+        const ::uint16_t len = static_cast< ::uint16_t >(str.size());
+        write_binary(out, len);
+        if (len > 0) write_binary(out, str.c_str(), len);
+    }
+
     /** Number of characters extracted on the last unformatted (binary) input operation
      *
      * @param in input stream
@@ -10,6 +10,8 @@
 #pragma once
 #include "interop/util/exception.h"
 #include "interop/util/filesystem.h"
+#include "interop/util/mapped_file.h"
+#include "interop/util/progress.h"
 #include "interop/io/format/stream_membuf.h"
 #include "interop/io/metric_stream.h"
 
@@ -43,15 +45,11 @@ namespace illumina { namespace interop { namespace io
     size_t write_interop_to_buffer(const MetricSet& metrics, ::uint8_t* buffer, size_t buffer_size)
                         throw(invalid_argument, bad_format_exception, incomplete_file_exception)
     {
-        std::ostringstream fout;
-        write_metrics(fout, metrics, metrics.version());
-        std::string str = fout.str();
-        if(buffer_size < str.length())
+        const size_t written = write_metrics(reinterpret_cast<char*>(buffer), buffer_size, metrics,
+                                             metrics.version());
+        if(written == 0)
             INTEROP_THROW(invalid_argument, "Buffer size too small");
-        size_t i=0;
-        for(;i<str.length();++i)
-            buffer[i] = static_cast< ::uint8_t >(str[i]);
-        return i;
+        return written;
     }
     /** Read the binary InterOp file into the given metric set
      *
@@ -117,16 +115,22 @@ namespace illumina { namespace interop { namespace io
      * @param run_directory file path to the run directory
      * @param metrics metric set
      * @param use_out use the copied version
+     * @param progress progress token checked between chunks of records, may be null
      * @throw file_not_found_exception
      * @throw bad_format_exception
      * @throw incomplete_file_exception
+     * @throw util::operation_cancelled_exception
      */
     template<class MetricSet>
-    void read_interop(const std::string& run_directory, MetricSet& metrics, const bool use_out=true)   throw
+    void read_interop(const std::string& run_directory,
+                      MetricSet& metrics,
+                      const bool use_out=true,
+                      util::progress_token* progress=0)   throw
                                                                         (file_not_found_exception,
                                                                         bad_format_exception,
                                                                         incomplete_file_exception,
-                                                                        model::index_out_of_bounds_exception)
+                                                                        model::index_out_of_bounds_exception,
+                                                                        util::operation_cancelled_exception)
     {
         std::string file_name = interop_filename<MetricSet>(run_directory, use_out);
         std::ifstream fin(file_name.c_str(), std::ios::binary);
@@ -136,7 +140,11 @@ namespace illumina { namespace interop { namespace io
             fin.open(file_name.c_str(), std::ios::binary);
         }
         if(!fin.good()) INTEROP_THROW(file_not_found_exception, "File not found: " << file_name);
-        read_metrics(fin, metrics, static_cast<size_t>(file_size(file_name)));
+        util::scoped_trace trace("read_interop", "io", MetricSet::prefix(), MetricSet::suffix());
+        const size_t byte_count = static_cast<size_t>(file_size(file_name));
+        trace.add_bytes(byte_count);
+        read_metrics(fin, metrics, byte_count, true, progress);
+        trace.add_records(metrics.size());
     }
     /** Write the metric set to a binary InterOp file
      *
@@ -165,6 +173,42 @@ namespace illumina { namespace interop { namespace io
         write_metrics(fout, metrics, version);
         return fout.good();
     }
+    /** Write the metric set to a binary InterOp file mapped into memory
+     *
+     * The file is sized with `compute_buffer_size` and the records are encoded directly into the mapped file. If the
+     * file cannot be mapped, or the records do not fit, it is written with `write_interop` instead.
+     *
+     * @note The 'Out' suffix (parameter: use_out) is appended when we read the file. We excluded the Out in certain
+     * conditions when writing the file.
+     *
+     * @param run_directory file path to the run directory
+     * @param metrics metric set
+     * @param use_out use the copied version
+     * @param version version of format to write
+     * @return true if write is successful
+     */
+    template<class MetricSet>
+    bool write_interop_mapped(const std::string& run_directory,
+                              const MetricSet& metrics,
+                              const bool use_out=true,
+                              const ::int16_t version=-1)
+    throw(file_not_found_exception,
+    bad_format_exception,
+    incomplete_file_exception)
+    {
+        if(metrics.empty() || metrics.version() == 0 )return true;
+        const std::string file_name = interop_filename<MetricSet>(run_directory, use_out);
+        {
+            mapped_output_file fout(file_name, size_of_buffer(metrics, version));
+            if(fout.is_open())
+            {
+                const size_t written = write_metrics(reinterpret_cast<char*>(fout.data()), fout.size(), metrics,
+                                                     version);
+                if(written > 0) return fout.close(written);
+            }
+        }
+        return write_interop(run_directory, metrics, use_out, version);
+    }
     /** Write only the header to a binary InterOp file
      *
      * @note The 'Out' suffix (parameter: use_out) is appended when we read the file. We excluded the Out in certain
@@ -242,32 +286,39 @@ namespace illumina { namespace interop { namespace io
      * @param metrics metric set
      * @param last_cycle last cycle to check
      * @param use_out use the copied version
+     * @param progress progress token checked between chunks of records, may be null
      * @throw file_not_found_exception
      * @throw bad_format_exception
      * @throw incomplete_file_exception
+     * @throw util::operation_cancelled_exception
      */
     template<class MetricSet>
     void read_interop_by_cycle(const std::string& run_directory,
                                MetricSet& metrics,
                                const size_t last_cycle,
-                               const bool use_out=true)
+                               const bool use_out=true,
+                               util::progress_token* progress=0)
     throw(interop::io::file_not_found_exception,
     interop::io::bad_format_exception,
     interop::io::incomplete_file_exception,
-    model::index_out_of_bounds_exception)
+    model::index_out_of_bounds_exception,
+    util::operation_cancelled_exception)
     {
         std::string incomplete_file_message;
+        util::scoped_trace trace("read_interop_by_cycle", "io", MetricSet::prefix(), MetricSet::suffix());
         for(size_t cycle=1;cycle <= last_cycle;++cycle)
         {
             const std::string file_name = interop_filename<MetricSet>(run_directory, cycle, use_out);
             const int64_t file_size_in_bytes = file_size(file_name);
             if(file_size_in_bytes < 0) continue;
+            util::check_progress(progress);
             std::ifstream fin(file_name.c_str(), std::ios::binary);
             if(fin.good())
             {
+                trace.add_bytes(static_cast< ::uint64_t >(file_size_in_bytes));
                 try
                 {
-                    read_metrics(fin, metrics, static_cast<size_t>(file_size(file_name)), false);
+                    read_metrics(fin, metrics, static_cast<size_t>(file_size_in_bytes), false, progress);
                 }
                 catch(const incomplete_file_exception& ex)
                 {
@@ -275,9 +326,78 @@ namespace illumina { namespace interop { namespace io
                 }
             }
         }
-        metrics.rebuild_index();
+        {
+            util::scoped_trace rebuild_trace("rebuild_index", "io", MetricSet::prefix(), MetricSet::suffix());
+            metrics.rebuild_index();
+            rebuild_trace.add_records(metrics.size());
+        }
+        trace.add_records(metrics.size());
+        if(incomplete_file_message != "")
+            throw incomplete_file_exception(incomplete_file_message);
+    }
+    /** Write the binary InterOp files of a metric set as text, decoding one record at a time
+     *
+     * The aggregate file is written if it exists, otherwise the by cycle files are written in cycle order. The text
+     * header is written once, before the first record, so nothing is written if the files hold no records.
+     *
+     * @see stream_text
+     *
+     * @param run_directory file path to the run directory
+     * @param out output stream
+     * @param metrics scratch metric set, holds the header and no metrics on return
+     * @param channel_names list of channel names
+     * @param last_cycle last cycle to check for by cycle files
+     * @param use_out use the copied version
+     * @return number of records written
+     * @throw file_not_found_exception
+     * @throw bad_format_exception
+     * @throw incomplete_file_exception
+     */
+    template<class MetricSet>
+    size_t stream_interop_text(const std::string& run_directory,
+                               std::ostream& out,
+                               MetricSet& metrics,
+                               const std::vector<std::string>& channel_names,
+                               const size_t last_cycle=0,
+                               const bool use_out=true)
+    throw(file_not_found_exception,
+    bad_format_exception,
+    incomplete_file_exception,
+    model::index_out_of_bounds_exception)
+    {
+        std::string file_name = interop_filename<MetricSet>(run_directory, use_out);
+        std::ifstream fin(file_name.c_str(), std::ios::binary);
+        if(!fin.good())
+        {
+            file_name = interop_filename<MetricSet>(run_directory, !use_out);
+            fin.open(file_name.c_str(), std::ios::binary);
+        }
+        if(fin.good()) return stream_text(fin, out, metrics, channel_names);
+
+        std::string incomplete_file_message;
+        size_t record_count = 0;
+        bool file_found = false;
+        for(size_t cycle=1;cycle <= last_cycle;++cycle)
+        {
+            file_name = interop_filename<MetricSet>(run_directory, cycle, use_out);
+            std::ifstream cycle_in(file_name.c_str(), std::ios::binary);
+            if(!cycle_in.good()) continue;
+            file_found = true;
+            try
+            {
+                record_count += stream_text(cycle_in, out, metrics, channel_names, record_count > 0);
+            }
+            catch(const incomplete_file_exception& ex)
+            {
+                incomplete_file_message = ex.what();
+            }
+        }
+        if(!file_found)
+            INTEROP_THROW(file_not_found_exception, "File not found: " << interop_filename<MetricSet>(run_directory,
+                                                                                                   use_out));
         if(incomplete_file_message != "")
             throw incomplete_file_exception(incomplete_file_message);
+        return record_count;
     }
     /** Check for the existence of the binary InterOp file into the given metric set
      *
@@ -12,9 +12,11 @@
 #include "interop/model/model_exceptions.h"
 #include "interop/io/format/metric_format_factory.h"
 #include "interop/io/format/text_format_factory.h"
+#include "interop/io/format/stream_membuf.h"
 #include "interop/io/paths.h"
 #include "interop/util/filesystem.h"
 #include "interop/util/assert.h"
+#include "interop/util/trace.h"
 
 #pragma once
 namespace illumina { namespace interop { namespace io
@@ -63,6 +65,23 @@ namespace illumina { namespace interop { namespace io
             *oit = it->first;
         }
     }
+    /** Get the latest version of the binary format
+     *
+     * @return latest registered version number, or -1 if no format is registered
+     */
+    template<class MetricType>
+    ::int16_t latest_version()
+    {
+        typedef metric_format_factory<MetricType> factory_t;
+        typedef typename factory_t::metric_format_map metric_format_map;
+        metric_format_map &format_map = factory_t::metric_formats();
+        int version = -1;
+        for(typename metric_format_map::const_iterator it = format_map.begin();it != format_map.end();++it)
+        {
+            if(it->first > version) version = it->first;
+        }
+        return static_cast< ::int16_t >(version);
+    }
     /** Read the header from the stream
      *
      * @param in input stream
@@ -94,9 +113,14 @@ namespace illumina { namespace interop { namespace io
      * @param metrics metric set
      * @param file_size number of bytes in the file
      * @param rebuild flag indicating whether to rebuild the lookup table
+     * @param progress progress token checked between chunks of records, may be null
      */
     template<class MetricSet>
-    void read_metrics(std::istream &in, MetricSet &metrics, const size_t file_size, const bool rebuild=true)
+    void read_metrics(std::istream &in,
+                      MetricSet &metrics,
+                      const size_t file_size,
+                      const bool rebuild=true,
+                      util::progress_token* progress=0)
     {
         typedef typename MetricSet::metric_type metric_t;
         typedef metric_format_factory<metric_t> factory_t;
@@ -113,14 +137,29 @@ namespace illumina { namespace interop { namespace io
         metrics.set_version(static_cast< ::int16_t>(version));
         try
         {
-            format_map[version]->read_metrics(in, metrics, file_size);
+            util::scoped_trace trace("decode", "io", MetricSet::prefix(), MetricSet::suffix());
+            const size_t record_count = metrics.size();
+            const size_t capacity = metrics.capacity();
+            format_map[version]->read_metrics(in, metrics, file_size, progress);
+            if(trace.is_active())
+            {
+                trace.add_bytes(file_size);
+                trace.add_records(metrics.size() - record_count);
+                if(metrics.capacity() > capacity)
+                    trace.add_allocation((metrics.capacity() - capacity) * sizeof(metric_t));
+            }
         }
         catch(const incomplete_file_exception& ex)
         {
             if(rebuild)metrics.rebuild_index();// TODO: Speed up with hash map if using c++11 compiler
             throw ex;
         }
-        if(rebuild)metrics.rebuild_index();
+        if(rebuild)
+        {
+            util::scoped_trace trace("rebuild_index", "io", MetricSet::prefix(), MetricSet::suffix());
+            metrics.rebuild_index();
+            trace.add_records(metrics.size());
+        }
     }
 
     /** Get the size of a single metric record
@@ -325,6 +364,55 @@ namespace illumina { namespace interop { namespace io
              it != metrics.end(); it++)
             format_map[version]->write_metric(out, *it, metrics);
     }
+    /** Write a set of metrics to a binary InterOp memory buffer
+     *
+     * The header is written through a stream. For a format with one record per metric, the records are then encoded
+     * directly into the buffer. Otherwise, or if the records do not fit, they are written through the stream as well,
+     * which reports the same errors as `write_metrics` on a stream.
+     *
+     * @param buffer destination buffer
+     * @param buffer_size number of bytes in the buffer
+     * @param metrics set of metrics
+     * @param version version of the InterOp to write (if less than 0, get from metric set)
+     * @return number of bytes written, or 0 if the buffer is too small
+     */
+    template<class MetricSet>
+    static size_t write_metrics(char* buffer,
+                                const size_t buffer_size,
+                                const MetricSet &metrics,
+                                ::int16_t version = -1)
+    {
+        typedef typename MetricSet::metric_type metric_type;
+        typedef metric_format_factory<metric_type> factory_type;
+        typedef typename factory_type::metric_format_map metric_format_map;
+        metric_format_map &format_map = factory_type::metric_formats();
+
+        if (version < 0) version = metrics.version();
+        if (format_map.find(version) == format_map.end())
+            INTEROP_THROW(bad_format_exception, "No format found to write file with version: " <<
+                                                version <<  " of " << format_map.size()
+                                                << " for " << metric_type::prefix() << "" << metric_type::suffix()
+                                                << " with " << metrics.size() << " metrics");
+
+        INTEROP_ASSERT(format_map[version]);
+        detail::output_membuf sbuf(buffer, buffer + buffer_size);
+        std::ostream out(&sbuf);
+        format_map[version]->write_metric_header(out, metrics);
+        if(!out.good()) return 0;
+        const size_t header_size = sbuf.size();
+        const size_t record_size = format_map[version]->record_size(metrics);
+        if(!format_map[version]->is_multi_record() && record_size*metrics.size() <= buffer_size - header_size)
+        {
+            char* record = buffer + header_size;
+            typedef typename MetricSet::const_iterator const_iterator;
+            for (const_iterator it = metrics.begin(); it != metrics.end(); it++, record += record_size)
+                format_map[version]->write_record(record, *it, metrics);
+            return header_size + record_size*metrics.size();
+        }
+        for (typename MetricSet::const_iterator it = metrics.begin(); it != metrics.end(); it++)
+            format_map[version]->write_metric(out, *it, metrics);
+        return out.good() ? sbuf.size() : 0;
+    }
     /** Write a set of metrics to a text output stream
      *
      * @param out output stream
@@ -363,6 +451,80 @@ namespace illumina { namespace interop { namespace io
             format->write_metric(out, *it, metrics, sep, eol, missing);
 
     }
+    /** Decode a binary InterOp stream one record at a time and write each record as text
+     *
+     * Only the header and the current record are held in memory, so text is written as soon as the first record is
+     * decoded. Records are written as stored in the stream, without the corrections applied when a run is loaded.
+     * A multi-record format spreads each metric over several records. Consecutive records with the same id are
+     * merged, and the metric is written when a record with another id is read.
+     *
+     * @param in input stream of binary InterOp data
+     * @param out output stream
+     * @param metrics scratch metric set, holds the header and no metrics on return
+     * @param channel_names list of channel names
+     * @param header_written if false, write the text header before the first record
+     * @param version version of the text format to write (if less than 0, use latest)
+     * @param sep column separator
+     * @param eol row separator
+     * @param missing missing value indicator
+     * @return number of records written
+     */
+    template<class MetricSet>
+    static size_t stream_text(std::istream &in,
+                              std::ostream &out,
+                              MetricSet &metrics,
+                              const std::vector<std::string>& channel_names,
+                              const bool header_written=false,
+                              ::int16_t version = -1,
+                              const char sep=',',
+                              const char eol='\n',
+                              const char missing='-')
+    {
+        typedef typename MetricSet::metric_type metric_type;
+        typedef text_format_factory<metric_type> factory_type;
+        typedef typename factory_type::abstract_text_format_t* abstract_text_format_pointer_t;
+        typedef metric_format_factory<metric_type> metric_factory_t;
+        typedef typename metric_factory_t::abstract_metric_format_t* abstract_metric_format_pointer_t;
+
+        factory_type &factory = factory_type::instance();
+        abstract_text_format_pointer_t format = factory.find(version);
+        if (format == 0)
+            INTEROP_THROW(bad_format_exception,
+                          "No format found to write file with version: "
+                                  << version <<  " of " << factory.size()
+                                  << " for " << metric_type::prefix() << "" << metric_type::suffix());
+        util::scoped_trace trace("stream_text", "io", MetricSet::prefix(), MetricSet::suffix());
+        metrics.trim(0);
+        metrics.offset_map().clear();
+        read_header(in, metrics);
+        abstract_metric_format_pointer_t binary_format = &*metric_factory_t::metric_formats()[metrics.version()];
+        typedef typename metric_factory_t::abstract_metric_format_t abstract_metric_format_t;
+        // The open metric is written once a record of another metric, or the end of the stream, is read
+        metric_type records[2] = {metric_type(metrics), metric_type(metrics)};
+        size_t open = 0;
+        bool has_open = false;
+        size_t record_count = 0;
+        bool write_header = !header_written;
+        for(;;)
+        {
+            const typename abstract_metric_format_t::record_status status =
+                    binary_format->read_next_record(in, metrics, records[open], records[1-open], has_open);
+            if(status == abstract_metric_format_t::MergedRecord || status == abstract_metric_format_t::SkippedRecord)
+                continue;
+            if(has_open)
+            {
+                if(write_header) format->write_header(out, metrics, channel_names, sep, eol);
+                write_header = false;
+                format->write_metric(out, records[open], metrics, sep, eol, missing);
+                ++record_count;
+            }
+            if(status == abstract_metric_format_t::EndOfRecords) break;
+            open = 1-open;
+            has_open = true;
+        }
+        trace.add_records(record_count);
+        return record_count;
+    }
 
     /** Generate a file name from a run directory and the metric type for by cycle InterOps
      *
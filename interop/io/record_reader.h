@@ -0,0 +1,235 @@
+/** Cursor over the records of a binary InterOp file
+ *
+ * The reader decodes each record in place into a metric held by the reader, so tools that count, filter or find the
+ * range of a metric can scan files of any size without building a metric set.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <fstream>
+#include <string>
+#include "interop/util/exception.h"
+#include "interop/util/cstdint.h"
+#include "interop/io/format/stream_membuf.h"
+#include "interop/io/metric_stream.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Forward cursor over the records of a binary InterOp file or byte buffer
+     *
+     * Records are yielded as stored, in file order, without the corrections applied when a run is loaded. A
+     * multi-record format spreads each metric over several records. Consecutive records with the same id are
+     * merged, and the metric is yielded when a record with another id is read. A metric whose records are not
+     * consecutive in the file is yielded once for each run of records.
+     *
+     * @code
+     * io::record_reader<error_metrics> reader(io::paths::interop_filename<error_metrics>(run_folder));
+     * while(reader.next())
+     *     max_error_rate = std::max(max_error_rate, reader.record().error_rate());
+     * @endcode
+     */
+    template<class MetricSet>
+    class record_reader
+    {
+    public:
+        /** Define the metric type */
+        typedef typename MetricSet::metric_type metric_t;
+        /** Define the header type */
+        typedef typename MetricSet::header_type header_t;
+
+    private:
+        typedef metric_format_factory<metric_t> factory_t;
+        typedef typename factory_t::abstract_metric_format_t abstract_metric_format_t;
+        typedef typename abstract_metric_format_t::record_status record_status;
+
+    public:
+        /** Constructor
+         */
+        record_reader() : m_buffer(0, 0), m_in(0), m_format(0), m_current(0), m_open(0), m_has_open(false), m_next(0)
+        {}
+        /** Constructor
+         *
+         * @param filename path to a binary InterOp file
+         */
+        explicit record_reader(const std::string& filename) throw(file_not_found_exception,
+        bad_format_exception,
+        incomplete_file_exception) : m_buffer(0, 0), m_in(0), m_format(0), m_current(0), m_open(0),
+                                     m_has_open(false), m_next(0)
+        {
+            open(filename);
+        }
+        /** Constructor
+         *
+         * @note the buffer must outlive the reader
+         *
+         * @param buffer byte buffer holding a binary InterOp file
+         * @param buffer_size length of the byte buffer
+         */
+        record_reader(const ::uint8_t* buffer, const size_t buffer_size) throw(bad_format_exception,
+        incomplete_file_exception) : m_buffer(0, 0), m_in(0), m_format(0), m_current(0), m_open(0),
+                                     m_has_open(false), m_next(0)
+        {
+            open(buffer, buffer_size);
+        }
+
+    public:
+        /** Open a binary InterOp file and read its header
+         *
+         * @param filename path to a binary InterOp file
+         */
+        void open(const std::string& filename) throw(file_not_found_exception,
+        bad_format_exception,
+        incomplete_file_exception)
+        {
+            close();
+            m_file.open(filename.c_str(), std::ios::binary);
+            if(!m_file.good()) INTEROP_THROW(file_not_found_exception, "File not found: " << filename);
+            m_in.rdbuf(m_file.rdbuf());
+            read_header();
+        }
+        /** Open a byte buffer holding a binary InterOp file and read its header
+         *
+         * @note the buffer must outlive the reader
+         *
+         * @param buffer byte buffer holding a binary InterOp file
+         * @param buffer_size length of the byte buffer
+         */
+        void open(const ::uint8_t* buffer, const size_t buffer_size) throw(bad_format_exception,
+        incomplete_file_exception)
+        {
+            close();
+            char* begin = reinterpret_cast<char*>(const_cast< ::uint8_t* >(buffer));
+            m_buffer.reset(begin, begin+buffer_size);
+            m_in.rdbuf(&m_buffer);
+            read_header();
+        }
+        /** Close the file
+         */
+        void close()
+        {
+            if(m_file.is_open()) m_file.close();
+            m_file.clear();
+            m_in.rdbuf(0);
+            m_metrics.clear();
+            m_format = 0;
+            m_current = 0;
+            m_open = 0;
+            m_has_open = false;
+            m_next = 0;
+        }
+        /** Advance to the next record
+         *
+         * @return false if there are no more records
+         */
+        bool next() throw(bad_format_exception, incomplete_file_exception)
+        {
+            if(m_format == 0) return false;
+            if(!m_format->is_multi_record())
+            {
+                record_status status;
+                do
+                {
+                    status = m_format->read_next_record(m_in, m_metrics, m_records[0], m_records[0], false);
+                }while(status == abstract_metric_format_t::SkippedRecord);
+                if(status == abstract_metric_format_t::EndOfRecords)
+                {
+                    m_format = 0;
+                    return false;
+                }
+                m_current = 0;
+                ++m_next;
+                return true;
+            }
+            // The open metric is complete once a record of another metric, or the end of the stream, is read
+            for(;;)
+            {
+                const size_t other = 1 - m_open;
+                const record_status status =
+                        m_format->read_next_record(m_in, m_metrics, m_records[m_open], m_records[other], m_has_open);
+                if(status == abstract_metric_format_t::EndOfRecords)
+                {
+                    m_format = 0;
+                    if(!m_has_open) return false;
+                    m_has_open = false;
+                    m_current = m_open;
+                    ++m_next;
+                    return true;
+                }
+                if(status != abstract_metric_format_t::NewRecord) continue;
+                const bool complete = m_has_open;
+                m_current = m_open;
+                m_open = other;
+                m_has_open = true;
+                if(complete)
+                {
+                    ++m_next;
+                    return true;
+                }
+            }
+        }
+
+    public:
+        /** Get the current record
+         *
+         * @note the reference is overwritten by the next call to `next`
+         *
+         * @return current record
+         */
+        const metric_t& record()const
+        {
+            return m_records[m_current];
+        }
+        /** Get the header read from the file
+         *
+         * @return metric header
+         */
+        const header_t& header()const
+        {
+            return m_metrics;
+        }
+        /** Get the version of the binary format
+         *
+         * @return version of the binary format
+         */
+        ::int16_t version()const
+        {
+            return m_metrics.version();
+        }
+        /** Get the number of records yielded so far
+         *
+         * @return number of records
+         */
+        size_t record_count()const
+        {
+            return m_next;
+        }
+
+    private:
+        void read_header()
+        {
+            io::read_header(m_in, m_metrics);
+            m_format = &*factory_t::metric_formats()[m_metrics.version()];
+            m_records[0] = metric_t(m_metrics);
+            m_records[1] = m_records[0];
+        }
+
+    private:
+        record_reader(const record_reader&);
+        record_reader& operator=(const record_reader&);
+
+    private:
+        std::ifstream m_file;
+        detail::membuf m_buffer;
+        std::istream m_in;
+        MetricSet m_metrics;
+        abstract_metric_format_t* m_format;
+        metric_t m_records[2];
+        size_t m_current;
+        size_t m_open;
+        bool m_has_open;
+        size_t m_next;
+    };
+}}}
@@ -0,0 +1,224 @@
+/** Cache of loaded runs kept resident in memory
+ *
+ * The cache holds fully loaded, finalized and frozen run metrics so repeated summary, plot and table requests on the
+ * same run folder do not reload it from disk. Before a cached run is handed out, the size and modification time of its
+ * InterOp files are compared against those recorded before they were read. Only the metric groups whose files changed
+ * are reloaded.
+ * When the estimated memory of the resident runs exceeds the budget, the least recently used runs are evicted.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <limits>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "interop/util/cstdint.h"
+#include "interop/model/run_metrics.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Counters describing how a run cache was used
+     */
+    struct run_cache_statistics
+    {
+        /** Constructor */
+        run_cache_statistics() : hit_count(0), load_count(0), refresh_count(0), eviction_count(0){}
+        /** Number of requests served from memory without reading any file */
+        size_t hit_count;
+        /** Number of runs loaded from scratch */
+        size_t load_count;
+        /** Number of runs partially or fully reloaded after their files changed */
+        size_t refresh_count;
+        /** Number of runs evicted to stay under the memory budget */
+        size_t eviction_count;
+    };
+
+    /** Least recently used cache of run metrics
+     *
+     * This class is not thread safe. A reference returned by `get` remains valid until the next call to `get`,
+     * `refresh`, `evict` or `clear`. Each run is frozen after it is loaded or refreshed, so until then, the run may be
+     * read by the const plot, summary and table logic from several threads at once.
+     *
+     * @code
+     * io::run_cache cache(memory_budget);
+     * const model::metrics::run_metrics& run = cache.get(run_folder);
+     * @endcode
+     */
+    class run_cache
+    {
+        /** Run held by the cache */
+        struct cache_entry
+        {
+            /** Constructor
+             *
+             * @param folder run folder
+             */
+            cache_entry(const std::string& folder="") :
+                    run_folder(folder),
+                    xml_signature(0),
+                    resident_bytes(0),
+                    last_check(0),
+                    legacy_bin_count(std::numeric_limits<size_t>::max())
+            {}
+            /** Run folder */
+            std::string run_folder;
+            /** Loaded run */
+            model::metrics::run_metrics run;
+            /** Signature of the InterOp files of each metric group */
+            std::vector< ::uint64_t > group_signatures;
+            /** Signature of RunInfo.xml and RunParameters.xml */
+            ::uint64_t xml_signature;
+            /** Estimated memory held by the run */
+            ::uint64_t resident_bytes;
+            /** Time the files were last checked for changes */
+            double last_check;
+            /** Number of legacy q-score bins found when the run was loaded */
+            size_t legacy_bin_count;
+        };
+        typedef std::list<cache_entry> entry_list_t;
+        typedef std::map<std::string, entry_list_t::iterator> entry_map_t;
+
+    public:
+        /** Vector of strings */
+        typedef std::vector<std::string> string_vector;
+
+    public:
+        /** Constructor
+         *
+         * @param memory_budget maximum estimated memory of resident runs in bytes, 0 for unlimited
+         * @param thread_count number of threads used to load each run
+         * @param refresh_interval minimum number of seconds between checks of a run's files for changes
+         */
+        run_cache(const ::uint64_t memory_budget=0, const size_t thread_count=1, const double refresh_interval=1.0) :
+                m_memory_budget(memory_budget),
+                m_thread_count(thread_count),
+                m_refresh_interval(refresh_interval),
+                m_resident_bytes(0)
+        {}
+
+    public:
+        /** Get a loaded run, loading or refreshing it if necessary
+         *
+         * The run becomes the most recently used, and other runs may be evicted to stay under the memory budget.
+         * If the run fails to load or refresh, it is removed from the cache.
+         *
+         * @param run_folder run folder path
+         * @return loaded and frozen run metrics
+         */
+        const model::metrics::run_metrics& get(const std::string& run_folder) throw(xml::xml_file_not_found_exception,
+        xml::bad_xml_format_exception,
+        xml::empty_xml_format_exception,
+        xml::missing_xml_element_exception,
+        xml::xml_parse_exception,
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception,
+        model::invalid_channel_exception,
+        model::index_out_of_bounds_exception,
+        model::invalid_tile_naming_method,
+        model::invalid_run_info_exception,
+        model::invalid_parameter);
+        /** Check a resident run for changed files immediately, ignoring the refresh interval
+         *
+         * @param run_folder run folder path
+         * @return true if any file was reloaded, false if the run is not resident or unchanged
+         */
+        bool refresh(const std::string& run_folder) throw(xml::xml_file_not_found_exception,
+        xml::bad_xml_format_exception,
+        xml::empty_xml_format_exception,
+        xml::missing_xml_element_exception,
+        xml::xml_parse_exception,
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception,
+        model::invalid_channel_exception,
+        model::index_out_of_bounds_exception,
+        model::invalid_tile_naming_method,
+        model::invalid_run_info_exception,
+        model::invalid_parameter);
+        /** Remove a run from the cache
+         *
+         * @param run_folder run folder path
+         * @return true if the run was resident
+         */
+        bool evict(const std::string& run_folder);
+        /** Remove all runs from the cache
+         */
+        void clear();
+        /** Test if a run is resident
+         *
+         * @param run_folder run folder path
+         * @return true if the run is resident
+         */
+        bool contains(const std::string& run_folder)const;
+        /** List the resident runs, most recently used first
+         *
+         * @param run_folders destination list of run folders
+         */
+        void list_runs(string_vector& run_folders)const;
+
+    public:
+        /** Get the number of resident runs
+         *
+         * @return number of resident runs
+         */
+        size_t size()const
+        {
+            return m_entries.size();
+        }
+        /** Get the estimated memory held by the resident runs
+         *
+         * @return number of bytes
+         */
+        ::uint64_t resident_bytes()const
+        {
+            return m_resident_bytes;
+        }
+        /** Get the memory budget
+         *
+         * @return maximum estimated memory of resident runs in bytes, 0 for unlimited
+         */
+        ::uint64_t memory_budget()const
+        {
+            return m_memory_budget;
+        }
+        /** Set the memory budget, evicting runs as necessary
+         *
+         * @param budget maximum estimated memory of resident runs in bytes, 0 for unlimited
+         */
+        void memory_budget(const ::uint64_t budget)
+        {
+            m_memory_budget = budget;
+            evict_over_budget();
+        }
+        /** Get the usage counters
+         *
+         * @return usage counters
+         */
+        const run_cache_statistics& statistics()const
+        {
+            return m_statistics;
+        }
+
+    private:
+        void load(cache_entry& entry);
+        bool refresh(cache_entry& entry, const double now);
+        void update_entry(cache_entry& entry, const ::uint64_t file_bytes);
+        void evict_over_budget();
+
+    private:
+        entry_list_t m_entries;
+        entry_map_t m_index;
+        ::uint64_t m_memory_budget;
+        size_t m_thread_count;
+        double m_refresh_interval;
+        ::uint64_t m_resident_bytes;
+        run_cache_statistics m_statistics;
+    };
+}}}
+
@@ -0,0 +1,94 @@
+/** Generate synthetic run folders of any size
+ *
+ * The metrics are streamed directly to disk, record by record, through the same binary layouts used to write real
+ * InterOp files, so the size of a run is limited only by disk space. Each metric group (and, for the by cycle layout,
+ * each cycle) is written by an independent task, which can run in parallel.
+ *
+ * Values are drawn from distributions that resemble a real run: clusters and intensities vary by tile, intensity and
+ * quality decay over each read, and the error rate rises towards the end of each read. The same seed always
+ * produces the same files, regardless of the number of threads.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <string>
+#include "interop/io/stream_exceptions.h"
+#include "interop/model/model_exceptions.h"
+#include "interop/model/run/info.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Options that control the content of a synthetic run
+     */
+    struct synthetic_run_options
+    {
+        /** Constructor
+         *
+         * @param seed_value seed of the random number generator
+         */
+        synthetic_run_options(const unsigned int seed_value=1) :
+                seed(seed_value),
+                bin_count(7),
+                sample_count(8),
+                by_cycle(false),
+                thread_count(1)
+        {}
+        /** Seed of the random number generator */
+        unsigned int seed;
+        /** Number of q-score bins, 0 writes an unbinned histogram */
+        size_t bin_count;
+        /** Number of samples reported in the index metrics */
+        size_t sample_count;
+        /** Write each cycle into its own `InterOp/C#.1` folder, rather than one file per metric group */
+        bool by_cycle;
+        /** Number of threads used to write the metric groups */
+        size_t thread_count;
+    };
+
+    /** Create the run info for a synthetic run
+     *
+     * The flowcell uses four digit tile naming. Runs with at least 40 cycles have two reads separated by an 8 cycle
+     * index read, shorter runs have a single read.
+     *
+     * @param lane_count number of lanes
+     * @param surface_count number of surfaces
+     * @param swath_count number of swaths per surface
+     * @param tile_count number of tiles per swath
+     * @param cycle_count total number of cycles
+     * @param channel_count number of image channels
+     * @return run info
+     */
+    model::run::info synthetic_run_info(const size_t lane_count,
+                                        const size_t surface_count,
+                                        const size_t swath_count,
+                                        const size_t tile_count,
+                                        const size_t cycle_count,
+                                        const size_t channel_count)
+                                        throw(model::invalid_parameter);
+
+    /** Write a synthetic run folder
+     *
+     * This creates the run folder (and InterOp folder) if they do not exist, writes the run info to `RunInfo.xml`, and
+     * writes the Tile, Error, Extraction, Image, CorrectedInt, Q, Index and EmpiricalPhasing InterOp files. The tiles
+     * are taken from the tile list of the run info, or enumerated from the flowcell layout if the list is empty.
+     *
+     * @param run_folder destination run folder
+     * @param run_info run info describing the flowcell, reads and channels
+     * @param options options that control the content of the run
+     * @return number of bytes written to the InterOp files
+     */
+    ::uint64_t write_synthetic_run(const std::string& run_folder,
+                                   const model::run::info& run_info,
+                                   const synthetic_run_options& options=synthetic_run_options())
+                                   throw(file_not_found_exception,
+                                   bad_format_exception,
+                                   model::invalid_parameter,
+                                   model::invalid_channel_exception,
+                                   xml::xml_file_not_found_exception,
+                                   xml::bad_xml_format_exception);
+}}}
+
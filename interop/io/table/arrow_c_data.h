@@ -0,0 +1,80 @@
+/** Apache Arrow C Data Interface
+ *
+ * These structures are defined by the Arrow C data interface ABI, and are copied here verbatim so that any Arrow
+ * consumer (pyarrow, DuckDB, polars, ...) can import InterOp data without this library depending on Arrow.
+ *
+ * @see https://arrow.apache.org/docs/format/CDataInterface.html
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include "interop/util/cstdint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+/** Describes the type and name of exported data */
+struct ArrowSchema
+{
+    /** Format string describing the data type */
+    const char* format;
+    /** Name of the field */
+    const char* name;
+    /** Binary encoded metadata (may be null) */
+    const char* metadata;
+    /** Bitfield of ARROW_FLAG_* */
+    int64_t flags;
+    /** Number of children */
+    int64_t n_children;
+    /** Array of child schemas */
+    struct ArrowSchema** children;
+    /** Dictionary schema (may be null) */
+    struct ArrowSchema* dictionary;
+    /** Release callback, null when released */
+    void (*release)(struct ArrowSchema*);
+    /** Opaque producer-specific data */
+    void* private_data;
+};
+
+/** Describes the buffers of exported data */
+struct ArrowArray
+{
+    /** Number of elements */
+    int64_t length;
+    /** Number of null elements */
+    int64_t null_count;
+    /** Logical offset into the buffers */
+    int64_t offset;
+    /** Number of buffers */
+    int64_t n_buffers;
+    /** Number of children */
+    int64_t n_children;
+    /** Array of buffer pointers */
+    const void** buffers;
+    /** Array of child arrays */
+    struct ArrowArray** children;
+    /** Dictionary array (may be null) */
+    struct ArrowArray* dictionary;
+    /** Release callback, null when released */
+    void (*release)(struct ArrowArray*);
+    /** Opaque producer-specific data */
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,167 @@
+/** Export metric sets and the imaging table through the Apache Arrow C Data Interface
+ *
+ * Each export fills an `ArrowSchema` describing a struct with one child per column, and an `ArrowArray` holding the
+ * column buffers. The buffers are owned by the exported array and freed by its `release` callback, which the consumer
+ * is responsible for calling (most Arrow libraries do so automatically on import).
+ *
+ * The columns carry the same names as those written by `write_text` (and `dumptext`), but each column is filled
+ * directly from the metric accessors and keeps the numeric type of the metric field.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include "interop/io/stream_exceptions.h"
+#include "interop/io/table/arrow_c_data.h"
+#include "interop/model/run_metrics.h"
+#include "interop/model/table/imaging_table.h"
+#include "interop/logic/table/table_util.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Export a corrected intensity metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::corrected_intensity_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export an error metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::error_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export an extraction metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names list of channel names, one per channel in the header
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::extraction_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>())
+                         throw(bad_format_exception);
+    /** Export an image metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names list of channel names, one per channel in the header
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::image_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>())
+                         throw(bad_format_exception);
+    /** Export an index metric set as an Arrow struct array
+     *
+     * There is one row per index in each metric.
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::index_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export a phasing metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::phasing_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export a dynamic phasing metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export a q-metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::q_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export a by lane q-metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::q_by_lane_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export a collapsed q-metric set as an Arrow struct array
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::q_collapsed_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export a tile metric set as an Arrow struct array
+     *
+     * There is one row per read in each metric. A metric without reads has a single row where the read columns are
+     * null.
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     * @param channel_names unused
+     */
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::tile_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names=std::vector<std::string>());
+    /** Export the imaging table as an Arrow struct array
+     *
+     * Each sub column of the table (e.g. one per channel) becomes a separate float column, and missing (NaN) values
+     * are marked as null.
+     *
+     * @note The table is stored row-major, so each column is copied once into a contiguous buffer.
+     *
+     * @param table imaging table
+     * @param schema destination schema, released by the consumer
+     * @param array destination array, released by the consumer
+     */
+    void export_to_arrow(const model::table::imaging_table& table, ArrowSchema* schema, ArrowArray* array);
+}}}
@@ -0,0 +1,60 @@
+/** Read-only access to metric sets derived from other metric sets of a run
+ *
+ * The plot, summary and table logic needs the collapsed q-metrics, the by lane q-metrics and the dynamic phasing
+ * metrics. These are derived when a run is loaded, but may be missing if a run was populated some other way. The
+ * functions below return the derived set held by the run or, if it is missing, derive it into a scratch set owned by
+ * the caller, so the run is never modified.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include "interop/model/run_metrics.h"
+#include "interop/logic/summary/map_cycle_to_read.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4290) // MSVC warns that it ignores the exception specification.
+#endif
+
+namespace illumina { namespace interop { namespace logic { namespace metric
+{
+    /** Get the collapsed q-metrics of a run without modifying the run
+     *
+     * @param metrics run metrics
+     * @param scratch destination for the collapsed q-metrics, if the run has none
+     * @param cumulative populate the cumulative distribution of the scratch set
+     * @return collapsed q-metrics of the run, or the scratch set
+     */
+    const model::metric_base::metric_set<model::metrics::q_collapsed_metric>&
+    collapsed_q_metrics(const model::metrics::run_metrics& metrics,
+                        model::metric_base::metric_set<model::metrics::q_collapsed_metric>& scratch,
+                        const bool cumulative=false) throw(model::index_out_of_bounds_exception);
+    /** Get the by lane q-metrics of a run without modifying the run
+     *
+     * @param metrics run metrics
+     * @param scratch destination for the by lane q-metrics, if the run has none
+     * @return by lane q-metrics of the run, or the scratch set
+     */
+    const model::metric_base::metric_set<model::metrics::q_by_lane_metric>&
+    q_metrics_by_lane(const model::metrics::run_metrics& metrics,
+                      model::metric_base::metric_set<model::metrics::q_by_lane_metric>& scratch)
+    throw(model::index_out_of_bounds_exception);
+    /** Get the dynamic phasing metrics of a run without modifying the run
+     *
+     * @param metrics run metrics
+     * @param cycle_to_read map of cycle to read information
+     * @param scratch destination for the dynamic phasing metrics, if the run has none
+     * @return dynamic phasing metrics of the run, or the scratch set
+     */
+    const model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>&
+    dynamic_phasing_metrics(const model::metrics::run_metrics& metrics,
+                            const logic::summary::read_cycle_vector_t& cycle_to_read,
+                            model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>& scratch);
+
+}}}}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -75,6 +75,22 @@ namespace illumina { namespace interop { namespace logic { namespace metric
      */
     void populate_cumulative_distribution(model::metric_base::metric_set<model::metrics::q_collapsed_metric>& q_metric_set)
                     throw( model::index_out_of_bounds_exception );
+    /** Compute the q-score suffix sums of each by lane q-metric
+     *
+     * Call it after `populate_cumulative_distribution` to answer threshold queries without summing the histogram.
+     * `run_metrics::finalize_after_load` and `run_metrics::freeze` call it for the run.
+     *
+     * @param q_metric_set q-metric set
+     */
+    void populate_qscore_suffix_sums(model::metric_base::metric_set<model::metrics::q_by_lane_metric>& q_metric_set);
+    /** Compute the q-score suffix sums of each q-metric
+     *
+     * Call it after `populate_cumulative_distribution` to answer threshold queries without summing the histogram.
+     * `run_metrics::finalize_after_load` and `run_metrics::freeze` call it for the run.
+     *
+     * @param q_metric_set q-metric set
+     */
+    void populate_qscore_suffix_sums(model::metric_base::metric_set<model::metrics::q_metric>& q_metric_set);
     /** Count number of unique counts to determine number
      * of unique bins for legacy binning
      *
@@ -16,6 +16,27 @@
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
     /** Plot a specified metric value by cycle
+     *
+     * The run is not modified, so a frozen run may be plotted from several threads at once.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data
+     */
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
+                       const constants::metric_type type,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data)
+                    throw(model::index_out_of_bounds_exception,
+                    model::invalid_metric_type,
+                    model::invalid_channel_exception,
+                    model::invalid_filter_option,
+                    model::invalid_read_exception);
+    /** Plot a specified metric value by cycle
+     *
+     * Collapsed q-metrics missing from the run are derived into the run.
      *
      * @ingroup plot_logic
      * @param metrics run metrics
@@ -34,6 +55,27 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                     model::invalid_read_exception);
 
     /** Plot a specified metric value by cycle using the candle stick model
+     *
+     * The run is not modified, so a frozen run may be plotted from several threads at once.
+     *
+     * @ingroup plot_logic
+     * @todo Is this temporary?
+     * @param metrics run metrics
+     * @param metric_name name of metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data
+     */
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
+                       const std::string& metric_name,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data)
+            throw(model::index_out_of_bounds_exception,
+            model::invalid_filter_option,
+            model::invalid_channel_exception,
+            model::invalid_metric_type);
+    /** Plot a specified metric value by cycle using the candle stick model
+     *
+     * Collapsed q-metrics missing from the run are derived into the run.
      *
      * @ingroup plot_logic
      * @todo Is this temporary?
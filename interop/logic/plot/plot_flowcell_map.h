@@ -18,6 +18,29 @@ namespace illumina { namespace interop { namespace logic { namespace plot
 
 
     /** Plot a flowcell map
+     *
+     * The run is not modified, so a frozen run may be plotted from several threads at once.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     */
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
+                                  const constants::metric_type type,
+                                  const model::plot::filter_options& options,
+                                  model::plot::flowcell_data& data,
+                                  float* buffer=0,
+                                  ::uint32_t* tile_buffer=0)
+                                  throw(model::invalid_filter_option,
+                                  model::invalid_metric_type,
+                                  model::index_out_of_bounds_exception);
+    /** Plot a flowcell map
+     *
+     * Collapsed q-metrics missing from the run are derived into the run.
      *
      * @ingroup plot_logic
      * @param metrics run metrics
@@ -66,6 +89,29 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     }
 
     /** Plot a flowcell map
+     *
+     * The run is not modified, so a frozen run may be plotted from several threads at once.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param metric_name specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     */
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
+                                  const std::string& metric_name,
+                                  const model::plot::filter_options& options,
+                                  model::plot::flowcell_data& data,
+                                  float* buffer=0,
+                                  ::uint32_t* tile_buffer=0)
+                                  throw(model::invalid_filter_option,
+                                  model::invalid_metric_type,
+                                  model::index_out_of_bounds_exception);
+    /** Plot a flowcell map
+     *
+     * Collapsed q-metrics missing from the run are derived into the run.
      *
      * @ingroup plot_logic
      * @param metrics run metrics
@@ -15,6 +15,26 @@
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
     /** Plot a heat map of q-scores
+     *
+     * The run is not modified, so a frozen run may be plotted from several threads at once.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param options options to filter the data
+     * @param data output heat map data
+     * @param buffer optional buffer of preallocated memory (for SWIG)
+     * @param buffer_size number of elements in buffer
+     */
+    void plot_qscore_heatmap(const model::metrics::run_metrics& metrics,
+                                    const model::plot::filter_options& options,
+                                    model::plot::heatmap_data& data,
+                                    float* buffer=0,
+                                    const size_t buffer_size=0)
+                                    throw(model::index_out_of_bounds_exception,
+                                    model::invalid_filter_option);
+    /** Plot a heat map of q-scores
+     *
+     * By lane q-metrics missing from the run are derived into the run.
      *
      * @ingroup plot_logic
      * @param metrics run metrics
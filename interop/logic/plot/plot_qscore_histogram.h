@@ -17,6 +17,25 @@ namespace illumina { namespace interop { namespace logic { namespace plot {
 
 
     /** Plot a histogram of q-scores
+     *
+     * The run is not modified, so a frozen run may be plotted from several threads at once.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param options options to filter the data
+     * @param data output plot data
+     * @param boundary index of bin to create the boundary sub plots (0 means do nothing)
+     */
+    void plot_qscore_histogram(const model::metrics::run_metrics& metrics,
+                               const model::plot::filter_options& options,
+                               model::plot::plot_data<model::plot::bar_point>& data,
+                               const size_t boundary=0)
+                                throw( model::invalid_read_exception,
+                                model::index_out_of_bounds_exception,
+                                model::invalid_filter_option);
+    /** Plot a histogram of q-scores
+     *
+     * By lane q-metrics missing from the run are derived into the run.
      *
      * @ingroup plot_logic
      * @param metrics run metrics
@@ -0,0 +1,148 @@
+/** Summary logic for a batch of run folders
+ *
+ * Loads and summarizes many run folders concurrently on one pool of threads. At most `batch_worker_count` runs are
+ * in memory at once, and the InterOp files of each run are loaded by nested tasks on the same pool. A run that fails
+ * to load or summarize records its error in its own result, and the rest of the batch continues.
+ *
+ *  @file
+ *  @date  10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include "interop/model/summary/run_summary.h"
+#include "interop/model/summary/index_flowcell_summary.h"
+
+
+namespace illumina { namespace interop { namespace logic { namespace summary
+{
+    /** Reason a run in a batch could not be summarized
+     */
+    enum batch_error_type
+    {
+        /** The run was summarized */
+        BatchSuccess,
+        /** RunInfo.xml is missing */
+        BatchMissingRunInfo,
+        /** RunInfo.xml or RunParameters.xml is malformed */
+        BatchMalformedXml,
+        /** An InterOp file has a bad format */
+        BatchBadFormat,
+        /** No InterOp files were found */
+        BatchEmptyInterOp,
+        /** Any other error */
+        BatchUnexpectedError
+    };
+
+    /** Options controlling how a batch of runs is loaded and summarized
+     */
+    struct batch_summary_options
+    {
+        /** Constructor
+         *
+         * @param threads number of threads shared by the batch
+         * @param max_resident maximum number of runs in memory at once, a count of runs, 0 to use the thread count
+         */
+        batch_summary_options(const size_t threads=1, const size_t max_resident=0) :
+                thread_count(threads),
+                max_resident_runs(max_resident),
+                summarize_runs(true),
+                summarize_index(false),
+                skip_median(false),
+                check_empty(true)
+        {}
+        /** Number of threads shared by the batch */
+        size_t thread_count;
+        /** Maximum number of runs in memory at once, 0 to use the thread count
+         *
+         * This is a count of runs, not a memory limit: it caps how many runs are loaded and summarized concurrently.
+         */
+        size_t max_resident_runs;
+        /** Summarize the run metrics (SAV summary tab) */
+        bool summarize_runs;
+        /** Summarize the index metrics (SAV index tab) */
+        bool summarize_index;
+        /** Skip the median calculation of the run summary */
+        bool skip_median;
+        /** Report a run without any InterOp files as an error */
+        bool check_empty;
+    };
+
+    /** Summary of a single run in a batch
+     */
+    struct batch_summary_result
+    {
+        /** Constructor
+         *
+         * @param folder run folder
+         */
+        batch_summary_result(const std::string& folder="") :
+                run_folder(folder),
+                error_type(BatchSuccess)
+        {}
+        /** Test if the run was summarized
+         *
+         * @return true if no error occurred
+         */
+        bool is_valid()const
+        {
+            return error_type == BatchSuccess;
+        }
+        /** Run folder */
+        std::string run_folder;
+        /** Reason the run could not be summarized */
+        batch_error_type error_type;
+        /** Error message */
+        std::string error_message;
+        /** Run summary, populated when batch_summary_options::summarize_runs is set */
+        model::summary::run_summary run_summary;
+        /** Index summary, populated when batch_summary_options::summarize_index is set */
+        model::summary::index_flowcell_summary index_summary;
+    };
+    /** Vector of batch summary results */
+    typedef std::vector<batch_summary_result> batch_summary_result_vector;
+
+    /** Receives the result of each run of a batch as soon as it can be reported
+     *
+     * The results are reported in the order of the run folders: a run is reported once it and every run before it
+     * are summarized. Calls are made from the worker threads of the batch, one at a time, and must not throw.
+     */
+    class batch_summary_listener
+    {
+    public:
+        /** Destructor */
+        virtual ~batch_summary_listener(){}
+        /** Report the result of a run
+         *
+         * @param result result of the run
+         */
+        virtual void run_summarized(const batch_summary_result& result) = 0;
+    };
+
+    /** Get the number of worker threads used for a batch
+     *
+     * @param run_count number of runs in the batch
+     * @param options batch options
+     * @return number of runs loaded concurrently
+     */
+    size_t batch_worker_count(const size_t run_count, const batch_summary_options& options);
+    /** Load and summarize a batch of run folders
+     *
+     * The results are in the same order as the run folders, regardless of the order in which the runs finish. Every
+     * thread of the batch may load the InterOp files of any run in memory.
+     *
+     * @ingroup summary_logic
+     * @param run_folders list of run folders
+     * @param results destination results, one per run folder
+     * @param options batch options
+     * @param listener receives each result in order as soon as it is ready, may be null
+     */
+    void summarize_run_batch(const std::vector<std::string>& run_folders,
+                             batch_summary_result_vector& results,
+                             const batch_summary_options& options=batch_summary_options(),
+                             batch_summary_listener* listener=0);
+
+}}}}
+
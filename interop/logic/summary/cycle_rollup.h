@@ -0,0 +1,312 @@
+/** Prefix sums of a per-cycle metric value for each tile
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "interop/util/math.h"
+#include "interop/util/cstdint.h"
+#include "interop/util/exception.h"
+#include "interop/model/model_exceptions.h"
+#include "interop/logic/summary/summary_statistics.h"
+#include "interop/model/metrics/error_metric.h"
+#include "interop/model/metrics/extraction_metric.h"
+#include "interop/model/metrics/q_collapsed_metric.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4290) // MSVC warns that it ignores the exception specification.
+#endif
+
+namespace illumina { namespace interop { namespace logic { namespace summary
+{
+    /** Prefix sums of a per-cycle metric value for each tile
+     *
+     * The rollup is built with a single pass over a collection of metrics. Afterwards, the sum, the number of values
+     * and the number of records of a tile over any range of cycles takes constant time.
+     *
+     * A record whose value is NaN counts as a record, but not as a value.
+     */
+    class cycle_rollup
+    {
+    public:
+        /** Define an id type */
+        typedef ::uint32_t id_t;
+
+    private:
+        typedef ::uint64_t key_t;
+        typedef std::vector<key_t> key_vector_t;
+
+    public:
+        /** Constructor */
+        cycle_rollup() : m_cycle_count(0){}
+
+    public:
+        /** Build the prefix sums for a collection of metrics
+         *
+         * @param beg iterator to start of a collection of metrics
+         * @param end iterator to end of a collection of metrics
+         * @param cycle_count total number of cycles
+         * @param value functor that takes a metric and returns its value
+         */
+        template<typename I, typename Value>
+        void assign(I beg, I end, const size_t cycle_count, Value value) throw(model::index_out_of_bounds_exception)
+        {
+            clear();
+            m_cycle_count = cycle_count;
+            for(I it = beg;it != end;++it) m_tiles.push_back(key_of(it->lane(), it->tile()));
+            std::sort(m_tiles.begin(), m_tiles.end());
+            m_tiles.erase(std::unique(m_tiles.begin(), m_tiles.end()), m_tiles.end());
+
+            const size_t stride = m_cycle_count+1;
+            m_sums.assign(m_tiles.size()*stride, 0.0);
+            m_value_counts.assign(m_tiles.size()*stride, 0);
+            m_record_counts.assign(m_tiles.size()*stride, 0);
+            for(;beg != end;++beg)
+            {
+                const size_t cycle = beg->cycle();
+                if(cycle == 0 || cycle > m_cycle_count)
+                    INTEROP_THROW(model::index_out_of_bounds_exception,
+                                  "Cycle exceeds total cycles from Reads in the RunInfo.xml");
+                const size_t offset = index_of(beg->lane(), beg->tile())*stride+cycle;
+                m_record_counts[offset] += 1;
+                const double val = value(*beg);
+                if(std::isnan(val)) continue;
+                m_sums[offset] += val;
+                m_value_counts[offset] += 1;
+            }
+            for(size_t offset=1;offset<m_sums.size();++offset)
+            {
+                if(offset % stride == 0) continue;
+                m_sums[offset] += m_sums[offset-1];
+                m_value_counts[offset] += m_value_counts[offset-1];
+                m_record_counts[offset] += m_record_counts[offset-1];
+            }
+        }
+        /** Discard the prefix sums
+         */
+        void clear()
+        {
+            m_tiles.clear();
+            m_sums.clear();
+            m_value_counts.clear();
+            m_record_counts.clear();
+            m_cycle_count = 0;
+        }
+        /** Test if the rollup holds no tiles
+         *
+         * @return true if there are no tiles
+         */
+        bool empty()const
+        {
+            return m_tiles.empty();
+        }
+        /** Get the number of tiles
+         *
+         * @return number of tiles
+         */
+        size_t tile_count()const
+        {
+            return m_tiles.size();
+        }
+        /** Get the total number of cycles
+         *
+         * @return number of cycles
+         */
+        size_t cycle_count()const
+        {
+            return m_cycle_count;
+        }
+        /** Get the lane of a tile
+         *
+         * Tiles are ordered by lane, then by tile id.
+         *
+         * @param index index of the tile
+         * @return lane number
+         */
+        id_t lane(const size_t index)const
+        {
+            INTEROP_ASSERT(index < m_tiles.size());
+            return static_cast<id_t>(m_tiles[index] >> 32);
+        }
+        /** Get the id of a tile
+         *
+         * @param index index of the tile
+         * @return tile id
+         */
+        id_t tile(const size_t index)const
+        {
+            INTEROP_ASSERT(index < m_tiles.size());
+            return static_cast<id_t>(m_tiles[index] & 0xffffffff);
+        }
+        /** Find the index of a tile
+         *
+         * @param lane lane number
+         * @param tile tile id
+         * @return index of the tile, or tile_count() if not found
+         */
+        size_t index_of(const id_t lane, const id_t tile)const
+        {
+            const key_t key = key_of(lane, tile);
+            key_vector_t::const_iterator it = std::lower_bound(m_tiles.begin(), m_tiles.end(), key);
+            if(it == m_tiles.end() || *it != key) return m_tiles.size();
+            return static_cast<size_t>(std::distance(m_tiles.begin(), it));
+        }
+        /** Sum the values of a tile over a range of cycles
+         *
+         * @param index index of the tile
+         * @param first_cycle first cycle in the range (1-indexed)
+         * @param last_cycle last cycle in the range, inclusive
+         * @return sum of the values
+         */
+        double sum(const size_t index, const size_t first_cycle, const size_t last_cycle)const
+        {
+            return range_of(m_sums, index, first_cycle, last_cycle);
+        }
+        /** Count the values of a tile over a range of cycles
+         *
+         * @param index index of the tile
+         * @param first_cycle first cycle in the range (1-indexed)
+         * @param last_cycle last cycle in the range, inclusive
+         * @return number of values that are not NaN
+         */
+        size_t value_count(const size_t index, const size_t first_cycle, const size_t last_cycle)const
+        {
+            return range_of(m_value_counts, index, first_cycle, last_cycle);
+        }
+        /** Count the records of a tile over a range of cycles
+         *
+         * @param index index of the tile
+         * @param first_cycle first cycle in the range (1-indexed)
+         * @param last_cycle last cycle in the range, inclusive
+         * @return number of records
+         */
+        size_t record_count(const size_t index, const size_t first_cycle, const size_t last_cycle)const
+        {
+            return range_of(m_record_counts, index, first_cycle, last_cycle);
+        }
+        /** Average the values of a tile over a range of cycles
+         *
+         * @param index index of the tile
+         * @param first_cycle first cycle in the range (1-indexed)
+         * @param last_cycle last cycle in the range, inclusive
+         * @return average of the values, or NaN if there are none
+         */
+        float mean(const size_t index, const size_t first_cycle, const size_t last_cycle)const
+        {
+            return divide(static_cast<float>(sum(index, first_cycle, last_cycle)),
+                          static_cast<float>(value_count(index, first_cycle, last_cycle)));
+        }
+
+    private:
+        static key_t key_of(const size_t lane, const size_t tile)
+        {
+            return (static_cast<key_t>(lane) << 32) | static_cast<key_t>(tile);
+        }
+        template<typename T>
+        T range_of(const std::vector<T>& prefix, const size_t index, const size_t first_cycle, size_t last_cycle)const
+        {
+            INTEROP_ASSERT(index < m_tiles.size());
+            if(last_cycle > m_cycle_count) last_cycle = m_cycle_count;
+            if(first_cycle == 0 || first_cycle > last_cycle) return T(0);
+            const size_t offset = index*(m_cycle_count+1);
+            return prefix[offset+last_cycle] - prefix[offset+first_cycle-1];
+        }
+
+    private:
+        key_vector_t m_tiles;
+        std::vector<double> m_sums;
+        std::vector<size_t> m_value_counts;
+        std::vector<size_t> m_record_counts;
+        size_t m_cycle_count;
+    };
+
+    /** Get the error rate of an error metric
+     */
+    struct error_rate_value
+    {
+        /** Get the error rate
+         *
+         * @param metric error metric
+         * @return error rate
+         */
+        double operator()(const model::metrics::error_metric& metric)const
+        {
+            return metric.error_rate();
+        }
+    };
+    /** Get the number of calls above Q20 of a collapsed q-metric
+     */
+    struct q20_value
+    {
+        /** Get the number of calls above Q20
+         *
+         * @param metric collapsed q-metric
+         * @return number of calls above Q20
+         */
+        double operator()(const model::metrics::q_collapsed_metric& metric)const
+        {
+            return static_cast<double>(metric.q20());
+        }
+    };
+    /** Get the number of calls above Q30 of a collapsed q-metric
+     */
+    struct q30_value
+    {
+        /** Get the number of calls above Q30
+         *
+         * @param metric collapsed q-metric
+         * @return number of calls above Q30
+         */
+        double operator()(const model::metrics::q_collapsed_metric& metric)const
+        {
+            return static_cast<double>(metric.q30());
+        }
+    };
+    /** Get the total number of calls of a collapsed q-metric
+     */
+    struct total_call_value
+    {
+        /** Get the total number of calls
+         *
+         * @param metric collapsed q-metric
+         * @return total number of calls
+         */
+        double operator()(const model::metrics::q_collapsed_metric& metric)const
+        {
+            return static_cast<double>(metric.total());
+        }
+    };
+    /** Get the intensity of a single channel of an extraction metric
+     */
+    class intensity_value
+    {
+    public:
+        /** Constructor
+         *
+         * @param channel index of the channel
+         */
+        intensity_value(const size_t channel) : m_channel(channel){}
+        /** Get the intensity of the channel
+         *
+         * @param metric extraction metric
+         * @return intensity
+         */
+        double operator()(const model::metrics::extraction_metric& metric)const
+        {
+            return static_cast<double>(metric.max_intensity(m_channel));
+        }
+
+    private:
+        size_t m_channel;
+    };
+
+}}}}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
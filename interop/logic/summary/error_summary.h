@@ -13,6 +13,7 @@
 #include "interop/util/length_of.h"
 #include "interop/model/model_exceptions.h"
 #include "interop/logic/summary/summary_statistics.h"
+#include "interop/logic/summary/cycle_rollup.h"
 #include "interop/logic/summary/map_cycle_to_read.h"
 #include "interop/logic/summary/cycle_state_summary.h"
 #include "interop/model/metrics/error_metric.h"
@@ -22,119 +23,56 @@
 
 namespace illumina { namespace interop { namespace logic { namespace summary
 {
-    /** Cache data structure for error metrics
-     *
-     */
-     class error_cache_element
-     {
-     public:
-         /** Constructor */
-         error_cache_element() : m_error_sum(0.0f), m_error_count(0), m_max_cycle(0) {}
-         /** Update the cache element
-          *
-          * @param error_rate error rate
-          */
-         void update_error(const float error_rate)
-         {
-             if(std::isnan(error_rate)) return;
-             m_error_sum += error_rate;
-             m_error_count++;
-         }
-         /** Update the cache element
-          *
-          * @param cycle_within_read cycle within read
-          */
-         void update_cycle(const size_t cycle_within_read)
-         {
-             m_max_cycle = std::max(m_max_cycle, cycle_within_read);
-         }
-         /** Average error rate
-          *
-          * @return average
-          */
-         float average()const
-         {
-             return divide(m_error_sum, static_cast<float>(m_error_count));
-         }
-         /** Get the maximum cycle apart of the average
-          *
-          * @return maximum cycle
-          */
-         size_t max_cycle()const
-         {
-             return m_max_cycle;
-         }
-         /** Test if there are no error values
-          *
-          * @return true if no values have been averaged
-          */
-         bool is_empty()const
-         {
-             return m_error_count == 0;
-         }
-
-     private:
-         float m_error_sum;
-         size_t m_error_count;
-         size_t m_max_cycle;
-     };
-
     /** Cache errors for all tiles up to a give max cycle
      *
-     * This function only includes errors from useable cycles (not the last cycle) to up the given max cycle.
+     * This function only includes errors from useable cycles (not the last cycle) to up the given max cycle. Each
+     * tile-read average is taken from the prefix sums of the rollup, so it does not depend on the number of cycles.
      *
-     * @param beg iterator to start of a collection of error metrics
-     * @param end iterator to end of a collection of error metrics
+     * @param rollup prefix sums of the error rate over cycles for each tile
      * @param max_cycle maximum cycle to take
      * @param cycle_to_read map that takes a cycle and returns the read-number cycle-in-read pair
      * @param naming_method tile naming convention
      * @param read_lane_cache destination cache by read then by lane a collection of errors
      * @param read_lane_surface_cache source cache by read then by lane then by surface a collection of errors
      */
-    template<typename I>
-    void cache_error_by_lane_read(I beg,
-                                  I end,
-                                  const size_t max_cycle,
-                                  const std::vector<read_cycle> &cycle_to_read,
-                                  const constants::tile_naming_method naming_method,
-                                  summary_by_lane_read<float> &read_lane_cache,
-                                  summary_by_lane_read<float> &read_lane_surface_cache)
+    inline void cache_error_by_lane_read(const cycle_rollup& rollup,
+                                         const size_t max_cycle,
+                                         const std::vector<read_cycle> &cycle_to_read,
+                                         const constants::tile_naming_method naming_method,
+                                         summary_by_lane_read<float> &read_lane_cache,
+                                         summary_by_lane_read<float> &read_lane_surface_cache)
     throw(model::index_out_of_bounds_exception)
     {
-        typedef std::pair<size_t, size_t> key_t;
-        typedef INTEROP_ORDERED_MAP(key_t, error_cache_element) error_tile_t;
-        typedef std::vector<error_tile_t> error_by_read_tile_t;
-        error_by_read_tile_t tmp(read_lane_cache.size());
-        for (; beg != end; ++beg)
+        std::vector<size_t> first_cycle(read_lane_cache.read_count(), 0);
+        std::vector<size_t> last_cycle(read_lane_cache.read_count(), 0);
+        for(size_t cycle=0;cycle<cycle_to_read.size();++cycle)
         {
-            INTEROP_ASSERT(beg->cycle() > 0);
-            INTEROP_ASSERT((beg->cycle() - 1) < cycle_to_read.size());
-            if ((beg->cycle() - 1) >= cycle_to_read.size())
-                INTEROP_THROW(model::index_out_of_bounds_exception, "Cycle exceeds total cycles from Reads in the RunInfo.xml");
-            const read_cycle &read = cycle_to_read[beg->cycle() - 1];
-            const key_t key = std::make_pair(beg->lane(), beg->tile());
-            const size_t read_number = read.number - 1;
-            INTEROP_ASSERTMSG(read_number < tmp.size(),
-                              read.number << " " << read.cycle_within_read << ", " << beg->cycle());
-            tmp[read_number][key].update_cycle(read.cycle_within_read);
-            if (read.cycle_within_read > max_cycle || read.is_last_cycle_in_read) continue;
-            tmp[read_number][key].update_error(beg->error_rate());
+            const size_t read_number = cycle_to_read[cycle].number - 1;
+            INTEROP_ASSERTMSG(read_number < first_cycle.size(), cycle_to_read[cycle].number << ", " << cycle+1);
+            if(read_number >= first_cycle.size()) continue;
+            if(first_cycle[read_number] == 0) first_cycle[read_number] = cycle+1;
+            last_cycle[read_number] = cycle+1;
         }
-        for (size_t read = 0; read < tmp.size(); ++read)
+        for (size_t read = 0; read < first_cycle.size(); ++read)
         {
-            for (typename error_tile_t::const_iterator ebeg = tmp[read].begin(), eend = tmp[read].end();
-                 ebeg != eend; ++ebeg)
+            if(first_cycle[read] == 0) continue;
+            const size_t first = first_cycle[read];
+            const size_t last = last_cycle[read];
+            // The last cycle of a read is not useable
+            const size_t useable_cycles = std::min(max_cycle, last-first);
+            for(size_t index=0;index<rollup.tile_count();++index)
             {
-                INTEROP_ASSERT(read < read_lane_cache.read_count());
-                const size_t lane = ebeg->first.first - 1;
+                if(rollup.record_count(index, first, last) == 0) continue;
+                const size_t lane = rollup.lane(index) - 1;
                 if (lane >= read_lane_cache.lane_count())
                     INTEROP_THROW(model::index_out_of_bounds_exception, "Lane exceeds number of lanes in RunInfo.xml");
-                if(max_cycle < std::numeric_limits<size_t>::max() && ebeg->second.max_cycle() < max_cycle) continue;
-                if(ebeg->second.is_empty()) continue;
-                const float err_avg = ebeg->second.average();
+                if(max_cycle < std::numeric_limits<size_t>::max() &&
+                   (max_cycle > last-first+1 || rollup.record_count(index, first+max_cycle-1, last) == 0)) continue;
+                if(useable_cycles == 0 || rollup.value_count(index, first, first+useable_cycles-1) == 0) continue;
+                const float err_avg = rollup.mean(index, first, first+useable_cycles-1);
                 read_lane_cache(read, lane).push_back(err_avg);
                 if(read_lane_surface_cache.surface_count() < 2) continue;
-                const ::uint32_t surface = logic::metric::surface(static_cast< ::uint32_t >(ebeg->first.second), naming_method);
+                const ::uint32_t surface = logic::metric::surface(rollup.tile(index), naming_method);
                 INTEROP_ASSERT(surface <= read_lane_surface_cache.surface_count());
                 INTEROP_ASSERT(surface > 0);
                 read_lane_surface_cache(read, lane, surface-1).push_back(err_avg);
@@ -198,30 +136,28 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      *
      * @todo: Refactor this to make simpler
      *
-     * @param beg iterator to start of a collection of error metrics
-     * @param end iterator to end of a collection of error metrics
+     * @param rollup prefix sums of the error rate over cycles for each tile
      * @param cycle_to_read map cycle to the read number and cycle within read number
      * @param naming_method tile naming convention
      * @param run destination run summary
      * @param skip_median skip the median calculation
      */
-    template<typename I>
-    void summarize_error_metrics(I beg,
-                                 I end,
-                                 const read_cycle_vector_t &cycle_to_read,
-                                 const constants::tile_naming_method naming_method,
-                                 model::summary::run_summary &run,
-                                 const bool skip_median=false) throw(model::index_out_of_bounds_exception)
+    inline void summarize_error_metrics(const cycle_rollup& rollup,
+                                        const read_cycle_vector_t &cycle_to_read,
+                                        const constants::tile_naming_method naming_method,
+                                        model::summary::run_summary &run,
+                                        const bool skip_median=false) throw(model::index_out_of_bounds_exception)
     {
         typedef summary_by_lane_read<float> summary_by_lane_read_t;
         typedef void (model::summary::stat_summary::*error_functor_t )(const model::summary::metric_stat&);
         typedef std::pair<size_t, error_functor_t> cycle_functor_pair_t;
 
-        if (beg == end) return;
+        if (rollup.empty()) return;
         if (run.size() == 0) return;
         const size_t surface_count = run.surface_count();
-        summary_by_lane_read_t read_lane_cache(run, std::distance(beg, end));
-        summary_by_lane_read_t read_lane_surface_cache(run, std::distance(beg, end), surface_count);
+        const ptrdiff_t tile_count = static_cast<ptrdiff_t>(rollup.tile_count());
+        summary_by_lane_read_t read_lane_cache(run, tile_count);
+        summary_by_lane_read_t read_lane_surface_cache(run, tile_count, surface_count);
 
         cycle_functor_pair_t cycle_functor_pairs[] = {
                 cycle_functor_pair_t(35u, &model::summary::stat_summary::error_rate_35),
@@ -231,8 +167,7 @@ namespace illumina { namespace interop { namespace logic { namespace summary
         };
         for (size_t i = 0; i < util::length_of(cycle_functor_pairs); ++i)
         {
-            cache_error_by_lane_read(beg,
-                                     end,
+            cache_error_by_lane_read(rollup,
                                      cycle_functor_pairs[i].first,
                                      cycle_to_read,
                                      naming_method,
@@ -248,8 +183,7 @@ namespace illumina { namespace interop { namespace logic { namespace summary
         }
 
 
-        cache_error_by_lane_read(beg,
-                                 end,
+        cache_error_by_lane_read(rollup,
                                  std::numeric_limits<size_t>::max(),
                                  cycle_to_read,
                                  naming_method,
@@ -305,5 +239,31 @@ namespace illumina { namespace interop { namespace logic { namespace summary
         run.total_summary().error_rate(divide(error_rate, static_cast<float>(total)));
     }
 
+    /** Summarize a collection error metrics
+     *
+     * This builds the prefix sums of the error rate once, then summarizes each cycle window from them.
+     *
+     * @param beg iterator to start of a collection of error metrics
+     * @param end iterator to end of a collection of error metrics
+     * @param cycle_to_read map cycle to the read number and cycle within read number
+     * @param naming_method tile naming convention
+     * @param run destination run summary
+     * @param skip_median skip the median calculation
+     */
+    template<typename I>
+    void summarize_error_metrics(I beg,
+                                 I end,
+                                 const read_cycle_vector_t &cycle_to_read,
+                                 const constants::tile_naming_method naming_method,
+                                 model::summary::run_summary &run,
+                                 const bool skip_median=false) throw(model::index_out_of_bounds_exception)
+    {
+        if (beg == end) return;
+        if (run.size() == 0) return;
+        cycle_rollup rollup;
+        rollup.assign(beg, end, cycle_to_read.size(), error_rate_value());
+        summarize_error_metrics(rollup, cycle_to_read, naming_method, run, skip_median);
+    }
+
 }}}}
 
@@ -32,11 +32,13 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      * @param tile_metrics source collection of tile metrics
      * @param lane_count number of lanes
      * @param summary destination index flowcell summary
+     * @param thread_count number of threads used to summarize lanes
      */
     void summarize_index_metrics(const model::metric_base::metric_set<model::metrics::index_metric>& index_metrics,
                                         const model::metric_base::metric_set<model::metrics::tile_metric>& tile_metrics,
                                         const size_t lane_count,
-                                        model::summary::index_flowcell_summary &summary)
+                                        model::summary::index_flowcell_summary &summary,
+                                        const size_t thread_count=1)
                                         throw(model::index_out_of_bounds_exception);
 
     /** Summarize index metrics from run metrics
@@ -44,9 +46,11 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      * @ingroup summary_logic
      * @param metrics source collection of all metrics
      * @param summary destination index flowcell summary
+     * @param thread_count number of threads used to summarize lanes
      */
     void summarize_index_metrics(const model::metrics::run_metrics &metrics,
-                                        model::summary::index_flowcell_summary &summary)
+                                        model::summary::index_flowcell_summary &summary,
+                                        const size_t thread_count=1)
                                             throw(model::index_out_of_bounds_exception);
 }}}}
 
@@ -15,23 +15,49 @@
 namespace illumina { namespace interop { namespace logic { namespace summary
 {
 
+    /** Summarize a collection run metrics
+     *
+     * The run is not modified, so a frozen run may be summarized from several threads at once. Derived metric sets
+     * missing from the run are derived into temporaries.
+     *
+     * @ingroup summary_logic
+     * @param metrics source collection of all metrics
+     * @param summary destination run summary
+     * @param skip_median skip the median calculation
+     * @param trim flag indicating whether to trim the summary model (default: true)
+     * @param progress progress token updated and checked after each metric set, may be null
+     */
+    void summarize_run_metrics(const model::metrics::run_metrics& metrics,
+                               model::summary::run_summary& summary,
+                               const bool skip_median=false,
+                               const bool trim=true,
+                               util::progress_token* progress=0)
+    throw( model::index_out_of_bounds_exception,
+    model::invalid_channel_exception,
+    model::invalid_run_info_exception,
+    util::operation_cancelled_exception );
     /** Summarize a collection run metrics
      *
      * TODO speed up calculation by adding no_median flag
      *
+     * Collapsed q-metrics and dynamic phasing metrics missing from the run are derived into the run.
+     *
      * @ingroup summary_logic
      * @param metrics source collection of all metrics
      * @param summary destination run summary
      * @param skip_median skip the median calculation
      * @param trim flag indicating whether to trim the summary model (default: true)
+     * @param progress progress token updated and checked after each metric set, may be null
      */
     void summarize_run_metrics(model::metrics::run_metrics& metrics,
                                model::summary::run_summary& summary,
                                const bool skip_median=false,
-                               const bool trim=true)
+                               const bool trim=true,
+                               util::progress_token* progress=0)
     throw( model::index_out_of_bounds_exception,
     model::invalid_channel_exception,
-    model::invalid_run_info_exception );
+    model::invalid_run_info_exception,
+    util::operation_cancelled_exception );
 
 
 }}}}
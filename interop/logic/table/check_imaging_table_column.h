@@ -9,6 +9,7 @@
 #include <vector>
 #include "interop/util/exception.h"
 #include "interop/util/constant_mapping.h"
+#include "interop/util/fixed_vector.h"
 #include "interop/constants/enums.h"
 #include "interop/logic/utils/enums.h"
 #include "interop/model/run_metrics.h"
@@ -211,6 +212,17 @@ namespace illumina { namespace interop { namespace logic { namespace table
         {
             return !values.empty();
         }
+
+        /** Test if a metric type is valid
+         *
+         * @param values fixed capacity vector of values
+         * @return true if not empty
+         */
+        template<typename T, size_t N>
+        static bool is_valid(const util::fixed_vector<T, N> &values)
+        {
+            return !values.empty();
+        }
     };
 }}}}
 
@@ -44,12 +44,29 @@ namespace illumina { namespace interop { namespace logic { namespace table
      */
     size_t count_table_columns(const std::vector<model::table::imaging_column>& columns);
     /** Create an imaging table from run metrics
+     *
+     * The run is not modified, so tables of a frozen run may be created from several threads at once.
+     *
+     * @param metrics source run metrics
+     * @param table destination imaging table
+     * @param progress progress token updated and checked between chunks of records, may be null
+     */
+    void create_imaging_table(const model::metrics::run_metrics& metrics,
+                              model::table::imaging_table& table,
+                              util::progress_token* progress=0)
+    throw(model::invalid_column_type, model::index_out_of_bounds_exception, util::operation_cancelled_exception);
+    /** Create an imaging table from run metrics
+     *
+     * Dynamic phasing metrics missing from the run are derived into the run.
      *
      * @param metrics source run metrics
      * @param table destination imaging table
+     * @param progress progress token updated and checked between chunks of records, may be null
      */
-    void create_imaging_table(model::metrics::run_metrics& metrics, model::table::imaging_table& table)
-    throw(model::invalid_column_type, model::index_out_of_bounds_exception);
+    void create_imaging_table(model::metrics::run_metrics& metrics,
+                              model::table::imaging_table& table,
+                              util::progress_token* progress=0)
+    throw(model::invalid_column_type, model::index_out_of_bounds_exception, util::operation_cancelled_exception);
 
     /** List the required on demand metrics
      *
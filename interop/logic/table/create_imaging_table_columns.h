@@ -43,7 +43,26 @@ namespace illumina { namespace interop { namespace logic { namespace table
      */
     void populate_column_offsets(std::vector<model::table::imaging_column>& columns)
     throw(model::invalid_column_type);
+    /** Derive the dynamic phasing metrics of the run, if they are missing
+     *
+     * @param metrics run metrics
+     */
+    void populate_dynamic_phasing_if_missing(model::metrics::run_metrics& metrics);
     /** Create a vector of column descriptors
+     *
+     * The run is not modified, so the columns of a frozen run may be created from several threads at once.
+     *
+     * @param metrics source collection of InterOp metrics from the run
+     * @param columns destination vector of column descriptors
+     */
+    void create_imaging_table_columns(const model::metrics::run_metrics& metrics,
+                                      std::vector< model::table::imaging_column >& columns)
+    throw(model::invalid_column_type,
+    model::index_out_of_bounds_exception,
+    model::invalid_channel_exception);
+    /** Create a vector of column descriptors
+     *
+     * Dynamic phasing metrics missing from the run are derived into the run.
      *
      * @param metrics source collection of InterOp metrics from the run
      * @param columns destination vector of column descriptors
@@ -9,6 +9,7 @@
 #include <vector>
 #include "interop/util/exception.h"
 #include "interop/util/constant_mapping.h"
+#include "interop/util/fixed_vector.h"
 #include "interop/constants/enums.h"
 #include "interop/model/run_metrics.h"
 #include "interop/model/model_exceptions.h"
@@ -218,6 +219,27 @@ namespace illumina { namespace interop { namespace logic { namespace table
             }
         }
 
+        /** Assign a value to an iterator
+         *
+         * @param destination iterator to desination collection
+         * @param end iterator to end of destination collection
+         * @param source  value to assign
+         * @param num_digits number of digits after the decimal
+         */
+        template<typename OutputIterator, typename U, size_t N>
+        static void copy_to(OutputIterator destination,
+                            OutputIterator end,
+                            const util::fixed_vector<U, N> &source,
+                            const size_t num_digits)
+        {
+            (void) end;
+            for (typename util::fixed_vector<U, N>::const_iterator it = source.begin(); it != source.end(); ++it, ++destination)
+            {
+                INTEROP_ASSERT(destination < end);
+                assign(*destination, *it, num_digits);
+            }
+        }
+
         /** Test if a metric type is valid
          *
          * @param val floating point value
@@ -249,6 +271,17 @@ namespace illumina { namespace interop { namespace logic { namespace table
         {
             return !values.empty();
         }
+
+        /** Test if a metric type is valid
+         *
+         * @param values fixed capacity vector of values
+         * @return true if not empty
+         */
+        template<typename T, size_t N>
+        static bool is_valid(const util::fixed_vector<T, N> &values)
+        {
+            return !values.empty();
+        }
     };
 }}}}
 
@@ -16,9 +16,15 @@
 #include "interop/util/exception.h"
 #include "interop/model/metric_base/base_cycle_metric.h"
 #include "interop/model/metric_base/base_read_metric.h"
+#include "interop/model/metric_base/metric_view.h"
 #include "interop/model/model_exceptions.h"
 #include "interop/util/lexical_cast.h"
 #include "interop/util/assert.h"
+#include "interop/util/radix_sort.h"
+#include "interop/util/thread_pool.h"
+#ifdef INTEROP_HAS_STD_THREAD
+#   include <mutex>
+#endif
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -27,10 +33,26 @@
 
 namespace illumina { namespace interop { namespace model { namespace metric_base
 {
+#ifdef INTEROP_HAS_STD_THREAD
+    /** Get the lock guarding the lane and cycle partitions of every metric set
+     *
+     * @return lock for the partitions
+     */
+    inline std::mutex& metric_set_partition_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+#endif
 
     /** Metric set holds a collection metrics
      *
      * This class holds a map that maps a unique id to the metric.
+     *
+     * The lane and cycle views are built on first use, and may be requested from several threads at once. They are
+     * discarded by any change that adds, removes or reorders metrics. Changing the lane or cycle of a metric in place,
+     * through a non-const accessor such as operator[], at_unchecked, begin or get_metric_ref, does not discard them;
+     * call invalidate_views after such a change.
      */
     template<typename T>
     class metric_set : public T::header_type
@@ -59,6 +81,10 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         typedef typename metric_array_t::size_type size_type;
         /** Define a set of ids */
         typedef std::set<uint_t> id_set_t; // TODO: Do the same for set
+        /** Define a view of metrics */
+        typedef metric_view<T> view_t;
+        /** Define a range of metrics */
+        typedef std::pair<typename metric_array_t::const_iterator, typename metric_array_t::const_iterator> const_range_t;
         /** Define offset map */
 #if defined(__cplusplus) && __cplusplus < 201103L // Workaround for SWIG not understanding the macro
         typedef std::map<id_t, size_t> offset_map_t;
@@ -85,7 +111,7 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          * @param version version of the file format
          */
         metric_set(const ::int16_t version )
-                : header_type(header_type::default_header()), m_version(version), m_data_source_exists(false)
+                : header_type(header_type::default_header()), m_version(version), m_data_source_exists(false), m_sorted(true)
         { }
         /** Constructor
          *
@@ -93,7 +119,7 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          * @param version version of the file format
          */
         metric_set(const header_type &header = header_type::default_header(), const ::int16_t version = 0)
-                : header_type(header), m_version(version), m_data_source_exists(false)
+                : header_type(header), m_version(version), m_data_source_exists(false), m_sorted(true)
         { }
 
         /** Constructor
@@ -106,7 +132,8 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
                 header_type(header),
                 m_data(vec),
                 m_version(version),
-                m_data_source_exists(false)
+                m_data_source_exists(false),
+                m_sorted(true)
         {
             rebuild_index(true);
         }
@@ -165,27 +192,80 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         }
 
     public:
-        /** Rebuild the index map and update the cycle state
+        /** Rebuild the index map and update the cycle and sorted state
          */
         void rebuild_index(const bool update_ids=false)
         {
             size_t offset = 0;
+            id_t last_id = 0;
+            m_sorted = true;
+            invalidate_views();
             for (const_iterator b = begin(), e = end(); b != e; ++b)
             {
+                const id_t id = b->id();
                 if(update_ids)
                 {
-                    m_id_map[b->id()] = offset;
+                    m_id_map[id] = offset;
                     ++offset;
                 }
+                if(id < last_id) m_sorted = false;
+                last_id = id;
                 T::header_type::update_max_cycle(*b);
             }
         }
+        /** Sort the metrics by id and rebuild the index map
+         *
+         * The ids are sorted with a radix sort, then the metrics are swapped into place without copying the set. Sets
+         * that are already sorted only rebuild the index map.
+         *
+         * @param thread_count number of threads used to sort large sets
+         */
+        void sort(const size_t thread_count=1)
+        {
+            m_id_map.clear();
+            invalidate_views();
+            if(m_sorted)
+            {
+                for(size_t i=0;i<m_data.size();++i) m_id_map[m_data[i].id()] = i;
+                return;
+            }
+            util::radix_key_vector_t keys(m_data.size());
+            for(size_t i=0;i<m_data.size();++i) keys[i] = util::radix_key_t(m_data[i].id(), i);
+            util::radix_sort(keys, thread_count);
+            for(size_t i=0;i<keys.size();++i) m_id_map[keys[i].first] = i;
+            // Follow each cycle of the permutation, swapping every metric into place; a visited slot points to itself
+            for(size_t i=0;i<keys.size();++i)
+            {
+                for(size_t j=i;;)
+                {
+                    const size_t source = keys[j].second;
+                    keys[j].second = j;
+                    if(source == i) break;
+                    std::swap(m_data[j], m_data[source]);
+                    j = source;
+                }
+            }
+            m_sorted = true;
+        }
+        /** Test if the metrics are ordered by id
+         *
+         * This is tracked on insert and recomputed by `rebuild_index` and `sort`. Metrics modified in place are not
+         * tracked.
+         *
+         * @return true if the metrics are ordered by id
+         */
+        bool is_sorted()const
+        {
+            return m_sorted;
+        }
         /** Resize the number of places in the metric vector
          *
          * @param n expected number of elements
          */
         void resize(const size_t n)
         {
+            if(n > m_data.size()) m_sorted = false;
+            invalidate_views();
             m_data.resize(n, metric_type(*this));
         }
         /** Reserve the number of places in the metric vector
@@ -196,12 +276,21 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         {
             m_data.reserve(n);
         }
+        /** Get the number of places reserved in the metric vector
+         *
+         * @return number of elements that fit without reallocating
+         */
+        size_t capacity()const
+        {
+            return m_data.capacity();
+        }
         /** Trim the set to the proper number of metrics
          *
          * @param n actual size of the metric set
          */
         void trim(const size_t n)
         {
+            invalidate_views();
             m_data.resize(n);
         }
         /** Find index of metric given the id. If not found, return number of metrics
@@ -248,6 +337,27 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             return m_id_map.find(id) != m_id_map.end();
         }
 
+        /** Get the range of metrics for a lane
+         *
+         * @param lane lane number
+         * @return range of metrics for the lane
+         */
+        const_range_t lane_range(const uint_t lane) const throw(model::invalid_parameter)
+        {
+            return id_range(base_metric::create_id(lane, 0), base_metric::create_id(static_cast<id_t>(lane)+1, 0));
+        }
+
+        /** Get the range of metrics for a tile
+         *
+         * @param lane lane number
+         * @param tile tile number
+         * @return range of metrics for the tile
+         */
+        const_range_t tile_range(const uint_t lane, const uint_t tile) const throw(model::invalid_parameter)
+        {
+            return id_range(base_metric::create_id(lane, tile), base_metric::create_id(lane, static_cast<id_t>(tile)+1));
+        }
+
         /** Add a metric to the metric set
          *
          * @param metric metric to add to set
@@ -269,6 +379,8 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             m_id_map[id] = size();
 
             T::header_type::update_max_cycle(metric);
+            if(!m_data.empty() && metric.id() < m_data.back().id()) m_sorted = false;
+            invalidate_views();
             m_data.push_back(metric);
         }
 
@@ -284,19 +396,15 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         const metric_type &get_metric(const uint_t lane, const uint_t tile,
                                       const uint_t cycle = 0) const throw(model::index_out_of_bounds_exception)
         {
-            try
-            {
-                return get_metric(metric_type::create_id(lane, tile, cycle));
-            }
-            catch (const index_out_of_bounds_exception &)
-            {
+            const metric_type* metric = try_get(lane, tile, cycle);
+            if (metric == 0)
                 INTEROP_THROW( index_out_of_bounds_exception, "No tile available: key: " <<
                                        metric_type::create_id(lane, tile, cycle) <<
                                                     " map: " << (m_id_map.size()) <<
                                                     "  lane: " << (lane) <<
                                                     "  tile: " << (tile) <<
                                                     "  cycle: " << (cycle));
-            }
+            return *metric;
         }
 
         /** Get metric for a unique identifier
@@ -317,6 +425,82 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             return m_data[it->second];
         }
 
+        /** Get metric for lane, tile and cycle, if it is in the set
+         *
+         * @param lane lane
+         * @param tile tile
+         * @param cycle cycle
+         * @return pointer to the metric, or null if the set has no such metric
+         */
+        const metric_type* try_get(const uint_t lane, const uint_t tile, const uint_t cycle = 0) const
+        {
+            return try_get(metric_type::create_id(lane, tile, cycle));
+        }
+
+        /** Get metric for a unique identifier, if it is in the set
+         *
+         * @param key unique id built from lane, tile and cycle (if available)
+         * @return pointer to the metric, or null if the set has no such metric
+         */
+        const metric_type* try_get(const id_t key) const
+        {
+            typename offset_map_t::const_iterator it = m_id_map.find(key);
+            if (it == m_id_map.end()) return 0;
+            INTEROP_ASSERT(it->second < m_data.size());
+            return &m_data[it->second];
+        }
+
+        /** Get metric for lane, tile and cycle, if it is in the set
+         *
+         * @param lane lane
+         * @param tile tile
+         * @param cycle cycle
+         * @return pointer to the metric, or null if the set has no such metric
+         */
+        metric_type* try_get(const uint_t lane, const uint_t tile, const uint_t cycle = 0)
+        {
+            return try_get(metric_type::create_id(lane, tile, cycle));
+        }
+
+        /** Get metric for a unique identifier, if it is in the set
+         *
+         * @param key unique id built from lane, tile and cycle (if available)
+         * @return pointer to the metric, or null if the set has no such metric
+         */
+        metric_type* try_get(const id_t key)
+        {
+            typename offset_map_t::const_iterator it = m_id_map.find(key);
+            if (it == m_id_map.end()) return 0;
+            INTEROP_ASSERT(it->second < m_data.size());
+            return &m_data[it->second];
+        }
+
+        /** Get a metric at the given index without checking the bounds
+         *
+         * The index must be less than size(), such as an index returned by find() and tested against size().
+         *
+         * @param n index
+         * @return metric
+         */
+        metric_type &at_unchecked(const size_t n)
+        {
+            INTEROP_ASSERT(n < m_data.size());
+            return m_data[n];
+        }
+
+        /** Get a metric at the given index without checking the bounds
+         *
+         * The index must be less than size(), such as an index returned by find() and tested against size().
+         *
+         * @param n index
+         * @return metric
+         */
+        const metric_type &at_unchecked(const size_t n)const
+        {
+            INTEROP_ASSERT(n < m_data.size());
+            return m_data[n];
+        }
+
         /** Get a metric at the given index
          *
          * @param n index
@@ -394,9 +578,8 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         id_vector lanes() const
         {
-            id_set_t id_set;
-            std::transform(begin(), end(), std::inserter(id_set, id_set.begin()), to_lane);
-            return id_vector(id_set.begin(), id_set.end());
+            const metric_partition::key_vector_t keys = lane_partition().keys();
+            return id_vector(keys.begin(), keys.end());
         }
 
         /** Get the number of lanes in the data
@@ -441,11 +624,8 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         void populate_tile_numbers_for_lane(id_set_t& tile_number_set, const uint_t lane) const
         {
-            transform_if(begin(),
-                         end(),
-                         std::inserter(tile_number_set, tile_number_set.begin()),
-                         lane_equals(lane),
-                         to_tile);
+            const view_t view = lane_view(lane);
+            transform(view.begin(), view.end(), std::inserter(tile_number_set, tile_number_set.begin()), to_tile);
         }
         /** Get a list of all available tile numbers for the specified lane
          *
@@ -461,8 +641,9 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
                                                     const uint_t surface,
                                                     const constants::tile_naming_method naming_convention) const
         {
-            transform_if(begin(),
-                         end(),
+            const view_t view = lane_view(lane);
+            transform_if(view.begin(),
+                         view.end(),
                          std::inserter(tile_number_set, tile_number_set.begin()),
                          lane_surface_equals(lane, surface, naming_convention),
                          to_tile);
@@ -502,12 +683,47 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         void metrics_for_lane(metric_array_t& lane_metrics, const uint_t lane) const
         {
-            lane_metrics.reserve(size());
-            copy_if(begin(),
-                    end(),
-                    std::back_inserter(lane_metrics),
-                    lane_equals(lane));
-            metric_array_t(lane_metrics).swap(lane_metrics); // Shrink to fit
+            const view_t view = lane_view(lane);
+            lane_metrics.reserve(lane_metrics.size()+view.size());
+            lane_metrics.insert(lane_metrics.end(), view.begin(), view.end());
+        }
+
+        /** Discard the lane and cycle views, so they are rebuilt on next use
+         *
+         * This must be called after the lane or cycle of a metric is changed in place. Like any other change, it
+         * must not run concurrently with a query of the metric set.
+         */
+        void invalidate_views()
+        {
+            m_lane_partition.clear();
+            m_cycle_partition.clear();
+        }
+
+        /** Get a view of the metrics for the specified lane
+         *
+         * The view does not copy the metrics, and is invalidated by any change to the metric set.
+         *
+         * @param lane lane number
+         * @return view of the metrics in the lane
+         */
+        view_t lane_view(const uint_t lane) const
+        {
+            const metric_partition& partition = lane_partition();
+            return view_t(&m_data, partition.offsets(lane), partition.count(lane));
+        }
+
+        /** Get a view of the metrics for the specified cycle
+         *
+         * The view does not copy the metrics, and is invalidated by any change to the metric set.
+         *
+         * @note Returns an empty view for metrics that do not have a cycle identifier
+         * @param cycle cycle number
+         * @return view of the metrics in the cycle
+         */
+        view_t cycle_view(const uint_t cycle) const
+        {
+            const metric_partition& partition = cycle_partition();
+            return view_t(&m_data, partition.offsets(cycle), partition.count(cycle));
         }
 
         /** Get a list of all cycles listed in the metric set
@@ -517,9 +733,8 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
          */
         id_vector cycles() const
         {
-            id_set_t cycle_set;
-            cycles(cycle_set);
-            return id_vector(cycle_set.begin(), cycle_set.end());
+            const metric_partition::key_vector_t keys = cycle_partition().keys();
+            return id_vector(keys.begin(), keys.end());
         }
 
         /** Get a list of all available metrics for the specified cycle
@@ -568,6 +783,16 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             m_data.clear();
             m_version=0;
             m_data_source_exists=false;
+            m_sorted=true;
+            invalidate_views();
+        }
+        /** Clear the metrics and release the memory that held them
+         */
+        void release()
+        {
+            clear();
+            metric_array_t().swap(m_data);
+            offset_map_t().swap(m_id_map);
         }
 
         /** Get the metrics in a vector
@@ -606,20 +831,15 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         metric_type &get_metric_ref(uint_t lane, uint_t tile,
                                     uint_t cycle = 0) throw(model::index_out_of_bounds_exception)
         {
-            try
-            {
-                return get_metric_ref(metric_type::create_id(lane, tile, cycle));
-            }
-            catch (const index_out_of_bounds_exception &)
-            {
+            metric_type* metric = try_get(lane, tile, cycle);
+            if (metric == 0)
                 INTEROP_THROW( index_out_of_bounds_exception,"No tile available: key: " <<
                                                     metric_type::create_id(lane, tile, cycle) <<
                                                     " map: " <<(m_id_map.size()) <<
                                                     "  lane: " << (lane) <<
                                                     "  tile: " << (tile) <<
                                                     "  cycle: " << (cycle));
-
-            }
+            return *metric;
         }
 
         /** Get metric for a unique identifier
@@ -648,18 +868,21 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         {
             return m_id_map;
         }
+        /** Build the lane and cycle views of the set
+         *
+         * The views are otherwise built on first use. Once built, the const queries of the set only read it.
+         */
+        void build_views() const
+        {
+            lane_partition();
+            cycle_partition();
+        }
 
     private:
         metric_array_t metrics_for_cycle(const uint_t cycle, const constants::base_cycle_t*) const
         {
-            metric_array_t cycle_metrics;
-            cycle_metrics.reserve(size());
-            copy_if(begin(),
-                    end(),
-                    std::back_inserter(cycle_metrics),
-                    cycle_equals(cycle));
-            metric_array_t(cycle_metrics).swap(cycle_metrics); // Shrink to fit
-            return cycle_metrics;
+            const view_t view = cycle_view(cycle);
+            return metric_array_t(view.begin(), view.end());
         }
 
         metric_array_t metrics_for_cycle(const uint_t, const void *) const
@@ -669,6 +892,20 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
 
 
     private:
+        const_range_t id_range(const id_t first_id, const id_t last_id) const throw(model::invalid_parameter)
+        {
+            if(!m_sorted) INTEROP_THROW(model::invalid_parameter, "Range requires metrics sorted by id");
+            const const_iterator first = std::lower_bound(begin(), end(), first_id, id_less);
+            // The id of the next lane wraps to zero past the last lane
+            if(last_id <= first_id) return const_range_t(first, end());
+            return const_range_t(first, std::lower_bound(first, end(), last_id, id_less));
+        }
+
+        static bool id_less(const metric_type &metric, const id_t id)
+        {
+            return metric.id() < id;
+        }
+
         static id_t to_id(const metric_type &metric)
         {
             return metric.id();
@@ -684,17 +921,45 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             return metric.tile();
         }
 
-        void cycles(id_set_t& cycles_set) const
+        const metric_partition& lane_partition() const
         {
-            cycles(cycles_set, base_t::null());
+#if defined(INTEROP_HAS_STD_THREAD)
+            std::lock_guard<std::mutex> lock(metric_set_partition_mutex());
+#elif defined(_OPENMP)
+#           pragma omp critical(metric_set_partition)
+#endif
+            if(!m_lane_partition.is_built())
+            {
+                metric_partition::key_vector_t keys(m_data.size());
+                std::transform(begin(), end(), keys.begin(), to_lane);
+                m_lane_partition.assign(keys);
+            }
+            return m_lane_partition;
+        }
+
+        const metric_partition& cycle_partition() const
+        {
+#if defined(INTEROP_HAS_STD_THREAD)
+            std::lock_guard<std::mutex> lock(metric_set_partition_mutex());
+#elif defined(_OPENMP)
+#           pragma omp critical(metric_set_partition)
+#endif
+            if(!m_cycle_partition.is_built())
+            {
+                metric_partition::key_vector_t keys;
+                cycle_keys(keys, base_t::null());
+                m_cycle_partition.assign(keys);
+            }
+            return m_cycle_partition;
         }
 
-        void cycles(id_set_t& cycles_set, const constants::base_cycle_t*) const
+        void cycle_keys(metric_partition::key_vector_t& keys, const constants::base_cycle_t*) const
         {
-            std::transform(begin(), end(), std::inserter(cycles_set, cycles_set.begin()), to_cycle);
+            keys.resize(m_data.size());
+            std::transform(begin(), end(), keys.begin(), to_cycle);
         }
 
-        void cycles(id_set_t&, const void *) const
+        void cycle_keys(metric_partition::key_vector_t&, const void *) const
         {
         }
 
@@ -727,28 +992,6 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             return it;
         }
 
-        template<class OIterator, class Predicate>
-        static OIterator copy_if(const_iterator beg, const_iterator end, OIterator it, Predicate pred)
-        {
-            while (beg != end)
-            {
-                if (pred(*beg))
-                    *it++ = *beg;
-                ++beg;
-            }
-            return it;
-        }
-
-        struct lane_equals
-        {
-            lane_equals(const uint_t lane) : m_lane(lane)
-            { }
-
-            bool operator()(const metric_type &metric) const
-            { return metric.lane() == m_lane; }
-
-            const uint_t m_lane;
-        };
         struct lane_surface_equals
         {
             lane_surface_equals(const uint_t lane,
@@ -770,17 +1013,6 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
             const constants::tile_naming_method m_naming_convention;
         };
 
-        struct cycle_equals
-        {
-            cycle_equals(uint_t cycle) : m_cycle(cycle)
-            { }
-
-            bool operator()(const metric_type &metric) const
-            { return metric.cycle() == m_cycle; }
-
-            uint_t m_cycle;
-        };
-
     protected:
         /** Array of metric data */
         metric_array_t m_data;
@@ -788,6 +1020,12 @@ namespace illumina { namespace interop { namespace model { namespace metric_base
         ::int16_t m_version;
         /** Does the file or other source exist */
         bool m_data_source_exists;
+        /** Are the metrics ordered by id */
+        bool m_sorted;
+        /** Offsets of the metrics grouped by lane, built on first use */
+        mutable metric_partition m_lane_partition;
+        /** Offsets of the metrics grouped by cycle, built on first use */
+        mutable metric_partition m_cycle_partition;
 
         // TODO: remove the following
         /** Map unique identifiers to the index of the metric */
@@ -0,0 +1,282 @@
+/** Non-owning views over the metrics of a metric set
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "interop/util/assert.h"
+#include "interop/util/exception.h"
+#include "interop/util/cstdint.h"
+#include "interop/model/model_exceptions.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4290) // MSVC warns that it ignores the exception specification.
+#endif
+
+namespace illumina { namespace interop { namespace model { namespace metric_base
+{
+    /** Offsets of metrics grouped by a key, such as the lane or cycle
+     *
+     * The offsets are grouped with a counting sort, so each group keeps the order of the metric set.
+     */
+    class metric_partition
+    {
+    public:
+        /** Define a key type */
+        typedef ::uint32_t key_t;
+        /** Define a key vector */
+        typedef std::vector<key_t> key_vector_t;
+
+    public:
+        /** Constructor */
+        metric_partition() : m_built(false){}
+
+    public:
+        /** Group the offsets of each key
+         *
+         * @param keys key of each metric, in the order of the metric set
+         */
+        void assign(const key_vector_t& keys)
+        {
+            key_t max_key = 0;
+            for(size_t i=0;i<keys.size();++i) if(keys[i] > max_key) max_key = keys[i];
+            m_starts.assign(keys.empty() ? 1 : static_cast<size_t>(max_key)+2, 0);
+            for(size_t i=0;i<keys.size();++i) ++m_starts[keys[i]+1];
+            for(size_t k=1;k<m_starts.size();++k) m_starts[k] += m_starts[k-1];
+            m_offsets.resize(keys.size());
+            std::vector<size_t> next(m_starts.begin(), m_starts.end()-1);
+            for(size_t i=0;i<keys.size();++i) m_offsets[next[keys[i]]++] = i;
+            m_built = true;
+        }
+        /** Discard the groups, so they are rebuilt on next use
+         */
+        void clear()
+        {
+            m_starts.clear();
+            m_offsets.clear();
+            m_built = false;
+        }
+        /** Test if the groups are built
+         *
+         * @return true if the groups are built
+         */
+        bool is_built()const
+        {
+            return m_built;
+        }
+        /** Get the number of metrics with the given key
+         *
+         * @param key key
+         * @return number of metrics
+         */
+        size_t count(const key_t key)const
+        {
+            if(static_cast<size_t>(key)+1 >= m_starts.size()) return 0;
+            return m_starts[key+1]-m_starts[key];
+        }
+        /** Get a pointer to the first offset of the given key
+         *
+         * @param key key
+         * @return pointer to the first offset, or null if there are none
+         */
+        const size_t* offsets(const key_t key)const
+        {
+            if(count(key) == 0) return 0;
+            return &m_offsets[m_starts[key]];
+        }
+        /** Get the keys with at least one metric, in ascending order
+         *
+         * @return vector of keys
+         */
+        key_vector_t keys()const
+        {
+            key_vector_t keys;
+            for(size_t k=0;k+1<m_starts.size();++k)
+                if(m_starts[k+1] > m_starts[k]) keys.push_back(static_cast<key_t>(k));
+            return keys;
+        }
+
+    private:
+        std::vector<size_t> m_starts;
+        std::vector<size_t> m_offsets;
+        bool m_built;
+    };
+
+    /** Non-owning view of a subset of the metrics in a metric set
+     *
+     * The view holds pointers into the metric set and its partition, and so is invalidated by any change to the
+     * metric set.
+     */
+    template<class T>
+    class metric_view
+    {
+    public:
+        /** Define the metric type */
+        typedef T metric_type;
+
+    public:
+        /** Iterate the metrics of a view
+         */
+        class const_iterator
+        {
+        public:
+            /** Define the iterator category */
+            typedef std::forward_iterator_tag iterator_category;
+            /** Define the value type */
+            typedef T value_type;
+            /** Define the difference type */
+            typedef std::ptrdiff_t difference_type;
+            /** Define a pointer */
+            typedef const T* pointer;
+            /** Define a reference */
+            typedef const T& reference;
+
+        public:
+            /** Constructor
+             *
+             * @param data metrics of the set
+             * @param offset pointer to the offset of the current metric
+             */
+            const_iterator(const std::vector<T>* data=0, const size_t* offset=0) : m_data(data), m_offset(offset){}
+
+        public:
+            /** Get the current metric
+             *
+             * @return current metric
+             */
+            const T& operator*()const
+            {
+                return (*m_data)[*m_offset];
+            }
+            /** Get the current metric
+             *
+             * @return pointer to current metric
+             */
+            const T* operator->()const
+            {
+                return &(*m_data)[*m_offset];
+            }
+            /** Advance to the next metric
+             *
+             * @return reference to this iterator
+             */
+            const_iterator& operator++()
+            {
+                ++m_offset;
+                return *this;
+            }
+            /** Test if two iterators point to the same metric
+             *
+             * @param other other iterator
+             * @return true if the iterators are equal
+             */
+            bool operator==(const const_iterator& other)const
+            {
+                return m_offset == other.m_offset;
+            }
+            /** Test if two iterators point to different metrics
+             *
+             * @param other other iterator
+             * @return true if the iterators differ
+             */
+            bool operator!=(const const_iterator& other)const
+            {
+                return m_offset != other.m_offset;
+            }
+
+        private:
+            const std::vector<T>* m_data;
+            const size_t* m_offset;
+        };
+
+    public:
+        /** Constructor
+         *
+         * @param data metrics of the set
+         * @param offsets pointer to the first offset in the view
+         * @param count number of metrics in the view
+         */
+        metric_view(const std::vector<T>* data=0, const size_t* offsets=0, const size_t count=0) :
+                m_data(data), m_offsets(offsets), m_count(count)
+        {}
+
+    public:
+        /** Get the number of metrics in the view
+         *
+         * @return number of metrics
+         */
+        size_t size()const
+        {
+            return m_count;
+        }
+        /** Test if the view is empty
+         *
+         * @return true if there are no metrics
+         */
+        bool empty()const
+        {
+            return m_count == 0;
+        }
+        /** Get the metric at the given index
+         *
+         * @param n index
+         * @return metric
+         */
+        const T& operator[](const size_t n)const
+        {
+            INTEROP_ASSERT(n < m_count);
+            return (*m_data)[m_offsets[n]];
+        }
+        /** Get the metric at the given index
+         *
+         * @param n index
+         * @return metric
+         */
+        const T& at(const size_t n)const throw(index_out_of_bounds_exception)
+        {
+            if(n >= m_count) INTEROP_THROW(index_out_of_bounds_exception, "Index out of bounds");
+            return (*m_data)[m_offsets[n]];
+        }
+        /** Get the offset of a metric in the metric set
+         *
+         * @param n index
+         * @return offset of the metric in the metric set
+         */
+        size_t offset_at(const size_t n)const throw(index_out_of_bounds_exception)
+        {
+            if(n >= m_count) INTEROP_THROW(index_out_of_bounds_exception, "Index out of bounds");
+            return m_offsets[n];
+        }
+        /** Get an iterator to the first metric
+         *
+         * @return iterator to the first metric
+         */
+        const_iterator begin()const
+        {
+            return const_iterator(m_data, m_offsets);
+        }
+        /** Get an iterator to one past the last metric
+         *
+         * @return iterator to one past the last metric
+         */
+        const_iterator end()const
+        {
+            return const_iterator(m_data, m_offsets+m_count);
+        }
+
+    private:
+        const std::vector<T>* m_data;
+        const size_t* m_offsets;
+        size_t m_count;
+    };
+}}}}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -24,6 +24,7 @@
 #include <cstring>
 #include <fstream>
 #include "interop/util/exception.h"
+#include "interop/util/fixed_vector.h"
 #include "interop/constants/enums.h"
 #include "interop/io/format/generic_layout.h"
 #include "interop/model/metric_base/metric_set.h"
@@ -76,6 +77,15 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         /** Define a float pointer to a float array
          */
         typedef float* float_pointer_t;
+        /** Define a uint16_t array with one value per base stored inline
+         */
+        typedef util::fixed_vector<ushort_t, constants::NUM_OF_BASES> ushort_base_array_t;
+        /** Define a float array with one value per base stored inline
+         */
+        typedef util::fixed_vector<float, constants::NUM_OF_BASES> float_base_array_t;
+        /** Define a uint array with one value per base and no call stored inline
+         */
+        typedef util::fixed_vector<uint_t, constants::NUM_OF_BASES_AND_NC> uint_call_array_t;
     public:
         /** Constructor
          */
@@ -247,7 +257,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
                  const uint_array_t& called_counts)
         {
             metric_base::base_cycle_metric::set_base(lane, tile, cycle);
-            m_called_counts = called_counts;
+            m_called_counts.assign(called_counts.begin(), called_counts.end());
         }
 
     public:
@@ -297,25 +307,43 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 
         /** Number of clusters called per called base (including No Calls)
          *
-         * @return vector of called counts
+         * @return copy of the called counts
          */
-        const uint_array_t &called_counts_array() const
-        { return m_called_counts; }
+        uint_array_t called_counts_array() const
+        { return m_called_counts.to_vector(); }
 
         /** Average corrected intensity for only base called clusters: A, C, G and T
          *
          * @note Supported by versions 2 and 3, not later
-         * @return vector of corrected called intensities
+         * @return copy of the corrected called intensities
          */
-        const float_array_t &corrected_int_called_array() const
-        { return m_corrected_int_called; }
+        float_array_t corrected_int_called_array() const
+        { return m_corrected_int_called.to_vector(); }
 
         /** Average corrected intensity for each type of base: A, C, G and T
          *
          * @note Supported version 2, not supported by 3 or later
-         * @return vector of corrected called intensities
+         * @return copy of the corrected intensities
+         */
+        ushort_array_t corrected_int_all_array() const
+        { return m_corrected_int_all.to_vector(); }
+
+        /** Average corrected intensity for only base called clusters stored in the record
+         *
+         * Unlike corrected_int_called_array, this does not copy the values.
+         *
+         * @return corrected called intensity for each base
          */
-        const ushort_array_t &corrected_int_all_array() const
+        const float_base_array_t &corrected_int_called_bases() const
+        { return m_corrected_int_called; }
+
+        /** Average corrected intensity for each type of base stored in the record
+         *
+         * Unlike corrected_int_all_array, this does not copy the values.
+         *
+         * @return corrected intensity for each base
+         */
+        const ushort_base_array_t &corrected_int_all_bases() const
         { return m_corrected_int_all; }
 
         /** Number of clusters called per called base (including No Calls)
@@ -411,10 +439,10 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         float_array_t percent_bases() const
         {
             uint_t total = total_calls();
-            std::vector<float> percent_bases(called_counts_array().size() - 1);
+            std::vector<float> percent_bases(m_called_counts.size() - 1);
             for (size_t i = 0; i < percent_bases.size(); ++i)
                 percent_bases[i] = (total == 0) ? std::numeric_limits<float>::quiet_NaN() :
-                                   called_counts_array()[i + 1] / static_cast<float>(total) * 100;
+                                   m_called_counts[i + 1] / static_cast<float>(total) * 100;
             return percent_bases;
         }
 
@@ -434,7 +462,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          */
         void corrected_int_called_array(const float_array_t & vals)
         {
-            m_corrected_int_called = vals;
+            m_corrected_int_called.assign(vals.begin(), vals.end());
         }
 
         //--------------------------------------------------------------------------------------------------------------
@@ -488,27 +516,27 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         /** Average corrected intensity for only base called clusters: A, C, G and T
          *
          * @deprecated Will be removed in 1.1.x (use corrected_int_called_array instead)
-         * @return vector of corrected called intensities
+         * @return copy of the corrected called intensities
          */
-        const float_array_t &correctedIntCalled() const
-        { return m_corrected_int_called; }
+        float_array_t correctedIntCalled() const
+        { return m_corrected_int_called.to_vector(); }
 
         /** Average corrected intensity for each type of base: A, C, G and T
          *
          * @deprecated Will be removed in 1.1.x (use corrected_int_all_array instead)
          * @note Supported version 2, not supported by 3 or later
-         * @return vector of corrected called intensities
+         * @return copy of the corrected intensities
          */
-        const ushort_array_t &correctedIntAll() const
-        { return m_corrected_int_all; }
+        ushort_array_t correctedIntAll() const
+        { return m_corrected_int_all.to_vector(); }
 
         /** Number of clusters called per called base (including No Calls)
          *
          * @deprecated Will be removed in 1.1.x (use called_counts_array instead)
-         * @return vector of called counts
+         * @return copy of the called counts
          */
-        const uint_array_t &calledCounts() const
-        { return m_called_counts; }
+        uint_array_t calledCounts() const
+        { return m_called_counts.to_vector(); }
 
         /** Number of clusters per no call
          *
@@ -636,10 +664,10 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 
     private:
         ushort_t m_average_cycle_intensity; // Version 1 & 2
-        ushort_array_t m_corrected_int_all; // Version 1 & 2
-        float_array_t m_corrected_int_called;
+        ushort_base_array_t m_corrected_int_all; // Version 1 & 2
+        float_base_array_t m_corrected_int_called;
         // All
-        uint_array_t m_called_counts; // All
+        uint_call_array_t m_called_counts; // All
         float m_signal_to_noise; // Version 2
 
         template<class MetricType, int Version>
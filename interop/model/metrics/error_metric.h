@@ -16,6 +16,7 @@
 
 #include <cstring>
 #include "interop/util/exception.h"
+#include "interop/util/fixed_vector.h"
 #include "interop/model/metric_base/base_cycle_metric.h"
 #include "interop/model/metric_base/metric_set.h"
 #include "interop/io/layout/base_metric.h"
@@ -45,6 +46,9 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         /** Define a uint array using an underlying vector
          */
         typedef std::vector<uint_t> uint_array_t;
+        /** Define a uint array with one value per number of mismatches stored inline
+         */
+        typedef util::fixed_vector<uint_t, MAX_MISMATCH> uint_mismatch_array_t;
     public:
         /** Constructor
          */
@@ -134,11 +138,11 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * etc.
          *
          * @note Suppored by version 3, really unsupported on most platforms, some older MiSeq and HiSeq support
-         * @return vector of mismatch cluster counts
+         * @return copy of the mismatch cluster counts
          */
-        const uint_array_t &mismatch_cluster_counts() const
+        uint_array_t mismatch_cluster_counts() const
         {
-            return m_mismatch_cluster_count;
+            return m_mismatch_cluster_count.to_vector();
         }
         /** @} */
         /** Calculated error rate, as determined by a spiked in PhiX control sample.
@@ -162,7 +166,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 
     private:
         float m_error_rate;
-        uint_array_t m_mismatch_cluster_count;
+        uint_mismatch_array_t m_mismatch_cluster_count;
         template<class MetricType, int Version>
         friend
         struct io::generic_layout;
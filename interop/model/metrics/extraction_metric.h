@@ -17,6 +17,7 @@
 #include <cstring>
 #include <algorithm>
 #include "interop/util/exception.h"
+#include "interop/util/fixed_vector.h"
 #include "interop/util/time.h"
 #include "interop/io/format/generic_layout.h"
 #include "interop/io/layout/base_metric.h"
@@ -80,6 +81,9 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      *
      * The extraction metrics include the max intensity and the focus score for each color channel.
      *
+     * The values are stored inside the record, so at most MAX_CHANNELS channels are supported. Reading a file
+     * with more channels throws bad_format_exception.
+     *
      * @note Supported versions: 2 and 3
      */
     class extraction_metric : public metric_base::base_cycle_metric
@@ -108,6 +112,12 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         /** Define a float pointer to a float array
          */
         typedef float *float_pointer_t;
+        /** Define a uint16_t array with one value per channel stored inline
+         */
+        typedef util::fixed_vector<ushort_t, MAX_CHANNELS> ushort_channel_array_t;
+        /** Define a float array with one value per channel stored inline
+         */
+        typedef util::fixed_vector<float, MAX_CHANNELS> float_channel_array_t;
 
     public:
         /** Constructor
@@ -378,9 +388,18 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * These values are estimated to be a 9x percentile of intensities extracted from each image, e.g.
          * each channel.
          *
-         * @return vector of intensity values
+         * @return copy of the intensity values
+         */
+        ushort_array_t max_intensity_values() const
+        { return m_max_intensity_values.to_vector(); }
+
+        /** Get the maximum intensity values stored in the record
+         *
+         * Unlike max_intensity_values, this does not copy the values.
+         *
+         * @return intensity value for each channel
          */
-        const ushort_array_t &max_intensity_values() const
+        const ushort_channel_array_t &max_intensity_channels() const
         { return m_max_intensity_values; }
 
         /** Get an array of focus scores
@@ -388,9 +407,18 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * These values are estimated using full width half max (FWHM) from each image, e.g. each channel.
          *
          * @deprecated Will be removed in 1.1.x (use focus_scores instead)
-         * @return vector of focus scores
+         * @return copy of the focus scores
+         */
+        float_array_t focus_scores() const
+        { return m_focus_scores.to_vector(); }
+
+        /** Get the focus scores stored in the record
+         *
+         * Unlike focus_scores, this does not copy the values.
+         *
+         * @return focus score for each channel
          */
-        const float_array_t &focus_scores() const
+        const float_channel_array_t &focus_score_channels() const
         { return m_focus_scores; }
 
         /** Get the number of channels
@@ -439,10 +467,10 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * These values are estimated using full width half max (FWHM).
          *
          * @deprecated Will be removed in 1.1.x (use focus_scores instead)
-         * @return vector of focus scores
+         * @return copy of the focus scores
          */
-        const float_array_t &focusScores() const
-        { return m_focus_scores; }
+        float_array_t focusScores() const
+        { return m_focus_scores.to_vector(); }
         /** Set the current extraction time
          *
          * @param time current time
@@ -478,8 +506,8 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     private:
         util::csharp_date_time m_date_time_csharp;
         ulong_t m_date_time;
-        ushort_array_t m_max_intensity_values;
-        float_array_t m_focus_scores;
+        ushort_channel_array_t m_max_intensity_values;
+        float_channel_array_t m_focus_scores;
         template<class MetricType, int Version>
         friend
         struct io::generic_layout;
@@ -15,6 +15,7 @@
 
 #include <cstring>
 #include "interop/util/exception.h"
+#include "interop/util/fixed_vector.h"
 #include "interop/io/format/generic_layout.h"
 #include "interop/io/layout/base_metric.h"
 #include "interop/model/metric_base/base_cycle_metric.h"
@@ -92,6 +93,9 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      *
      * Per tile per cycle per channel percentiles of pixel values used to autocontrast thumbnail images
      *
+     * The values are stored inside the record, so at most MAX_CHANNELS channels are supported. Reading a version 3
+     * file with more channels throws bad_format_exception.
+     *
      * @note Supported versions: 1, 2 and 3
      */
     class image_metric : public metric_base::base_cycle_metric
@@ -115,6 +119,9 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         /** Define a uint16_t pointer to a uint16_t array
          */
         typedef ::uint16_t *ushort_pointer_t;
+        /** Define a uint16_t array with one value per channel stored inline
+         */
+        typedef util::fixed_vector<ushort_t, MAX_CHANNELS> ushort_channel_array_t;
     public:
         /** Constructor
          */
@@ -216,18 +223,40 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 
         /** Minimum contrast intensity
          *
-         * @return minimum contrast intensity
+         * @return copy of the minimum contrast intensity
          */
-        const ushort_array_t &min_contrast_array() const
+        ushort_array_t min_contrast_array() const
         {
-            return m_min_contrast;
+            return m_min_contrast.to_vector();
         }
 
         /** Maximum contrast intensity
          *
-         * @return maximum contrast intensity
+         * @return copy of the maximum contrast intensity
+         */
+        ushort_array_t max_contrast_array() const
+        {
+            return m_max_contrast.to_vector();
+        }
+
+        /** Minimum contrast intensity stored in the record
+         *
+         * Unlike min_contrast_array, this does not copy the values.
+         *
+         * @return minimum contrast intensity for each channel
          */
-        const ushort_array_t &max_contrast_array() const
+        const ushort_channel_array_t &min_contrast_channels() const
+        {
+            return m_min_contrast;
+        }
+
+        /** Maximum contrast intensity stored in the record
+         *
+         * Unlike max_contrast_array, this does not copy the values.
+         *
+         * @return maximum contrast intensity for each channel
+         */
+        const ushort_channel_array_t &max_contrast_channels() const
         {
             return m_max_contrast;
         }
@@ -291,21 +320,21 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         /** Minimum contrast intensity
          *
          * @deprecated Will be removed in 1.1.x (use min_contrast_array instead)
-         * @return minimum contrast intensity
+         * @return copy of the minimum contrast intensity
          */
-        const ushort_array_t &minContrast() const
+        ushort_array_t minContrast() const
         {
-            return m_min_contrast;
+            return m_min_contrast.to_vector();
         }
 
         /** Maximum contrast intensity
          *
          * @deprecated Will be removed in 1.1.x (use max_contrast_array instead)
-         * @return maximum contrast intensity
+         * @return copy of the maximum contrast intensity
          */
-        const ushort_array_t &maxContrast() const
+        ushort_array_t maxContrast() const
         {
-            return m_max_contrast;
+            return m_max_contrast.to_vector();
         }
 
         /** Number of channels
@@ -327,8 +356,8 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         { return "Image"; }
 
     private:
-        ushort_array_t m_min_contrast;
-        ushort_array_t m_max_contrast;
+        ushort_channel_array_t m_min_contrast;
+        ushort_channel_array_t m_max_contrast;
         ushort_t m_channel_count;
         template<class MetricType, int Version>
         friend
@@ -18,6 +18,7 @@
 #include <vector>
 #include "interop/util/exception.h"
 #include "interop/util/assert.h"
+#include "interop/util/string_pool.h"
 #include "interop/model/metric_base/base_read_metric.h"
 #include "interop/model/model_exceptions.h"
 #include "interop/io/format/generic_layout.h"
@@ -29,6 +30,9 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      *
      * This class defines all the information that describes an index within a sequencing run.
      *
+     * The same index sequences, sample ids and projects repeat across every tile of a run, so each index holds only
+     * the id of its strings in the process-wide util::string_pool.
+     *
      * @note Supported versions: 1, 2
      */
     class index_info
@@ -38,10 +42,10 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          *
          */
         index_info() :
-                m_index_seq(""),
-                m_sample_id(""),
-                m_sample_proj(""),
-                m_cluster_count(0)
+                m_cluster_count(0),
+                m_index_seq_id(0),
+                m_sample_id_id(0),
+                m_sample_proj_id(0)
         {
         }
 
@@ -56,10 +60,10 @@ namespace illumina { namespace interop { namespace model { namespace metrics
                    const std::string &sample_id,
                    const std::string &sample_proj,
                    const ::uint64_t cluster_count) :
-                m_index_seq(index_seq),
-                m_sample_id(sample_id),
-                m_sample_proj(sample_proj),
-                m_cluster_count(cluster_count)
+                m_cluster_count(cluster_count),
+                m_index_seq_id(util::string_pool::intern(index_seq)),
+                m_sample_id_id(util::string_pool::intern(sample_id)),
+                m_sample_proj_id(util::string_pool::intern(sample_proj))
         {
         }
 
@@ -77,21 +81,21 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * @return index sequence
          */
         const std::string &index_seq() const
-        { return m_index_seq; }
+        { return util::string_pool::at(m_index_seq_id); }
 
         /** Get the sample id
          *
          * @return sample id
          */
         const std::string &sample_id() const
-        { return m_sample_id; }
+        { return util::string_pool::at(m_sample_id_id); }
 
         /** Get the sample project
          *
          * @return sample project
          */
         const std::string &sample_proj() const
-        { return m_sample_proj; }
+        { return util::string_pool::at(m_sample_proj_id); }
 
         /** Get the number of clusters (per tile) that have this index sequences
          *
@@ -100,6 +104,29 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         ::uint64_t cluster_count() const
         { return m_cluster_count; }
 
+        /** Get the id of the index sequence in the string pool
+         *
+         * Two indexes have the same id if and only if they have the same sequence.
+         *
+         * @return id of index sequence
+         */
+        ::uint32_t index_seq_id() const
+        { return m_index_seq_id; }
+
+        /** Get the id of the sample id in the string pool
+         *
+         * @return id of sample id
+         */
+        ::uint32_t sample_id_id() const
+        { return m_sample_id_id; }
+
+        /** Get the id of the sample project in the string pool
+         *
+         * @return id of sample project
+         */
+        ::uint32_t sample_proj_id() const
+        { return m_sample_proj_id; }
+
         /** Test if the sequence is a dual index
          *
          * The two sequences in a dual index are separated by a '-' or a '+'
@@ -118,8 +145,8 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         std::string index1() const
         {
             const std::string::size_type pos = index_of_separator();
-            if (pos != std::string::npos) return m_index_seq.substr(0, pos);
-            return m_index_seq;
+            if (pos != std::string::npos) return index_seq().substr(0, pos);
+            return index_seq();
         }
 
         /** Get the second sequence in a dual index (or empty string for single index)
@@ -129,23 +156,23 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         std::string index2() const
         {
             const std::string::size_type pos = index_of_separator();
-            if (pos != std::string::npos) return m_index_seq.substr(pos + 1);
+            if (pos != std::string::npos) return index_seq().substr(pos + 1);
             return "";
         }
         /** @} */
     private:
         std::string::size_type index_of_separator() const
         {
-            const std::string::size_type pos = m_index_seq.find('-');
+            const std::string::size_type pos = index_seq().find('-');
             if (pos != std::string::npos) return pos;
-            return m_index_seq.find('+');
+            return index_seq().find('+');
         }
 
     private:
-        std::string m_index_seq;
-        std::string m_sample_id;
-        std::string m_sample_proj;
         ::uint64_t m_cluster_count;
+        ::uint32_t m_index_seq_id;
+        ::uint32_t m_sample_id_id;
+        ::uint32_t m_sample_proj_id;
         template<class MetricType, int Version>
         friend
         struct io::generic_layout;
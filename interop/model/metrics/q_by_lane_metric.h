@@ -77,6 +77,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             for (const_iterator beg = metric.qscore_hist().begin(), end = metric.qscore_hist().end();
                  beg != end; ++beg, ++it)
                 *it += *beg;
+            m_qscore_suffix.clear();
         }
 
     public:
@@ -342,6 +342,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             metric_base::base_cycle_metric::set_base(lane, tile, cycle);
             m_qscore_hist = qscore_hist;
             m_qscore_hist_cumulative.resize(qscore_hist.size(), 0);
+            m_qscore_suffix.clear();
         }
 
     public:
@@ -390,6 +391,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          */
         uint_t sum_qscore() const
         {
+            if(has_suffix_sums()) return static_cast<uint_t>(m_qscore_suffix[0]);
             return std::accumulate(m_qscore_hist.begin(), m_qscore_hist.end(), 0);
         }
 
@@ -399,6 +401,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          */
         ::uint64_t sum_qscore_cumulative() const
         {
+            if(has_suffix_sums()) return m_qscore_suffix[m_qscore_suffix.size() / 2];
             return std::accumulate(m_qscore_hist_cumulative.begin(),
                                    m_qscore_hist_cumulative.end(),
                                    static_cast< ::uint64_t >(0));
@@ -444,7 +447,12 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         uint_t total_over_qscore(const size_t qscore_index) const
         {
             uint_t total_count = 0;
-            if(qscore_index <= m_qscore_hist.size())
+            if(has_suffix_sums())
+            {
+                if(qscore_index < m_qscore_suffix.size() / 2)
+                    total_count = static_cast<uint_t>(m_qscore_suffix[qscore_index]);
+            }
+            else if(qscore_index <= m_qscore_hist.size())
                 total_count = std::accumulate(m_qscore_hist.begin() + qscore_index, m_qscore_hist.end(), 0);
             return total_count;
         }
@@ -462,7 +470,13 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         {
             INTEROP_ASSERT(m_qscore_hist_cumulative.size() > 0);
             ::uint64_t total_count = 0;
-            if(qscore_index <= m_qscore_hist_cumulative.size())
+            if(has_suffix_sums())
+            {
+                const size_t bin_count = m_qscore_suffix.size() / 2;
+                if(qscore_index < bin_count)
+                    total_count = m_qscore_suffix[bin_count + qscore_index];
+            }
+            else if(qscore_index <= m_qscore_hist_cumulative.size())
                 total_count = std::accumulate(m_qscore_hist_cumulative.begin() + qscore_index,
                                               m_qscore_hist_cumulative.end(),
                                               static_cast< ::uint64_t >(0));
@@ -630,6 +644,41 @@ namespace illumina { namespace interop { namespace model { namespace metrics
                 for (uint64_vector::iterator cur = m_qscore_hist_cumulative.begin(); beg != end; ++beg, ++cur)
                     *cur += *beg;
             }
+            m_qscore_suffix.clear();
+        }
+        /** Compute the suffix sums of the local and cumulative q-score histograms
+         *
+         * Element i of a suffix sum holds the number of calls in bin i or above. Once computed, `sum_qscore`,
+         * `total_over_qscore` and their cumulative variants take a single load rather than summing the histogram.
+         *
+         * Call it after `accumulate`. `run_metrics::finalize_after_load` and `run_metrics::freeze` compute the sums
+         * of every q-metric and by lane q-metric. The sums are discarded by any later change to the histogram.
+         */
+        void compute_suffix_sums()
+        {
+            const size_t bin_count = m_qscore_hist.size();
+            if (bin_count == 0 || m_qscore_hist_cumulative.size() != bin_count)
+            {
+                m_qscore_suffix.clear();
+                return;
+            }
+            m_qscore_suffix.resize(2 * bin_count);
+            ::uint64_t local = 0, cumulative = 0;
+            for (size_t i = bin_count; i > 0; --i)
+            {
+                local += m_qscore_hist[i - 1];
+                cumulative += m_qscore_hist_cumulative[i - 1];
+                m_qscore_suffix[i - 1] = local;
+                m_qscore_suffix[bin_count + i - 1] = cumulative;
+            }
+        }
+        /** Test if the suffix sums are up to date
+         *
+         * @return true if `compute_suffix_sums` was called after the last change to the histogram
+         */
+        bool has_suffix_sums() const
+        {
+            return !m_qscore_hist.empty() && m_qscore_suffix.size() == 2 * m_qscore_hist.size();
         }
 
         /** Accumulate q-score histogram into the destination distribution
@@ -660,6 +709,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
                 m_qscore_hist[i] = m_qscore_hist[static_cast<size_t>(header.bin_at(i).value()-1)];
             }
             m_qscore_hist.resize(header.bin_count());
+            m_qscore_suffix.clear();
         }
 
         /** Q-score value of the histogram
@@ -694,6 +744,8 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     protected:
         /** Unsigned int vector for q-score histogram */
         uint32_vector m_qscore_hist;
+        /** Local then cumulative suffix sums, or empty if not requested */
+        uint64_vector m_qscore_suffix;
     private:
         uint64_vector m_qscore_hist_cumulative;
 
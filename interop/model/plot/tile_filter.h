@@ -0,0 +1,133 @@
+/** Tile and cycle filter compiled from the filter options
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <limits>
+#include <vector>
+#include "interop/model/plot/filter_options.h"
+#include "interop/model/run/flowcell_layout.h"
+
+namespace illumina { namespace interop { namespace model { namespace plot
+{
+
+    /** Tile and cycle filter compiled from the filter options
+     *
+     * The filter options decode the surface, tile number, swath and section from the tile id of every record they
+     * test. This filter decodes each tile id allowed by the flowcell layout once, and stores whether it is accepted
+     * in a table indexed by tile id. The cycle constraint is stored as a range.
+     *
+     * Tile ids outside the table, e.g. for absolute tile naming, fall back to the filter options.
+     */
+    class tile_filter
+    {
+    public:
+        /** ID type */
+        typedef filter_options::id_t id_t;
+
+    public:
+        /** Constructor
+         *
+         * @param options options to filter the data
+         * @param layout layout of the flowcell
+         */
+        tile_filter(const filter_options& options, const run::flowcell_layout& layout) :
+                m_options(options),
+                m_lane(options.lane()),
+                m_first_cycle(options.all_cycles() ? 0 : options.cycle()),
+                m_last_cycle(options.all_cycles() ? std::numeric_limits<id_t>::max() : options.cycle()),
+                m_all_tiles(options.all_tile_numbers() && options.all_swaths() && options.all_sections() &&
+                            !options.is_specific_surface())
+        {
+            if(m_all_tiles) return;
+            const constants::tile_naming_method method = options.naming_method();
+            m_accepted.assign(tile_id_limit(method, layout.surface_count()), 0);
+            for(size_t tile=0;tile<m_accepted.size();++tile)
+            {
+                const metric_base::base_metric probe(1, static_cast<id_t>(tile));
+                m_accepted[tile] = static_cast<unsigned char>(options.valid_surface(probe.surface(method)) &&
+                                                             options.valid_tile_number(probe.number(method)) &&
+                                                             options.valid_swath(probe.swath(method)) &&
+                                                             options.valid_section(probe.section(method)));
+            }
+        }
+
+    public:
+        /** Replace the range of cycles to keep
+         *
+         * @param first_cycle first cycle to keep
+         * @param last_cycle last cycle to keep
+         */
+        void cycle_range(const id_t first_cycle, const id_t last_cycle)
+        {
+            m_first_cycle = first_cycle;
+            m_last_cycle = last_cycle;
+        }
+        /** Test if the tile of a metric should be kept
+         *
+         * @param metric metric with a lane and tile
+         * @return true if the metric should not be filtered
+         */
+        template<class Metric>
+        bool valid_tile(const Metric& metric) const
+        {
+            if(m_lane != static_cast<id_t>(filter_options::ALL_IDS) && metric.lane() != m_lane) return false;
+            if(m_all_tiles) return true;
+            const id_t tile = metric.tile();
+            if(tile < m_accepted.size()) return m_accepted[tile] != 0;
+            return m_options.valid_tile(metric);
+        }
+        /** Test if the tile and cycle of a metric should be kept
+         *
+         * @param metric metric with a lane, tile and, optionally, a cycle
+         * @return true if the metric should not be filtered
+         */
+        template<class Metric>
+        bool valid_tile_cycle(const Metric& metric) const
+        {
+            typedef typename Metric::base_t base_t;
+            return valid_tile(metric) && valid_cycle(metric, base_t::null());
+        }
+        /** Test if the cycle should be kept
+         *
+         * @param cycle cycle number
+         * @return true if the cycle should not be filtered
+         */
+        bool valid_cycle(const id_t cycle) const
+        {
+            return cycle >= m_first_cycle && cycle <= m_last_cycle;
+        }
+
+    private:
+        template<class Metric>
+        bool valid_cycle(const Metric& metric, const constants::base_cycle_t*) const
+        {
+            return valid_cycle(metric.cycle());
+        }
+        template<class Metric>
+        bool valid_cycle(const Metric&, const void*) const
+        {
+            return true;
+        }
+        static size_t tile_id_limit(const constants::tile_naming_method method, const size_t surface_count)
+        {
+            // The surface is the leading digit of the tile id
+            if(method == constants::FourDigit) return (surface_count+1) * 1000;
+            if(method == constants::FiveDigit) return (surface_count+1) * 10000;
+            return 0;
+        }
+
+    private:
+        filter_options m_options;
+        id_t m_lane;
+        id_t m_first_cycle;
+        id_t m_last_cycle;
+        bool m_all_tiles;
+        std::vector<unsigned char> m_accepted;
+    };
+
+}}}}
@@ -9,6 +9,8 @@
 
 #include "interop/util/exception.h"
 #include "interop/util/object_list.h"
+#include "interop/util/progress.h"
+#include "interop/util/thread_pool.h"
 #include "interop/model/metric_base/metric_set.h"
 #include "interop/io/stream_exceptions.h"
 #include "interop/io/metric_file_stream.h"
@@ -111,8 +113,11 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          *
          * @param run_folder run folder path
          * @param thread_count number of threads to use for network loading
+         * @param progress progress token updated and checked while loading, may be null
          */
-        void read(const std::string &run_folder, const size_t thread_count=1) throw(xml::xml_file_not_found_exception,
+        void read(const std::string &run_folder,
+                  const size_t thread_count=1,
+                  util::progress_token* progress=0) throw(xml::xml_file_not_found_exception,
         xml::bad_xml_format_exception,
         xml::empty_xml_format_exception,
         xml::missing_xml_element_exception,
@@ -123,18 +128,51 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         model::invalid_channel_exception,
         model::index_out_of_bounds_exception,
         model::invalid_tile_naming_method,
-        model::invalid_run_info_exception);
+        model::invalid_run_info_exception,
+        util::operation_cancelled_exception);
         /** Read binary metrics and XML files from the run folder
          *
          * @param run_folder run folder path
          * @param valid_to_load list of metrics to load
          * @param thread_count number of threads to use for network loading
          * @param skip_loaded skip metrics that are already loaded
+         * @param progress progress token updated and checked while loading, may be null
          */
         void read(const std::string &run_folder,
                   const std::vector<unsigned char>& valid_to_load,
                   const size_t thread_count=1,
-                  const bool skip_loaded=false)
+                  const bool skip_loaded=false,
+                  util::progress_token* progress=0)
+        throw(xml::xml_file_not_found_exception,
+        xml::bad_xml_format_exception,
+        xml::empty_xml_format_exception,
+        xml::missing_xml_element_exception,
+        xml::xml_parse_exception,
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception,
+        model::invalid_channel_exception,
+        model::index_out_of_bounds_exception,
+        model::invalid_tile_naming_method,
+        model::invalid_run_info_exception,
+        invalid_parameter,
+        util::operation_cancelled_exception);
+        /** Read binary metrics and XML files from the run folder, using the threads of an existing pool
+         *
+         * This lets a caller that already runs tasks on a pool, such as a batch of runs, load each run with nested
+         * tasks on the same pool rather than start a pool per run.
+         *
+         * @param run_folder run folder path
+         * @param valid_to_load list of metrics to load
+         * @param pool pool of threads used to load and finalize the metrics
+         * @param skip_loaded skip metrics that are already loaded
+         * @param progress progress token updated and checked while loading, may be null
+         */
+        void read(const std::string &run_folder,
+                  const std::vector<unsigned char>& valid_to_load,
+                  util::thread_pool& pool,
+                  const bool skip_loaded=false,
+                  util::progress_token* progress=0)
         throw(xml::xml_file_not_found_exception,
         xml::bad_xml_format_exception,
         xml::empty_xml_format_exception,
@@ -147,7 +185,8 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         model::index_out_of_bounds_exception,
         model::invalid_tile_naming_method,
         model::invalid_run_info_exception,
-        invalid_parameter);
+        invalid_parameter,
+        util::operation_cancelled_exception);
 
         /** Read XML files: RunInfo.xml and possibly RunParameters.xml
          *
@@ -192,6 +231,17 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         model::invalid_tile_naming_method,
         model::index_out_of_bounds_exception,
         model::invalid_run_info_exception);
+        /** Derive every lazily computed metric set and view, and return a read-only snapshot of the run
+         *
+         * The collapsed and by lane q-metrics, the cumulative q-score distributions, the dynamic phasing metrics and
+         * the lane and cycle views of every metric set are built eagerly. Afterwards, the const overloads of the plot,
+         * summary and table logic only read the run, so the snapshot may be shared by several threads as long as the
+         * run is not modified.
+         *
+         * @param thread_count number of threads used to derive the metric sets
+         * @return read-only snapshot of the run
+         */
+        const run_metrics& freeze(const size_t thread_count=1) throw(model::index_out_of_bounds_exception);
 
         /** Test if all metrics are empty
          *
@@ -336,11 +386,16 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * @param run_folder run folder path
          * @param last_cycle last cycle of run
          * @param thread_count number of threads to use for network loading
+         * @param progress progress token updated and checked while loading, may be null
          */
-        void read_metrics(const std::string &run_folder, const size_t last_cycle, const size_t thread_count) throw(
+        void read_metrics(const std::string &run_folder,
+                          const size_t last_cycle,
+                          const size_t thread_count,
+                          util::progress_token* progress=0) throw(
         io::file_not_found_exception,
         io::bad_format_exception,
-        io::incomplete_file_exception);
+        io::incomplete_file_exception,
+        util::operation_cancelled_exception);
         /** Read binary metrics from the run folder
          *
          * This function ignores:
@@ -353,21 +408,28 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          * @param valid_to_load boolean vector indicating which files to load
          * @param thread_count number of threads to use for network loading
          * @param skip_loaded skip metrics that are already loaded
+         * @param progress progress token updated and checked while loading, may be null
          */
         void read_metrics(const std::string &run_folder,
                           const size_t last_cycle,
                           const std::vector<unsigned char>& valid_to_load,
                           const size_t thread_count,
-                          const bool skip_loaded=false) throw(
+                          const bool skip_loaded=false,
+                          util::progress_token* progress=0) throw(
         io::file_not_found_exception,
         io::bad_format_exception,
         io::incomplete_file_exception,
-        invalid_parameter);
+        invalid_parameter,
+        util::operation_cancelled_exception);
         /** Write binary metrics to the run folder
+         *
+         * Each metric group is encoded directly into its output file, and with more than one thread the groups are
+         * written concurrently.
          *
          * @param run_folder run folder path
+         * @param thread_count number of threads used to write the metric groups
          */
-        void write_metrics(const std::string &run_folder)const throw(
+        void write_metrics(const std::string &run_folder, const size_t thread_count=1)const throw(
         io::file_not_found_exception,
         io::bad_format_exception);
 
@@ -466,13 +528,34 @@ namespace illumina { namespace interop { namespace model { namespace metrics
          */
         void populate_id_map(cycle_metric_map_t &map) const;
         /** Sort the metrics by id
+         *
+         * The index of each metric set is rebuilt, and range queries on the sets use the sorted order.
+         *
+         * @param thread_count number of threads used to sort large metric sets
          */
-        void sort();
+        void sort(const size_t thread_count=1);
 
         /** Clear all the metrics
          */
          void clear();
 
+    private:
+        void read_metrics(const std::string &run_folder,
+                          const size_t last_cycle,
+                          const unsigned char* valid_to_load,
+                          util::thread_pool& pool,
+                          const bool skip_loaded,
+                          util::progress_token* progress) throw(
+        io::file_not_found_exception,
+        io::bad_format_exception,
+        io::incomplete_file_exception,
+        util::operation_cancelled_exception);
+        void finalize_after_load(size_t count, util::thread_pool& pool) throw(
+        model::invalid_channel_exception,
+        model::invalid_tile_naming_method,
+        model::index_out_of_bounds_exception,
+        model::invalid_run_info_exception);
+
     private:
         metric_list_t m_metrics;
         run::info m_run_info;
@@ -61,12 +61,12 @@
         INTEROP_TUPLE7(ErrorRate,             metrics::error_metric,              error_rate,                 Void, Float, ValueType, 3)\
         INTEROP_TUPLE7(PercentGreaterThanQ20, metrics::q_metric,                  percent_over_qscore,        Q20,  Float, ValueType, 2)\
         INTEROP_TUPLE7(PercentGreaterThanQ30, metrics::q_metric,                  percent_over_qscore,        Q30,  Float, ValueType, 2)\
-        INTEROP_TUPLE7(P90,                   metrics::extraction_metric,         max_intensity_values,       Void, UShort, ChannelArray, 0)\
+        INTEROP_TUPLE7(P90,                   metrics::extraction_metric,         max_intensity_channels,     Void, UShort, ChannelArray, 0)\
         INTEROP_TUPLE7(PercentNoCalls,        metrics::corrected_intensity_metric,percent_nocall,             Void, Float, ValueType, 1)\
         INTEROP_TUPLE7(PercentBase,           metrics::corrected_intensity_metric,percent_bases,              Void, Float, BaseArray, 1)\
-        INTEROP_TUPLE7(Fwhm,                  metrics::extraction_metric,         focus_scores,               Void, Float, ChannelArray, 2) \
-        INTEROP_TUPLE7(Corrected,             metrics::corrected_intensity_metric,corrected_int_all_array,    Void, UShort, BaseArray, 0)\
-        INTEROP_TUPLE7(Called,                metrics::corrected_intensity_metric,corrected_int_called_array, Void, UShort, BaseArray, 0)\
+        INTEROP_TUPLE7(Fwhm,                  metrics::extraction_metric,         focus_score_channels,       Void, Float, ChannelArray, 2) \
+        INTEROP_TUPLE7(Corrected,             metrics::corrected_intensity_metric,corrected_int_all_bases,    Void, UShort, BaseArray, 0)\
+        INTEROP_TUPLE7(Called,                metrics::corrected_intensity_metric,corrected_int_called_bases, Void, UShort, BaseArray, 0)\
         INTEROP_TUPLE7(SignalToNoise,         metrics::corrected_intensity_metric,signal_to_noise,            Void, Float, ValueType, 2)\
         INTEROP_TUPLE7(PercentPhasingWeight,   metrics::phasing_metric,            phasing_weight,             Void, Float, ValueType, 3)\
         INTEROP_TUPLE7(PercentPrephasingWeight,metrics::phasing_metric,            prephasing_weight,          Void, Float, ValueType, 3)\
@@ -74,8 +74,8 @@
         INTEROP_TUPLE7(PhasingOffset,          metrics::dynamic_phasing_metric,    phasing_offset,             Void, Float, ValueType, 3)\
         INTEROP_TUPLE7(PrephasingSlope,        metrics::dynamic_phasing_metric,    prephasing_slope,           Void, Float, ValueType, 3)\
         INTEROP_TUPLE7(PrephasingOffset,       metrics::dynamic_phasing_metric,    prephasing_offset,          Void, Float, ValueType, 3)\
-        INTEROP_TUPLE7(MinimumContrast,       metrics::image_metric,              min_contrast_array,         Void, UShort, ChannelArray, 0)\
-        INTEROP_TUPLE7(MaximumContrast,       metrics::image_metric,              max_contrast_array,         Void, UShort, ChannelArray, 0)\
+        INTEROP_TUPLE7(MinimumContrast,       metrics::image_metric,              min_contrast_channels,      Void, UShort, ChannelArray, 0)\
+        INTEROP_TUPLE7(MaximumContrast,       metrics::image_metric,              max_contrast_channels,      Void, UShort, ChannelArray, 0)\
         INTEROP_TUPLE7(Surface,               metric_base::base_metric,           surface,                    NamingConvention, UInt, IdType, 0)\
         INTEROP_TUPLE7(Swath,                 metric_base::base_metric,           swath,                      NamingConvention, UInt, IdType, 0)\
         INTEROP_TUPLE7(Section,               metric_base::base_metric,           section,                    NamingConvention, UInt, IdType, 0)\
@@ -69,6 +69,14 @@ namespace illumina { namespace interop { namespace io
      * @return size of the file or -1 if the operation failed
      */
     ::int64_t file_size(const std::string& path);
+    /** Get the last modification time of a file
+     *
+     * The resolution is nanoseconds where the platform provides it, otherwise seconds scaled to nanoseconds.
+     *
+     * @param path path to the target file
+     * @return modification time in nanoseconds since the epoch or -1 if the operation failed
+     */
+    ::int64_t file_modification_time(const std::string& path);
 }}}
 
 
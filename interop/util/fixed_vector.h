@@ -0,0 +1,265 @@
+/** Vector with a fixed capacity stored inline
+ *
+ * Per-channel and per-base values of a metric record never exceed a small, known number of values. Storing them
+ * in place, rather than in a std::vector, means reading, resizing and copying a metric set needs no allocation per
+ * record.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "interop/util/assert.h"
+#include "interop/util/exception.h"
+#include "interop/util/length_of.h"
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Vector of at most N values stored inline
+     *
+     * This provides the subset of the std::vector interface used by the metric records.
+     */
+    template<typename T, size_t N>
+    class fixed_vector
+    {
+    public:
+        /** Define the value type */
+        typedef T value_type;
+        /** Define the size type */
+        typedef size_t size_type;
+        /** Define a reference */
+        typedef T& reference;
+        /** Define a constant reference */
+        typedef const T& const_reference;
+        /** Define an iterator */
+        typedef T* iterator;
+        /** Define a constant iterator */
+        typedef const T* const_iterator;
+
+    public:
+        /** Constructor
+         */
+        fixed_vector() : m_size(0)
+        {
+            init(0);
+        }
+        /** Constructor
+         *
+         * @param n number of values
+         * @param value value to assign to each element
+         */
+        explicit fixed_vector(const size_t n, const T& value=T()) throw(std::length_error) : m_size(0)
+        {
+            resize(n, value);
+            init(n);
+        }
+        /** Constructor
+         *
+         * @param beg pointer to first value
+         * @param end pointer to one past the last value
+         */
+        template<typename U>
+        fixed_vector(const U* beg, const U* end) throw(std::length_error) : m_size(0)
+        {
+            assign(beg, end);
+            init(m_size);
+        }
+        /** Constructor
+         *
+         * @param vec vector of values
+         */
+        explicit fixed_vector(const std::vector<T>& vec) throw(std::length_error) : m_size(0)
+        {
+            assign(vec.begin(), vec.end());
+            init(m_size);
+        }
+
+    public:
+        /** Get the number of values
+         *
+         * @return number of values
+         */
+        size_t size()const
+        {
+            return m_size;
+        }
+        /** Test if there are no values
+         *
+         * @return true if there are no values
+         */
+        bool empty()const
+        {
+            return m_size == 0;
+        }
+        /** Get the maximum number of values
+         *
+         * @return maximum number of values
+         */
+        static size_t capacity()
+        {
+            return N;
+        }
+        /** Get the value at the given index
+         *
+         * @param n index
+         * @return value
+         */
+        reference operator[](const size_t n)
+        {
+            INTEROP_ASSERT(n < N);
+            return m_values[n];
+        }
+        /** Get the value at the given index
+         *
+         * @param n index
+         * @return value
+         */
+        const_reference operator[](const size_t n)const
+        {
+            INTEROP_ASSERT(n < N);
+            return m_values[n];
+        }
+        /** Get the first value
+         *
+         * @return first value
+         */
+        reference front()
+        {
+            return m_values[0];
+        }
+        /** Get the first value
+         *
+         * @return first value
+         */
+        const_reference front()const
+        {
+            return m_values[0];
+        }
+        /** Get an iterator to the first value
+         *
+         * @return iterator to first value
+         */
+        iterator begin()
+        {
+            return m_values;
+        }
+        /** Get an iterator to one past the last value
+         *
+         * @return iterator to one past the last value
+         */
+        iterator end()
+        {
+            return m_values + m_size;
+        }
+        /** Get an iterator to the first value
+         *
+         * @return iterator to first value
+         */
+        const_iterator begin()const
+        {
+            return m_values;
+        }
+        /** Get an iterator to one past the last value
+         *
+         * @return iterator to one past the last value
+         */
+        const_iterator end()const
+        {
+            return m_values + m_size;
+        }
+        /** Change the number of values
+         *
+         * @param n number of values
+         * @param value value to assign to new elements
+         */
+        void resize(const size_t n, const T& value=T()) throw(std::length_error)
+        {
+            if(n > N) INTEROP_THROW(std::length_error, "Number of values " << n << " exceeds capacity " << N);
+            for(size_t i=m_size;i<n;++i) m_values[i] = value;
+            m_size = n;
+        }
+        /** Replace the values with a range of values
+         *
+         * @param beg iterator to first value
+         * @param end iterator to one past the last value
+         */
+        template<typename I>
+        void assign(I beg, I end) throw(std::length_error)
+        {
+            m_size = 0;
+            for(;beg != end;++beg)
+            {
+                if(m_size == N) INTEROP_THROW(std::length_error, "Number of values exceeds capacity " << N);
+                m_values[m_size] = *beg;
+                ++m_size;
+            }
+        }
+        /** Remove all values
+         */
+        void clear()
+        {
+            m_size = 0;
+        }
+        /** Copy the values into a std::vector
+         *
+         * @return vector of values
+         */
+        std::vector<T> to_vector()const
+        {
+            return std::vector<T>(begin(), end());
+        }
+        /** Test if two arrays hold the same values
+         *
+         * @param other other array
+         * @return true if both arrays hold the same values
+         */
+        bool operator==(const fixed_vector<T, N>& other)const
+        {
+            if(m_size != other.m_size) return false;
+            for(size_t i=0;i<m_size;++i)
+                if(!(m_values[i] == other.m_values[i])) return false;
+            return true;
+        }
+        /** Test if two arrays hold different values
+         *
+         * @param other other array
+         * @return true if the arrays hold different values
+         */
+        bool operator!=(const fixed_vector<T, N>& other)const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void init(const size_t from)
+        {
+            // Unused slots are assigned so that copying a record never reads an uninitialized value
+            for(size_t i=from;i<N;++i) m_values[i] = T();
+        }
+
+    private:
+        T m_values[N];
+        size_t m_size;
+    };
+
+    /** Length of a fixed capacity vector
+     *
+     * Returns fixed_vector::size()
+     */
+    template<typename T, size_t N>
+    struct length_of_type<fixed_vector<T, N> >
+    {
+        /** Length of a fixed capacity vector
+         *
+         * @param vec fixed capacity vector
+         * @return fixed_vector::size()
+         */
+        static size_t size(const fixed_vector<T, N> &vec)
+        { return vec.size(); }
+    };
+}}}
@@ -0,0 +1,38 @@
+/** Helpers for writing JSON
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <ostream>
+#include <string>
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Write a string as a JSON string literal
+     *
+     * Quotes and backslashes are escaped, and other control characters are written as \\n, \\r, \\t or \\u00XX.
+     *
+     * @param out output stream
+     * @param str string to escape
+     */
+    inline void write_json_string(std::ostream& out, const std::string& str)
+    {
+        static const char hex[] = "0123456789abcdef";
+        out << '"';
+        for(size_t i=0;i<str.size();++i)
+        {
+            const char ch = str[i];
+            const unsigned char code = static_cast<unsigned char>(ch);
+            if(ch == '"' || ch == '\\') out << '\\' << ch;
+            else if(ch == '\n') out << "\\n";
+            else if(ch == '\r') out << "\\r";
+            else if(ch == '\t') out << "\\t";
+            else if(code < 0x20) out << "\\u00" << hex[code >> 4] << hex[code & 0xf];
+            else out << ch;
+        }
+        out << '"';
+    }
+}}}
@@ -0,0 +1,74 @@
+/** Output file mapped into memory
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+#include <string>
+#include "interop/util/cstdint.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Output file of known size mapped into memory for writing
+     *
+     * The file is created and its blocks are reserved with `posix_fallocate` before it is mapped, so data encoded
+     * into `data()` goes straight to the page cache without an intermediate stream buffer. If the blocks cannot be
+     * reserved, for example when the disk is full, the file is not mapped. Memory mapping is not supported on Windows
+     * or macOS, where `is_open` is always false. The caller should fall back to a stream whenever `is_open` is false.
+     */
+    class mapped_output_file
+    {
+    public:
+        /** Constructor
+         *
+         * @param filename path to the output file
+         * @param size number of bytes to map, must be greater than 0
+         */
+        mapped_output_file(const std::string& filename, const size_t size);
+        /** Destructor, unmaps the file at its mapped size */
+        ~mapped_output_file();
+
+    public:
+        /** Unmap and close the file
+         *
+         * @param size final size of the file, must not exceed the mapped size
+         * @return true if the file was closed without error
+         */
+        bool close(const size_t size);
+        /** Test if the file was created and mapped
+         *
+         * @return true if the file is mapped
+         */
+        bool is_open()const
+        {
+            return m_data != 0;
+        }
+        /** Get the start of the mapped bytes
+         *
+         * @return pointer to the mapped bytes
+         */
+        ::uint8_t* data()
+        {
+            return m_data;
+        }
+        /** Get the number of mapped bytes
+         *
+         * @return number of mapped bytes
+         */
+        size_t size()const
+        {
+            return m_size;
+        }
+
+    private:
+        mapped_output_file(const mapped_output_file&);
+        mapped_output_file& operator=(const mapped_output_file&);
+
+    private:
+        ::uint8_t* m_data;
+        size_t m_size;
+        int m_file;
+    };
+}}}
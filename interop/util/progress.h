@@ -0,0 +1,149 @@
+/** Progress reporting and cancellation for long running loads and reports
+ *
+ * A progress token is shared between the caller and a loader or report. The loader adds the bytes and records it
+ * has processed for each metric group, and checks the token at chunk boundaries. Another thread, such as a GUI timer,
+ * may poll the counts and cancel the token. A cancelled loader throws operation_cancelled_exception at its next
+ * check, and releases the memory it was filling as the exception unwinds.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include "interop/util/cstdint.h"
+#include "interop/constants/enums.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4290) // MSVC warns that it ignores the exception specification.
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Exception raised if an operation is cancelled with a progress token
+     *
+     * @ingroup interop_exceptions
+     */
+    struct operation_cancelled_exception : public std::runtime_error
+    {
+        /** Constructor
+         *
+         *  @param mesg error message
+         */
+        operation_cancelled_exception(const std::string &mesg) : std::runtime_error(mesg)
+        { }
+    };
+
+    class progress_token_impl;
+
+    /** Progress counts and cancellation flag shared with a long running operation
+     *
+     * The counts and the flag may be read and updated from any thread. They are atomic when built with C++11, and
+     * guarded by an OpenMP critical section when built with OpenMP alone. Without either, the library runs on a
+     * single thread, and the token must only be used from that thread.
+     */
+    class progress_token
+    {
+    public:
+        enum
+        {
+            /** Number of records decoded between checks of the token */
+            RecordChunk = 4096
+        };
+
+    public:
+        /** Constructor */
+        progress_token();
+        /** Destructor */
+        ~progress_token();
+
+    public:
+        /** Request that the operation stop at its next check
+         */
+        void cancel();
+        /** Test if the operation was cancelled
+         *
+         * @return true if cancel was called
+         */
+        bool is_cancelled()const;
+        /** Throw if the operation was cancelled
+         *
+         * @throws operation_cancelled_exception
+         */
+        void check()const throw(operation_cancelled_exception);
+        /** Add to the progress of a metric group, then throw if the operation was cancelled
+         *
+         * @param group metric group
+         * @param bytes number of bytes processed
+         * @param records number of records processed
+         * @throws operation_cancelled_exception
+         */
+        void update(const constants::metric_group group, const ::uint64_t bytes, const ::uint64_t records)
+        throw(operation_cancelled_exception);
+        /** Get the number of bytes processed for a metric group
+         *
+         * @param group metric group
+         * @return number of bytes
+         */
+        ::uint64_t bytes(const constants::metric_group group)const;
+        /** Get the number of records processed for a metric group
+         *
+         * @param group metric group
+         * @return number of records
+         */
+        ::uint64_t records(const constants::metric_group group)const;
+        /** Get the number of bytes processed for all metric groups
+         *
+         * @return number of bytes
+         */
+        ::uint64_t total_bytes()const;
+        /** Get the number of records processed for all metric groups
+         *
+         * @return number of records
+         */
+        ::uint64_t total_records()const;
+        /** Zero the counts and clear the cancellation flag
+         */
+        void reset();
+
+    private:
+        progress_token(const progress_token&);
+        progress_token& operator=(const progress_token&);
+
+    private:
+        progress_token_impl* m_impl;
+    };
+
+    /** Throw if an optional progress token was cancelled
+     *
+     * @param progress progress token, may be null
+     * @throws operation_cancelled_exception
+     */
+    inline void check_progress(const progress_token* progress) throw(operation_cancelled_exception)
+    {
+        if(progress != 0) progress->check();
+    }
+    /** Add to the progress of a metric group, then throw if an optional progress token was cancelled
+     *
+     * @param progress progress token, may be null
+     * @param group metric group
+     * @param bytes number of bytes processed
+     * @param records number of records processed
+     * @throws operation_cancelled_exception
+     */
+    inline void update_progress(progress_token* progress,
+                                const constants::metric_group group,
+                                const ::uint64_t bytes,
+                                const ::uint64_t records) throw(operation_cancelled_exception)
+    {
+        if(progress != 0) progress->update(group, bytes, records);
+    }
+}}}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -0,0 +1,31 @@
+/** Radix sort on 64-bit keys
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "interop/util/cstdint.h"
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Define a key paired with the offset of its value */
+    typedef std::pair< ::uint64_t, size_t > radix_key_t;
+    /** Define a vector of keys paired with the offsets of their values */
+    typedef std::vector<radix_key_t> radix_key_vector_t;
+
+    /** Sort keys with a stable least-significant-digit radix sort
+     *
+     * Each pass sorts on one byte of the key. Bytes that are equal in every key, e.g. the unused upper bits of a
+     * metric id, are skipped. Each pass is split over the given number of threads when the vector is large.
+     *
+     * @param keys keys paired with the offsets of their values
+     * @param thread_count number of threads to use
+     */
+    void radix_sort(radix_key_vector_t& keys, const size_t thread_count=1);
+}}}
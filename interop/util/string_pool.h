@@ -0,0 +1,55 @@
+/** Process-wide pool of interned strings
+ *
+ * Each distinct string is stored once and referred to by a 32-bit id. The ids never change, and a string is never
+ * removed from the pool, so an id may be resolved from any thread for the lifetime of the process. Id 0 is always
+ * the empty string.
+ *
+ * The pool is meant for small sets of strings that repeat across many records, such as the index sequences, sample
+ * ids and projects of the index metrics.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "interop/util/cstdint.h"
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Process-wide pool of interned strings
+     *
+     * Adding a string is guarded by a lock when built with C++11 or OpenMP. Resolving an id takes no lock, since the
+     * storage of a string never moves once it is added. Without C++11 or OpenMP, the library runs on a single thread,
+     * and the pool must only be used from that thread.
+     */
+    class string_pool
+    {
+    public:
+        /** Define an id type */
+        typedef ::uint32_t id_t;
+
+    public:
+        /** Add a string to the pool, if it is not already there
+         *
+         * @param str string
+         * @return id of the string
+         */
+        static id_t intern(const std::string& str);
+        /** Get the string with the given id
+         *
+         * @note the id must have been returned by intern
+         * @param id id of the string
+         * @return string
+         */
+        static const std::string& at(const id_t id);
+        /** Get the number of distinct strings in the pool
+         *
+         * @return number of strings, including the empty string
+         */
+        static size_t size();
+    };
+}}}
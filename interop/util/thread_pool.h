@@ -0,0 +1,157 @@
+/** Work-stealing thread pool with task groups
+ *
+ * When the library is built with C++11 thread support, each worker owns a queue of tasks: it runs its newest task
+ * first, and steals the oldest task of another queue when its own is empty. A thread waiting on a task group runs
+ * queued tasks until the group finishes, so tasks may create and wait on nested groups in the same pool.
+ *
+ * Without C++11 thread support, the tasks of a group run on OpenMP threads when the library is built with OpenMP.
+ * A nested group runs in order in the thread of the task that waits on it. Without OpenMP, the tasks of a group run
+ * in order in the thread that waits on it.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#pragma once
+
+#include <cstddef>
+
+/** Defined when the library runs tasks on std::thread workers */
+#if (defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#   define INTEROP_HAS_STD_THREAD
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+    class thread_pool_impl;
+    class task_group_state;
+
+    /** Unit of work run by a thread pool
+     */
+    class pool_task
+    {
+    public:
+        /** Destructor */
+        virtual ~pool_task(){}
+        /** Run the task
+         */
+        virtual void run() = 0;
+    };
+
+    /** Task that runs a copy of a functor
+     */
+    template<class Functor>
+    class functor_task : public pool_task
+    {
+    public:
+        /** Constructor
+         *
+         * @param func functor to copy
+         */
+        functor_task(const Functor& func) : m_func(func){}
+        /** Run the functor
+         */
+        void run()
+        {
+            m_func();
+        }
+
+    private:
+        Functor m_func;
+    };
+
+    /** Pool of worker threads shared by all task groups created on it
+     */
+    class thread_pool
+    {
+    public:
+        /** Constructor
+         *
+         * The thread waiting on a task group also runs tasks, so the pool starts one fewer worker than the given
+         * thread count.
+         *
+         * @param thread_count number of threads that run tasks
+         */
+        explicit thread_pool(const size_t thread_count=1);
+        /** Destructor
+         *
+         * Stops and joins the workers.
+         */
+        ~thread_pool();
+
+    public:
+        /** Get the number of threads that run tasks
+         *
+         * @return number of threads
+         */
+        size_t thread_count()const;
+        /** Test if tasks may run on worker threads
+         *
+         * @return true if the library was built with C++11 thread support or OpenMP
+         */
+        static bool supports_threads();
+        /** Get the index of the worker running the current thread
+         *
+         * @return index of the worker, or 0 if the current thread is not a worker
+         */
+        static size_t current_worker();
+
+    private:
+        thread_pool(const thread_pool&);
+        thread_pool& operator=(const thread_pool&);
+
+    private:
+        thread_pool_impl* m_impl;
+        friend class task_group;
+    };
+
+    /** Group of tasks that are waited on together
+     *
+     * If a task throws, tasks of the group that have not started are skipped, and wait() rethrows the first
+     * exception. Without C++11 thread support, an exception thrown on an OpenMP thread is rethrown as a copy: the
+     * exceptions of the library and the standard library keep their type, and any other exception is rethrown as
+     * std::runtime_error with the same message.
+     */
+    class task_group
+    {
+    public:
+        /** Constructor
+         *
+         * @param pool pool that runs the tasks
+         */
+        explicit task_group(thread_pool& pool);
+        /** Destructor
+         *
+         * Waits for every task of the group, and discards any exception.
+         */
+        ~task_group();
+
+    public:
+        /** Queue a copy of a functor to run on the pool
+         *
+         * @param func functor to run
+         */
+        template<class Functor>
+        void run(const Functor& func)
+        {
+            submit(new functor_task<Functor>(func));
+        }
+        /** Wait for every task of the group, running queued tasks while waiting
+         *
+         * @throws the first exception thrown by a task of the group
+         */
+        void wait();
+
+    private:
+        void submit(pool_task* task);
+
+    private:
+        task_group(const task_group&);
+        task_group& operator=(const task_group&);
+
+    private:
+        thread_pool& m_pool;
+        task_group_state* m_state;
+    };
+}}}
@@ -23,4 +23,30 @@ namespace illumina { namespace interop { namespace util
 
     };
 
+    /** Get the elapsed wall clock time in seconds from an arbitrary, fixed starting point
+     *
+     * Unlike `std::clock`, this measures real time, so it includes time spent waiting on IO and is not inflated by
+     * work done on other threads. Only the difference between two calls is meaningful.
+     *
+     * @return time in seconds
+     */
+    double wall_time();
+
+    /** Measure the wall clock time spent in a scope
+     */
+    class scoped_wall_timer
+    {
+    public:
+        /** Constructor
+         *
+         * @param duration destination for the elapsed time in seconds, set on destruction
+         */
+        scoped_wall_timer(double& duration) : m_start(wall_time()), m_duration(duration){}
+        /** Destructor */
+        ~scoped_wall_timer(){m_duration = wall_time()-m_start;}
+    private:
+        double m_start;
+        double& m_duration;
+    };
+
 }}}
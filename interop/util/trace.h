@@ -0,0 +1,215 @@
+/** Opt-in wall clock instrumentation of named stages
+ *
+ * Loading, finalizing, summarizing, plotting and tabulating a run each record a span when tracing is enabled. A span
+ * holds the wall time of the stage along with the bytes read, records decoded and memory allocated for the results.
+ * The spans can be copied out for inspection, or exported as Chrome trace JSON (open in `chrome://tracing` or
+ * Perfetto).
+ *
+ * Tracing is disabled by default, in which case each stage costs a single flag check.
+ *
+ * Spans may be recorded from any thread when built with C++11 or OpenMP. Without either, the library runs on a single
+ * thread, and tracing must only be used from that thread.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include "interop/util/cstdint.h"
+#include "interop/util/timer.h"
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Wall time and work done by a single stage
+     */
+    struct trace_event
+    {
+        /** Constructor
+         *
+         * @param event_name name of the stage
+         * @param event_category category of the stage
+         * @param thread thread that ran the stage
+         * @param start start time in seconds since tracing was enabled
+         * @param duration wall time in seconds
+         */
+        trace_event(const std::string& event_name="",
+                    const std::string& event_category="",
+                    const size_t thread=0,
+                    const double start=0,
+                    const double duration=0) :
+                name(event_name),
+                category(event_category),
+                thread_id(thread),
+                start_seconds(start),
+                duration_seconds(duration),
+                bytes(0),
+                records(0),
+                allocations(0),
+                allocated_bytes(0)
+        {}
+        /** Name of the stage */
+        std::string name;
+        /** Category of the stage, e.g. io, finalize, summary, plot or table */
+        std::string category;
+        /** Id of the thread that ran the stage, distinct for each thread */
+        size_t thread_id;
+        /** Start time in seconds since tracing was enabled */
+        double start_seconds;
+        /** Wall time in seconds */
+        double duration_seconds;
+        /** Number of bytes read */
+        ::uint64_t bytes;
+        /** Number of records decoded or produced */
+        ::uint64_t records;
+        /** Number of allocations made for the results */
+        ::uint64_t allocations;
+        /** Number of bytes allocated for the results */
+        ::uint64_t allocated_bytes;
+    };
+    /** Vector of trace events */
+    typedef std::vector<trace_event> trace_event_vector;
+
+    /** Enable or disable tracing
+     *
+     * Enabling tracing resets the time origin of new events, but does not clear existing events.
+     *
+     * @param enable true to record events
+     */
+    void enable_tracing(const bool enable=true);
+    /** Test if tracing is enabled
+     *
+     * @return true if events are being recorded
+     */
+    bool is_tracing_enabled();
+    /** Remove all recorded events
+     */
+    void clear_trace();
+    /** Get the number of recorded events
+     *
+     * @return number of events
+     */
+    size_t trace_event_count();
+    /** Copy the recorded events
+     *
+     * @param events destination vector
+     */
+    void copy_trace_events(trace_event_vector& events);
+    /** Record an event
+     *
+     * This function is thread safe.
+     *
+     * @param event trace event
+     */
+    void record_trace_event(const trace_event& event);
+    /** Write the recorded events in the Chrome trace event format
+     *
+     * @param out output stream
+     */
+    void write_chrome_trace(std::ostream& out);
+    /** Get the recorded events in the Chrome trace event format
+     *
+     * @return JSON string
+     */
+    std::string chrome_trace();
+
+    /** Record a span covering the lifetime of this object
+     *
+     * When tracing is disabled, this only checks a flag on construction.
+     *
+     * @code
+     * util::scoped_trace trace("summarize_run_metrics", "summary");
+     * ...
+     * trace.add_records(record_count);
+     * @endcode
+     */
+    class scoped_trace
+    {
+    public:
+        /** Constructor
+         *
+         * @param name name of the stage (must outlive this object)
+         * @param category category of the stage (must outlive this object)
+         * @param detail optional detail appended to the name, e.g. the metric prefix (must outlive this object)
+         * @param detail_suffix optional suffix appended to the detail, e.g. the metric suffix (must outlive this object)
+         */
+        scoped_trace(const char* name,
+                     const char* category="interop",
+                     const char* detail=0,
+                     const char* detail_suffix=0) :
+                m_active(is_tracing_enabled()),
+                m_name(name),
+                m_category(category),
+                m_detail(detail),
+                m_detail_suffix(detail_suffix),
+                m_start(m_active ? wall_time() : 0),
+                m_bytes(0),
+                m_records(0),
+                m_allocations(0),
+                m_allocated_bytes(0)
+        {}
+        /** Destructor, records the span if tracing was enabled on construction
+         */
+        ~scoped_trace()
+        {
+            if(m_active) finish();
+        }
+
+    public:
+        /** Test if this span will be recorded
+         *
+         * @return true if tracing was enabled on construction
+         */
+        bool is_active()const
+        {
+            return m_active;
+        }
+        /** Add to the number of bytes read
+         *
+         * @param count number of bytes
+         */
+        void add_bytes(const ::uint64_t count)
+        {
+            m_bytes += count;
+        }
+        /** Add to the number of records decoded or produced
+         *
+         * @param count number of records
+         */
+        void add_records(const ::uint64_t count)
+        {
+            m_records += count;
+        }
+        /** Record an allocation made for the results
+         *
+         * @param byte_count number of bytes allocated
+         */
+        void add_allocation(const ::uint64_t byte_count)
+        {
+            if(byte_count == 0) return;
+            ++m_allocations;
+            m_allocated_bytes += byte_count;
+        }
+
+    private:
+        void finish();
+        scoped_trace(const scoped_trace&);
+        scoped_trace& operator=(const scoped_trace&);
+
+    private:
+        bool m_active;
+        const char* m_name;
+        const char* m_category;
+        const char* m_detail;
+        const char* m_detail_suffix;
+        double m_start;
+        ::uint64_t m_bytes;
+        ::uint64_t m_records;
+        ::uint64_t m_allocations;
+        ::uint64_t m_allocated_bytes;
+    };
+}}}
@@ -0,0 +1 @@
+#define INTEROP_VERSION "v1.0.16-src"
@@ -0,0 +1,105 @@
+/** @page convert_run Rewrite a run folder in the latest InterOp versions
+ *
+ * This application rewrites the InterOp files of one or more run folders in the newest format versions that keep
+ * all of their data, so archived runs load without the legacy code paths, e.g. the q-score binning of version 4
+ * q-metrics. Each file is streamed record by record into a temporary file, which then replaces the original.
+ *
+ * ### Running the Program
+ *
+ * The program runs as follows:
+ *
+ *      $ convert_run --threads=8 140131_1287_0851_A01n401drr
+ *
+ * Each InterOp file found is listed with its version before and after conversion, e.g.
+ *
+ *      # Version: v1.0.19
+ *      # Run Folder: 140131_1287_0851_A01n401drr
+ *      Filename,Source,Target,Records
+ *      140131_1287_0851_A01n401drr/InterOp/QMetricsOut.bin,4,7,1372
+ *      140131_1287_0851_A01n401drr/InterOp/ExtractionMetricsOut.bin,2,2,0
+ *
+ * Files that are already in their latest lossless version are left untouched and report 0 records.
+ *
+ * ### Command line options
+ *
+ *      --threads=n (where `n` is an integer greater than 0)
+ *          Number of files converted at the same time.
+ */
+
+#include <iostream>
+#include "interop/io/convert_run.h"
+#include "interop/util/filesystem.h"
+#include "interop/util/option_parser.h"
+#include "interop/version.h"
+#include "inc/application.h"
+
+using namespace illumina::interop;
+
+int main(int argc, const char** argv)
+{
+    size_t thread_count = 4;
+    util::option_parser description;
+    description
+            (thread_count, "threads", "Number of files converted at the same time");
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [run_folder2 ...] [--option1=value1]" << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try
+    {
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    if(argc < 2)
+    {
+        std::cerr << "No run folder specified" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::cout << "# Version: " << INTEROP_VERSION << std::endl;
+
+    for(int i=1;i<argc;++i)
+    {
+        std::cout << "# Run Folder: " << argv[i] << std::endl;
+        io::converted_interop_vector converted;
+        try
+        {
+            io::convert_run(argv[i], converted, thread_count);
+        }
+        catch(const xml::xml_file_not_found_exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return MISSING_RUNINFO_XML;
+        }
+        catch(const xml::xml_parse_exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return MALFORMED_XML;
+        }
+        catch(const io::bad_format_exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return BAD_FORMAT;
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            return UNEXPECTED_EXCEPTION;
+        }
+        std::cout << "Filename,Source,Target,Records" << std::endl;
+        for(size_t j=0;j<converted.size();++j)
+        {
+            std::cout << converted[j].filename << ","
+                      << converted[j].source_version << ","
+                      << converted[j].target_version << ","
+                      << converted[j].record_count << std::endl;
+        }
+    }
+    return SUCCESS;
+}
@@ -191,7 +191,7 @@ int copy_tile_metrics(const std::string& input, const std::string& output, const
 
     std::cout << io::interop_basename<tile_metric_set_t>() << ": " << metrics.version() << std::endl;
     try {
-        io::write_interop(output, metrics);
+        io::write_interop_mapped(output, metrics);
     }
     catch(const io::file_not_found_exception& ex)
     {
@@ -220,7 +220,7 @@ int copy_tile_metrics(const std::string& input, const std::string& output, const
 
     tile_metric_set_t metrics_out(subset, metrics.version(), metrics);
     try {
-        io::write_interop(output, metrics_out);
+        io::write_interop_mapped(output, metrics_out);
     }
     catch(const io::file_not_found_exception& ex)
     {
@@ -271,7 +271,7 @@ int copy_cycle_metrics(const std::string& input, const std::string& output, cons
 
     MetricSet metrics_out(subset, metrics.version(), metrics);
     try {
-        io::write_interop(output, metrics_out);
+        io::write_interop_mapped(output, metrics_out);
     }
     catch(const io::file_not_found_exception& ex)
     {
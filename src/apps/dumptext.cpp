@@ -110,6 +110,11 @@
  *
  *      --subset=n (where `n` is an integer greater than 0)
  *          This option selects the first `n` records and displays only those.
+ *      --stream=1
+ *          This option decodes each InterOp file one record at a time and writes each record as soon as it is read,
+ *          so memory use does not grow with the size of the files. Records are written as stored in the files, so
+ *          legacy Q-metrics are not binned and metrics derived after loading, such as Q-metrics by lane, are only
+ *          written when their own files exist. It cannot be combined with `--subset`.
  */
 
 #include <iostream>
@@ -148,6 +153,94 @@ private:
     std::vector<std::string> m_channel_names;
 
 };
+/** Call back functor for streaming the InterOp files of a run to the output stream as text
+ */
+struct metric_streamer
+{
+    /** Constructor
+     *
+     * @param run_folder run folder path
+     * @param out output stream
+     * @param channels list of channel names
+     * @param last_cycle last cycle to check for by cycle files
+     */
+    metric_streamer(const std::string& run_folder,
+                    std::ostream& out,
+                    const std::vector<std::string>& channels,
+                    const size_t last_cycle) :
+            m_run_folder(run_folder),
+            m_out(out),
+            m_channel_names(channels),
+            m_last_cycle(last_cycle)
+    {}
+    /** Function operator overload to stream data
+     *
+     * @param metrics scratch set of metrics
+     */
+    template<class MetricSet>
+    void operator()(MetricSet& metrics)const
+    {
+        try
+        {
+            io::stream_interop_text(m_run_folder, m_out, metrics, m_channel_names, m_last_cycle);
+        }
+        catch(const io::file_not_found_exception&){}
+        catch(const io::incomplete_file_exception&){}
+    }
+private:
+    std::string m_run_folder;
+    std::ostream& m_out;
+    std::vector<std::string> m_channel_names;
+    size_t m_last_cycle;
+};
+/** Stream the InterOp files of a run to the output stream as text
+ *
+ * @param run_folder run folder path
+ * @param out output stream
+ * @return exit code
+ */
+int stream_run_metrics(const char* run_folder, std::ostream& out)
+{
+    run_metrics run;
+    try
+    {
+        run.read_run_info(run_folder);
+        run.read_run_parameters(run_folder);
+        if(run.run_info().channels().empty())
+            run.legacy_channel_update(run.run_parameters().instrument_type());
+    }
+    catch(const xml::xml_file_not_found_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return MISSING_RUNINFO_XML;
+    }
+    catch(const xml::xml_parse_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return MALFORMED_XML;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return UNEXPECTED_EXCEPTION;
+    }
+    metric_streamer stream_metrics(run_folder, out, run.run_info().channels(), run.run_info().total_cycles());
+    try
+    {
+        run.metrics_callback(stream_metrics);
+    }
+    catch (const io::bad_format_exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return BAD_FORMAT;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return UNEXPECTED_EXCEPTION;
+    }
+    return SUCCESS;
+}
 /** Copy of subset of metrics
  */
 struct subset_copier
@@ -192,9 +285,11 @@ int main(int argc, const char** argv)
     std::cout << "# Version: " << INTEROP_VERSION << std::endl;
 
     size_t subset_count=0;
+    int stream_records=0;
     util::option_parser description;
     description
-            (subset_count, "subset", "Number of metrics to subsample");
+            (subset_count, "subset", "Number of metrics to subsample")
+            (stream_records, "stream", "Write each record as it is decoded, without loading the run");
     if(description.is_help_requested(argc, argv))
     {
         std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
@@ -210,9 +305,21 @@ int main(int argc, const char** argv)
         std::cerr << ex.what() << std::endl;
         return INVALID_ARGUMENTS;
     }
+    if(stream_records != 0 && subset_count > 0)
+    {
+        std::cerr << "--stream cannot be combined with --subset" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
 
     for(int i=1;i<argc;i++)
     {
+        if(stream_records != 0)
+        {
+            const int ret = stream_run_metrics(argv[i], std::cout);
+            if(ret != SUCCESS) return ret;
+            std::cout << eol << std::endl;
+            continue;
+        }
         run_metrics run;
         int ret = read_run_metrics(argv[i], run, thread_count);
         if(ret != SUCCESS) return ret;
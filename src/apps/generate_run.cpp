@@ -0,0 +1,141 @@
+/** @page generate_run Generate a synthetic run folder
+ *
+ * This developer application writes a synthetic run folder of any size, including RunInfo.xml and the Tile, Error,
+ * Extraction, Image, CorrectedInt, Q, Index and EmpiricalPhasing InterOp files. The records are streamed directly to
+ * disk, so the size of the run is limited only by disk space.
+ *
+ * ### Running the Program
+ *
+ * The program runs as follows:
+ *
+ *      $ generate_run --lanes=8 --tiles=50 --cycles=318 --threads=8 /tmp/synthetic_run
+ *
+ * The flowcell, reads and channels can instead be copied from an existing RunInfo.xml:
+ *
+ *      $ generate_run --run-info=140131_1287_0851_A01n401drr/RunInfo.xml /tmp/synthetic_run
+ *
+ * The same seed always produces the same InterOp files. Use `--by-cycle=1` to write each cycle into its own
+ * `InterOp/C#.1` folder, as during a run.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include "interop/util/filesystem.h"
+#include "interop/util/option_parser.h"
+#include "interop/util/timer.h"
+#include "interop/io/synthetic_run.h"
+#include "interop/version.h"
+#include "inc/application.h"
+
+using namespace illumina::interop;
+
+int main(int argc, const char** argv)
+{
+    size_t lane_count = 8;
+    size_t surface_count = 2;
+    size_t swath_count = 2;
+    size_t tile_count = 14;
+    size_t cycle_count = 318;
+    size_t channel_count = 2;
+    std::string run_info_template;
+    io::synthetic_run_options options;
+    options.thread_count = 4;
+    util::option_parser description;
+    description
+            (run_info_template, "run-info", "Copy the flowcell, reads and channels from this RunInfo.xml")
+            (lane_count, "lanes", "Number of lanes")
+            (surface_count, "surfaces", "Number of surfaces (1 or 2)")
+            (swath_count, "swaths", "Number of swaths per surface")
+            (tile_count, "tiles", "Number of tiles per swath")
+            (cycle_count, "cycles", "Total number of cycles")
+            (channel_count, "channels", "Number of image channels")
+            (options.bin_count, "bins", "Number of q-score bins, 0 for unbinned")
+            (options.sample_count, "samples", "Number of samples in the index metrics")
+            (options.seed, "seed", "Seed for the random number generator")
+            (options.by_cycle, "by-cycle", "Write each cycle into its own InterOp/C#.1 folder (0 or 1)")
+            (options.thread_count, "threads", "Number of threads used to write the metric groups");
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try
+    {
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    if(argc != 2)
+    {
+        std::cerr << "Expected a single run folder to generate" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::cout << "# Version: " << INTEROP_VERSION << std::endl;
+
+    model::run::info run_info;
+    try
+    {
+        if(run_info_template.empty())
+        {
+            run_info = io::synthetic_run_info(lane_count,
+                                              surface_count,
+                                              swath_count,
+                                              tile_count,
+                                              cycle_count,
+                                              channel_count);
+        }
+        else run_info.read(run_info_template);
+    }
+    catch(const xml::xml_file_not_found_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return MISSING_RUNINFO_XML;
+    }
+    catch(const xml::xml_parse_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return MALFORMED_XML;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+
+    const std::string run_folder = argv[1];
+    std::cout << "# Run Folder: " << run_folder << std::endl;
+    double duration = 0;
+    ::uint64_t byte_count;
+    try
+    {
+        util::scoped_wall_timer timer(duration);
+        byte_count = io::write_synthetic_run(run_folder, run_info, options);
+    }
+    catch(const model::invalid_parameter& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    catch(const model::invalid_channel_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << "Error: Unable to write InterOp files" << std::endl;
+        std::cerr << ex.what() << std::endl;
+        return UNEXPECTED_EXCEPTION;
+    }
+    const double megabytes = static_cast<double>(byte_count) / (1024.0 * 1024.0);
+    std::cout << "# Bytes: " << byte_count << std::endl;
+    std::cout << "# Seconds: " << std::fixed << std::setprecision(3) << duration << std::endl;
+    std::cout << "# MB/s: " << std::fixed << std::setprecision(1) << (duration > 0 ? megabytes / duration : 0)
+              << std::endl;
+    return SUCCESS;
+}
@@ -9,6 +9,7 @@
  */
 #pragma once
 #include "interop/model/run_metrics.h"
+#include "interop/logic/summary/batch_summary.h"
 
 
 /** Exit codes that can be produced by the application
@@ -132,3 +133,28 @@ inline int read_run_metrics(const char* filename,
 // @ [Reading a subset of run metrics in C++]
     return SUCCESS;
 }
+/** Convert the error of a run in a batch to an exit code
+ *
+ * @param error_type reason a run in a batch could not be summarized
+ * @return exit code
+ */
+inline int batch_exit_code(const illumina::interop::logic::summary::batch_error_type error_type)
+{
+    using namespace illumina::interop::logic::summary;
+    switch(error_type)
+    {
+        case BatchSuccess:
+            return SUCCESS;
+        case BatchMissingRunInfo:
+            return MISSING_RUNINFO_XML;
+        case BatchMalformedXml:
+            return MALFORMED_XML;
+        case BatchBadFormat:
+            return BAD_FORMAT;
+        case BatchEmptyInterOp:
+            return EMPTY_INTEROP;
+        default:
+            return UNEXPECTED_EXCEPTION;
+    }
+}
+
@@ -21,6 +21,13 @@
  *      2               WU_1_spike      NA              AAGAGGCA        ACTGCATA        1.5316
  *      ...
  *
+ * Any number of run folders may be given. They are loaded and summarized concurrently, yet printed in the order given,
+ * each as soon as it and the run folders before it are summarized:
+ *
+ *      $ index-summary --threads=8 --max-resident=4 run_folder1 run_folder2 ...
+ *
+ * Here 8 threads are shared by the batch, and at most 4 runs are held in memory at once.
+ *
  * The InterOp sub folder may contain any of the following files:
  *
  *  - IndexMetricsOut.bin
@@ -39,6 +46,9 @@
  *      2. The InterOp files do not contain valid data
  *
  *  A missing InterOp file will be silently ignored. Incomplete InterOp files are also ignored.
+ *
+ *  A run folder that cannot be summarized does not stop the remaining run folders; the error code of the first
+ *  such run folder is returned.
  */
 
 
@@ -46,6 +56,7 @@
 #include <iomanip>
 #include "interop/io/metric_file_stream.h"
 #include "interop/logic/summary/index_summary.h"
+#include "interop/logic/summary/batch_summary.h"
 #include "interop/util/option_parser.h"
 #include "interop/version.h"
 #include "inc/application.h"
@@ -64,6 +75,53 @@ using namespace illumina::interop;
  */
 void print_summary(std::ostream& out, const index_flowcell_summary& summary, const bool csv_format);
 
+/** Print the index summary of each run as soon as it and the runs before it are summarized
+ */
+class print_index_summary_listener : public batch_summary_listener
+{
+public:
+    /** Constructor
+     *
+     * @param csv_format format output as CSV only
+     */
+    print_index_summary_listener(const bool csv_format) : m_csv_format(csv_format), m_exit_code(SUCCESS){}
+    /** Print the index summary of a run
+     *
+     * @param result result of the run
+     */
+    void run_summarized(const batch_summary_result& result)
+    {
+        if(m_exit_code == UNEXPECTED_EXCEPTION) return;
+        if(!result.is_valid())
+        {
+            std::cerr << result.error_message << std::endl;
+            if(m_exit_code == SUCCESS) m_exit_code = batch_exit_code(result.error_type);
+            return;
+        }
+        try
+        {
+            print_summary(std::cout, result.index_summary, m_csv_format);
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            m_exit_code = UNEXPECTED_EXCEPTION;
+        }
+    }
+    /** Get the exit code of the program
+     *
+     * @return error code of the first run that could not be summarized or printed, otherwise SUCCESS
+     */
+    int exit_code()const
+    {
+        return m_exit_code;
+    }
+
+private:
+    bool m_csv_format;
+    int m_exit_code;
+};
+
 int main(int argc, const char** argv)
 {
     if(argc == 0)
@@ -72,15 +130,18 @@ int main(int argc, const char** argv)
         //print_help(std::cout);
         return INVALID_ARGUMENTS;
     }
-    const size_t thread_count = 1;
+    size_t thread_count = 1;
+    size_t max_resident_runs = 0;
     int csv_format = 0;
 
     util::option_parser description;
     description
-            (csv_format, "csv", "Format output as CSV only");
+            (csv_format, "csv", "Format output as CSV only")
+            (thread_count, "threads", "Number of threads shared by all the runs")
+            (max_resident_runs, "max-resident", "Maximum number of runs held in memory at once, 0 for one per thread");
     if(description.is_help_requested(argc, argv))
     {
-        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [run_folder2 ...] [--option1=value1] [--option2=value2]" << std::endl;
         description.display_help(std::cout);
         return SUCCESS;
     }
@@ -95,36 +156,15 @@ int main(int argc, const char** argv)
         return INVALID_ARGUMENTS;
     }
 
-    std::vector<unsigned char> valid_to_load;
-    logic::utils::list_index_metrics_to_load(valid_to_load); // Only load the InterOp files required
+    batch_summary_options options(thread_count, max_resident_runs);
+    options.summarize_runs = false;
+    options.summarize_index = true;
+    std::vector<std::string> run_folders(argv+1, argv+argc);
+    batch_summary_result_vector results;
+    print_index_summary_listener listener(csv_format > 0);
     std::cout << "# Version: " << INTEROP_VERSION << std::endl;
-    for(int i=1;i<argc;i++)
-    {
-        run_metrics run;
-        int ret = read_run_metrics(argv[i], run, valid_to_load, thread_count);
-        if (ret != SUCCESS) return ret;
-        index_flowcell_summary summary;
-        try
-        {
-            summarize_index_metrics(run, summary);
-        }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            return UNEXPECTED_EXCEPTION;
-        }
-        summary.sort();
-        try
-        {
-            print_summary(std::cout, summary, csv_format > 0);
-        }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            return UNEXPECTED_EXCEPTION;
-        }
-    }
-    return SUCCESS;
+    summarize_run_batch(run_folders, results, options, &listener);
+    return listener.exit_code();
 }
 
 /** Take a collection of strings and print them using a fixed width
@@ -0,0 +1,1021 @@
+/** @page interop_server Serve summary, plot and table requests from resident runs
+ *
+ * This application keeps loaded runs resident in memory and answers summary, plot and table requests over a UNIX
+ * domain socket. A dashboard can query the same runs repeatedly without paying to reload and finalize them each
+ * time.
+ *
+ * ### Running the Program
+ *
+ * The program runs as follows:
+ *
+ *      $ interop_server --socket=/tmp/interop.sock --memory-budget=4096 --threads=4
+ *
+ * The server runs until it is interrupted with SIGINT or SIGTERM. The `shutdown` request also stops the server, but
+ * only if the server was started with `--allow-shutdown=1`, since any local client may connect to the socket.
+ *
+ * The server refuses to start if another server is listening on the socket. A socket file left behind by a server
+ * that is no longer running is replaced.
+ *
+ * ### Protocol
+ *
+ * A client connects to the socket and sends one request per line. Each request is a command followed by its
+ * arguments, separated by spaces. Arguments containing spaces may be enclosed in double quotes. The server answers
+ * each request with a single line of JSON, and the connection stays open for further requests. Clients are answered
+ * in turn, one request each, on `--threads` threads, so a client that stays connected does not block others.
+ * Requests that read resident runs are answered at the same time, while a request that loads, refreshes or evicts a
+ * run waits for them and then runs alone.
+ *
+ *      summary <run_folder>
+ *      index-summary <run_folder>
+ *      plot-by-cycle <run_folder> --metric-name=Intensity [--filter-by-lane=1] ...
+ *      plot-by-lane <run_folder> --metric-name=Density [--filter-by-read=1] ...
+ *      plot-flowcell <run_folder> --metric-name=Intensity [--filter-by-cycle=1] ...
+ *      imaging-table <run_folder>
+ *      refresh <run_folder>
+ *      evict <run_folder>
+ *      status
+ *      shutdown
+ *
+ * The plot commands accept the same options as the `plot_by_cycle`, `plot_by_lane` and `plot_flowcell` programs.
+ * A successful response has `"status": "ok"`. A failed request has `"status": "error"` and a `"message"`, and the
+ * server continues to serve other requests.
+ *
+ * ### Caching
+ *
+ * Each run is loaded in full on first use. Before a resident run answers a request, its InterOp files are checked for
+ * changes at most once per `--refresh-interval` seconds, and only the metric groups whose files changed are reloaded.
+ * When the estimated memory of the resident runs exceeds `--memory-budget` megabytes, the least recently used runs
+ * are evicted.
+ */
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include "interop/io/run_cache.h"
+#include "interop/logic/summary/run_summary.h"
+#include "interop/logic/summary/index_summary.h"
+#include "interop/logic/plot/plot_by_cycle.h"
+#include "interop/logic/plot/plot_by_lane.h"
+#include "interop/logic/plot/plot_flowcell_map.h"
+#include "interop/logic/table/create_imaging_table.h"
+#include "interop/util/json.h"
+#include "interop/util/thread_pool.h"
+#include "interop/version.h"
+#include "inc/application.h"
+#include "inc/plot_options.h"
+
+#if defined(INTEROP_HAS_STD_THREAD)
+#include <condition_variable>
+#include <mutex>
+#elif defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#ifndef WIN32
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace illumina::interop;
+
+/** Longest request line accepted by the server */
+static const size_t MAX_REQUEST_SIZE = 65536;
+/** Seconds a response may wait on a client that does not read it */
+static const int SEND_TIMEOUT_SECONDS = 10;
+/** Microseconds to wait before accepting again when out of descriptors or memory */
+static const unsigned int ACCEPT_BACKOFF_MICROSECONDS = 100000;
+
+/** Split a request line into tokens separated by spaces
+ *
+ * A token enclosed in double quotes may contain spaces.
+ *
+ * @param line request line
+ * @param tokens destination tokens
+ */
+static void split_request(const std::string& line, std::vector<std::string>& tokens)
+{
+    tokens.clear();
+    size_t i = 0;
+    while(i < line.size())
+    {
+        while(i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+        if(i >= line.size()) break;
+        std::string token;
+        if(line[i] == '"')
+        {
+            ++i;
+            while(i < line.size() && line[i] != '"') token += line[i++];
+            ++i;
+        }
+        else
+        {
+            while(i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') token += line[i++];
+        }
+        tokens.push_back(token);
+    }
+}
+
+/** Write a floating point number as JSON, where NaN and infinity become null
+ *
+ * @param out output stream
+ * @param value number to write
+ */
+static void write_json_number(std::ostream& out, const float value)
+{
+    if(value != value || value > std::numeric_limits<float>::max() || value < -std::numeric_limits<float>::max())
+        out << "null";
+    else
+        out << value;
+}
+/** Write the mean, standard deviation and median of a statistic
+ *
+ * @param out output stream
+ * @param name name of the statistic
+ * @param stat statistic
+ */
+static void write_json_stat(std::ostream& out, const char* name, const model::summary::metric_stat& stat)
+{
+    out << ", \"" << name << "\": [";
+    write_json_number(out, stat.mean());
+    out << ", ";
+    write_json_number(out, stat.stddev());
+    out << ", ";
+    write_json_number(out, stat.median());
+    out << "]";
+}
+/** Write the totals of a metric summary
+ *
+ * @param out output stream
+ * @param summary metric summary
+ */
+static void write_json_metric_summary(std::ostream& out, const model::summary::metric_summary& summary)
+{
+    out << "{\"yield_g\": ";
+    write_json_number(out, summary.yield_g());
+    out << ", \"projected_yield_g\": ";
+    write_json_number(out, summary.projected_yield_g());
+    out << ", \"percent_aligned\": ";
+    write_json_number(out, summary.percent_aligned());
+    out << ", \"error_rate\": ";
+    write_json_number(out, summary.error_rate());
+    out << ", \"first_cycle_intensity\": ";
+    write_json_number(out, summary.first_cycle_intensity());
+    out << ", \"percent_gt_q30\": ";
+    write_json_number(out, summary.percent_gt_q30());
+    out << "}";
+}
+/** Write a run summary, with each lane statistic as [mean, stddev, median]
+ *
+ * @param out output stream
+ * @param summary run summary
+ */
+static void write_json(std::ostream& out, const model::summary::run_summary& summary)
+{
+    out << "{\"total\": ";
+    write_json_metric_summary(out, summary.total_summary());
+    out << ", \"nonindex\": ";
+    write_json_metric_summary(out, summary.nonindex_summary());
+    out << ", \"reads\": [";
+    for(size_t read=0;read<summary.size();++read)
+    {
+        const model::summary::read_summary& read_summary = summary[read];
+        out << (read == 0 ? "" : ", ") << "{\"number\": " << read_summary.read().number()
+            << ", \"is_index\": " << (read_summary.read().is_index() ? "true" : "false")
+            << ", \"summary\": ";
+        write_json_metric_summary(out, read_summary.summary());
+        out << ", \"lanes\": [";
+        for(size_t lane=0;lane<read_summary.size();++lane)
+        {
+            const model::summary::lane_summary& lane_summary = read_summary[lane];
+            out << (lane == 0 ? "" : ", ") << "{\"lane\": " << lane_summary.lane()
+                << ", \"tile_count\": " << lane_summary.tile_count() << ", \"reads\": ";
+            write_json_number(out, lane_summary.reads());
+            out << ", \"reads_pf\": ";
+            write_json_number(out, lane_summary.reads_pf());
+            out << ", \"yield_g\": ";
+            write_json_number(out, lane_summary.yield_g());
+            out << ", \"projected_yield_g\": ";
+            write_json_number(out, lane_summary.projected_yield_g());
+            out << ", \"percent_gt_q30\": ";
+            write_json_number(out, lane_summary.percent_gt_q30());
+            write_json_stat(out, "density", lane_summary.density());
+            write_json_stat(out, "density_pf", lane_summary.density_pf());
+            write_json_stat(out, "cluster_count", lane_summary.cluster_count());
+            write_json_stat(out, "cluster_count_pf", lane_summary.cluster_count_pf());
+            write_json_stat(out, "percent_pf", lane_summary.percent_pf());
+            write_json_stat(out, "phasing", lane_summary.phasing());
+            write_json_stat(out, "prephasing", lane_summary.prephasing());
+            write_json_stat(out, "percent_aligned", lane_summary.percent_aligned());
+            write_json_stat(out, "error_rate", lane_summary.error_rate());
+            write_json_stat(out, "first_cycle_intensity", lane_summary.first_cycle_intensity());
+            out << "}";
+        }
+        out << "]}";
+    }
+    out << "]}";
+}
+/** Write an index summary
+ *
+ * @param out output stream
+ * @param summary index flowcell summary
+ */
+static void write_json(std::ostream& out, const model::summary::index_flowcell_summary& summary)
+{
+    out << "{\"lanes\": [";
+    for(size_t lane=0;lane<summary.size();++lane)
+    {
+        const model::summary::index_lane_summary& lane_summary = summary[lane];
+        out << (lane == 0 ? "" : ", ") << "{\"lane\": " << lane+1
+            << ", \"total_reads\": " << lane_summary.total_reads()
+            << ", \"total_pf_reads\": " << lane_summary.total_pf_reads()
+            << ", \"fraction_mapped\": ";
+        write_json_number(out, lane_summary.total_fraction_mapped_reads());
+        out << ", \"cv\": ";
+        write_json_number(out, lane_summary.mapped_reads_cv());
+        out << ", \"min\": ";
+        write_json_number(out, lane_summary.min_mapped_reads());
+        out << ", \"max\": ";
+        write_json_number(out, lane_summary.max_mapped_reads());
+        out << ", \"samples\": [";
+        for(size_t i=0;i<lane_summary.size();++i)
+        {
+            const model::summary::index_count_summary& count = lane_summary[i];
+            out << (i == 0 ? "" : ", ") << "{\"id\": " << count.id() << ", \"sample_id\": ";
+            util::write_json_string(out, count.sample_id());
+            out << ", \"project\": ";
+            util::write_json_string(out, count.project_name());
+            out << ", \"index1\": ";
+            util::write_json_string(out, count.index1());
+            out << ", \"index2\": ";
+            util::write_json_string(out, count.index2());
+            out << ", \"cluster_count\": " << count.cluster_count() << ", \"fraction_mapped\": ";
+            write_json_number(out, count.fraction_mapped());
+            out << "}";
+        }
+        out << "]}";
+    }
+    out << "]}";
+}
+/** Write an axis of a chart
+ *
+ * @param out output stream
+ * @param axis chart axis
+ */
+static void write_json(std::ostream& out, const model::plot::axis& axis)
+{
+    out << "{\"label\": ";
+    util::write_json_string(out, axis.label());
+    out << ", \"min\": ";
+    write_json_number(out, axis.min());
+    out << ", \"max\": ";
+    write_json_number(out, axis.max());
+    out << "}";
+}
+/** Write candle stick plot data, with each point as [x, lower, p25, p50, p75, upper]
+ *
+ * @param out output stream
+ * @param data plot data
+ */
+static void write_json(std::ostream& out, const model::plot::plot_data<model::plot::candle_stick_point>& data)
+{
+    typedef model::plot::plot_data<model::plot::candle_stick_point> plot_data_t;
+    typedef model::plot::series<model::plot::candle_stick_point> series_t;
+    out << "{\"title\": ";
+    util::write_json_string(out, data.title());
+    out << ", \"x_axis\": ";
+    write_json(out, data.x_axis());
+    out << ", \"y_axis\": ";
+    write_json(out, data.y_axis());
+    out << ", \"series\": [";
+    for(plot_data_t::const_iterator it = data.begin();it != data.end();++it)
+    {
+        out << (it == data.begin() ? "" : ", ") << "{\"title\": ";
+        util::write_json_string(out, it->title());
+        out << ", \"color\": ";
+        util::write_json_string(out, it->color());
+        out << ", \"points\": [";
+        for(series_t::const_iterator point = it->begin();point != it->end();++point)
+        {
+            out << (point == it->begin() ? "[" : ", [");
+            write_json_number(out, point->x());
+            out << ", ";
+            write_json_number(out, point->lower());
+            out << ", ";
+            write_json_number(out, point->p25());
+            out << ", ";
+            write_json_number(out, point->p50());
+            out << ", ";
+            write_json_number(out, point->p75());
+            out << ", ";
+            write_json_number(out, point->upper());
+            out << "]";
+        }
+        out << "]}";
+    }
+    out << "]}";
+}
+/** Write flowcell heat map data, with values and tile ids as rows of lanes
+ *
+ * @param out output stream
+ * @param data flowcell data
+ */
+static void write_json(std::ostream& out, const model::plot::flowcell_data& data)
+{
+    out << "{\"title\": ";
+    util::write_json_string(out, data.title());
+    out << ", \"subtitle\": ";
+    util::write_json_string(out, data.subtitle());
+    out << ", \"lane_count\": " << data.lane_count()
+        << ", \"swath_count\": " << data.swath_count()
+        << ", \"tile_count\": " << data.tile_count()
+        << ", \"values\": [";
+    for(size_t lane=0;lane<data.row_count();++lane)
+    {
+        out << (lane == 0 ? "[" : ", [");
+        for(size_t loc=0;loc<data.column_count();++loc)
+        {
+            if(loc > 0) out << ", ";
+            write_json_number(out, data.at(lane, loc));
+        }
+        out << "]";
+    }
+    out << "], \"tile_ids\": [";
+    for(size_t lane=0;lane<data.row_count();++lane)
+    {
+        out << (lane == 0 ? "[" : ", [");
+        for(size_t loc=0;loc<data.column_count();++loc)
+            out << (loc == 0 ? "" : ", ") << data.tile_id(lane, loc);
+        out << "]";
+    }
+    out << "]}";
+}
+/** Write an imaging table as a list of column names and a list of rows
+ *
+ * @param out output stream
+ * @param table imaging table
+ */
+static void write_json(std::ostream& out, const model::table::imaging_table& table)
+{
+    const model::table::imaging_table::column_vector_t& columns = table.columns();
+    out << "{\"columns\": [";
+    bool first = true;
+    for(size_t col=0;col<columns.size();++col)
+    {
+        for(size_t sub=0;sub<columns[col].size();++sub)
+        {
+            if(!first) out << ", ";
+            first = false;
+            util::write_json_string(out, columns[col].full_name(sub));
+        }
+    }
+    out << "], \"rows\": [";
+    for(size_t row=0;row<table.row_count();++row)
+    {
+        out << (row == 0 ? "[" : ", [");
+        first = true;
+        for(size_t col=0;col<columns.size();++col)
+        {
+            for(size_t sub=0;sub<columns[col].size();++sub)
+            {
+                if(!first) out << ", ";
+                first = false;
+                write_json_number(out, table.at(row, col, sub));
+            }
+        }
+        out << "]";
+    }
+    out << "]}";
+}
+/** Write the usage counters of the cache
+ *
+ * @param out output stream
+ * @param cache run cache
+ */
+static void write_json(std::ostream& out, const io::run_cache& cache)
+{
+    io::run_cache::string_vector runs;
+    cache.list_runs(runs);
+    const io::run_cache_statistics& statistics = cache.statistics();
+    out << "{\"version\": ";
+    util::write_json_string(out, INTEROP_VERSION);
+    out << ", \"resident_bytes\": " << cache.resident_bytes()
+        << ", \"memory_budget\": " << cache.memory_budget()
+        << ", \"hits\": " << statistics.hit_count
+        << ", \"loads\": " << statistics.load_count
+        << ", \"refreshes\": " << statistics.refresh_count
+        << ", \"evictions\": " << statistics.eviction_count
+        << ", \"runs\": [";
+    for(size_t i=0;i<runs.size();++i)
+    {
+        if(i > 0) out << ", ";
+        util::write_json_string(out, runs[i]);
+    }
+    out << "]}";
+}
+
+/** Parse the plot options of a request
+ *
+ * @param tokens request tokens, where the first two are the command and the run folder
+ * @param metric_name destination metric name
+ * @param options destination filter options
+ */
+static void parse_plot_options(const std::vector<std::string>& tokens,
+                               std::string& metric_name,
+                               model::plot::filter_options& options)
+{
+    std::vector<const char*> argv(tokens.size());
+    for(size_t i=0;i<tokens.size();++i) argv[i] = tokens[i].c_str();
+    int argc = static_cast<int>(argv.size());
+    util::option_parser description;
+    add_metric_option(description, metric_name);
+    add_filter_options(description, options);
+    description.parse(argc, &argv[0]);
+    description.check_for_unknown_options(argc, &argv[0]);
+}
+
+/** Lock around the resident runs
+ *
+ * A request holds the lock alone while it changes the cache, e.g. to load, refresh or evict a run. It then shares the
+ * lock while it reads the frozen run, so several requests may read resident runs at once. Without C++11 threads, a
+ * request holds the lock alone until it is answered.
+ */
+class cache_lock
+{
+public:
+    /** Constructor */
+    cache_lock()
+#if defined(INTEROP_HAS_STD_THREAD)
+            : m_reader_count(0), m_writing(false)
+#endif
+    {
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+        omp_init_lock(&m_lock);
+#endif
+    }
+    /** Destructor */
+    ~cache_lock()
+    {
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+        omp_destroy_lock(&m_lock);
+#endif
+    }
+    /** Wait until no other request holds the lock, then hold it alone
+     */
+    void lock()
+    {
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(m_writing || m_reader_count > 0) m_released.wait(lock);
+        m_writing = true;
+#elif defined(_OPENMP)
+        omp_set_lock(&m_lock);
+#endif
+    }
+    /** Let other readers share the lock held alone by this request
+     */
+    void share()
+    {
+#if defined(INTEROP_HAS_STD_THREAD)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_writing = false;
+            ++m_reader_count;
+        }
+        m_released.notify_all();
+#endif
+    }
+    /** Release the lock
+     *
+     * @param shared true if the lock was shared with `share`
+     */
+    void unlock(const bool shared)
+    {
+#if defined(INTEROP_HAS_STD_THREAD)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(shared) --m_reader_count;
+            else m_writing = false;
+        }
+        m_released.notify_all();
+#elif defined(_OPENMP)
+        omp_unset_lock(&m_lock);
+        (void)shared;
+#else
+        (void)shared;
+#endif
+    }
+
+private:
+    cache_lock(const cache_lock&);
+    cache_lock& operator=(const cache_lock&);
+
+private:
+#if defined(INTEROP_HAS_STD_THREAD)
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    size_t m_reader_count;
+    bool m_writing;
+#elif defined(_OPENMP)
+    omp_lock_t m_lock;
+#endif
+};
+/** Hold the cache lock for the lifetime of this object
+ */
+class scoped_cache_lock
+{
+public:
+    /** Constructor, holds the lock alone
+     *
+     * @param lock lock around the resident runs
+     */
+    scoped_cache_lock(cache_lock& lock) : m_lock(lock), m_shared(false)
+    {
+        m_lock.lock();
+    }
+    /** Destructor, releases the lock */
+    ~scoped_cache_lock()
+    {
+        m_lock.unlock(m_shared);
+    }
+    /** Let other readers share the lock
+     */
+    void share()
+    {
+        if(m_shared) return;
+        m_lock.share();
+        m_shared = true;
+    }
+
+private:
+    scoped_cache_lock(const scoped_cache_lock&);
+    scoped_cache_lock& operator=(const scoped_cache_lock&);
+
+private:
+    cache_lock& m_lock;
+    bool m_shared;
+};
+
+/** Answer a single request
+ *
+ * @param line request line
+ * @param cache resident runs
+ * @param lock lock around the resident runs
+ * @param allow_shutdown true if the shutdown request is accepted
+ * @param shutdown set to true when the server should stop
+ * @return JSON response
+ */
+static std::string handle_request(const std::string& line,
+                                  io::run_cache& cache,
+                                  cache_lock& lock,
+                                  const bool allow_shutdown,
+                                  bool& shutdown)
+{
+    std::vector<std::string> tokens;
+    split_request(line, tokens);
+    std::ostringstream out;
+    out << "{\"status\": \"ok\"";
+    try
+    {
+        if(tokens.empty()) throw std::runtime_error("Empty request");
+        scoped_cache_lock hold(lock);
+        const std::string& command = tokens[0];
+        if(command == "status")
+        {
+            out << ", \"cache\": ";
+            write_json(out, cache);
+        }
+        else if(command == "shutdown")
+        {
+            if(!allow_shutdown)
+                throw std::runtime_error("Shutdown is disabled, start the server with --allow-shutdown=1");
+            shutdown = true;
+        }
+        else
+        {
+            if(tokens.size() < 2) throw std::runtime_error("Missing run folder for " + command);
+            const std::string& run_folder = tokens[1];
+            out << ", \"run\": ";
+            util::write_json_string(out, run_folder);
+            if(command == "evict")
+            {
+                out << ", \"evicted\": " << (cache.evict(run_folder) ? "true" : "false");
+            }
+            else if(command == "refresh")
+            {
+                out << ", \"refreshed\": " << (cache.refresh(run_folder) ? "true" : "false");
+            }
+            else if(command == "summary")
+            {
+                const model::metrics::run_metrics& run = cache.get(run_folder);
+                hold.share();
+                model::summary::run_summary summary;
+                logic::summary::summarize_run_metrics(run, summary, true);
+                out << ", \"summary\": ";
+                write_json(out, summary);
+            }
+            else if(command == "index-summary")
+            {
+                const model::metrics::run_metrics& run = cache.get(run_folder);
+                hold.share();
+                model::summary::index_flowcell_summary summary;
+                logic::summary::summarize_index_metrics(run, summary);
+                summary.sort();
+                out << ", \"index_summary\": ";
+                write_json(out, summary);
+            }
+            else if(command == "imaging-table")
+            {
+                const model::metrics::run_metrics& run = cache.get(run_folder);
+                hold.share();
+                model::table::imaging_table table;
+                logic::table::create_imaging_table(run, table);
+                out << ", \"table\": ";
+                write_json(out, table);
+            }
+            else if(command == "plot-by-cycle" || command == "plot-by-lane" || command == "plot-flowcell")
+            {
+                const model::metrics::run_metrics& run = cache.get(run_folder);
+                hold.share();
+                model::plot::filter_options options(run.run_info().flowcell().naming_method());
+                std::string metric_name = "Intensity";
+                if(command == "plot-flowcell")
+                {
+                    options.cycle(1);
+                    options.dna_base(constants::A);
+                    options.channel(0);
+                }
+                parse_plot_options(tokens, metric_name, options);
+                out << ", \"plot\": ";
+                if(command == "plot-flowcell")
+                {
+                    model::plot::flowcell_data data;
+                    logic::plot::plot_flowcell_map(run, metric_name, options, data);
+                    write_json(out, data);
+                }
+                else
+                {
+                    model::plot::plot_data<model::plot::candle_stick_point> data;
+                    if(command == "plot-by-cycle") logic::plot::plot_by_cycle(run, metric_name, options, data);
+                    else logic::plot::plot_by_lane(run, metric_name, options, data);
+                    write_json(out, data);
+                }
+            }
+            else throw std::runtime_error("Unknown command: " + command);
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        std::ostringstream error;
+        error << "{\"status\": \"error\", \"message\": ";
+        util::write_json_string(error, ex.what());
+        error << "}\n";
+        return error.str();
+    }
+    out << "}\n";
+    return out.str();
+}
+
+#ifndef WIN32
+/** Set by SIGINT or SIGTERM to stop the server */
+static volatile sig_atomic_t stop_requested = 0;
+
+/** Request that the server stop
+ */
+static void request_stop(int)
+{
+    stop_requested = 1;
+}
+
+/** Connected client and the bytes of its requests not yet answered
+ */
+struct client_connection
+{
+    /** Constructor
+     *
+     * @param sock client socket
+     */
+    client_connection(const int sock=-1) : socket(sock), connected(true), shutdown(false){}
+    /** Client socket */
+    int socket;
+    /** Bytes received and not yet answered */
+    std::string pending;
+    /** False once the client disconnected, or must be disconnected */
+    bool connected;
+    /** Set when the client asked the server to stop */
+    bool shutdown;
+
+    /** Test if a complete request is waiting to be answered
+     *
+     * @return true if a complete request was received
+     */
+    bool has_request()const
+    {
+        return pending.find('\n') != std::string::npos;
+    }
+};
+
+/** Send a complete response to the client
+ *
+ * @param client client socket
+ * @param response response bytes
+ * @return true if the response was sent
+ */
+static bool send_response(const int client, const std::string& response)
+{
+    size_t offset = 0;
+    while(offset < response.size())
+    {
+        const ssize_t count = ::send(client, response.data()+offset, response.size()-offset, 0);
+        if(count < 0 && errno == EINTR) continue;
+        if(count <= 0) return false;
+        offset += static_cast<size_t>(count);
+    }
+    return true;
+}
+/** Answer at most one request from a client
+ *
+ * If no complete request is waiting, the client is read once, so the call does not block when the socket is
+ * readable.
+ *
+ * @param client connected client
+ * @param cache resident runs
+ * @param lock lock around the resident runs
+ * @param allow_shutdown true if the shutdown request is accepted
+ * @return false if the client disconnected, or must be disconnected
+ */
+static bool serve_request(client_connection& client,
+                          io::run_cache& cache,
+                          cache_lock& lock,
+                          const bool allow_shutdown)
+{
+    if(!client.has_request())
+    {
+        char buffer[4096];
+        ssize_t count;
+        do
+        {
+            count = ::recv(client.socket, buffer, sizeof(buffer), 0);
+        } while(count < 0 && errno == EINTR);
+        if(count <= 0) return false;
+        client.pending.append(buffer, static_cast<size_t>(count));
+    }
+    const std::string::size_type end = client.pending.find('\n');
+    if(end == std::string::npos)
+    {
+        if(client.pending.size() <= MAX_REQUEST_SIZE) return true;
+        send_response(client.socket, "{\"status\": \"error\", \"message\": \"Request too long\"}\n");
+        return false;
+    }
+    const std::string line = client.pending.substr(0, end);
+    client.pending.erase(0, end+1);
+    return send_response(client.socket, handle_request(line, cache, lock, allow_shutdown, client.shutdown));
+}
+/** Answer at most one request from a client on the thread pool
+ */
+class serve_request_task
+{
+public:
+    /** Constructor
+     *
+     * @param client connected client, only touched by this task
+     * @param cache resident runs
+     * @param lock lock around the resident runs
+     * @param allow_shutdown true if the shutdown request is accepted
+     */
+    serve_request_task(client_connection& client, io::run_cache& cache, cache_lock& lock, const bool allow_shutdown) :
+            m_client(&client), m_cache(&cache), m_lock(&lock), m_allow_shutdown(allow_shutdown){}
+    /** Answer the request and record whether the client is still connected
+     */
+    void operator()()const
+    {
+        m_client->connected = serve_request(*m_client, *m_cache, *m_lock, m_allow_shutdown);
+    }
+
+private:
+    client_connection* m_client;
+    io::run_cache* m_cache;
+    cache_lock* m_lock;
+    bool m_allow_shutdown;
+};
+/** Accept a waiting client
+ *
+ * @param server listening socket
+ * @param clients destination list of clients
+ * @return false if the server can no longer accept clients
+ */
+static bool accept_client(const int server, std::vector<client_connection>& clients)
+{
+    const int client = ::accept(server, 0, 0);
+    if(client >= 0)
+    {
+        struct timeval timeout;
+        timeout.tv_sec = SEND_TIMEOUT_SECONDS;
+        timeout.tv_usec = 0;
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        clients.push_back(client_connection(client));
+        return true;
+    }
+    switch(errno)
+    {
+        case EINTR:
+        case EAGAIN:
+        case ECONNABORTED:
+        case EPROTO:
+            // The client gave up, or a signal arrived, before the connection was accepted
+            return true;
+        case EMFILE:
+        case ENFILE:
+        case ENOBUFS:
+        case ENOMEM:
+            std::cerr << "Unable to accept client: " << std::strerror(errno) << std::endl;
+            ::usleep(ACCEPT_BACKOFF_MICROSECONDS);
+            return true;
+        default:
+            std::cerr << "Unable to accept clients: " << std::strerror(errno) << std::endl;
+            return false;
+    }
+}
+/** Remove a socket file left by a server that is no longer running
+ *
+ * @param address address of the socket
+ * @return false if the path exists and is not a stale socket
+ */
+static bool remove_stale_socket(const struct sockaddr_un& address)
+{
+    struct stat info;
+    if(::lstat(address.sun_path, &info) != 0) return errno == ENOENT;
+    if(!S_ISSOCK(info.st_mode))
+    {
+        std::cerr << "Path exists and is not a socket: " << address.sun_path << std::endl;
+        return false;
+    }
+    const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(probe < 0) return false;
+    const bool connected = ::connect(probe, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address)) == 0;
+    const int connect_error = errno;
+    ::close(probe);
+    if(connected)
+    {
+        std::cerr << "Another server is listening on " << address.sun_path << std::endl;
+        return false;
+    }
+    if(connect_error != ECONNREFUSED)
+    {
+        std::cerr << "Unable to check socket " << address.sun_path << ": " << std::strerror(connect_error) << std::endl;
+        return false;
+    }
+    return ::unlink(address.sun_path) == 0;
+}
+/** Answer requests until the server is stopped
+ *
+ * Clients are polled together, and each client with a waiting request is answered once per pass, so a client that
+ * stays connected does not block others. The requests of a pass are answered on the thread pool.
+ *
+ * @param server listening socket
+ * @param cache resident runs
+ * @param pool thread pool that answers the requests
+ * @param allow_shutdown true if the shutdown request is accepted
+ * @return true if the server stopped normally
+ */
+static bool serve_clients(const int server, io::run_cache& cache, util::thread_pool& pool, const bool allow_shutdown)
+{
+    cache_lock lock;
+    std::vector<client_connection> clients;
+    std::vector<struct pollfd> polled;
+    bool shutdown = false;
+    bool accepting = true;
+    while(!shutdown && !stop_requested && accepting)
+    {
+        polled.resize(clients.size()+1);
+        polled[0].fd = server;
+        polled[0].events = POLLIN;
+        polled[0].revents = 0;
+        bool request_waiting = false;
+        for(size_t i=0;i<clients.size();++i)
+        {
+            polled[i+1].fd = clients[i].socket;
+            polled[i+1].events = POLLIN;
+            polled[i+1].revents = 0;
+            request_waiting = request_waiting || clients[i].has_request();
+        }
+        if(::poll(&polled.front(), static_cast<nfds_t>(polled.size()), request_waiting ? 0 : -1) < 0)
+        {
+            if(errno == EINTR) continue;
+            std::cerr << "Unable to poll clients: " << std::strerror(errno) << std::endl;
+            accepting = false;
+            break;
+        }
+        {
+            util::task_group tasks(pool);
+            for(size_t i=0;i<clients.size();++i)
+            {
+                const bool ready = (polled[i+1].revents & (POLLIN | POLLHUP | POLLERR)) != 0 ||
+                                   clients[i].has_request();
+                if(ready) tasks.run(serve_request_task(clients[i], cache, lock, allow_shutdown));
+            }
+            tasks.wait();
+        }
+        size_t kept = 0;
+        for(size_t i=0;i<clients.size();++i)
+        {
+            shutdown = shutdown || clients[i].shutdown;
+            if(!clients[i].connected)
+            {
+                ::close(clients[i].socket);
+                continue;
+            }
+            clients[kept++] = clients[i];
+        }
+        clients.resize(kept);
+        if(!shutdown && (polled[0].revents & POLLIN) != 0) accepting = accept_client(server, clients);
+    }
+    for(size_t i=0;i<clients.size();++i) ::close(clients[i].socket);
+    return accepting;
+}
+#endif
+
+int main(int argc, const char** argv)
+{
+    std::string socket_path = "interop.sock";
+    size_t memory_budget_mb = 4096;
+    size_t thread_count = 1;
+    double refresh_interval = 1.0;
+    int allow_shutdown = 0;
+    util::option_parser description;
+    description
+            (socket_path, "socket", "Path of the UNIX domain socket to listen on")
+            (memory_budget_mb, "memory-budget", "Estimated memory of resident runs in megabytes, 0 for unlimited")
+            (thread_count, "threads", "Number of threads used to answer clients and to load each run")
+            (refresh_interval, "refresh-interval", "Minimum number of seconds between checks for changed InterOp files")
+            (allow_shutdown, "allow-shutdown", "Stop the server when a client sends the shutdown request");
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " [--option1=value1] [--option2=value2]" << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try
+    {
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+#ifdef WIN32
+    std::cerr << "interop_server requires UNIX domain sockets, which are not supported on this platform" << std::endl;
+    return UNEXPECTED_EXCEPTION;
+#else
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path is too long: " << socket_path << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path)-1);
+
+    const int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server < 0)
+    {
+        std::cerr << "Unable to create socket" << std::endl;
+        return UNEXPECTED_EXCEPTION;
+    }
+    if(!remove_stale_socket(address))
+    {
+        std::cerr << "Unable to listen on " << socket_path << std::endl;
+        ::close(server);
+        return UNEXPECTED_EXCEPTION;
+    }
+    if(::bind(server, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 || ::listen(server, 16) != 0)
+    {
+        std::cerr << "Unable to listen on " << socket_path << std::endl;
+        ::close(server);
+        return UNEXPECTED_EXCEPTION;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    std::cout << "# Version: " << INTEROP_VERSION << std::endl;
+    std::cout << "# Socket: " << socket_path << std::endl;
+    io::run_cache cache(static_cast< ::uint64_t >(memory_budget_mb)*1024*1024, thread_count, refresh_interval);
+    util::thread_pool pool(thread_count);
+    const bool stopped = serve_clients(server, cache, pool, allow_shutdown != 0);
+    ::close(server);
+    ::unlink(socket_path.c_str());
+    return stopped ? SUCCESS : UNEXPECTED_EXCEPTION;
+#endif
+}
+
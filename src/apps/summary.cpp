@@ -10,6 +10,13 @@
  *
  * In this sample, 140131_1287_0851_A01n401drr is a run folder and the summary is written to the standard output.
  *
+ * Any number of run folders may be given. They are loaded and summarized concurrently, yet printed in the order given,
+ * each as soon as it and the run folders before it are summarized:
+ *
+ *      $ summary --threads=8 --max-resident=4 run_folder1 run_folder2 ...
+ *
+ * Here 8 threads are shared by the batch, and at most 4 runs are held in memory at once.
+ *
  * The InterOp sub folder may contain any of the following files:
  *
  *  - ErrorMetricsOut.bin
@@ -39,6 +46,7 @@
 #include "interop/util/length_of.h"
 #include "interop/io/metric_file_stream.h"
 #include "interop/logic/summary/run_summary.h"
+#include "interop/logic/summary/batch_summary.h"
 #include "interop/util/option_parser.h"
 #include "interop/version.h"
 #include "inc/application.h"
@@ -58,6 +66,56 @@ using namespace illumina::interop;
  */
 void print_summary(std::ostream& out, const run_summary& summary, const size_t information_level, const bool csv_format);
 
+/** Print the summary of each run as soon as it and the runs before it are summarized
+ */
+class print_summary_listener : public batch_summary_listener
+{
+public:
+    /** Constructor
+     *
+     * @param information_level level of information to print
+     * @param csv_format format output as CSV only
+     */
+    print_summary_listener(const size_t information_level, const bool csv_format) :
+            m_information_level(information_level), m_csv_format(csv_format), m_exit_code(SUCCESS){}
+    /** Print the summary of a run
+     *
+     * @param result result of the run
+     */
+    void run_summarized(const batch_summary_result& result)
+    {
+        if(m_exit_code != SUCCESS) return;
+        std::cout << io::basename(result.run_folder) << std::endl;
+        if(!result.is_valid())
+        {
+            std::cerr << result.error_message << std::endl;
+            return;
+        }
+        try
+        {
+            print_summary(std::cout, result.run_summary, m_information_level, m_csv_format);
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            m_exit_code = UNEXPECTED_EXCEPTION;
+        }
+    }
+    /** Get the exit code of the program
+     *
+     * @return UNEXPECTED_EXCEPTION if a summary could not be printed, otherwise SUCCESS
+     */
+    int exit_code()const
+    {
+        return m_exit_code;
+    }
+
+private:
+    size_t m_information_level;
+    bool m_csv_format;
+    int m_exit_code;
+};
+
 int main(int argc, const char** argv)
 {
     const bool skip_median_calculation=true;
@@ -67,17 +125,20 @@ int main(int argc, const char** argv)
         //print_help(std::cout);
         return INVALID_ARGUMENTS;
     }
-    const size_t thread_count = 1;
+    size_t thread_count = 1;
+    size_t max_resident_runs = 0;
 
     size_t information_level=5;
     int csv_format=0;
     util::option_parser description;
     description
             (information_level, "level", "Level of summary information: 0: total, 1: non-index, 2: Read, 3: Lane, 4: Surface")
-            (csv_format, "csv", "Format output as CSV only");
+            (csv_format, "csv", "Format output as CSV only")
+            (thread_count, "threads", "Number of threads shared by all the runs")
+            (max_resident_runs, "max-resident", "Maximum number of runs held in memory at once, 0 for one per thread");
     if(description.is_help_requested(argc, argv))
     {
-        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [run_folder2 ...] [--option1=value1] [--option2=value2]" << std::endl;
         description.display_help(std::cout);
         return SUCCESS;
     }
@@ -93,42 +154,15 @@ int main(int argc, const char** argv)
     }
 
 // @ [Reporting Summary Metrics in C++]
-    std::vector<unsigned char> valid_to_load;
-    logic::utils::list_summary_metrics_to_load(valid_to_load); // Only load the InterOp files required
-
+    batch_summary_options options(thread_count, max_resident_runs);
+    options.skip_median = skip_median_calculation;
+    std::vector<std::string> run_folders(argv+1, argv+argc);
+    batch_summary_result_vector results;
+    print_summary_listener listener(information_level, csv_format!=0);
     std::cout << "# Version: " << INTEROP_VERSION << std::endl;
-    for(int i=1;i<argc;i++)
-    {
-        run_metrics run;
-
-        std::cout << io::basename(argv[i]) << std::endl;
-        int ret = read_run_metrics(argv[i], run, valid_to_load, thread_count);
-        if(ret != SUCCESS)
-        {
-            continue;
-        }
-        run_summary summary;
-        try
-        {
-            summarize_run_metrics(run, summary, skip_median_calculation);
-        }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            continue;
-        }
-        try
-        {
-            print_summary(std::cout, summary, information_level, csv_format!=0);
-        }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            return UNEXPECTED_EXCEPTION;
-        }
-    }
+    summarize_run_batch(run_folders, results, options, &listener);
 // @ [Reporting Summary Metrics in C++]
-    return SUCCESS;
+    return listener.exit_code();
 }
 
 /** Take a collection of strings and print them using a fixed width
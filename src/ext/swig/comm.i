@@ -5,6 +5,7 @@
 %include <stdint.i>
 %include <std_vector.i>
 %include "util/operator_overload.i"
+%include "util/thread_impl.i"
 
 //////////////////////////////////////////////
 // Don't wrap it, just use it with %import
@@ -48,6 +49,10 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 %include "interop/io/metric_file_stream.h"
 %include "interop/io/paths.h"
 
+// Reading and writing a file only touches C++ objects, allow other Python threads to run
+RELEASE_GIL(illumina::interop::io::read_interop)
+RELEASE_GIL(illumina::interop::io::write_interop)
+
 // Wrap all the interface functions
 %define WRAP_METRIC_IO(metric_t)
     %template(compute_buffer_size ) illumina::interop::io::compute_buffer_size< metric_base::metric_set<metric_t> >;
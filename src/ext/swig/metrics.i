@@ -58,11 +58,24 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 %ignore set_base(const io::layout::base_metric& base);
 %ignore set_base(const io::layout::base_cycle_metric& base);
 %ignore set_base(const io::layout::base_read_metric& base);
+// Inline arrays are not wrapped, the std::vector accessors return the same values
+%ignore max_intensity_channels;
+%ignore focus_score_channels;
+%ignore min_contrast_channels;
+%ignore max_contrast_channels;
+%ignore corrected_int_called_bases;
+%ignore corrected_int_all_bases;
 
 %include "interop/util/time.h"
 %include "interop/model/metric_base/base_metric.h"
 %include "interop/model/metric_base/base_cycle_metric.h"
 %include "interop/model/metric_base/base_read_metric.h"
+%ignore illumina::interop::model::metric_base::metric_partition;
+%ignore illumina::interop::model::metric_base::metric_view::const_iterator;
+%ignore illumina::interop::model::metric_base::metric_view::begin;
+%ignore illumina::interop::model::metric_base::metric_view::end;
+%ignore illumina::interop::model::metric_base::metric_view::operator[];
+%include "interop/model/metric_base/metric_view.h"
 %include "interop/model/metric_base/metric_set.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +90,8 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
     %ignore illumina::interop::model::metric_base::metric_set<metric_t>::populate_tile_numbers_for_lane;
     %ignore illumina::interop::model::metric_base::metric_set<metric_t>::populate_tile_numbers_for_lane_surface;
     %ignore illumina::interop::model::metric_base::metric_set<metric_t>::offset_map;
+    %ignore illumina::interop::model::metric_base::metric_set<metric_t>::lane_range;
+    %ignore illumina::interop::model::metric_base::metric_set<metric_t>::tile_range;
 
     %apply size_t { std::map< std::size_t, metric_t >::size_type };
     %apply uint64_t { metric_base::metric_set<metric_t>::id_t };
@@ -87,6 +102,7 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
     using namespace illumina::interop::model::metrics;
     namespace metric_base = illumina::interop::model::metric_base;
 
+    %template(metric_t ## _view) metric_base::metric_view<metric_t>;
     %template(base_ ## metric_t ## s) metric_base::metric_set<metric_t>;
     %template(vector_ ## metric_t ## s) std::vector<metric_t>;
 
@@ -5,6 +5,7 @@
 %include <stdint.i>
 %include <std_vector.i>
 %include "util/operator_overload.i"
+%include "util/thread_impl.i"
 
 //////////////////////////////////////////////
 // Don't wrap it, just use it with %import
@@ -115,6 +116,12 @@ WRAP_VECTOR(std::vector<illumina::interop::model::plot::candle_stick_point>)
 #include "interop/logic/plot/plot_flowcell_map.h"
 #include "interop/logic/plot/plot_sample_qc.h"
 %}
+RELEASE_GIL(illumina::interop::logic::plot::plot_by_cycle)
+RELEASE_GIL(illumina::interop::logic::plot::plot_by_lane)
+RELEASE_GIL(illumina::interop::logic::plot::plot_qscore_histogram)
+RELEASE_GIL(illumina::interop::logic::plot::plot_qscore_heatmap)
+RELEASE_GIL(illumina::interop::logic::plot::plot_flowcell_map)
+RELEASE_GIL(illumina::interop::logic::plot::plot_sample_qc)
 %include "interop/logic/plot/plot_by_cycle.h"
 %include "interop/logic/plot/plot_by_lane.h"
 %include "interop/logic/plot/plot_qscore_histogram.h"
@@ -11,6 +11,8 @@
 // Ignore methods that should not be wrapped
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 %ignore illumina::interop::model::metrics::q_score_bin::operator=;
+%ignore illumina::interop::util::scoped_trace;
+%ignore illumina::interop::util::write_chrome_trace;
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -32,6 +34,7 @@
 #include "interop/model/run/parameters.h"
 #include "interop/logic/metric/q_metric.h"
 #include "interop/logic/utils/enums.h"
+#include "interop/util/trace.h"
 %}
 
 
@@ -59,8 +62,10 @@
 %include "interop/model/run/info.h"
 %include "interop/model/run/parameters.h"
 %include "interop/logic/utils/enums.h"
+%include "interop/util/trace.h"
 
 %template(read_info_vector) std::vector<illumina::interop::model::run::read_info>;
+%template(trace_event_vector) std::vector<illumina::interop::util::trace_event>;
 
 
 
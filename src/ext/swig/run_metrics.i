@@ -7,6 +7,7 @@
 %import "src/ext/swig/exceptions/exceptions_impl.i"
 %include "src/ext/swig/arrays/arrays_impl.i"
 %include "util/operator_overload.i"
+%include "util/thread_impl.i"
 
 //////////////////////////////////////////////
 // Don't wrap it, just use it with %import
@@ -71,6 +72,14 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 %{
 #include "interop/model/run_metrics.h"
 %}
+// Loading a run only touches C++ objects, allow other Python threads to run
+RELEASE_GIL(illumina::interop::model::metrics::run_metrics::read)
+RELEASE_GIL(illumina::interop::model::metrics::run_metrics::read_xml)
+RELEASE_GIL(illumina::interop::model::metrics::run_metrics::read_run_info)
+RELEASE_GIL(illumina::interop::model::metrics::run_metrics::read_run_parameters)
+RELEASE_GIL(illumina::interop::model::metrics::run_metrics::read_metrics)
+RELEASE_GIL(illumina::interop::model::metrics::run_metrics::finalize_after_load)
+RELEASE_GIL(illumina::interop::model::metrics::run_metrics::write_metrics)
 %include "interop/model/run_metrics.h"
 
 %define WRAP_RUN_METRICS(metric_t)
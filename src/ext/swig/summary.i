@@ -5,6 +5,7 @@
 %include <stdint.i>
 %include <std_vector.i>
 %include "util/operator_overload.i"
+%include "util/thread_impl.i"
 
 //////////////////////////////////////////////
 // Don't wrap it, just use it with %import
@@ -88,6 +89,7 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 %{
 #include "interop/logic/summary/run_summary.h"
 %}
+RELEASE_GIL(illumina::interop::logic::summary::summarize_run_metrics)
 %include "interop/logic/summary/run_summary.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -113,5 +115,18 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 %{
 #include "interop/logic/summary/index_summary.h"
 %}
+RELEASE_GIL(illumina::interop::logic::summary::summarize_index_metrics)
 
 %include "interop/logic/summary/index_summary.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Batch Summary Logic
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+%{
+#include "interop/logic/summary/batch_summary.h"
+%}
+RELEASE_GIL(illumina::interop::logic::summary::summarize_run_batch)
+
+%include "interop/logic/summary/batch_summary.h"
+
+%template(batch_summary_result_vector) std::vector<illumina::interop::logic::summary::batch_summary_result>;
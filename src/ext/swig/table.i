@@ -6,6 +6,7 @@
 %include <std_vector.i>
 %include <std_map.i>
 %include "util/operator_overload.i"
+%include "util/thread_impl.i"
 
 //////////////////////////////////////////////
 // Don't wrap it, just use it with %import
@@ -55,6 +56,8 @@ EXCEPTION_WRAPPER(WRAP_EXCEPTION_IMPORT)
 #include "interop/logic/table/create_imaging_table_columns.h"
 #include "interop/logic/table/create_imaging_table.h"
 %}
+RELEASE_GIL(illumina::interop::logic::table::create_imaging_table)
+RELEASE_GIL(illumina::interop::logic::table::populate_imaging_table_data)
 
 %include "interop/model/table/imaging_column.h"
 %include "interop/model/table/imaging_table.h"
@@ -0,0 +1,16 @@
+// Release the Python global interpreter lock (GIL) around long running library calls
+//
+// The Python modules are generated with thread support (-threads), but the GIL is only released for the entry points
+// marked with RELEASE_GIL, every other wrapper keeps the lock. The marked functions only operate on C++ objects: the
+// arguments are converted before the lock is released, and the result (or exception) is converted after the lock is
+// re-acquired. Numpy buffers passed to these functions are only accessed through their raw data pointer.
+
+#if defined(SWIGPYTHON)
+%nothread;
+%define RELEASE_GIL(FUNCTION)
+%thread FUNCTION;
+%enddef
+#else
+%define RELEASE_GIL(FUNCTION)
+%enddef
+#endif
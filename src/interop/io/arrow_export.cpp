@@ -0,0 +1,673 @@
+/** Export metric sets and the imaging table through the Apache Arrow C Data Interface
+ *
+ * Metric sets are stored as arrays of structs, and the imaging table is row-major, so neither can lend a column buffer
+ * directly. Each column is built once, column by column, from the metric accessors, and the buffers are then moved
+ * into the exported array.
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include "interop/io/table/arrow_export.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include "interop/util/math.h"
+#include "interop/util/lexical_cast.h"
+#include "interop/logic/utils/enums.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Vector of bytes */
+    typedef std::vector< ::uint8_t > byte_vector_t;
+
+    /** Column of values, stored in the layout of an Arrow array */
+    struct arrow_column
+    {
+        /** Constructor */
+        arrow_column() : format(""), length(0), null_count(0){}
+        /** Field name */
+        std::string name;
+        /** Arrow format string */
+        const char* format;
+        /** Validity bitmap, empty when no value is null */
+        byte_vector_t validity;
+        /** Value buffer */
+        byte_vector_t data;
+        /** String offsets */
+        std::vector< ::int32_t > offsets;
+        /** Number of values */
+        size_t length;
+        /** Number of null values */
+        size_t null_count;
+    };
+    /** Collection of columns
+     *
+     * A deque is used so that adding a column does not move the buffers of the columns already built.
+     */
+    typedef std::deque<arrow_column> arrow_column_deque;
+
+    /** Arrow format string of a C++ value type */
+    template<typename T>
+    struct arrow_format;
+    /** Arrow format string of an unsigned 16-bit integer */
+    template<>
+    struct arrow_format< ::uint16_t >
+    {
+        /** @return format string */
+        static const char* value(){return "S";}
+    };
+    /** Arrow format string of an unsigned 32-bit integer */
+    template<>
+    struct arrow_format< ::uint32_t >
+    {
+        /** @return format string */
+        static const char* value(){return "I";}
+    };
+    /** Arrow format string of an unsigned 64-bit integer */
+    template<>
+    struct arrow_format< ::uint64_t >
+    {
+        /** @return format string */
+        static const char* value(){return "L";}
+    };
+    /** Arrow format string of a 32-bit float */
+    template<>
+    struct arrow_format< float >
+    {
+        /** @return format string */
+        static const char* value(){return "f";}
+    };
+
+    /** Memory owned by an exported schema */
+    struct arrow_schema_holder
+    {
+        /** Format string */
+        std::string format;
+        /** Field name */
+        std::string name;
+        /** Child schemas */
+        std::vector<ArrowSchema> children;
+        /** Pointers to the child schemas */
+        std::vector<ArrowSchema*> child_pointers;
+    };
+    /** Memory owned by an exported array */
+    struct arrow_array_holder
+    {
+        /** Validity bitmap */
+        byte_vector_t validity;
+        /** Value buffer */
+        byte_vector_t data;
+        /** String offsets */
+        std::vector< ::int32_t > offsets;
+        /** Pointers to the buffers */
+        std::vector<const void*> buffers;
+        /** Child arrays */
+        std::vector<ArrowArray> children;
+        /** Pointers to the child arrays */
+        std::vector<ArrowArray*> child_pointers;
+    };
+
+    /** Add a fixed width column with room for the given number of values
+     *
+     * @param columns collection of columns
+     * @param name field name
+     * @param length number of values
+     * @return new column
+     */
+    template<typename T>
+    static arrow_column& add_column(arrow_column_deque& columns, const std::string& name, const size_t length)
+    {
+        columns.push_back(arrow_column());
+        arrow_column& column = columns.back();
+        column.name = name;
+        column.format = arrow_format<T>::value();
+        column.length = length;
+        column.data.resize(length*sizeof(T));
+        return column;
+    }
+    /** Add a string column with room for the given number of values
+     *
+     * The values must be set in row order with `set_string`.
+     *
+     * @param columns collection of columns
+     * @param name field name
+     * @param length number of values
+     * @return new column
+     */
+    static arrow_column& add_string_column(arrow_column_deque& columns, const std::string& name, const size_t length)
+    {
+        columns.push_back(arrow_column());
+        arrow_column& column = columns.back();
+        column.name = name;
+        column.format = "u";
+        column.length = length;
+        column.offsets.assign(length+1, 0);
+        return column;
+    }
+    /** Set a value in a fixed width column
+     *
+     * @param column destination column
+     * @param row row index
+     * @param value value to set
+     */
+    template<typename T>
+    static void set_value(arrow_column& column, const size_t row, const T value)
+    {
+        INTEROP_ASSERT((row+1)*sizeof(T) <= column.data.size());
+        std::memcpy(&column.data[row*sizeof(T)], &value, sizeof(T));
+    }
+    /** Set a value in a string column
+     *
+     * @param column destination column
+     * @param row row index, must follow the previous row set
+     * @param value value to set
+     */
+    static void set_string(arrow_column& column, const size_t row, const std::string& value)
+    {
+        INTEROP_ASSERT(row+1 < column.offsets.size());
+        column.data.insert(column.data.end(), value.begin(), value.end());
+        column.offsets[row+1] = static_cast< ::int32_t >(column.data.size());
+    }
+    /** Mark a value as null
+     *
+     * @param column destination column
+     * @param row row index
+     */
+    static void set_null(arrow_column& column, const size_t row)
+    {
+        if(column.validity.empty()) column.validity.assign((column.length+7)/8, 0xff);
+        column.validity[row/8] &= static_cast< ::uint8_t >(~(1u << (row%8)));
+        ++column.null_count;
+    }
+
+    /** Add a column filled with one accessor of each metric
+     *
+     * @param columns collection of columns
+     * @param name field name
+     * @param metrics set of metrics
+     * @param getter accessor of the value
+     */
+    template<class MetricSet, class Metric, typename R>
+    static void add_column(arrow_column_deque& columns,
+                           const std::string& name,
+                           const MetricSet& metrics,
+                           R (Metric::*getter)()const)
+    {
+        arrow_column& column = add_column<R>(columns, name, metrics.size());
+        size_t row = 0;
+        for(typename MetricSet::const_iterator it = metrics.begin();it != metrics.end();++it, ++row)
+            set_value(column, row, ((*it).*getter)());
+    }
+    /** Add one column per channel, filled from the inline channel array of each metric
+     *
+     * A metric with fewer channels than the header has null values for the missing channels.
+     *
+     * @param columns collection of columns
+     * @param prefix prefix of the field name
+     * @param channel_names name of each channel
+     * @param metrics set of metrics
+     * @param getter accessor of the channel array
+     */
+    template<class MetricSet, class Metric, class Array>
+    static void add_channel_columns(arrow_column_deque& columns,
+                                    const std::string& prefix,
+                                    const std::vector<std::string>& channel_names,
+                                    const MetricSet& metrics,
+                                    const Array& (Metric::*getter)()const)
+    {
+        typedef typename Array::value_type value_t;
+        for(size_t channel=0;channel<channel_names.size();++channel)
+        {
+            arrow_column& column = add_column<value_t>(columns, prefix+"_"+channel_names[channel], metrics.size());
+            size_t row = 0;
+            for(typename MetricSet::const_iterator it = metrics.begin();it != metrics.end();++it, ++row)
+            {
+                const Array& values = ((*it).*getter)();
+                if(channel < values.size()) set_value(column, row, values[channel]);
+                else set_null(column, row);
+            }
+        }
+    }
+    /** Add the lane, tile and cycle columns
+     *
+     * @param columns collection of columns
+     * @param metrics set of metrics
+     */
+    template<class MetricSet>
+    static void add_cycle_id_columns(arrow_column_deque& columns, const MetricSet& metrics)
+    {
+        typedef typename MetricSet::metric_type metric_t;
+        add_column(columns, "Lane", metrics, &metric_t::lane);
+        add_column(columns, "Tile", metrics, &metric_t::tile);
+        add_column(columns, "Cycle", metrics, &metric_t::cycle);
+    }
+    /** Check the channel names match the channel count of the header
+     *
+     * @param metrics set of metrics
+     * @param channel_names name of each channel
+     */
+    template<class MetricSet>
+    static void check_channel_names(const MetricSet& metrics, const std::vector<std::string>& channel_names)
+    throw(bad_format_exception)
+    {
+        if(static_cast<size_t>(metrics.channel_count()) != channel_names.size())
+            INTEROP_THROW(bad_format_exception, "Header and channel names count mismatch: "
+                    << metrics.channel_count() << " != " << channel_names.size());
+    }
+
+    /** Release an exported schema and any children not moved by the consumer
+     *
+     * @param schema exported schema
+     */
+    static void release_arrow_schema(ArrowSchema* schema)
+    {
+        if(schema == 0 || schema->release == 0) return;
+        arrow_schema_holder* holder = static_cast<arrow_schema_holder*>(schema->private_data);
+        for(size_t i=0;i<holder->children.size();++i)
+        {
+            if(holder->children[i].release != 0) holder->children[i].release(&holder->children[i]);
+        }
+        delete holder;
+        schema->release = 0;
+    }
+    /** Release an exported array and any children not moved by the consumer
+     *
+     * @param array exported array
+     */
+    static void release_arrow_array(ArrowArray* array)
+    {
+        if(array == 0 || array->release == 0) return;
+        arrow_array_holder* holder = static_cast<arrow_array_holder*>(array->private_data);
+        for(size_t i=0;i<holder->children.size();++i)
+        {
+            if(holder->children[i].release != 0) holder->children[i].release(&holder->children[i]);
+        }
+        delete holder;
+        array->release = 0;
+    }
+    /** Get a pointer to the start of a buffer, null if the buffer is empty
+     *
+     * @param buffer vector buffer
+     * @return pointer to first element or null
+     */
+    template<typename T>
+    static const void* buffer_pointer(const std::vector<T>& buffer)
+    {
+        return buffer.empty() ? 0 : static_cast<const void*>(&buffer[0]);
+    }
+    /** Initialize a schema that owns its strings and children
+     *
+     * @param schema destination schema
+     * @param format format string
+     * @param name field name
+     * @param flags schema flags
+     * @param child_count number of children
+     * @return holder for the schema memory
+     */
+    static arrow_schema_holder* init_schema(ArrowSchema* schema,
+                                            const std::string& format,
+                                            const std::string& name,
+                                            const ::int64_t flags,
+                                            const size_t child_count)
+    {
+        arrow_schema_holder* holder = new arrow_schema_holder;
+        holder->format = format;
+        holder->name = name;
+        holder->children.resize(child_count);
+        holder->child_pointers.resize(child_count);
+        for(size_t i=0;i<child_count;++i) holder->child_pointers[i] = &holder->children[i];
+        schema->format = holder->format.c_str();
+        schema->name = holder->name.c_str();
+        schema->metadata = 0;
+        schema->flags = flags;
+        schema->n_children = static_cast< ::int64_t >(child_count);
+        schema->children = child_count > 0 ? &holder->child_pointers[0] : 0;
+        schema->dictionary = 0;
+        schema->release = release_arrow_schema;
+        schema->private_data = holder;
+        return holder;
+    }
+    /** Initialize an array that owns its buffers and children
+     *
+     * @param array destination array
+     * @param length number of elements
+     * @param child_count number of children
+     * @return holder for the array memory
+     */
+    static arrow_array_holder* init_array(ArrowArray* array, const size_t length, const size_t child_count)
+    {
+        arrow_array_holder* holder = new arrow_array_holder;
+        holder->children.resize(child_count);
+        holder->child_pointers.resize(child_count);
+        for(size_t i=0;i<child_count;++i) holder->child_pointers[i] = &holder->children[i];
+        array->length = static_cast< ::int64_t >(length);
+        array->null_count = 0;
+        array->offset = 0;
+        array->n_buffers = 0;
+        array->n_children = static_cast< ::int64_t >(child_count);
+        array->buffers = 0;
+        array->children = child_count > 0 ? &holder->child_pointers[0] : 0;
+        array->dictionary = 0;
+        array->release = release_arrow_array;
+        array->private_data = holder;
+        return holder;
+    }
+    /** Export a single column, the column buffers are moved into the array
+     *
+     * @param column column (cleared on return)
+     * @param schema destination schema
+     * @param array destination array
+     */
+    static void export_column(arrow_column& column, ArrowSchema* schema, ArrowArray* array)
+    {
+        init_schema(schema, column.format, column.name, ARROW_FLAG_NULLABLE, 0);
+        arrow_array_holder* holder = init_array(array, column.length, 0);
+        holder->validity.swap(column.validity);
+        holder->data.swap(column.data);
+        holder->offsets.swap(column.offsets);
+        array->null_count = static_cast< ::int64_t >(column.null_count);
+        holder->buffers.push_back(buffer_pointer(holder->validity));
+        if(!holder->offsets.empty()) holder->buffers.push_back(buffer_pointer(holder->offsets));
+        holder->buffers.push_back(buffer_pointer(holder->data));
+        array->n_buffers = static_cast< ::int64_t >(holder->buffers.size());
+        array->buffers = &holder->buffers[0];
+    }
+    /** Export all columns as a struct array
+     *
+     * @param columns collection of columns (cleared on return)
+     * @param name name of the struct field
+     * @param row_count number of rows
+     * @param schema destination schema
+     * @param array destination array
+     */
+    static void export_struct(arrow_column_deque& columns,
+                              const std::string& name,
+                              const size_t row_count,
+                              ArrowSchema* schema,
+                              ArrowArray* array)
+    {
+        const size_t column_count = columns.size();
+        arrow_schema_holder* schema_holder = init_schema(schema, "+s", name, 0, column_count);
+        arrow_array_holder* array_holder = init_array(array, row_count, column_count);
+        array_holder->buffers.push_back(0);
+        array->n_buffers = 1;
+        array->buffers = &array_holder->buffers[0];
+        for(size_t i=0;i<column_count;++i)
+            export_column(columns[i], &schema_holder->children[i], &array_holder->children[i]);
+        columns.clear();
+    }
+    /** Name of the struct exported for a metric set
+     *
+     * @param metrics set of metrics
+     * @return prefix and suffix of the metric file
+     */
+    template<class MetricSet>
+    static std::string struct_name(const MetricSet& metrics)
+    {
+        return std::string(metrics.prefix())+metrics.suffix();
+    }
+    /** Export the q-score histogram of each metric, one column per bin
+     *
+     * @param metrics set of metrics
+     * @param schema destination schema
+     * @param array destination array
+     */
+    template<class MetricSet>
+    static void export_qscore_histogram(const MetricSet& metrics, ArrowSchema* schema, ArrowArray* array)
+    {
+        arrow_column_deque columns;
+        add_cycle_id_columns(columns, metrics);
+        for(size_t bin=0;bin<metrics.q_val_count();++bin)
+        {
+            arrow_column& column = add_column< ::uint32_t >(columns,
+                                                            "Bin_"+util::lexical_cast<std::string>(bin+1),
+                                                            metrics.size());
+            size_t row = 0;
+            for(typename MetricSet::const_iterator it = metrics.begin();it != metrics.end();++it, ++row)
+            {
+                if(bin < it->qscore_hist().size()) set_value(column, row, it->qscore_hist()[bin]);
+                else set_null(column, row);
+            }
+        }
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::corrected_intensity_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        typedef model::metrics::corrected_intensity_metric metric_t;
+        typedef model::metric_base::metric_set<metric_t>::const_iterator const_iterator;
+        std::vector<std::string> bases;
+        constants::list_enum_names<constants::dna_bases>(bases);
+        const std::vector<std::string> called_bases(bases.begin()+1, bases.end());
+        arrow_column_deque columns;
+        add_cycle_id_columns(columns, metrics);
+        add_column(columns, "AverageCycleIntensity", metrics, &metric_t::average_cycle_intensity);
+        add_column(columns, "SignalToNoise", metrics, &metric_t::signal_to_noise);
+        for(size_t i=0;i<bases.size();++i)
+        {
+            arrow_column& column = add_column< ::uint32_t >(columns, "CalledCount_"+bases[i], metrics.size());
+            const constants::dna_bases base = static_cast<constants::dna_bases>(static_cast<int>(i)-1);
+            size_t row = 0;
+            for(const_iterator it = metrics.begin();it != metrics.end();++it, ++row)
+                set_value(column, row, it->called_counts(base));
+        }
+        add_channel_columns(columns, "CalledIntensity", called_bases, metrics, &metric_t::corrected_int_called_bases);
+        add_channel_columns(columns, "AllIntensity", called_bases, metrics, &metric_t::corrected_int_all_bases);
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::error_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        arrow_column_deque columns;
+        add_cycle_id_columns(columns, metrics);
+        add_column(columns, "ErrorRate", metrics, &model::metrics::error_metric::error_rate);
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::extraction_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names)
+                         throw(bad_format_exception)
+    {
+        typedef model::metrics::extraction_metric metric_t;
+        check_channel_names(metrics, channel_names);
+        arrow_column_deque columns;
+        add_cycle_id_columns(columns, metrics);
+        add_column(columns, "TimeStamp", metrics, &metric_t::date_time);
+        add_channel_columns(columns, "MaxIntensity", channel_names, metrics, &metric_t::max_intensity_channels);
+        add_channel_columns(columns, "Focus", channel_names, metrics, &metric_t::focus_score_channels);
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::image_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>& channel_names)
+                         throw(bad_format_exception)
+    {
+        typedef model::metrics::image_metric metric_t;
+        check_channel_names(metrics, channel_names);
+        arrow_column_deque columns;
+        add_cycle_id_columns(columns, metrics);
+        add_channel_columns(columns, "MinContrast", channel_names, metrics, &metric_t::min_contrast_channels);
+        add_channel_columns(columns, "MaxContrast", channel_names, metrics, &metric_t::max_contrast_channels);
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::index_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        typedef model::metric_base::metric_set<model::metrics::index_metric>::const_iterator const_iterator;
+        typedef model::metrics::index_metric::const_iterator index_iterator;
+        size_t row_count = 0;
+        for(const_iterator it = metrics.begin();it != metrics.end();++it) row_count += it->size();
+        arrow_column_deque columns;
+        arrow_column& lane = add_column< ::uint32_t >(columns, "Lane", row_count);
+        arrow_column& tile = add_column< ::uint32_t >(columns, "Tile", row_count);
+        arrow_column& read = add_column< ::uint32_t >(columns, "Read", row_count);
+        arrow_column& sequence = add_string_column(columns, "Sequence", row_count);
+        arrow_column& sample = add_string_column(columns, "Sample", row_count);
+        arrow_column& project = add_string_column(columns, "Project", row_count);
+        arrow_column& cluster_count = add_column< ::uint64_t >(columns, "ClusterCount", row_count);
+        size_t row = 0;
+        for(const_iterator it = metrics.begin();it != metrics.end();++it)
+        {
+            for(index_iterator index = it->indices().begin();index != it->indices().end();++index, ++row)
+            {
+                set_value(lane, row, it->lane());
+                set_value(tile, row, it->tile());
+                set_value(read, row, it->read());
+                set_string(sequence, row, index->index_seq());
+                set_string(sample, row, index->sample_id());
+                set_string(project, row, index->sample_proj());
+                set_value(cluster_count, row, index->cluster_count());
+            }
+        }
+        export_struct(columns, struct_name(metrics), row_count, schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::phasing_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        typedef model::metrics::phasing_metric metric_t;
+        arrow_column_deque columns;
+        add_cycle_id_columns(columns, metrics);
+        add_column(columns, "Phasing", metrics, &metric_t::phasing_weight);
+        add_column(columns, "Prephasing", metrics, &metric_t::prephasing_weight);
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        typedef model::metrics::dynamic_phasing_metric metric_t;
+        arrow_column_deque columns;
+        add_column(columns, "Lane", metrics, &metric_t::lane);
+        add_column(columns, "Tile", metrics, &metric_t::tile);
+        add_column(columns, "Read", metrics, &metric_t::read);
+        add_column(columns, "PhasingSlope", metrics, &metric_t::phasing_slope);
+        add_column(columns, "PhasingOffset", metrics, &metric_t::phasing_offset);
+        add_column(columns, "PrephasingSlope", metrics, &metric_t::prephasing_slope);
+        add_column(columns, "PrephasingOffset", metrics, &metric_t::prephasing_offset);
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::q_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        export_qscore_histogram(metrics, schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::q_by_lane_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        export_qscore_histogram(metrics, schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::q_collapsed_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        typedef model::metrics::q_collapsed_metric metric_t;
+        arrow_column_deque columns;
+        add_cycle_id_columns(columns, metrics);
+        add_column(columns, "Q20", metrics, &metric_t::q20);
+        add_column(columns, "Q30", metrics, &metric_t::q30);
+        add_column(columns, "Total", metrics, &metric_t::total);
+        add_column(columns, "MedianQScore", metrics, &metric_t::median_qscore);
+        export_struct(columns, struct_name(metrics), metrics.size(), schema, array);
+    }
+
+    void export_to_arrow(const model::metric_base::metric_set<model::metrics::tile_metric>& metrics,
+                         ArrowSchema* schema,
+                         ArrowArray* array,
+                         const std::vector<std::string>&)
+    {
+        typedef model::metric_base::metric_set<model::metrics::tile_metric>::const_iterator const_iterator;
+        typedef model::metrics::tile_metric::read_metric_vector::const_iterator read_iterator;
+        size_t row_count = 0;
+        for(const_iterator it = metrics.begin();it != metrics.end();++it)
+            row_count += std::max(it->read_metrics().size(), static_cast<size_t>(1));
+        arrow_column_deque columns;
+        arrow_column& lane = add_column< ::uint32_t >(columns, "Lane", row_count);
+        arrow_column& tile = add_column< ::uint32_t >(columns, "Tile", row_count);
+        arrow_column& read = add_column< ::uint32_t >(columns, "Read", row_count);
+        arrow_column& cluster_count = add_column<float>(columns, "ClusterCount", row_count);
+        arrow_column& cluster_count_pf = add_column<float>(columns, "ClusterCountPF", row_count);
+        arrow_column& density = add_column<float>(columns, "Density", row_count);
+        arrow_column& density_pf = add_column<float>(columns, "DensityPF", row_count);
+        arrow_column& aligned = add_column<float>(columns, "Aligned", row_count);
+        arrow_column& prephasing = add_column<float>(columns, "Prephasing", row_count);
+        arrow_column& phasing = add_column<float>(columns, "Phasing", row_count);
+        size_t row = 0;
+        for(const_iterator it = metrics.begin();it != metrics.end();++it)
+        {
+            const size_t read_count = std::max(it->read_metrics().size(), static_cast<size_t>(1));
+            for(size_t i=0;i<read_count;++i, ++row)
+            {
+                set_value(lane, row, it->lane());
+                set_value(tile, row, it->tile());
+                set_value(cluster_count, row, it->cluster_count());
+                set_value(cluster_count_pf, row, it->cluster_count_pf());
+                set_value(density, row, it->cluster_density());
+                set_value(density_pf, row, it->cluster_density_pf());
+                if(it->read_metrics().empty())
+                {
+                    set_null(read, row);
+                    set_null(aligned, row);
+                    set_null(prephasing, row);
+                    set_null(phasing, row);
+                    continue;
+                }
+                const read_iterator read_metric = it->read_metrics().begin()+i;
+                set_value(read, row, read_metric->read());
+                set_value(aligned, row, read_metric->percent_aligned());
+                set_value(prephasing, row, read_metric->percent_prephasing());
+                set_value(phasing, row, read_metric->percent_phasing());
+            }
+        }
+        export_struct(columns, struct_name(metrics), row_count, schema, array);
+    }
+
+    void export_to_arrow(const model::table::imaging_table& table, ArrowSchema* schema, ArrowArray* array)
+    {
+        arrow_column_deque columns;
+        for(size_t col=0;col<table.column_count();++col)
+        {
+            const model::table::imaging_column& imaging_column = table.columns()[col];
+            for(size_t sub=0;sub<imaging_column.size();++sub)
+            {
+                arrow_column& column = add_column<float>(columns, imaging_column.full_name(sub), table.row_count());
+                for(size_t row=0;row<table.row_count();++row)
+                {
+                    const float val = table(row, col, sub);
+                    if(std::isnan(val)) set_null(column, row);
+                    else set_value(column, row, val);
+                }
+            }
+        }
+        export_struct(columns, "Imaging", table.row_count(), schema, array);
+    }
+}}}
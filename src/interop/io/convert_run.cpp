@@ -0,0 +1,361 @@
+/** Rewrite the InterOp files of a run folder in the latest lossless format versions
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/io/convert_run.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include "interop/io/record_reader.h"
+#include "interop/io/metric_file_stream.h"
+#include "interop/logic/metric/q_metric.h"
+#include "interop/model/run_metrics.h"
+#include "interop/util/thread_pool.h"
+#include "interop/util/trace.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Get the newest version of a metric group that stores every field of the given version
+     *
+     * @param group metric group
+     * @param version current version of the file
+     * @param latest latest registered version of the metric group
+     * @param has_bins true if the q-score bins are known
+     * @return version to write
+     */
+    static ::int16_t lossless_version(const constants::metric_group group,
+                                      const ::int16_t version,
+                                      const ::int16_t latest,
+                                      const bool has_bins)
+    {
+        const ::int16_t last_unbinned_q_version = 6;
+        switch(group)
+        {
+            case constants::CorrectedInt: // Version 3 drops the average and called intensities
+            case constants::Extraction: // Version 3 drops the time stamp
+            case constants::Tile: // Version 3 drops the density and phasing
+                return version;
+            case constants::Q:
+            case constants::QByLane: // Version 7 only stores binned histograms
+                if(!has_bins) return std::max(version, std::min(latest, last_unbinned_q_version));
+                return std::max(version, latest);
+            default:
+                return std::max(version, latest);
+        }
+    }
+    /** Test if the q-score bins of a metric set are known
+     *
+     * @return false
+     */
+    template<class MetricSet>
+    static bool has_bins(const MetricSet&)
+    {
+        return false;
+    }
+    /** Test if the q-score bins of a metric set are known
+     *
+     * @param header q-metric header
+     * @return true if the header has bins
+     */
+    static bool has_bins(const model::metric_base::metric_set<model::metrics::q_metric>& header)
+    {
+        return header.bin_count() > 0;
+    }
+    /** Test if the q-score bins of a metric set are known
+     *
+     * @param header q-metric by lane header
+     * @return true if the header has bins
+     */
+    static bool has_bins(const model::metric_base::metric_set<model::metrics::q_by_lane_metric>& header)
+    {
+        return header.bin_count() > 0;
+    }
+    /** Assign legacy q-score bins to a header
+     *
+     * @return false
+     */
+    template<class MetricSet>
+    static bool populate_legacy_bins(const std::string&, MetricSet&, const constants::instrument_type)
+    {
+        return false;
+    }
+    /** Assign legacy q-score bins to a version 4 q-metric header, if its records use at most 7 q-scores
+     *
+     * This scans the file once, counting the distinct q-scores with a non-zero count, as the loader does.
+     *
+     * @param filename path to the q-metric file
+     * @param header q-metric header
+     * @param instrument instrument type
+     * @return true if bins were assigned, and records must be compressed
+     */
+    static bool populate_legacy_bins(const std::string& filename,
+                                     model::metric_base::metric_set<model::metrics::q_metric>& header,
+                                     const constants::instrument_type instrument)
+    {
+        typedef model::metric_base::metric_set<model::metrics::q_metric> q_metric_set_t;
+        typedef model::metrics::q_metric::uint_t uint_t;
+        const size_t max_bin_count = 7;
+        if(header.version() > 4 || header.bin_count() > 0) return false;
+        std::set<uint_t> bins_found;
+        record_reader<q_metric_set_t> reader(filename);
+        while(reader.next() && bins_found.size() <= max_bin_count)
+        {
+            const std::vector<uint_t>& hist = reader.record().qscore_hist();
+            for(uint_t i=0;i<static_cast<uint_t>(hist.size());++i)
+                if(hist[i] > 0) bins_found.insert(i);
+        }
+        if(!logic::metric::requires_legacy_bins(bins_found.size())) return false;
+        logic::metric::populate_legacy_q_score_bins(header.bins(), instrument, bins_found.size());
+        return true;
+    }
+    /** Compress a record into the bins of its header
+     */
+    template<class Metric, class Header>
+    static void compress_record(Metric&, const Header&)
+    {
+    }
+    /** Compress a q-metric record into the bins of its header
+     *
+     * @param metric q-metric
+     * @param header q-metric header
+     */
+    static void compress_record(model::metrics::q_metric& metric,
+                                const model::metric_base::metric_set<model::metrics::q_metric>& header)
+    {
+        metric.compress(header);
+    }
+    /** Replace one file with another
+     *
+     * @param source file to rename
+     * @param destination file to replace
+     */
+    static void replace_file(const std::string& source, const std::string& destination)
+    {
+#ifdef WIN32
+        std::remove(destination.c_str());
+#endif
+        if(std::rename(source.c_str(), destination.c_str()) != 0)
+        {
+            std::remove(source.c_str());
+            INTEROP_THROW(file_not_found_exception, "Unable to replace file: " << destination);
+        }
+    }
+    /** Rewrite a single InterOp file, if a newer version stores all of its data
+     *
+     * @param result file to convert, updated with the versions and number of records written
+     * @param instrument instrument type used to assign legacy q-score bins
+     */
+    template<class MetricSet>
+    static void convert_interop(converted_interop& result, const constants::instrument_type instrument)
+    {
+        typedef typename MetricSet::metric_type metric_t;
+        typedef metric_format_factory<metric_t> factory_t;
+        typedef typename factory_t::abstract_metric_format_t abstract_metric_format_t;
+
+        util::scoped_trace trace("convert_interop", "io", MetricSet::prefix(), MetricSet::suffix());
+        record_reader<MetricSet> reader(result.filename);
+        MetricSet header(reader.header(), reader.version());
+        result.source_version = reader.version();
+        const bool compress = populate_legacy_bins(result.filename, header, instrument);
+        result.target_version = lossless_version(static_cast<constants::metric_group>(MetricSet::TYPE),
+                                                 reader.version(),
+                                                 latest_version<metric_t>(),
+                                                 has_bins(header));
+        if(!compress && result.target_version == result.source_version) return;
+        header.set_version(result.target_version);
+
+        abstract_metric_format_t* format = &*factory_t::metric_formats()[result.target_version];
+        const std::string temp_filename = result.filename + ".tmp";
+        try
+        {
+            std::ofstream fout(temp_filename.c_str(), std::ios::binary);
+            if(!fout.good()) INTEROP_THROW(file_not_found_exception, "Unable to write file: " << temp_filename);
+            format->write_metric_header(fout, header);
+            metric_t compressed(header);
+            while(reader.next())
+            {
+                if(compress)
+                {
+                    compressed = reader.record();
+                    compress_record(compressed, header);
+                    format->write_metric(fout, compressed, header);
+                }
+                else format->write_metric(fout, reader.record(), header);
+                ++result.record_count;
+            }
+            fout.close();
+            if(fout.fail()) INTEROP_THROW(file_not_found_exception, "Unable to write file: " << temp_filename);
+        }
+        catch(...)
+        {
+            std::remove(temp_filename.c_str());
+            throw;
+        }
+        reader.close();
+        replace_file(temp_filename, result.filename);
+        trace.add_records(result.record_count);
+    }
+    /** List the InterOp files found in a run folder
+     */
+    struct list_interop_files
+    {
+        /** Constructor
+         *
+         * @param run_folder run folder path
+         * @param last_cycle last cycle to check for by cycle files
+         * @param files destination list of files
+         */
+        list_interop_files(const std::string& run_folder, const size_t last_cycle, converted_interop_vector& files) :
+                m_run_folder(run_folder),
+                m_last_cycle(last_cycle),
+                m_files(files)
+        {}
+        /** List the files of a single metric group
+         */
+        template<class MetricSet>
+        void operator()(const MetricSet&)const
+        {
+            const constants::metric_group group = static_cast<constants::metric_group>(MetricSet::TYPE);
+            std::vector<std::string> files;
+            for(int use_out=1;use_out >= 0;--use_out)
+            {
+                list_interop_filenames<MetricSet>(files, m_run_folder, m_last_cycle, use_out != 0);
+                for(size_t i=0;i<files.size();++i)
+                {
+                    if(is_file_readable(files[i]))
+                        m_files.push_back(converted_interop(files[i], group));
+                }
+            }
+        }
+
+    private:
+        std::string m_run_folder;
+        size_t m_last_cycle;
+        converted_interop_vector& m_files;
+    };
+    /** Convert a single InterOp file
+     */
+    struct convert_interop_file
+    {
+        /** Constructor
+         *
+         * @param result file to convert
+         * @param instrument instrument type used to assign legacy q-score bins
+         */
+        convert_interop_file(converted_interop& result, const constants::instrument_type instrument) :
+                m_result(result),
+                m_instrument(instrument)
+        {}
+        /** Convert the file if it belongs to this metric group
+         */
+        template<class MetricSet>
+        void operator()(const MetricSet&)const
+        {
+            if(static_cast<constants::metric_group>(MetricSet::TYPE) != m_result.group) return;
+            convert_interop<MetricSet>(m_result, m_instrument);
+        }
+
+    private:
+        converted_interop& m_result;
+        constants::instrument_type m_instrument;
+    };
+
+    /** Convert a single InterOp file on a pool
+     */
+    class convert_interop_file_task
+    {
+    public:
+        /** Constructor
+         *
+         * @param run run metrics, used to dispatch on the metric group
+         * @param result file to convert
+         * @param instrument instrument type used to assign legacy q-score bins
+         */
+        convert_interop_file_task(const model::metrics::run_metrics& run,
+                                  converted_interop& result,
+                                  const constants::instrument_type instrument) :
+                m_run(&run),
+                m_result(&result),
+                m_instrument(instrument)
+        {}
+        /** Convert the file
+         */
+        void operator()()const
+        {
+            convert_interop_file convert_file(*m_result, m_instrument);
+            m_run->metrics_callback(convert_file);
+        }
+
+    private:
+        const model::metrics::run_metrics* m_run;
+        converted_interop* m_result;
+        constants::instrument_type m_instrument;
+    };
+
+    void convert_run(const std::string& run_folder,
+                     converted_interop_vector& converted,
+                     const size_t thread_count) throw(xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception)
+    {
+        util::scoped_trace trace("convert_run", "io");
+        model::metrics::run_metrics run;
+        run.read_run_info(run_folder);
+        try
+        {
+            run.read_run_parameters(run_folder, true);
+        }
+        catch(const io::file_not_found_exception&){}// Only needed to bin legacy q-metrics
+        const constants::instrument_type instrument = run.run_parameters().instrument_type();
+
+        converted.clear();
+        list_interop_files list_files(run_folder, run.run_info().total_cycles(), converted);
+        run.metrics_callback(list_files);
+        trace.add_records(converted.size());
+
+        if(thread_count > 1)
+        {
+            util::thread_pool pool(thread_count);
+            util::task_group tasks(pool);
+            for(size_t i=0;i<converted.size();++i)
+                tasks.run(convert_interop_file_task(run, converted[i], instrument));
+            try
+            {
+                tasks.wait();
+            }
+            catch(const io::file_not_found_exception&)
+            {
+                throw;
+            }
+            catch(const io::bad_format_exception&)
+            {
+                throw;
+            }
+            catch(const io::incomplete_file_exception&)
+            {
+                throw;
+            }
+            catch(const std::exception& ex)
+            {
+                throw io::bad_format_exception(ex.what());
+            }
+            return;
+        }
+        for(size_t i=0;i<converted.size();++i)
+        {
+            convert_interop_file convert_file(converted[i], instrument);
+            run.metrics_callback(convert_file);
+        }
+    }
+}}}
@@ -0,0 +1,438 @@
+/** Cache of loaded runs kept resident in memory
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include "interop/io/run_cache.h"
+
+#include "interop/io/metric_file_stream.h"
+#include "interop/io/paths.h"
+#include "interop/logic/metric/q_metric.h"
+#include "interop/util/filesystem.h"
+#include "interop/util/timer.h"
+#include "interop/util/trace.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    /** Offset basis of the 64-bit FNV-1a hash */
+    static const ::uint64_t FNV_OFFSET_BASIS = (static_cast< ::uint64_t >(0xcbf29ce4u) << 32) | 0x84222325u;
+    /** Prime of the 64-bit FNV-1a hash */
+    static const ::uint64_t FNV_PRIME = (static_cast< ::uint64_t >(0x100u) << 32) | 0x1b3u;
+
+    /** Mix a value into a 64-bit FNV-1a hash
+     *
+     * @param hash current hash
+     * @param value value to mix in
+     * @return updated hash
+     */
+    static ::uint64_t mix_signature(::uint64_t hash, const ::uint64_t value)
+    {
+        for(size_t i=0;i<8;++i)
+        {
+            hash ^= (value >> (i*8)) & 0xff;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+    /** Mix the size and modification time of a file into a hash
+     *
+     * A missing file leaves the hash unchanged.
+     *
+     * @param hash current hash
+     * @param index position of the file in its list
+     * @param filename path to the file
+     * @param byte_count running total of the bytes of existing files
+     * @return updated hash
+     */
+    static ::uint64_t mix_file_signature(::uint64_t hash,
+                                         const size_t index,
+                                         const std::string& filename,
+                                         ::uint64_t& byte_count)
+    {
+        const ::int64_t size = file_size(filename);
+        if(size < 0) return hash;
+        byte_count += static_cast< ::uint64_t >(size);
+        hash = mix_signature(hash, index);
+        hash = mix_signature(hash, static_cast< ::uint64_t >(size));
+        return mix_signature(hash, static_cast< ::uint64_t >(file_modification_time(filename)));
+    }
+    /** Remove trailing path separators so equivalent run folders share an entry
+     *
+     * @param run_folder run folder path
+     * @return normalized run folder path
+     */
+    static std::string normalize_run_folder(const std::string& run_folder)
+    {
+        std::string::size_type last = run_folder.find_last_not_of("/\\");
+        if(last == std::string::npos) return run_folder;
+        return run_folder.substr(0, last+1);
+    }
+
+    /** Compute a signature of the InterOp files of each metric group
+     *
+     * Both the aggregate and the per cycle files, with and without the 'Out' suffix, are included.
+     */
+    class compute_group_signatures
+    {
+    public:
+        /** Constructor
+         *
+         * @param run_folder run folder path
+         * @param last_cycle last cycle of the run
+         * @param signatures destination signatures indexed by metric group
+         * @param byte_count destination total size of the InterOp files
+         */
+        compute_group_signatures(const std::string& run_folder,
+                                 const size_t last_cycle,
+                                 std::vector< ::uint64_t >& signatures,
+                                 ::uint64_t& byte_count) :
+                m_run_folder(run_folder),
+                m_last_cycle(last_cycle),
+                m_signatures(signatures),
+                m_byte_count(byte_count)
+        {
+            m_signatures.assign(static_cast<size_t>(constants::MetricCount), 0);
+            m_byte_count = 0;
+        }
+        /** Compute the signature of a single metric group
+         *
+         * @param metrics metric set
+         */
+        template<class MetricSet>
+        void operator()(const MetricSet& metrics)const
+        {
+            ::uint64_t hash = FNV_OFFSET_BASIS;
+            std::vector<std::string> files;
+            for(int use_out=1;use_out>=0;--use_out)
+            {
+                io::list_interop_filenames<MetricSet>(files, m_run_folder, m_last_cycle, use_out != 0);
+                for(size_t i=0;i<files.size();++i)
+                    hash = mix_file_signature(hash, i*2+static_cast<size_t>(use_out), files[i], m_byte_count);
+            }
+            m_signatures[static_cast<size_t>(MetricSet::TYPE)] = hash;
+            (void)metrics;
+        }
+
+    private:
+        std::string m_run_folder;
+        size_t m_last_cycle;
+        std::vector< ::uint64_t >& m_signatures;
+        ::uint64_t& m_byte_count;
+    };
+    /** Sum the memory held by the records of each metric set
+     */
+    class sum_record_bytes
+    {
+    public:
+        /** Constructor
+         *
+         * @param byte_count destination number of bytes
+         */
+        sum_record_bytes(::uint64_t& byte_count) : m_byte_count(byte_count){}
+        /** Add the memory held by the records of a metric set
+         *
+         * @param metrics metric set
+         */
+        template<class MetricSet>
+        void operator()(const MetricSet& metrics)const
+        {
+            m_byte_count += static_cast< ::uint64_t >(metrics.capacity()) *
+                    sizeof(typename MetricSet::metric_type);
+        }
+
+    private:
+        ::uint64_t& m_byte_count;
+    };
+    /** Clear the selected metric sets
+     */
+    class clear_metric_groups
+    {
+    public:
+        /** Constructor
+         *
+         * @param groups flag for each metric group, non-zero to clear
+         */
+        clear_metric_groups(const std::vector<unsigned char>& groups) : m_groups(groups){}
+        /** Clear the metric set if selected
+         *
+         * @param metrics metric set
+         */
+        template<class MetricSet>
+        void operator()(MetricSet& metrics)const
+        {
+            if(m_groups[static_cast<size_t>(MetricSet::TYPE)]) metrics.clear();
+        }
+
+    private:
+        const std::vector<unsigned char>& m_groups;
+    };
+
+    /** Compute a signature of the XML files of a run
+     *
+     * @param run_folder run folder path
+     * @return signature
+     */
+    static ::uint64_t xml_signature(const std::string& run_folder)
+    {
+        ::uint64_t byte_count = 0;
+        ::uint64_t hash = FNV_OFFSET_BASIS;
+        hash = mix_file_signature(hash, 0, paths::run_info(run_folder), byte_count);
+        hash = mix_file_signature(hash, 1, paths::run_parameters(run_folder), byte_count);
+        return mix_file_signature(hash, 2, paths::run_parameters(run_folder, true), byte_count);
+    }
+
+    /** Get a loaded run, loading or refreshing it if necessary
+     *
+     * @param run_folder run folder path
+     * @return loaded and frozen run metrics
+     */
+    const model::metrics::run_metrics& run_cache::get(const std::string& run_folder) throw(
+    xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_channel_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_tile_naming_method,
+    model::invalid_run_info_exception,
+    model::invalid_parameter)
+    {
+        const std::string key = normalize_run_folder(run_folder);
+        entry_map_t::iterator it = m_index.find(key);
+        if(it != m_index.end())
+        {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            cache_entry& entry = m_entries.front();
+            const double now = util::wall_time();
+            try
+            {
+                if(now - entry.last_check < m_refresh_interval || !refresh(entry, now)) ++m_statistics.hit_count;
+            }
+            catch(...)
+            {
+                evict(key);
+                throw;
+            }
+            evict_over_budget();
+            return m_entries.front().run;
+        }
+        m_entries.push_front(cache_entry(key));
+        try
+        {
+            load(m_entries.front());
+        }
+        catch(...)
+        {
+            m_entries.pop_front();
+            throw;
+        }
+        m_index[key] = m_entries.begin();
+        m_resident_bytes += m_entries.front().resident_bytes;
+        ++m_statistics.load_count;
+        evict_over_budget();
+        return m_entries.front().run;
+    }
+    /** Check a resident run for changed files immediately, ignoring the refresh interval
+     *
+     * @param run_folder run folder path
+     * @return true if any file was reloaded, false if the run is not resident or unchanged
+     */
+    bool run_cache::refresh(const std::string& run_folder) throw(xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_channel_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_tile_naming_method,
+    model::invalid_run_info_exception,
+    model::invalid_parameter)
+    {
+        entry_map_t::iterator it = m_index.find(normalize_run_folder(run_folder));
+        if(it == m_index.end()) return false;
+        bool changed;
+        try
+        {
+            changed = refresh(*it->second, util::wall_time());
+        }
+        catch(...)
+        {
+            evict(run_folder);
+            throw;
+        }
+        evict_over_budget();
+        return changed;
+    }
+    /** Remove a run from the cache
+     *
+     * @param run_folder run folder path
+     * @return true if the run was resident
+     */
+    bool run_cache::evict(const std::string& run_folder)
+    {
+        entry_map_t::iterator it = m_index.find(normalize_run_folder(run_folder));
+        if(it == m_index.end()) return false;
+        m_resident_bytes -= it->second->resident_bytes;
+        m_entries.erase(it->second);
+        m_index.erase(it);
+        return true;
+    }
+    /** Remove all runs from the cache
+     */
+    void run_cache::clear()
+    {
+        m_entries.clear();
+        m_index.clear();
+        m_resident_bytes = 0;
+    }
+    /** Test if a run is resident
+     *
+     * @param run_folder run folder path
+     * @return true if the run is resident
+     */
+    bool run_cache::contains(const std::string& run_folder)const
+    {
+        return m_index.find(normalize_run_folder(run_folder)) != m_index.end();
+    }
+    /** List the resident runs, most recently used first
+     *
+     * @param run_folders destination list of run folders
+     */
+    void run_cache::list_runs(string_vector& run_folders)const
+    {
+        run_folders.clear();
+        run_folders.reserve(m_entries.size());
+        for(entry_list_t::const_iterator it = m_entries.begin();it != m_entries.end();++it)
+            run_folders.push_back(it->run_folder);
+    }
+
+    /** Load a run from scratch
+     *
+     * The signatures are computed before the files are read, so a file written during the load is reloaded by the
+     * next refresh.
+     *
+     * @param entry cache entry
+     */
+    void run_cache::load(cache_entry& entry)
+    {
+        util::scoped_trace trace("run_cache_load", "cache");
+        entry.last_check = util::wall_time();
+        entry.xml_signature = xml_signature(entry.run_folder);
+        entry.run.clear();
+        entry.run.read_xml(entry.run_folder);
+        const size_t last_cycle = entry.run.run_info().total_cycles();
+        ::uint64_t file_bytes;
+        compute_group_signatures compute_signatures(entry.run_folder, last_cycle, entry.group_signatures, file_bytes);
+        entry.run.metrics_callback(compute_signatures);
+        entry.run.read_metrics(entry.run_folder, last_cycle, m_thread_count);
+        // Kept so a refresh bins reloaded legacy q-metrics the same way
+        entry.legacy_bin_count = entry.run.count_legacy_bins();
+        entry.run.finalize_after_load(entry.legacy_bin_count);
+        update_entry(entry, file_bytes);
+    }
+    /** Reload the metric groups whose files changed
+     *
+     * If the reload fails, the caller evicts the partially loaded run.
+     *
+     * A change to RunInfo.xml or RunParameters.xml reloads the whole run. Otherwise, the changed metric groups are
+     * cleared and read again, along with the groups derived from them during finalization.
+     *
+     * @param entry cache entry
+     * @param now current time
+     * @return true if any file was reloaded
+     */
+    bool run_cache::refresh(cache_entry& entry, const double now)
+    {
+        entry.last_check = now;
+        const ::uint64_t previous_bytes = entry.resident_bytes;
+        if(xml_signature(entry.run_folder) != entry.xml_signature)
+        {
+            load(entry);
+        }
+        else
+        {
+            std::vector< ::uint64_t > signatures;
+            ::uint64_t file_bytes;
+            const size_t last_cycle = entry.run.run_info().total_cycles();
+            compute_group_signatures compute_signatures(entry.run_folder, last_cycle, signatures, file_bytes);
+            entry.run.metrics_callback(compute_signatures);
+            std::vector<unsigned char> changed(signatures.size(), 0);
+            bool any_changed = false;
+            for(size_t i=0;i<signatures.size();++i)
+            {
+                if(i < entry.group_signatures.size() && signatures[i] == entry.group_signatures[i]) continue;
+                changed[i] = 1;
+                any_changed = true;
+            }
+            if(!any_changed) return false;
+
+            util::scoped_trace trace("run_cache_refresh", "cache");
+            // Legacy q-metrics are binned and compressed together, so both sets are reloaded if either changed
+            const bool reload_q = changed[constants::Q] || changed[constants::QByLane];
+            if(reload_q && logic::metric::requires_legacy_bins(entry.legacy_bin_count))
+            {
+                changed[constants::Q] = 1;
+                changed[constants::QByLane] = 1;
+            }
+            if(changed[constants::Q])
+            {
+                changed[constants::QByLane] = 1;
+                changed[constants::QCollapsed] = 1;
+            }
+            if(changed[constants::EmpiricalPhasing] || changed[constants::Tile])
+                changed[constants::DynamicPhasing] = 1;
+            clear_metric_groups clear_changed(changed);
+            entry.run.metrics_callback(clear_changed);
+            entry.run.read_metrics(entry.run_folder, last_cycle, changed, m_thread_count);
+            // Q-metrics that were not reloaded already carry their bins, and must not be binned again
+            entry.run.finalize_after_load(reload_q ? entry.legacy_bin_count : 0);
+            entry.group_signatures.swap(signatures);
+            update_entry(entry, file_bytes);
+        }
+        m_resident_bytes = m_resident_bytes - previous_bytes + entry.resident_bytes;
+        ++m_statistics.refresh_count;
+        return true;
+    }
+    /** Freeze a loaded run and record its estimated memory
+     *
+     * The memory estimate is the storage of the records plus the size of the InterOp files, which approximates the
+     * per record data (e.g. histograms) held outside the records themselves.
+     *
+     * @param entry cache entry
+     * @param file_bytes total size of the InterOp files, measured before they were read
+     */
+    void run_cache::update_entry(cache_entry& entry, const ::uint64_t file_bytes)
+    {
+        entry.run.freeze(m_thread_count);
+        ::uint64_t record_bytes = 0;
+        sum_record_bytes sum_bytes(record_bytes);
+        entry.run.metrics_callback(sum_bytes);
+        entry.resident_bytes = record_bytes + file_bytes;
+    }
+    /** Evict the least recently used runs until the resident runs fit in the memory budget
+     *
+     * The most recently used run is never evicted.
+     */
+    void run_cache::evict_over_budget()
+    {
+        if(m_memory_budget == 0) return;
+        while(m_resident_bytes > m_memory_budget && m_entries.size() > 1)
+        {
+            cache_entry& entry = m_entries.back();
+            m_resident_bytes -= entry.resident_bytes;
+            m_index.erase(entry.run_folder);
+            m_entries.pop_back();
+            ++m_statistics.eviction_count;
+        }
+    }
+}}}
+
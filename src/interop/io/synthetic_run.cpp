@@ -0,0 +1,1126 @@
+/** Generate synthetic run folders of any size
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/io/synthetic_run.h"
+
+#include <cmath>
+#include <fstream>
+#include <vector>
+#include "interop/util/filesystem.h"
+#include "interop/util/lexical_cast.h"
+#include "interop/io/paths.h"
+#include "interop/io/format/metric_format_factory.h"
+#include "interop/logic/metric/tile_metric.h"
+#include "interop/model/metrics/corrected_intensity_metric.h"
+#include "interop/model/metrics/error_metric.h"
+#include "interop/model/metrics/extraction_metric.h"
+#include "interop/model/metrics/image_metric.h"
+#include "interop/model/metrics/index_metric.h"
+#include "interop/model/metrics/phasing_metric.h"
+#include "interop/model/metrics/q_metric.h"
+#include "interop/model/metrics/tile_metric.h"
+#include "interop/util/thread_pool.h"
+
+namespace illumina { namespace interop { namespace io
+{
+    using namespace model::metrics;
+    /** Unsigned 32-bit integer */
+    typedef ::uint32_t synthetic_uint_t;
+
+    /** Mix two values into a well distributed hash
+     *
+     * This is used to derive an independent random stream for each tile, or each metric group and cycle, so the
+     * generated values do not depend on the order in which the tasks run.
+     *
+     * @param lhs first value
+     * @param rhs second value
+     * @return hash
+     */
+    static synthetic_uint_t synthetic_hash(synthetic_uint_t lhs, const synthetic_uint_t rhs)
+    {
+        lhs ^= rhs + 0x9e3779b9u + (lhs << 6) + (lhs >> 2);
+        lhs ^= lhs >> 16;
+        lhs *= 0x85ebca6bu;
+        lhs ^= lhs >> 13;
+        lhs *= 0xc2b2ae35u;
+        lhs ^= lhs >> 16;
+        return lhs;
+    }
+
+    /** Small, portable random number generator (xorshift)
+     */
+    class synthetic_random
+    {
+    public:
+        /** Constructor
+         *
+         * @param seed seed of the generator
+         */
+        synthetic_random(const synthetic_uint_t seed) : m_state(seed == 0 ? 0x6d2b79f5u : seed){}
+        /** Generate a uniform random number in [0, 1)
+         *
+         * @return random number
+         */
+        float uniform()
+        {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return static_cast<float>(m_state >> 8) / 16777216.0f;
+        }
+        /** Generate an approximately normal random number
+         *
+         * This uses the sum of four uniform numbers, which is fast and bounded.
+         *
+         * @param mean mean of the distribution
+         * @param sd standard deviation of the distribution
+         * @return random number
+         */
+        float normal(const float mean, const float sd)
+        {
+            const float sum = uniform() + uniform() + uniform() + uniform();
+            return mean + sd * (sum - 2.0f) * 1.7320508f;
+        }
+        /** Generate an approximately normal random number clamped to a range
+         *
+         * @param mean mean of the distribution
+         * @param sd standard deviation of the distribution
+         * @param lower lower bound
+         * @param upper upper bound
+         * @return random number
+         */
+        float normal(const float mean, const float sd, const float lower, const float upper)
+        {
+            const float val = normal(mean, sd);
+            return val < lower ? lower : (val > upper ? upper : val);
+        }
+    private:
+        synthetic_uint_t m_state;
+    };
+
+    /** Properties that vary by tile, but are shared among all metric groups
+     */
+    struct synthetic_tile
+    {
+        /** Constructor
+         *
+         * @param lane_id lane number
+         * @param tile_id tile number
+         * @param seed seed of the run
+         */
+        synthetic_tile(const synthetic_uint_t lane_id, const synthetic_uint_t tile_id, const synthetic_uint_t seed) :
+                lane(lane_id), tile(tile_id)
+        {
+            synthetic_random random(synthetic_hash(synthetic_hash(seed, lane_id), tile_id));
+            cluster_count = random.normal(3.2e6f, 2.5e5f, 1e5f, 1e7f);
+            cluster_count_pf = cluster_count * random.normal(0.82f, 0.04f, 0.3f, 0.99f);
+            intensity = random.normal(1000.0f, 80.0f, 100.0f, 4000.0f);
+            quality_offset = random.normal(0.0f, 0.5f);
+        }
+        /** Lane number */
+        synthetic_uint_t lane;
+        /** Tile number */
+        synthetic_uint_t tile;
+        /** Number of clusters */
+        float cluster_count;
+        /** Number of clusters passing filter */
+        float cluster_count_pf;
+        /** Intensity at the first cycle */
+        float intensity;
+        /** Shift in mean q-score */
+        float quality_offset;
+    };
+
+    /** Metric groups written by the generator
+     */
+    enum synthetic_group
+    {
+        SyntheticTile,
+        SyntheticIndex,
+        SyntheticError,
+        SyntheticExtraction,
+        SyntheticImage,
+        SyntheticCorrectedInt,
+        SyntheticQ,
+        SyntheticPhasing,
+        SyntheticGroupCount
+    };
+
+    /** Shared state of a synthetic run
+     */
+    struct synthetic_context
+    {
+        /** Run folder */
+        std::string run_folder;
+        /** Run info */
+        model::run::info run_info;
+        /** Options */
+        synthetic_run_options options;
+        /** Tiles on the flowcell */
+        std::vector<synthetic_tile> tiles;
+        /** Read index of each cycle (0-based, indexed by cycle-1) */
+        std::vector<size_t> cycle_read;
+        /** Fraction of the read completed at each cycle (indexed by cycle-1) */
+        std::vector<float> cycle_fraction;
+        /** Index sequence of each sample */
+        std::vector<std::string> sample_sequences;
+        /** Fraction of clusters assigned to each sample */
+        std::vector<float> sample_fractions;
+        /** Q-score bins */
+        q_metric::header_type::qscore_bin_vector_type bins;
+    };
+
+    /** Stream records of a single metric type to a binary InterOp file
+     *
+     * For a format with one record per metric, the records are encoded directly into a buffer that is written to the
+     * file whenever it fills up. Otherwise, each record is written through a buffered stream.
+     */
+    template<class Metric>
+    class synthetic_record_writer
+    {
+        typedef metric_format_factory<Metric> factory_t;
+        typedef typename factory_t::metric_format_map metric_format_map;
+        typedef typename factory_t::abstract_metric_format_t format_t;
+        typedef typename Metric::header_type header_t;
+        enum{ BUFFER_SIZE = 1 << 20 };
+
+    public:
+        /** Constructor
+         *
+         * @param file_name destination file
+         * @param header header of the metric
+         * @param version version of the format
+         */
+        synthetic_record_writer(const std::string& file_name, const header_t& header, const ::int16_t version) :
+                m_header(header), m_buffer(BUFFER_SIZE), m_record_size(0), m_used(0)
+        {
+            metric_format_map& format_map = factory_t::metric_formats();
+            typename metric_format_map::iterator it = format_map.find(version);
+            if(it == format_map.end())
+                INTEROP_THROW(bad_format_exception, "No format found to write " << Metric::prefix() << Metric::suffix()
+                                                    << " with version: " << version);
+            m_format = &*it->second;
+            if(m_format->is_multi_record())
+                m_out.rdbuf()->pubsetbuf(&m_buffer.front(), static_cast<std::streamsize>(m_buffer.size()));
+            else
+                m_record_size = m_format->record_size(m_header);
+            m_out.open(file_name.c_str(), std::ios::binary);
+            if(!m_out.good()) INTEROP_THROW(file_not_found_exception, "File not found: " << file_name);
+            m_format->write_metric_header(m_out, m_header);
+        }
+        /** Write a single metric record
+         *
+         * @param metric metric record
+         */
+        void write(const Metric& metric)
+        {
+            if(m_record_size == 0)
+            {
+                m_format->write_metric(m_out, metric, m_header);
+                return;
+            }
+            if(m_used + m_record_size > m_buffer.size()) flush();
+            m_format->write_record(&m_buffer[m_used], metric, m_header);
+            m_used += m_record_size;
+        }
+        /** Close the file
+         *
+         * @return number of bytes written
+         */
+        ::uint64_t close()
+        {
+            flush();
+            const std::streamoff size = m_out.tellp();
+            m_out.close();
+            if(m_out.fail()) INTEROP_THROW(bad_format_exception, "Failed to write " << Metric::prefix()
+                                                                  << Metric::suffix());
+            return static_cast< ::uint64_t >(size);
+        }
+
+    private:
+        void flush()
+        {
+            if(m_used == 0) return;
+            m_out.write(&m_buffer.front(), static_cast<std::streamsize>(m_used));
+            m_used = 0;
+        }
+
+    private:
+        header_t m_header;
+        std::vector<char> m_buffer;
+        size_t m_record_size;
+        size_t m_used;
+        std::ofstream m_out;
+        format_t* m_format;
+    };
+
+    /** Get the file name for a metric, either in the InterOp folder or in a cycle folder
+     *
+     * @param context shared state of the run
+     * @param cycle cycle folder, 0 for the InterOp folder
+     * @return file name
+     */
+    template<class Metric>
+    static std::string synthetic_filename(const synthetic_context& context, const size_t cycle)
+    {
+        if(cycle == 0) return paths::interop_filename<Metric>(context.run_folder);
+        return paths::interop_filename<Metric>(context.run_folder, cycle);
+    }
+
+    /** Write the tile metrics
+     *
+     * @param context shared state of the run
+     * @param cycle cycle folder, 0 for the InterOp folder
+     * @return number of bytes written
+     */
+    static ::uint64_t write_synthetic_tile_metrics(const synthetic_context& context, const size_t cycle)
+    {
+        synthetic_record_writer<tile_metric> writer(synthetic_filename<tile_metric>(context, cycle),
+                                                    tile_metric::header_type::default_header(),
+                                                    2);
+        synthetic_random random(synthetic_hash(context.options.seed, SyntheticTile));
+        const model::run::info::read_vector_t& reads = context.run_info.reads();
+        const float tile_area = 1.4f;
+        for(size_t i=0;i<context.tiles.size();++i)
+        {
+            const synthetic_tile& tile = context.tiles[i];
+            tile_metric::read_metric_vector read_metrics;
+            for(size_t read=0;read<reads.size();++read)
+            {
+                if(reads[read].is_index()) continue;
+                read_metrics.push_back(tile_metric::read_metric_type(reads[read].number(),
+                                                                     random.normal(92.0f, 3.0f, 0.0f, 100.0f),
+                                                                     random.normal(0.12f, 0.03f, 0.0f, 1.0f),
+                                                                     random.normal(0.1f, 0.03f, 0.0f, 1.0f)));
+            }
+            writer.write(tile_metric(tile.lane,
+                                     tile.tile,
+                                     tile.cluster_count / tile_area,
+                                     tile.cluster_count_pf / tile_area,
+                                     tile.cluster_count,
+                                     tile.cluster_count_pf,
+                                     read_metrics));
+        }
+        return writer.close();
+    }
+
+    /** Write the index metrics
+     *
+     * @param context shared state of the run
+     * @param cycle cycle folder, 0 for the InterOp folder
+     * @return number of bytes written
+     */
+    static ::uint64_t write_synthetic_index_metrics(const synthetic_context& context, const size_t cycle)
+    {
+        synthetic_record_writer<index_metric> writer(synthetic_filename<index_metric>(context, cycle),
+                                                     index_metric::header_type::default_header(),
+                                                     1);
+        synthetic_random random(synthetic_hash(context.options.seed, SyntheticIndex));
+        const model::run::info::read_vector_t& reads = context.run_info.reads();
+        for(size_t i=0;i<context.tiles.size();++i)
+        {
+            const synthetic_tile& tile = context.tiles[i];
+            for(size_t read=0;read<reads.size();++read)
+            {
+                if(!reads[read].is_index()) continue;
+                index_metric::index_array_t indices;
+                indices.reserve(context.sample_sequences.size());
+                for(size_t sample=0;sample<context.sample_sequences.size();++sample)
+                {
+                    const float clusters = tile.cluster_count_pf * context.sample_fractions[sample]
+                                           * random.normal(1.0f, 0.02f, 0.0f, 2.0f);
+                    indices.push_back(index_metric::index_info_t(context.sample_sequences[sample],
+                                                                 util::lexical_cast<std::string>(sample+1),
+                                                                 "SyntheticProject",
+                                                                 static_cast< ::uint64_t >(clusters)));
+                }
+                writer.write(index_metric(tile.lane, tile.tile, reads[read].number(), indices));
+            }
+        }
+        return writer.close();
+    }
+
+    /** Generate error metrics, which are not reported for index reads
+     */
+    struct synthetic_error_generator
+    {
+        /** Metric type */
+        typedef error_metric metric_type;
+        /** Write skipped for index reads */
+        enum{ SKIP_INDEX = true };
+        /** Constructor
+         *
+         * @param context shared state of the run
+         */
+        synthetic_error_generator(const synthetic_context& context){(void)context;}
+        /** Header of the metric file
+         *
+         * @return header
+         */
+        metric_type::header_type header()const{return metric_type::header_type::default_header();}
+        /** Version of the metric file
+         *
+         * @return version
+         */
+        ::int16_t version()const{return 3;}
+        /** Prepare values shared by all tiles for a cycle
+         *
+         * @param fraction fraction of the read completed
+         */
+        void begin_cycle(const float fraction){m_fraction = fraction;}
+        /** Generate a metric record for a tile
+         *
+         * @param tile tile properties
+         * @param cycle cycle number
+         * @param random random number generator
+         * @return metric record
+         */
+        metric_type operator()(const synthetic_tile& tile, const synthetic_uint_t cycle, synthetic_random& random)
+        {
+            return metric_type(tile.lane,
+                               tile.tile,
+                               cycle,
+                               0.1f + 0.8f * m_fraction * m_fraction + std::fabs(random.normal(0.0f, 0.05f)));
+        }
+    private:
+        float m_fraction;
+    };
+
+    /** Generate extraction metrics, where intensity decays over the read
+     */
+    struct synthetic_extraction_generator
+    {
+        /** Metric type */
+        typedef extraction_metric metric_type;
+        /** Write skipped for index reads */
+        enum{ SKIP_INDEX = false };
+        /** Constructor
+         *
+         * @param context shared state of the run
+         */
+        synthetic_extraction_generator(const synthetic_context& context) :
+                m_max_intensity(context.run_info.channels().size()),
+                m_focus_score(context.run_info.channels().size()){}
+        /** Header of the metric file
+         *
+         * @return header
+         */
+        metric_type::header_type header()const
+        {
+            return metric_type::header_type(static_cast<metric_type::ushort_t>(m_focus_score.size()));
+        }
+        /** Version of the metric file
+         *
+         * @return version
+         */
+        ::int16_t version()const{return 3;}
+        /** Prepare values shared by all tiles for a cycle
+         *
+         * @param fraction fraction of the read completed
+         */
+        void begin_cycle(const float fraction){m_decay = 1.0f - 0.6f * fraction;}
+        /** Generate a metric record for a tile
+         *
+         * @param tile tile properties
+         * @param cycle cycle number
+         * @param random random number generator
+         * @return metric record
+         */
+        metric_type operator()(const synthetic_tile& tile, const synthetic_uint_t cycle, synthetic_random& random)
+        {
+            const float intensity = tile.intensity * m_decay;
+            for(size_t channel=0;channel<m_focus_score.size();++channel)
+            {
+                m_max_intensity[channel] = static_cast<metric_type::ushort_t>(
+                        random.normal(intensity * (1.0f - 0.15f * static_cast<float>(channel)),
+                                      intensity * 0.03f, 0.0f, 65535.0f));
+                m_focus_score[channel] = random.normal(2.4f, 0.1f, 0.0f, 10.0f);
+            }
+            return metric_type(tile.lane,
+                               tile.tile,
+                               cycle,
+                               1475280000ul + cycle * 300ul,
+                               m_max_intensity,
+                               m_focus_score);
+        }
+    private:
+        std::vector<metric_type::ushort_t> m_max_intensity;
+        std::vector<float> m_focus_score;
+        float m_decay;
+    };
+
+    /** Generate image metrics
+     */
+    struct synthetic_image_generator
+    {
+        /** Metric type */
+        typedef image_metric metric_type;
+        /** Write skipped for index reads */
+        enum{ SKIP_INDEX = false };
+        /** Constructor
+         *
+         * @param context shared state of the run
+         */
+        synthetic_image_generator(const synthetic_context& context) :
+                m_min_contrast(context.run_info.channels().size()),
+                m_max_contrast(context.run_info.channels().size()){}
+        /** Header of the metric file
+         *
+         * @return header
+         */
+        metric_type::header_type header()const
+        {
+            return metric_type::header_type(static_cast<metric_type::ushort_t>(m_min_contrast.size()));
+        }
+        /** Version of the metric file
+         *
+         * @return version
+         */
+        ::int16_t version()const{return 3;}
+        /** Prepare values shared by all tiles for a cycle
+         */
+        void begin_cycle(const float){}
+        /** Generate a metric record for a tile
+         *
+         * @param tile tile properties
+         * @param cycle cycle number
+         * @param random random number generator
+         * @return metric record
+         */
+        metric_type operator()(const synthetic_tile& tile, const synthetic_uint_t cycle, synthetic_random& random)
+        {
+            for(size_t channel=0;channel<m_min_contrast.size();++channel)
+            {
+                m_min_contrast[channel] = static_cast<metric_type::ushort_t>(random.normal(200.0f, 10.0f, 0.0f, 65535.0f));
+                m_max_contrast[channel] = static_cast<metric_type::ushort_t>(random.normal(450.0f, 20.0f, 0.0f, 65535.0f));
+            }
+            return metric_type(tile.lane,
+                               tile.tile,
+                               cycle,
+                               static_cast<metric_type::ushort_t>(m_min_contrast.size()),
+                               m_min_contrast,
+                               m_max_contrast);
+        }
+    private:
+        std::vector<metric_type::ushort_t> m_min_contrast;
+        std::vector<metric_type::ushort_t> m_max_contrast;
+    };
+
+    /** Generate corrected intensity metrics, where the fraction of no calls grows over the read
+     */
+    struct synthetic_corrected_intensity_generator
+    {
+        /** Metric type */
+        typedef corrected_intensity_metric metric_type;
+        /** Write skipped for index reads */
+        enum{ SKIP_INDEX = false };
+        /** Constructor
+         *
+         * @param context shared state of the run
+         */
+        synthetic_corrected_intensity_generator(const synthetic_context& context) :
+                m_called_intensity(constants::NUM_OF_BASES),
+                m_called_counts(constants::NUM_OF_BASES_AND_NC){(void)context;}
+        /** Header of the metric file
+         *
+         * @return header
+         */
+        metric_type::header_type header()const{return metric_type::header_type::default_header();}
+        /** Version of the metric file
+         *
+         * @return version
+         */
+        ::int16_t version()const{return 3;}
+        /** Prepare values shared by all tiles for a cycle
+         *
+         * @param fraction fraction of the read completed
+         */
+        void begin_cycle(const float fraction)
+        {
+            m_decay = 1.0f - 0.6f * fraction;
+            m_no_call = 0.001f + 0.01f * fraction * fraction;
+        }
+        /** Generate a metric record for a tile
+         *
+         * @param tile tile properties
+         * @param cycle cycle number
+         * @param random random number generator
+         * @return metric record
+         */
+        metric_type operator()(const synthetic_tile& tile, const synthetic_uint_t cycle, synthetic_random& random)
+        {
+            const float intensity = tile.intensity * m_decay;
+            float base_total = 0;
+            float base_fraction[constants::NUM_OF_BASES];
+            for(size_t base=0;base<constants::NUM_OF_BASES;++base)
+            {
+                base_fraction[base] = random.normal(0.25f, 0.01f, 0.01f, 1.0f);
+                base_total += base_fraction[base];
+                m_called_intensity[base] = random.normal(intensity * 0.7f, 30.0f, 0.0f, 65535.0f);
+            }
+            m_called_counts[0] = static_cast<synthetic_uint_t>(tile.cluster_count_pf * m_no_call);
+            for(size_t base=0;base<constants::NUM_OF_BASES;++base)
+            {
+                m_called_counts[base+1] = static_cast<synthetic_uint_t>(
+                        tile.cluster_count_pf * (1.0f - m_no_call) * base_fraction[base] / base_total);
+            }
+            return metric_type(tile.lane, tile.tile, cycle, m_called_intensity, m_called_counts);
+        }
+    private:
+        std::vector<float> m_called_intensity;
+        std::vector<synthetic_uint_t> m_called_counts;
+        float m_decay;
+        float m_no_call;
+    };
+
+    /** Generate q-score histograms, where the mean q-score drops over the read
+     */
+    struct synthetic_q_generator
+    {
+        /** Metric type */
+        typedef q_metric metric_type;
+        /** Write skipped for index reads */
+        enum{ SKIP_INDEX = false };
+        /** Constructor
+         *
+         * @param context shared state of the run
+         */
+        synthetic_q_generator(const synthetic_context& context) :
+                m_bins(context.bins),
+                m_histogram(context.bins.empty() ? static_cast<size_t>(metric_type::MAX_Q_BINS) : context.bins.size()),
+                m_quality(m_histogram.size()){}
+        /** Header of the metric file
+         *
+         * @return header
+         */
+        metric_type::header_type header()const{return metric_type::header_type(m_bins);}
+        /** Version of the metric file
+         *
+         * @return version
+         */
+        ::int16_t version()const{return static_cast< ::int16_t >(m_bins.empty() ? 4 : 6);}
+        /** Prepare values shared by all tiles for a cycle
+         *
+         * @param fraction fraction of the read completed
+         */
+        void begin_cycle(const float fraction)
+        {
+            const float mean = 37.0f - 6.0f * fraction * fraction;
+            const float sd = 4.0f + 2.0f * fraction;
+            float total = 0;
+            for(size_t bin=0;bin<m_quality.size();++bin)
+            {
+                const size_t lower = m_bins.empty() ? bin+1 : m_bins[bin].lower();
+                const size_t upper = m_bins.empty() ? bin+1 : m_bins[bin].upper();
+                m_quality[bin] = 0;
+                for(size_t q=lower;q<=upper;++q)
+                {
+                    const float z = (static_cast<float>(q) - mean) / sd;
+                    m_quality[bin] += std::exp(-0.5f*z*z);
+                }
+                total += m_quality[bin];
+            }
+            for(size_t bin=0;bin<m_quality.size();++bin) m_quality[bin] /= total;
+        }
+        /** Generate a metric record for a tile
+         *
+         * @param tile tile properties
+         * @param cycle cycle number
+         * @param random random number generator
+         * @return metric record
+         */
+        metric_type operator()(const synthetic_tile& tile, const synthetic_uint_t cycle, synthetic_random& random)
+        {
+            const float shift = 1.0f + tile.quality_offset * 0.01f;
+            for(size_t bin=0;bin<m_histogram.size();++bin)
+            {
+                const float weight = bin+1 < m_histogram.size() ? m_quality[bin] : m_quality[bin] * shift;
+                m_histogram[bin] = static_cast<synthetic_uint_t>(
+                        tile.cluster_count_pf * weight * random.normal(1.0f, 0.01f, 0.0f, 2.0f));
+            }
+            return metric_type(tile.lane, tile.tile, cycle, m_histogram);
+        }
+    private:
+        q_metric::header_type::qscore_bin_vector_type m_bins;
+        std::vector<synthetic_uint_t> m_histogram;
+        std::vector<float> m_quality;
+    };
+
+    /** Generate empirical phasing metrics
+     */
+    struct synthetic_phasing_generator
+    {
+        /** Metric type */
+        typedef phasing_metric metric_type;
+        /** Write skipped for index reads */
+        enum{ SKIP_INDEX = false };
+        /** Constructor
+         *
+         * @param context shared state of the run
+         */
+        synthetic_phasing_generator(const synthetic_context& context){(void)context;}
+        /** Header of the metric file
+         *
+         * @return header
+         */
+        metric_type::header_type header()const{return metric_type::header_type::default_header();}
+        /** Version of the metric file
+         *
+         * @return version
+         */
+        ::int16_t version()const{return 1;}
+        /** Prepare values shared by all tiles for a cycle
+         */
+        void begin_cycle(const float){}
+        /** Generate a metric record for a tile
+         *
+         * @param tile tile properties
+         * @param cycle cycle number
+         * @param random random number generator
+         * @return metric record
+         */
+        metric_type operator()(const synthetic_tile& tile, const synthetic_uint_t cycle, synthetic_random& random)
+        {
+            return metric_type(tile.lane,
+                               tile.tile,
+                               cycle,
+                               random.normal(0.1f, 0.02f, 0.0f, 1.0f),
+                               random.normal(0.08f, 0.02f, 0.0f, 1.0f));
+        }
+    };
+
+    /** Write the by cycle metrics for a range of cycles to a single file
+     *
+     * Each cycle draws from its own random stream, so the records are identical whether all cycles are written to one
+     * file or each cycle is written to its own folder.
+     *
+     * @param context shared state of the run
+     * @param group metric group to write
+     * @param first_cycle first cycle to write
+     * @param last_cycle last cycle to write
+     * @param cycle cycle folder, 0 for the InterOp folder
+     * @return number of bytes written
+     */
+    template<class Generator>
+    static ::uint64_t write_synthetic_cycle_metrics(const synthetic_context& context,
+                                                    const synthetic_group group,
+                                                    const size_t first_cycle,
+                                                    const size_t last_cycle,
+                                                    const size_t cycle)
+    {
+        typedef typename Generator::metric_type metric_t;
+        Generator generator(context);
+        synthetic_record_writer<metric_t> writer(synthetic_filename<metric_t>(context, cycle),
+                                                 generator.header(),
+                                                 generator.version());
+        const model::run::info::read_vector_t& reads = context.run_info.reads();
+        for(size_t cur_cycle=first_cycle;cur_cycle<=last_cycle;++cur_cycle)
+        {
+            if(Generator::SKIP_INDEX && reads[context.cycle_read[cur_cycle-1]].is_index()) continue;
+            const synthetic_uint_t cycle_id = static_cast<synthetic_uint_t>(cur_cycle);
+            synthetic_random random(synthetic_hash(synthetic_hash(context.options.seed, group), cycle_id));
+            generator.begin_cycle(context.cycle_fraction[cur_cycle-1]);
+            for(size_t i=0;i<context.tiles.size();++i)
+                writer.write(generator(context.tiles[i], cycle_id, random));
+        }
+        return writer.close();
+    }
+
+    /** A unit of work: one metric group written to one file
+     */
+    struct synthetic_task
+    {
+        /** Constructor
+         *
+         * @param group_id metric group
+         * @param first first cycle
+         * @param last last cycle
+         * @param folder cycle folder, 0 for the InterOp folder
+         */
+        synthetic_task(const synthetic_group group_id=SyntheticTile,
+                       const size_t first=0,
+                       const size_t last=0,
+                       const size_t folder=0) :
+                group(group_id), first_cycle(first), last_cycle(last), cycle(folder){}
+        /** Metric group */
+        synthetic_group group;
+        /** First cycle */
+        size_t first_cycle;
+        /** Last cycle */
+        size_t last_cycle;
+        /** Cycle folder, 0 for the InterOp folder */
+        size_t cycle;
+    };
+
+    /** Run a single task
+     *
+     * @param context shared state of the run
+     * @param task task to run
+     * @return number of bytes written
+     */
+    static ::uint64_t run_synthetic_task(const synthetic_context& context, const synthetic_task& task)
+    {
+        switch(task.group)
+        {
+            case SyntheticTile:
+                return write_synthetic_tile_metrics(context, task.cycle);
+            case SyntheticIndex:
+                return write_synthetic_index_metrics(context, task.cycle);
+            case SyntheticError:
+                return write_synthetic_cycle_metrics<synthetic_error_generator>(
+                        context, task.group, task.first_cycle, task.last_cycle, task.cycle);
+            case SyntheticExtraction:
+                return write_synthetic_cycle_metrics<synthetic_extraction_generator>(
+                        context, task.group, task.first_cycle, task.last_cycle, task.cycle);
+            case SyntheticImage:
+                return write_synthetic_cycle_metrics<synthetic_image_generator>(
+                        context, task.group, task.first_cycle, task.last_cycle, task.cycle);
+            case SyntheticCorrectedInt:
+                return write_synthetic_cycle_metrics<synthetic_corrected_intensity_generator>(
+                        context, task.group, task.first_cycle, task.last_cycle, task.cycle);
+            case SyntheticQ:
+                return write_synthetic_cycle_metrics<synthetic_q_generator>(
+                        context, task.group, task.first_cycle, task.last_cycle, task.cycle);
+            case SyntheticPhasing:
+                return write_synthetic_cycle_metrics<synthetic_phasing_generator>(
+                        context, task.group, task.first_cycle, task.last_cycle, task.cycle);
+            default:
+                INTEROP_THROW(model::invalid_parameter, "Unexpected metric group: " << task.group);
+        }
+    }
+
+    /** Run a single task on the thread pool
+     *
+     * The number of bytes written is stored in a slot owned by the task, so no lock is needed.
+     */
+    class synthetic_task_functor
+    {
+    public:
+        /** Constructor
+         *
+         * @param context shared state of the run
+         * @param task task to run
+         * @param byte_count destination for the number of bytes written
+         */
+        synthetic_task_functor(const synthetic_context& context,
+                               const synthetic_task& task,
+                               ::uint64_t& byte_count) :
+                m_context(&context), m_task(&task), m_byte_count(&byte_count){}
+        /** Run the task
+         */
+        void operator()()const
+        {
+            *m_byte_count = run_synthetic_task(*m_context, *m_task);
+        }
+
+    private:
+        const synthetic_context* m_context;
+        const synthetic_task* m_task;
+        ::uint64_t* m_byte_count;
+    };
+
+    /** Wait for the tasks to finish, and rethrow the first exception as one of the documented types
+     *
+     * @param tasks group of synthetic tasks
+     */
+    static void wait_for_synthetic_tasks(util::task_group& tasks)
+    throw(file_not_found_exception,
+    bad_format_exception,
+    model::invalid_parameter,
+    model::invalid_channel_exception,
+    xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception)
+    {
+        try
+        {
+            tasks.wait();
+        }
+        catch(const file_not_found_exception&)
+        {
+            throw;
+        }
+        catch(const bad_format_exception&)
+        {
+            throw;
+        }
+        catch(const model::invalid_parameter&)
+        {
+            throw;
+        }
+        catch(const model::invalid_channel_exception&)
+        {
+            throw;
+        }
+        catch(const xml::xml_file_not_found_exception&)
+        {
+            throw;
+        }
+        catch(const xml::bad_xml_format_exception&)
+        {
+            throw;
+        }
+        catch(const std::exception& ex)
+        {
+            throw bad_format_exception(ex.what());
+        }
+    }
+
+    /** List the tiles of the flowcell
+     *
+     * @param context shared state of the run
+     */
+    static void list_synthetic_tiles(synthetic_context& context)
+    {
+        const model::run::flowcell_layout& flowcell = context.run_info.flowcell();
+        const synthetic_uint_t seed = context.options.seed;
+        if(!flowcell.tiles().empty())
+        {
+            for(size_t i=0;i<flowcell.tiles().size();++i)
+            {
+                const synthetic_uint_t lane = logic::metric::lane_from_name(flowcell.tiles()[i]);
+                const synthetic_uint_t tile = logic::metric::tile_from_name(flowcell.tiles()[i]);
+                if(lane == 0 || tile == 0)
+                    INTEROP_THROW(model::invalid_parameter, "Invalid tile name: " << flowcell.tiles()[i]);
+                context.tiles.push_back(synthetic_tile(lane, tile, seed));
+            }
+            return;
+        }
+        const synthetic_uint_t section_count = std::max<synthetic_uint_t>(1, flowcell.sections_per_lane());
+        for(synthetic_uint_t lane=1;lane<=flowcell.lane_count();++lane)
+        {
+            for(synthetic_uint_t surface=1;surface<=flowcell.surface_count();++surface)
+            {
+                for(synthetic_uint_t swath=1;swath<=flowcell.swath_count();++swath)
+                {
+                    for(synthetic_uint_t section=1;section<=section_count;++section)
+                    {
+                        for(synthetic_uint_t tile=1;tile<=flowcell.tile_count();++tile)
+                        {
+                            switch(flowcell.naming_method())
+                            {
+                                case constants::FiveDigit:
+                                    context.tiles.push_back(synthetic_tile(
+                                            lane, surface*10000+swath*1000+section*100+tile, seed));
+                                    break;
+                                case constants::Absolute:
+                                    context.tiles.push_back(synthetic_tile(
+                                            lane,
+                                            (((surface-1)*flowcell.swath_count()+swath-1)*section_count+section-1)
+                                            *flowcell.tile_count()+tile,
+                                            seed));
+                                    break;
+                                default:
+                                    if(section > 1) break;
+                                    context.tiles.push_back(synthetic_tile(lane, surface*1000+swath*100+tile, seed));
+                                    break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /** Create the run info for a synthetic run
+     *
+     * @param lane_count number of lanes
+     * @param surface_count number of surfaces
+     * @param swath_count number of swaths per surface
+     * @param tile_count number of tiles per swath
+     * @param cycle_count total number of cycles
+     * @param channel_count number of image channels
+     * @return run info
+     */
+    model::run::info synthetic_run_info(const size_t lane_count,
+                                        const size_t surface_count,
+                                        const size_t swath_count,
+                                        const size_t tile_count,
+                                        const size_t cycle_count,
+                                        const size_t channel_count)
+                                        throw(model::invalid_parameter)
+    {
+        using namespace model::run;
+        typedef read_info::cycle_t cycle_t;
+        typedef flowcell_layout::uint_t uint_t;
+        if(lane_count == 0 || surface_count == 0 || swath_count == 0 || tile_count == 0 || cycle_count == 0)
+            INTEROP_THROW(model::invalid_parameter, "Flowcell layout and cycle count must be non-zero");
+        if(tile_count > 99 || swath_count > 9 || surface_count > 2)
+            INTEROP_THROW(model::invalid_parameter,
+                          "Four digit tile naming supports at most 2 surfaces, 9 swaths and 99 tiles");
+        const cycle_t cycles = static_cast<cycle_t>(cycle_count);
+        info::read_vector_t reads;
+        if(cycle_count >= 40)
+        {
+            const cycle_t index_cycles = 8;
+            const cycle_t read1 = (cycles-index_cycles)/2;
+            reads.push_back(read_info(1, 1, read1));
+            reads.push_back(read_info(2, read1+1, read1+index_cycles, true));
+            reads.push_back(read_info(3, read1+index_cycles+1, cycles));
+        }
+        else reads.push_back(read_info(1, 1, cycles));
+
+        info::str_vector_t channels;
+        if(channel_count == 2)
+        {
+            channels.push_back("Red");
+            channels.push_back("Green");
+        }
+        else if(channel_count == 4)
+        {
+            channels.push_back("A");
+            channels.push_back("C");
+            channels.push_back("G");
+            channels.push_back("T");
+        }
+        else
+        {
+            for(size_t i=0;i<channel_count;++i)
+                channels.push_back("Channel"+util::lexical_cast<std::string>(i+1));
+        }
+        const flowcell_layout flowcell(static_cast<uint_t>(lane_count),
+                                       static_cast<uint_t>(surface_count),
+                                       static_cast<uint_t>(swath_count),
+                                       static_cast<uint_t>(tile_count),
+                                       1,
+                                       1,
+                                       flowcell_layout::str_vector_t(),
+                                       constants::FourDigit);
+        return info(flowcell, reads, channels);
+    }
+
+    /** Write a synthetic run folder
+     *
+     * @param run_folder destination run folder
+     * @param run_info run info describing the flowcell, reads and channels
+     * @param options options that control the content of the run
+     * @return number of bytes written to the InterOp files
+     */
+    ::uint64_t write_synthetic_run(const std::string& run_folder,
+                                   const model::run::info& run_info,
+                                   const synthetic_run_options& options)
+                                   throw(file_not_found_exception,
+                                   bad_format_exception,
+                                   model::invalid_parameter,
+                                   model::invalid_channel_exception,
+                                   xml::xml_file_not_found_exception,
+                                   xml::bad_xml_format_exception)
+    {
+        typedef q_metric::header_type::bin_t bin_t;
+        typedef bin_t::bin_type bin_type;
+        const size_t channel_count = run_info.channels().size();
+        if(channel_count == 0 || channel_count > extraction_metric::MAX_CHANNELS)
+            INTEROP_THROW(model::invalid_channel_exception, "Channel count must be between 1 and "
+                    << extraction_metric::MAX_CHANNELS << ", found " << channel_count);
+        if(options.bin_count > static_cast<size_t>(q_metric::MAX_Q_BINS))
+            INTEROP_THROW(model::invalid_parameter, "Bin count must not exceed " << q_metric::MAX_Q_BINS);
+        if(run_info.reads().empty() || run_info.total_cycles() == 0)
+            INTEROP_THROW(model::invalid_parameter, "Run info must have at least one read");
+
+        synthetic_context context;
+        context.run_folder = run_folder;
+        context.run_info = run_info;
+        context.options = options;
+        list_synthetic_tiles(context);
+        if(context.tiles.empty()) INTEROP_THROW(model::invalid_parameter, "Run info has no tiles");
+
+        const size_t cycle_count = run_info.total_cycles();
+        context.cycle_read.assign(cycle_count, 0);
+        context.cycle_fraction.assign(cycle_count, 0.0f);
+        for(size_t read=0;read<run_info.reads().size();++read)
+        {
+            const model::run::read_info& info = run_info.reads()[read];
+            for(size_t cycle=info.first_cycle();cycle<=info.last_cycle() && cycle <= cycle_count;++cycle)
+            {
+                context.cycle_read[cycle-1] = read;
+                context.cycle_fraction[cycle-1] = static_cast<float>(cycle-info.first_cycle()+1)
+                                                  / static_cast<float>(info.total_cycles());
+            }
+        }
+
+        if(options.bin_count == 7)
+        {
+            const bin_type lower[] = {2, 10, 20, 25, 30, 35, 40};
+            const bin_type upper[] = {9, 19, 24, 29, 34, 39, 40};
+            const bin_type value[] = {2, 14, 21, 27, 32, 36, 40};
+            for(size_t i=0;i<options.bin_count;i++)
+                context.bins.push_back(bin_t(lower[i], upper[i], value[i]));
+        }
+        else if(options.bin_count > 0)
+        {
+            const size_t width = std::max<size_t>(1, q_metric::MAX_Q_BINS / options.bin_count);
+            for(size_t i=0;i<options.bin_count;i++)
+            {
+                const bin_type lower = static_cast<bin_type>(1+i*width);
+                const bin_type upper = static_cast<bin_type>(i+1 == options.bin_count ?
+                                                             q_metric::MAX_Q_BINS : lower+width-1);
+                context.bins.push_back(bin_t(lower, upper, static_cast<bin_type>((lower+upper)/2)));
+            }
+        }
+
+        synthetic_random random(synthetic_hash(options.seed, SyntheticGroupCount));
+        const char bases[] = {'A', 'C', 'G', 'T'};
+        float sample_total = 0;
+        for(size_t sample=0;sample<options.sample_count;++sample)
+        {
+            std::string sequence;
+            for(size_t i=0;i<17;++i)
+                sequence += i == 8 ? '-' : bases[static_cast<size_t>(random.uniform()*4) % 4];
+            context.sample_sequences.push_back(sequence);
+            context.sample_fractions.push_back(random.normal(1.0f, 0.2f, 0.1f, 2.0f));
+            sample_total += context.sample_fractions.back();
+        }
+        // About 90% of the clusters are assigned to a sample
+        for(size_t sample=0;sample<options.sample_count;++sample)
+            context.sample_fractions[sample] *= 0.9f / sample_total;
+
+        io::mkdir(run_folder);
+        const std::string interop_folder = io::dirname(paths::interop_filename<tile_metric>(run_folder));
+        io::mkdir(interop_folder);
+        run_info.write(paths::run_info(run_folder));
+
+        std::vector<synthetic_task> tasks;
+        const bool has_index = options.sample_count > 0 && run_info.is_indexed();
+        if(options.by_cycle)
+        {
+            for(size_t cycle=1;cycle<=cycle_count;++cycle)
+                io::mkdir(io::dirname(paths::interop_filename<tile_metric>(run_folder, cycle)));
+            tasks.push_back(synthetic_task(SyntheticTile, 0, 0, cycle_count));
+            if(has_index) tasks.push_back(synthetic_task(SyntheticIndex, 0, 0, cycle_count));
+            for(int group=SyntheticError;group<SyntheticGroupCount;++group)
+            {
+                for(size_t cycle=1;cycle<=cycle_count;++cycle)
+                {
+                    if(group == SyntheticError && run_info.reads()[context.cycle_read[cycle-1]].is_index()) continue;
+                    tasks.push_back(synthetic_task(static_cast<synthetic_group>(group), cycle, cycle, cycle));
+                }
+            }
+        }
+        else
+        {
+            tasks.push_back(synthetic_task(SyntheticTile));
+            if(has_index) tasks.push_back(synthetic_task(SyntheticIndex));
+            for(int group=SyntheticError;group<SyntheticGroupCount;++group)
+                tasks.push_back(synthetic_task(static_cast<synthetic_group>(group), 1, cycle_count, 0));
+        }
+
+        ::uint64_t byte_count = 0;
+        if(options.thread_count > 1)
+        {
+            std::vector< ::uint64_t > task_byte_count(tasks.size(), 0);
+            util::thread_pool pool(options.thread_count);
+            util::task_group group(pool);
+            for(size_t i=0;i<tasks.size();++i)
+                group.run(synthetic_task_functor(context, tasks[i], task_byte_count[i]));
+            wait_for_synthetic_tasks(group);
+            for(size_t i=0;i<task_byte_count.size();++i) byte_count += task_byte_count[i];
+            return byte_count;
+        }
+        for(size_t i=0;i<tasks.size();++i) byte_count += run_synthetic_task(context, tasks[i]);
+        return byte_count;
+    }
+}}}
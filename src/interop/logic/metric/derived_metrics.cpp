@@ -0,0 +1,79 @@
+/** Read-only access to metric sets derived from other metric sets of a run
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include "interop/logic/metric/derived_metrics.h"
+#include "interop/logic/metric/q_metric.h"
+#include "interop/logic/metric/dynamic_phasing_metric.h"
+
+
+namespace illumina { namespace interop { namespace logic { namespace metric
+{
+    /** Get the collapsed q-metrics of a run without modifying the run
+     *
+     * @param metrics run metrics
+     * @param scratch destination for the collapsed q-metrics, if the run has none
+     * @param cumulative populate the cumulative distribution of the scratch set
+     * @return collapsed q-metrics of the run, or the scratch set
+     */
+    const model::metric_base::metric_set<model::metrics::q_collapsed_metric>&
+    collapsed_q_metrics(const model::metrics::run_metrics& metrics,
+                        model::metric_base::metric_set<model::metrics::q_collapsed_metric>& scratch,
+                        const bool cumulative) throw(model::index_out_of_bounds_exception)
+    {
+        if(!metrics.get<model::metrics::q_collapsed_metric>().empty())
+            return metrics.get<model::metrics::q_collapsed_metric>();
+        scratch.clear();
+        create_collapse_q_metrics(metrics.get<model::metrics::q_metric>(), scratch);
+        if(cumulative) populate_cumulative_distribution(scratch);
+        return scratch;
+    }
+    /** Get the by lane q-metrics of a run without modifying the run
+     *
+     * @param metrics run metrics
+     * @param scratch destination for the by lane q-metrics, if the run has none
+     * @return by lane q-metrics of the run, or the scratch set
+     */
+    const model::metric_base::metric_set<model::metrics::q_by_lane_metric>&
+    q_metrics_by_lane(const model::metrics::run_metrics& metrics,
+                      model::metric_base::metric_set<model::metrics::q_by_lane_metric>& scratch)
+    throw(model::index_out_of_bounds_exception)
+    {
+        if(!metrics.get<model::metrics::q_by_lane_metric>().empty())
+            return metrics.get<model::metrics::q_by_lane_metric>();
+        scratch.clear();
+        create_q_metrics_by_lane(metrics.get<model::metrics::q_metric>(), scratch);
+        return scratch;
+    }
+    /** Get the dynamic phasing metrics of a run without modifying the run
+     *
+     * Deriving the dynamic phasing metrics also fills in missing phasing slopes of the tile metrics. These updates are
+     * made to a copy of the tile metrics, which is discarded.
+     *
+     * @param metrics run metrics
+     * @param cycle_to_read map of cycle to read information
+     * @param scratch destination for the dynamic phasing metrics, if the run has none
+     * @return dynamic phasing metrics of the run, or the scratch set
+     */
+    const model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>&
+    dynamic_phasing_metrics(const model::metrics::run_metrics& metrics,
+                            const logic::summary::read_cycle_vector_t& cycle_to_read,
+                            model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>& scratch)
+    {
+        if(!metrics.get<model::metrics::dynamic_phasing_metric>().empty() ||
+           metrics.get<model::metrics::phasing_metric>().empty())
+            return metrics.get<model::metrics::dynamic_phasing_metric>();
+        scratch.clear();
+        model::metric_base::metric_set<model::metrics::tile_metric> tile_metrics =
+                metrics.get<model::metrics::tile_metric>();
+        populate_dynamic_phasing_metrics(metrics.get<model::metrics::phasing_metric>(),
+                                         cycle_to_read,
+                                         scratch,
+                                         tile_metrics);
+        return scratch;
+    }
+
+}}}}
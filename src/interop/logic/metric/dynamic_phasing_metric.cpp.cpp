@@ -78,14 +78,13 @@ namespace illumina { namespace interop { namespace logic { namespace metric
                 //loop through all cycles in a read and populate the 3 arrays
                 for (uint32_t cycle = 0; cycle < cycle_to_read.size(); ++cycle)
                 {
-                    if (phasing_metrics.has_metric(lane, tile, cycle + 1))
+                    const model::metrics::phasing_metric* metric = phasing_metrics.try_get(lane, tile, cycle + 1);
+                    if (metric != 0)
                     {
-                        const model::metrics::phasing_metric metric = phasing_metrics.get_metric(lane, tile, cycle + 1);
-
                         max_cycle_relative_to_read = cycle_to_read[cycle].cycle_within_read;
                         cycles.push_back(static_cast<float>(max_cycle_relative_to_read));
-                        phasing_values.push_back(metric.phasing_weight());
-                        prephasing_values.push_back(metric.prephasing_weight());
+                        phasing_values.push_back(metric->phasing_weight());
+                        prephasing_values.push_back(metric->prephasing_weight());
                     }
                     if(cycle_to_read[cycle].is_last_cycle_in_read)
                     {
@@ -99,7 +98,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
                             const size_t tile_offset = tile_metrics.find(lane, tile);
                             if(tile_offset < tile_metrics.size())
                             {
-                                model::metrics::tile_metric& tile_metric = tile_metrics[tile_offset];
+                                model::metrics::tile_metric& tile_metric = tile_metrics.at_unchecked(tile_offset);
                                 compute_linear_fit(cycles, phasing_values, phasing_slope, phasing_offset, 25);
                                 compute_linear_fit(cycles, prephasing_values, prephasing_slope, prephasing_offset, 25);
                                 tile_metric.update_phasing_if_missing(read, phasing_slope, prephasing_slope);
@@ -36,7 +36,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
                 const uint_t tile_id = *tile_beg;
                 size_t prev_idx = metric_set.find(lane_id, tile_id, 1);
                 if(prev_idx >= metric_set.size()) continue;
-                QMetric& metric = metric_set[prev_idx];
+                QMetric& metric = metric_set.at_unchecked(prev_idx);
                 metric.accumulate(metric);
                 const uint_t second_cycle_start = 2; // We have to accumulate the first cycle with itself, and every
                 // subsequent with the previous cycle.
@@ -46,7 +46,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
                     const size_t cur_idx = metric_set.find(lane_id, tile_id, cycle);
                     if(cur_idx>=metric_set.size() || prev_idx>=metric_set.size())
                         continue;// TODO: if this happens zero out following q-scores
-                    metric_set[cur_idx].accumulate(metric_set[prev_idx]);
+                    metric_set.at_unchecked(cur_idx).accumulate(metric_set.at_unchecked(prev_idx));
                     prev_idx=cur_idx;
                 }
             }
@@ -70,7 +70,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
         {
             size_t prev_idx = q_metric_set.find(*lane_beg, tile_id, 1);
             if(prev_idx >= q_metric_set.size()) continue;
-            q_by_lane_metric& metric = q_metric_set[prev_idx];
+            q_by_lane_metric& metric = q_metric_set.at_unchecked(prev_idx);
             metric.accumulate(metric);
             const uint_t second_cycle_start = 2; // We have to accumulate the first cycle with itself, and every
             // subsequent with the previous cycle.
@@ -80,7 +80,7 @@ namespace illumina { namespace interop { namespace logic { namespace metric
                 const size_t cur_idx = q_metric_set.find(*lane_beg, tile_id, cycle);
                 if(cur_idx>=q_metric_set.size() || prev_idx>=q_metric_set.size())
                     continue;// TODO: if this happens zero out following q-scores
-                q_metric_set[cur_idx].accumulate(q_metric_set[prev_idx]);
+                q_metric_set.at_unchecked(cur_idx).accumulate(q_metric_set.at_unchecked(prev_idx));
                 prev_idx=cur_idx;
             }
         }
@@ -105,6 +105,33 @@ namespace illumina { namespace interop { namespace logic { namespace metric
     {
         populate_cumulative_distribution_t(q_metric_set);
     }
+    /** Compute the q-score suffix sums of each metric in the set
+     *
+     * @param q_metric_set q-metric set
+     */
+    template<typename QMetric>
+    static void populate_qscore_suffix_sums_t(model::metric_base::metric_set<QMetric>& q_metric_set)
+    {
+        typedef typename model::metric_base::metric_set<QMetric>::iterator iterator;
+        for(iterator beg = q_metric_set.begin(), end = q_metric_set.end();beg != end;++beg)
+            beg->compute_suffix_sums();
+    }
+    /** Compute the q-score suffix sums of each by lane q-metric
+     *
+     * @param q_metric_set q-metric set
+     */
+    void populate_qscore_suffix_sums(model::metric_base::metric_set<model::metrics::q_by_lane_metric>& q_metric_set)
+    {
+        populate_qscore_suffix_sums_t(q_metric_set);
+    }
+    /** Compute the q-score suffix sums of each q-metric
+     *
+     * @param q_metric_set q-metric set
+     */
+    void populate_qscore_suffix_sums(model::metric_base::metric_set<model::metrics::q_metric>& q_metric_set)
+    {
+        populate_qscore_suffix_sums_t(q_metric_set);
+    }
     /** Count number of unique counts to determine number
      * of unique bins for legacy binning
      *
@@ -259,8 +286,9 @@ namespace illumina { namespace interop { namespace logic { namespace metric
         for(const_iterator beg = metric_set.begin(), end = metric_set.end();beg != end;++beg)
         {
             const id_t id = model::metric_base::base_cycle_metric::create_id(beg->lane(), 0, beg->cycle());
-            if(bylane.has_metric(id))
-                bylane.get_metric_ref(id).accumulate_by_lane(*beg);
+            model::metrics::q_by_lane_metric* metric = bylane.try_get(id);
+            if(metric != 0)
+                metric->accumulate_by_lane(*beg);
             else
                 bylane.insert(model::metrics::q_by_lane_metric(beg->lane(), 0, beg->cycle(), beg->qscore_hist()));
         }
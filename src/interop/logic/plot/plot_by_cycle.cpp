@@ -9,7 +9,10 @@
 #include "interop/logic/metric/metric_value.h"
 #include "interop/logic/plot/plot_point.h"
 #include "interop/logic/plot/plot_data.h"
+#include "interop/model/plot/tile_filter.h"
 #include "interop/logic/metric/q_metric.h"
+#include "interop/logic/metric/derived_metrics.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
@@ -18,14 +21,14 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      *
      * @param metrics set of metric records
      * @param proxy functor that takes a metric record and returns a metric value
-     * @param options filter for metric records
+     * @param filter filter for metric records
      * @param type type of metric to extract using the proxy functor
      * @param points collection of points where x is cycle number and y is the mean metric value
      */
     template<typename MetricSet, typename MetricProxy, typename Point>
     size_t populate_metric_average_by_cycle(const MetricSet& metrics,
                                             MetricProxy& proxy,
-                                            const model::plot::filter_options& options,
+                                            const model::plot::tile_filter& filter,
                                             const constants::metric_type type,
                                             model::plot::data_point_collection<Point>& points)
     {
@@ -34,7 +37,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         const float dummy_x = 1;
         for(typename MetricSet::const_iterator b = metrics.begin(), e = metrics.end();b != e;++b)
         {
-            if(!options.valid_tile(*b)) continue;
+            if(!filter.valid_tile(*b)) continue;
             const float val = proxy(*b, type);
             if(std::isnan(val) || std::isinf(val)) continue;
             points[b->cycle()-1].add(dummy_x, val);
@@ -54,7 +57,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      *
      * @param metrics set of metric records
      * @param proxy functor that takes a metric record and returns a metric value
-     * @param options filter for metric records
+     * @param filter filter for metric records
      * @param type type of metric to extract using the proxy functor
      * @param points collection of points where x is cycle number and y is the candle stick metric values
      * @return last populated cycle
@@ -62,7 +65,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     template<typename MetricSet, typename MetricProxy>
     size_t populate_candle_stick_by_cycle(const MetricSet& metrics,
                                           MetricProxy& proxy,
-                                          const model::plot::filter_options& options,
+                                          const model::plot::tile_filter& filter,
                                           const constants::metric_type type,
                                           model::plot::data_point_collection<model::plot::candle_stick_point>& points)
     {
@@ -75,7 +78,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
 
         for(typename MetricSet::const_iterator b = metrics.begin(), e = metrics.end();b != e;++b)
         {
-            if(!options.valid_tile(*b)) continue;
+            if(!filter.valid_tile(*b)) continue;
             const float val = proxy(*b, type);
             if(std::isnan(val) || std::isinf(val)) continue;
             tile_by_cycle[b->cycle()-1].push_back(val);
@@ -141,11 +144,12 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output plot data
      */
     template<class Point>
-    void plot_by_cycle_t(model::metrics::run_metrics& metrics,
+    void plot_by_cycle_t(const model::metrics::run_metrics& metrics,
                        const constants::metric_type type,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<Point>& data)
     {
+        util::scoped_trace trace("plot_by_cycle", "plot");
         data.clear();
         if(!options.all_cycles())
             INTEROP_THROW(model::invalid_filter_option, "Filtering by cycle is not supported");// TODO: Remove this!
@@ -154,6 +158,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         if(!utils::is_cycle_metric(type))
             INTEROP_THROW(model::invalid_filter_option, "Only cycle metrics are supported");
         options.validate(type, metrics.run_info()); // TODO: Check ignored?
+        const model::plot::tile_filter filter(options, metrics.run_info().flowcell());
         size_t max_cycle=0;
         bool is_empty = true;
         switch(logic::utils::to_group(type))
@@ -169,7 +174,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                         max_cycle = populate_metric_average_by_cycle(
                                 metrics.get<model::metrics::extraction_metric>(),
                                 proxy,
-                                options,
+                                filter,
                                 type,
                                 data[i]
                         );
@@ -183,7 +188,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                     max_cycle = populate_candle_stick_by_cycle(
                             metrics.get<model::metrics::extraction_metric>(),
                             proxy,
-                            options,
+                            filter,
                             type,
                             data[0]);
                 }
@@ -202,7 +207,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                         max_cycle = populate_metric_average_by_cycle(
                                 metrics.get<model::metrics::corrected_intensity_metric>(),
                                 proxy,
-                                options,
+                                filter,
                                 type,
                                 data[i]
                         );
@@ -216,7 +221,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                     max_cycle = populate_candle_stick_by_cycle(
                             metrics.get<model::metrics::corrected_intensity_metric>(),
                             proxy,
-                            options,
+                            filter,
                             type,
                             data[0]);
                 }
@@ -228,17 +233,17 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                 data.assign(1, model::plot::series<Point>());
 
                 typedef model::metrics::q_collapsed_metric metric_t;
+                typedef model::metric_base::metric_set<metric_t> metric_set_t;
                 metric::metric_value<metric_t> proxy2;
-                if(0 == metrics.get<metric_t>().size())
-                    logic::metric::create_collapse_q_metrics(metrics.get<model::metrics::q_metric>(),
-                                                             metrics.get<metric_t>());
+                metric_set_t scratch;
+                const metric_set_t& metric_set = logic::metric::collapsed_q_metrics(metrics, scratch);
                 max_cycle = populate_candle_stick_by_cycle(
-                        metrics.get<metric_t>(),
+                        metric_set,
                         proxy2,
-                        options,
+                        filter,
                         type,
                         data[0]);
-                is_empty = metrics.get<metric_t>().empty();
+                is_empty = metric_set.empty();
                 break;
             }
             case constants::Error://TODO: skip last cycle of read for error metric
@@ -248,7 +253,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                 max_cycle = populate_candle_stick_by_cycle(
                         metrics.get<model::metrics::error_metric>(),
                         proxy3,
-                        options,
+                        filter,
                         type,
                         data[0]);
                 is_empty = metrics.get<model::metrics::error_metric>().empty();
@@ -263,7 +268,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                 max_cycle = populate_candle_stick_by_cycle(
                         metrics.get<metric_t>(),
                         proxy4,
-                        options,
+                        filter,
                         type,
                         data[0]);
                 is_empty = metrics.get<metric_t>().empty();
@@ -316,7 +321,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output plot data
      */
     template<class Point>
-    void plot_by_cycle_t(model::metrics::run_metrics& metrics,
+    void plot_by_cycle_t(const model::metrics::run_metrics& metrics,
                          const std::string& metric_name,
                          const model::plot::filter_options& options,
                          model::plot::plot_data<Point>& data)
@@ -335,7 +340,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     * @param options options to filter the data
     * @param data output plot data
     */
-    void plot_by_cycle(model::metrics::run_metrics& metrics,
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
                        const constants::metric_type type,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<model::plot::candle_stick_point>& data)
@@ -357,7 +362,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param options options to filter the data
      * @param data output plot data
      */
-    void plot_by_cycle(model::metrics::run_metrics& metrics,
+    void plot_by_cycle(const model::metrics::run_metrics& metrics,
                        const std::string& metric_name,
                        const model::plot::filter_options& options,
                        model::plot::plot_data<model::plot::candle_stick_point>& data)
@@ -369,6 +374,68 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         plot_by_cycle_t(metrics, metric_name, options, data);
     }
 
+    /** Collapse the q-metrics of the run, if they are missing and needed to plot the metric type
+     *
+     * @param metrics run metrics
+     * @param type metric type to plot
+     */
+    static void collapse_q_metrics_if_missing(model::metrics::run_metrics& metrics, const constants::metric_type type)
+    {
+        if(logic::utils::to_group(type) != constants::Q) return;
+        if(0 == metrics.get<model::metrics::q_collapsed_metric>().size())
+            logic::metric::create_collapse_q_metrics(metrics.get<model::metrics::q_metric>(),
+                                                     metrics.get<model::metrics::q_collapsed_metric>());
+    }
+    /** Plot a specified metric value by cycle
+    *
+    * Collapsed q-metrics missing from the run are derived into the run.
+    *
+    * @ingroup plot_logic
+    * @param metrics run metrics
+    * @param type specific metric value to plot by cycle
+    * @param options options to filter the data
+    * @param data output plot data
+    */
+    void plot_by_cycle(model::metrics::run_metrics& metrics,
+                       const constants::metric_type type,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data)
+            throw(model::index_out_of_bounds_exception,
+            model::invalid_metric_type,
+            model::invalid_channel_exception,
+            model::invalid_filter_option,
+            model::invalid_read_exception)
+    {
+        collapse_q_metrics_if_missing(metrics, type);
+        plot_by_cycle_t(static_cast<const model::metrics::run_metrics&>(metrics), type, options, data);
+    }
+
+    /** Plot a specified metric value by cycle using the candle stick model
+     *
+     * Collapsed q-metrics missing from the run are derived into the run.
+     *
+     * @ingroup plot_logic
+     * @todo Is this temporary?
+     * @param metrics run metrics
+     * @param metric_name name of metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output plot data
+     */
+    void plot_by_cycle(model::metrics::run_metrics& metrics,
+                       const std::string& metric_name,
+                       const model::plot::filter_options& options,
+                       model::plot::plot_data<model::plot::candle_stick_point>& data)
+            throw(model::index_out_of_bounds_exception,
+            model::invalid_filter_option,
+            model::invalid_channel_exception,
+            model::invalid_metric_type)
+    {
+        const constants::metric_type type = constants::parse<constants::metric_type>(metric_name);
+        if(type == constants::UnknownMetricType)
+            INTEROP_THROW(model::invalid_metric_type, "Unsupported metric type: " << metric_name);
+        plot_by_cycle(metrics, type, options, data);
+    }
+
     /** List metric types available for by cycle plots
      *
      * @param types destination vector to fill with metric types
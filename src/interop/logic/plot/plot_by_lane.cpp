@@ -10,6 +10,8 @@
 #include "interop/logic/metric/metric_value.h"
 #include "interop/logic/plot/plot_point.h"
 #include "interop/logic/plot/plot_data.h"
+#include "interop/model/plot/tile_filter.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
@@ -18,14 +20,14 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      *
      * @param metrics set of metric records
      * @param proxy functor that takes a metric record and returns a metric value
-     * @param options filter for metric records
+     * @param filter filter for metric records
      * @param type type of metric to extract using the proxy functor
      * @param points collection of points where x is lane number and y is the candle stick metric values
      */
     template<typename MetricSet, typename MetricProxy, typename Point>
     void populate_candle_stick_by_lane(const MetricSet& metrics,
                                        MetricProxy& proxy,
-                                       const model::plot::filter_options& options,
+                                       const model::plot::tile_filter& filter,
                                        const constants::metric_type type,
                                        model::plot::data_point_collection<Point>& points)
     {
@@ -39,7 +41,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
 
         for(typename MetricSet::const_iterator b = metrics.begin(), e = metrics.end();b != e;++b)
         {
-            if(!options.valid_tile(*b)) continue;
+            if(!filter.valid_tile(*b)) continue;
             const float val = proxy(*b, type);
             if(std::isnan(val)) continue;
             tile_by_lane[b->lane()-1].push_back(val);
@@ -73,14 +75,16 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     model::invalid_metric_type,
     model::invalid_filter_option)
     {
+        util::scoped_trace trace("plot_by_lane", "plot");
         data.clear();
         if(utils::is_cycle_metric(type))
             INTEROP_THROW(model::invalid_metric_type, "Cycle metrics are unsupported: " << constants::to_string(type));
         options.validate(type, metrics.run_info());
+        const model::plot::tile_filter filter(options, metrics.run_info().flowcell());
         if(metrics.is_group_empty(logic::utils::to_group(type))) return;
         data.assign(1, model::plot::series<Point>(utils::to_description(type), "Blue"));
         metric::metric_value<model::metrics::tile_metric> proxy3(options.read());
-        populate_candle_stick_by_lane(metrics.get<model::metrics::tile_metric>(), proxy3, options, type,
+        populate_candle_stick_by_lane(metrics.get<model::metrics::tile_metric>(), proxy3, filter, type,
                                       data[0]);
 
         const size_t read_count = metrics.run_info().reads().size();
@@ -93,7 +97,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
             const constants::metric_type second_type =
                     (type==constants::Clusters ? constants::ClustersPF : constants::ClusterCountPF);
             //(type==constants::Density ? constants::DensityPF : constants::ClusterCountPF);
-            populate_candle_stick_by_lane(metrics.get<model::metrics::tile_metric>(), proxy3, options, second_type,
+            populate_candle_stick_by_lane(metrics.get<model::metrics::tile_metric>(), proxy3, filter, second_type,
                                           data[1]);
         }
 
@@ -9,6 +9,9 @@
 
 #include "interop/logic/metric/metric_value.h"
 #include "interop/logic/metric/q_metric.h"
+#include "interop/logic/metric/derived_metrics.h"
+#include "interop/model/plot/tile_filter.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
@@ -35,9 +38,10 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     {
         if(beg == end) return;
         const bool all_surfaces = !options.is_specific_surface();
+        const model::plot::tile_filter filter(options, layout);
         for (;beg != end;++beg)
         {
-            if( !options.valid_tile_cycle(*beg) ) continue;
+            if( !filter.valid_tile_cycle(*beg) ) continue;
             const float val = proxy(*beg, type);
             if(std::isnan(val)) continue;
             data.set_data(beg->lane()-1,
@@ -53,6 +57,16 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         }
     }
 
+    /** Test if the metric type is an accumulated q-score percentage
+     *
+     * @param type metric type
+     * @return true for the accumulated percent above Q20 or Q30
+     */
+    static bool is_accumulated(const constants::metric_type type)
+    {
+        return type == constants::AccumPercentQ20 || type == constants::AccumPercentQ30;
+    }
+
     /** Plot a flowcell map
      *
      * @ingroup plot_logic
@@ -63,7 +77,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param buffer preallocated memory for data
      * @param tile_buffer preallocated memory for tile ids
      */
-    void plot_flowcell_map(model::metrics::run_metrics& metrics,
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
                                   const constants::metric_type type,
                                   const model::plot::filter_options& options,
                                   model::plot::flowcell_data& data,
@@ -73,6 +87,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     model::invalid_metric_type,
     model::index_out_of_bounds_exception)
     {
+        util::scoped_trace trace("plot_flowcell_map", "plot");
         data.clear();
         options.validate(type, metrics.run_info());
 
@@ -145,13 +160,9 @@ namespace illumina { namespace interop { namespace logic { namespace plot
             {
                 typedef model::metrics::q_collapsed_metric metric_t;
                 typedef model::metric_base::metric_set<metric_t> metric_set_t;
-                metric_set_t &metric_set = metrics.get<metric_t>();
-                if(0 == metric_set.size())
-                {
-                    logic::metric::create_collapse_q_metrics(metrics.get<model::metrics::q_metric>(), metric_set);
-                    if(type == constants::AccumPercentQ20 || type == constants::AccumPercentQ30)
-                        logic::metric::populate_cumulative_distribution(metric_set);
-                }
+                metric_set_t scratch;
+                const metric_set_t& metric_set = logic::metric::collapsed_q_metrics(metrics, scratch,
+                                                                                    is_accumulated(type));
                 metric::metric_value<metric_t> proxy;
                 is_empty = metric_set.empty();
                 populate_flowcell_map(metric_set.begin(), metric_set.end(), proxy, type, layout, options, data,
@@ -234,6 +245,70 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param buffer preallocated memory for data
      * @param tile_buffer preallocated memory for tile ids
      */
+    void plot_flowcell_map(const model::metrics::run_metrics& metrics,
+                                  const std::string& metric_name,
+                                  const model::plot::filter_options& options,
+                                  model::plot::flowcell_data& data,
+                                  float* buffer,
+                                  ::uint32_t* tile_buffer)
+    throw(model::invalid_filter_option,
+    model::invalid_metric_type,
+    model::index_out_of_bounds_exception)
+    {
+        const constants::metric_type type = constants::parse<constants::metric_type>(metric_name);
+        if(type == constants::UnknownMetricType)
+            INTEROP_THROW(model::invalid_metric_type, "Unsupported metric type: " << metric_name);
+        plot_flowcell_map(metrics, type, options, data, buffer, tile_buffer);
+    }
+
+    /** Plot a flowcell map
+     *
+     * Collapsed q-metrics missing from the run are derived into the run.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param type specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     */
+    void plot_flowcell_map(model::metrics::run_metrics& metrics,
+                                  const constants::metric_type type,
+                                  const model::plot::filter_options& options,
+                                  model::plot::flowcell_data& data,
+                                  float* buffer,
+                                  ::uint32_t* tile_buffer)
+    throw(model::invalid_filter_option,
+    model::invalid_metric_type,
+    model::index_out_of_bounds_exception)
+    {
+        typedef model::metric_base::metric_set<model::metrics::q_collapsed_metric> q_collapsed_metric_set_t;
+        q_collapsed_metric_set_t& collapsed = metrics.get<model::metrics::q_collapsed_metric>();
+        if(logic::utils::to_group(type) == constants::Q && collapsed.empty())
+        {
+            logic::metric::create_collapse_q_metrics(metrics.get<model::metrics::q_metric>(), collapsed);
+            if(is_accumulated(type)) logic::metric::populate_cumulative_distribution(collapsed);
+        }
+        plot_flowcell_map(static_cast<const model::metrics::run_metrics&>(metrics),
+                          type,
+                          options,
+                          data,
+                          buffer,
+                          tile_buffer);
+    }
+    /** Plot a flowcell map
+     *
+     * Collapsed q-metrics missing from the run are derived into the run.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param metric_name specific metric value to plot by cycle
+     * @param options options to filter the data
+     * @param data output flowcell map
+     * @param buffer preallocated memory for data
+     * @param tile_buffer preallocated memory for tile ids
+     */
     void plot_flowcell_map(model::metrics::run_metrics& metrics,
                                   const std::string& metric_name,
                                   const model::plot::filter_options& options,
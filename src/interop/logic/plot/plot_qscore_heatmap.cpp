@@ -9,6 +9,9 @@
 
 #include "interop/model/plot/bar_point.h"
 #include "interop/logic/metric/q_metric.h"
+#include "interop/logic/metric/derived_metrics.h"
+#include "interop/model/plot/tile_filter.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
@@ -19,19 +22,19 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param beg iterator to start of q-metric collection
      * @param end iterator to end of q-metric collection
      * @param bins q-score bins
-     * @param options filter for metric records
+     * @param filter filter for metric records
      * @param data q-score heatmap
      */
     template<typename I, typename B>
     void populate_heatmap_from_compressed(I beg,
                                           I end,
                                           const std::vector<B>& bins,
-                                          const model::plot::filter_options &options,
+                                          const model::plot::tile_filter &filter,
                                           model::plot::heatmap_data& data)
     {
         for (;beg != end;++beg)
         {
-            if( !options.valid_tile(*beg) ) continue;
+            if( !filter.valid_tile(*beg) ) continue;
             for(size_t bin =0;bin < bins.size();++bin)
                 data(beg->cycle()-1, bins[bin].value()-1) += beg->qscore_hist(bin);
         }
@@ -40,18 +43,18 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      *
      * @param beg iterator to start of q-metric collection
      * @param end iterator to end of q-metric collection
-     * @param options filter for metric records
+     * @param filter filter for metric records
      * @param data q-score heatmap
      */
     template<typename I>
     void populate_heatmap_from_uncompressed(I beg,
                                             I end,
-                                            const model::plot::filter_options &options,
+                                            const model::plot::tile_filter &filter,
                                             model::plot::heatmap_data& data)
     {
         for (;beg != end;++beg)
         {
-            if( !options.valid_tile(*beg) ) continue;
+            if( !filter.valid_tile(*beg) ) continue;
             for(size_t bin =0;bin < beg->size();++bin)
                 data(beg->cycle()-1, bin) += beg->qscore_hist(bin);
         }
@@ -96,12 +99,14 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      *
      * @param metric_set q-metrics (full or by lane)
      * @param options options to filter the data
+     * @param layout layout of the flowcell
      * @param data output heat map data
      * @param buffer preallocated memory
      */
     template<class Metric>
     void populate_heatmap(const model::metric_base::metric_set<Metric>& metric_set,
                           const model::plot::filter_options& options,
+                          const model::run::flowcell_layout& layout,
                           model::plot::heatmap_data& data,
                           float* buffer)
     {
@@ -114,17 +119,18 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                                                    << metric_set.bin_count() << ", "
                                                    << metric::is_compressed(metric_set) << ", "
                                                    << metric_set.get_bins().back().upper());
+        const model::plot::tile_filter filter(options, layout);
         const bool is_compressed = logic::metric::is_compressed(metric_set);
         if(is_compressed)
             populate_heatmap_from_compressed(metric_set.begin(),
                                              metric_set.end(),
                                              metric_set.get_bins(),
-                                             options,
+                                             filter,
                                              data);
         else
             populate_heatmap_from_uncompressed(metric_set.begin(),
                                                metric_set.end(),
-                                               options,
+                                               filter,
                                                data);
         normalize_heatmap(data);
         remap_to_bins(metric_set.get_bins().begin(),
@@ -140,7 +146,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output heat map data
      * @param buffer preallocated memory
      */
-    void plot_qscore_heatmap(model::metrics::run_metrics& metrics,
+    void plot_qscore_heatmap(const model::metrics::run_metrics& metrics,
                                     const model::plot::filter_options& options,
                                     model::plot::heatmap_data& data,
                                     float* buffer,
@@ -148,23 +154,24 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     throw(model::index_out_of_bounds_exception,
     model::invalid_filter_option)
     {
+        util::scoped_trace trace("plot_qscore_heatmap", "plot");
         data.clear();
         if(options.is_specific_surface())
         {
             typedef model::metrics::q_metric metric_t;
             if (metrics.get<metric_t>().size() == 0)return;
             options.validate(constants::QScore, metrics.run_info());
-            populate_heatmap(metrics.get<metric_t>(), options, data, buffer);
+            populate_heatmap(metrics.get<metric_t>(), options, metrics.run_info().flowcell(), data, buffer);
         }
         else
         {
             typedef model::metrics::q_by_lane_metric metric_t;
-            if(0 == metrics.get<metric_t>().size())
-                logic::metric::create_q_metrics_by_lane(metrics.get<model::metrics::q_metric>(),
-                                                        metrics.get<metric_t>());
-            if (metrics.get<metric_t>().size() == 0)return;
+            model::metric_base::metric_set<metric_t> scratch;
+            const model::metric_base::metric_set<metric_t>& metric_set =
+                    logic::metric::q_metrics_by_lane(metrics, scratch);
+            if (metric_set.size() == 0)return;
             options.validate(constants::QScore, metrics.run_info());
-            populate_heatmap(metrics.get<metric_t>(), options, data, buffer);
+            populate_heatmap(metric_set, options, metrics.run_info().flowcell(), data, buffer);
         }
 
         data.set_xrange(0, static_cast<float>(data.row_count()));
@@ -180,6 +187,33 @@ namespace illumina { namespace interop { namespace logic { namespace plot
             title += " " + options.surface_description();
         data.set_title(title);
     }
+    /** Plot a heat map of q-scores
+     *
+     * By lane q-metrics missing from the run are derived into the run.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param options options to filter the data
+     * @param data output heat map data
+     * @param buffer preallocated memory
+     */
+    void plot_qscore_heatmap(model::metrics::run_metrics& metrics,
+                                    const model::plot::filter_options& options,
+                                    model::plot::heatmap_data& data,
+                                    float* buffer,
+                                    const size_t buffer_size)
+    throw(model::index_out_of_bounds_exception,
+    model::invalid_filter_option)
+    {
+        if(!options.is_specific_surface() && 0 == metrics.get<model::metrics::q_by_lane_metric>().size())
+            logic::metric::create_q_metrics_by_lane(metrics.get<model::metrics::q_metric>(),
+                                                    metrics.get<model::metrics::q_by_lane_metric>());
+        plot_qscore_heatmap(static_cast<const model::metrics::run_metrics&>(metrics),
+                            options,
+                            data,
+                            buffer,
+                            buffer_size);
+    }
     /** Count number of rows for the heat map
      *
      * @param metrics run metrics
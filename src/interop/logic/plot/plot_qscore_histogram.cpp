@@ -7,6 +7,9 @@
  */
 #include "interop/logic/plot/plot_qscore_histogram.h"
 #include "interop/logic/metric/q_metric.h"
+#include "interop/logic/metric/derived_metrics.h"
+#include "interop/model/plot/tile_filter.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot
 {
@@ -16,24 +19,20 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      *
      * @param beg iterator to start of q-metric collection
      * @param end iterator to end of q-metric collection
-     * @param options filter for metric records
-     * @param first_cycle first cycle to keep
-     * @param last_cycle last cycle to keep
+     * @param filter filter for metric records, including the range of cycles to keep
      * @param histogram q-score histogram
      */
     template<typename I>
     void populate_distribution(I beg,
                                I end,
-                               const model::plot::filter_options &options,
-                               const size_t first_cycle,
-                               const size_t last_cycle,
+                               const model::plot::tile_filter &filter,
                                std::vector<float>& histogram)
     {
         if(beg == end) return;
         histogram.resize(beg->size(), 0);
         for (;beg != end;++beg)
         {
-            if( !options.valid_tile(*beg) || beg->cycle() < first_cycle || beg->cycle() > last_cycle) continue;
+            if( !filter.valid_tile_cycle(*beg) ) continue;
             beg->accumulate_into(histogram);
         }
     }
@@ -144,7 +143,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
      * @param data output plot data
      * @param boundary index of bin to create the boundary sub plots (0 means do nothing)
      */
-    void plot_qscore_histogram(model::metrics::run_metrics& metrics,
+    void plot_qscore_histogram(const model::metrics::run_metrics& metrics,
                                const model::plot::filter_options& options,
                                model::plot::plot_data<model::plot::bar_point>& data,
                                const size_t boundary)
@@ -153,6 +152,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
     model::invalid_filter_option)
     {
         typedef model::plot::bar_point Point;
+        util::scoped_trace trace("plot_qscore_histogram", "plot");
         data.clear();
         if(options.is_specific_surface())
         {
@@ -165,6 +165,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         }
         options.validate(constants::QScore, metrics.run_info());
         const size_t first_cycle = options.all_reads() ? 1 : metrics.run_info().read(options.read()).first_cycle();
+        model::plot::tile_filter filter(options, metrics.run_info().flowcell());
 
         data.push_back(model::plot::series<Point>("Q Score", "Blue", model::plot::series<Point>::Bar));
         if(boundary>0)
@@ -189,17 +190,17 @@ namespace illumina { namespace interop { namespace logic { namespace plot
                                                               options,
                                                               metrics.get<metric_t>().max_cycle());
             if(metrics.get<metric_t>().size() == 0) return;
+            filter.cycle_range(static_cast<model::plot::tile_filter::id_t>(first_cycle),
+                               static_cast<model::plot::tile_filter::id_t>(last_cycle));
             populate_distribution(
                     metrics.get<metric_t>().begin(),
                     metrics.get<metric_t>().end(),
-                    options,
-                    first_cycle,
-                    last_cycle,
+                    filter,
                     histogram);
             axis_scale = scale_histogram(histogram);
-            if(!metrics.get<metric_t>().bins().empty())
-                max_x_value=plot_binned_histogram(metrics.get<metric_t>().bins().begin(),
-                                                  metrics.get<metric_t>().bins().end(),
+            if(!metrics.get<metric_t>().get_bins().empty())
+                max_x_value=plot_binned_histogram(metrics.get<metric_t>().get_bins().begin(),
+                                                  metrics.get<metric_t>().get_bins().end(),
                                                   histogram,
                                                   data[0]);
             else max_x_value=plot_unbinned_histogram(histogram, data[0]);
@@ -207,25 +208,25 @@ namespace illumina { namespace interop { namespace logic { namespace plot
         else
         {
             typedef model::metrics::q_by_lane_metric metric_t;
-            if(0 == metrics.get<metric_t>().size())
-                logic::metric::create_q_metrics_by_lane(metrics.get<model::metrics::q_metric>(),
-                                                        metrics.get<metric_t>());
-            if(0 == metrics.get<metric_t>().size()) return;
+            model::metric_base::metric_set<metric_t> scratch;
+            const model::metric_base::metric_set<metric_t>& metric_set =
+                    logic::metric::q_metrics_by_lane(metrics, scratch);
+            if(0 == metric_set.size()) return;
             const size_t last_cycle = get_last_filtered_cycle(metrics.run_info(),
                                                               options,
-                                                              metrics.get<metric_t>().max_cycle());
-            INTEROP_ASSERT(0 != metrics.get<metric_t>().size());
+                                                              metric_set.max_cycle());
+            INTEROP_ASSERT(0 != metric_set.size());
+            filter.cycle_range(static_cast<model::plot::tile_filter::id_t>(first_cycle),
+                               static_cast<model::plot::tile_filter::id_t>(last_cycle));
             populate_distribution(
-                    metrics.get<metric_t>().begin(),
-                    metrics.get<metric_t>().end(),
-                    options,
-                    first_cycle,
-                    last_cycle,
+                    metric_set.begin(),
+                    metric_set.end(),
+                    filter,
                     histogram);
             axis_scale = scale_histogram(histogram);
-            if(!metrics.get<metric_t>().bins().empty())
-                max_x_value=plot_binned_histogram(metrics.get<metric_t>().bins().begin(),
-                                                  metrics.get<metric_t>().bins().end(),
+            if(!metric_set.get_bins().empty())
+                max_x_value=plot_binned_histogram(metric_set.get_bins().begin(),
+                                                  metric_set.get_bins().end(),
                                                   histogram,
                                                   data[0]);
             else max_x_value=plot_unbinned_histogram(histogram, data[0]);
@@ -270,6 +271,29 @@ namespace illumina { namespace interop { namespace logic { namespace plot
             title += " " + options.surface_description();
         data.set_title(title);
     }
+    /** Plot a histogram of q-scores
+     *
+     * By lane q-metrics missing from the run are derived into the run.
+     *
+     * @ingroup plot_logic
+     * @param metrics run metrics
+     * @param options options to filter the data
+     * @param data output plot data
+     * @param boundary index of bin to create the boundary sub plots (0 means do nothing)
+     */
+    void plot_qscore_histogram(model::metrics::run_metrics& metrics,
+                               const model::plot::filter_options& options,
+                               model::plot::plot_data<model::plot::bar_point>& data,
+                               const size_t boundary)
+    throw( model::invalid_read_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_filter_option)
+    {
+        if(!options.is_specific_surface() && 0 == metrics.get<model::metrics::q_by_lane_metric>().size())
+            logic::metric::create_q_metrics_by_lane(metrics.get<model::metrics::q_metric>(),
+                                                    metrics.get<model::metrics::q_by_lane_metric>());
+        plot_qscore_histogram(static_cast<const model::metrics::run_metrics&>(metrics), options, data, boundary);
+    }
 
 
 }}}}
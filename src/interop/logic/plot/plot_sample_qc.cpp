@@ -7,7 +7,11 @@
  */
 #include "interop/logic/plot/plot_sample_qc.h"
 
+#include <algorithm>
 #include "interop/logic/utils/enums.h"
+#include "interop/util/map.h"
+#include "interop/util/string_pool.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace plot {
 
@@ -25,42 +29,33 @@ namespace illumina { namespace interop { namespace logic { namespace plot {
                                     model::plot::data_point_collection<Point>& points)
     {
         typedef model::metric_base::metric_set<model::metrics::index_metric> index_metric_set_t;
-        typedef INTEROP_UNORDERED_MAP(std::string, ::uint64_t) index_count_map_t;
-        typedef typename index_count_map_t::iterator map_iterator;
-        typedef typename index_count_map_t::const_iterator const_map_iterator;
         typedef typename model::metrics::index_metric::const_iterator const_index_iterator;
+        typedef std::pair<std::string, ::uint64_t> sequence_count_t;
+        typedef INTEROP_UNORDERED_MAP(::uint32_t, ::uint64_t) sequence_count_map_t;
 
-        index_count_map_t index_count_map;
+        // Cluster count of each index, by the id of its sequence in the string pool
+        sequence_count_map_t count_of_sequence;
         ::uint64_t pf_cluster_count_total = 0;
         for(typename index_metric_set_t::const_iterator b = index_metrics.begin(), e = index_metrics.end();b != e;++b)
         {
             if(lane != b->lane()) continue;
-            try
-            {
-                const model::metrics::tile_metric &tile_metric = tile_metrics.get_metric(b->lane(), b->tile());
-                pf_cluster_count_total += static_cast< ::uint64_t >( tile_metric.cluster_count_pf());
-                for(const_index_iterator ib = b->indices().begin(), ie =  b->indices().end();ib != ie;++ib)
-                {
-                    map_iterator found_index = index_count_map.find(ib->index_seq());
-                    if(found_index == index_count_map.end()) index_count_map[ib->index_seq()] = ib->cluster_count();
-                    else found_index->second += ib->cluster_count();
-                }
-            }
-            catch(const model::index_out_of_bounds_exception&){continue;} // TODO: check better?
+            const model::metrics::tile_metric* tile_metric = tile_metrics.try_get(b->lane(), b->tile());
+            if(tile_metric == 0) continue;
+            pf_cluster_count_total += static_cast< ::uint64_t >( tile_metric->cluster_count_pf());
+            for(const_index_iterator ib = b->indices().begin(), ie =  b->indices().end();ib != ie;++ib)
+                count_of_sequence[ib->index_seq_id()] += ib->cluster_count();
         }
-        points.resize(index_count_map.size());
+        std::vector<sequence_count_t> keys;
+        keys.reserve(count_of_sequence.size());
+        for(typename sequence_count_map_t::const_iterator it = count_of_sequence.begin();it != count_of_sequence.end();++it)
+            keys.push_back(sequence_count_t(util::string_pool::at(it->first), it->second));
+        std::sort(keys.begin(), keys.end());
+        points.resize(keys.size());
         float max_height=0;
-        std::vector<float> heights;
-        heights.reserve(index_count_map.size());
         size_t i=0;
-        std::vector<std::string> keys;
-        keys.reserve(index_count_map.size());
-        for(const_map_iterator b = index_count_map.begin(), e = index_count_map.end();b != e;++b)
-            keys.push_back(b->first);
-        std::stable_sort(keys.begin(), keys.end());
-        for(typename std::vector<std::string>::const_iterator b = keys.begin(), e = keys.end();b != e;++b,++i)
+        for(typename std::vector<sequence_count_t>::const_iterator b = keys.begin(), e = keys.end();b != e;++b,++i)
         {
-            const float height = (pf_cluster_count_total==0) ? 0.0f : 100.0f * index_count_map[*b] / pf_cluster_count_total;
+            const float height = (pf_cluster_count_total==0) ? 0.0f : 100.0f * b->second / pf_cluster_count_total;
             points[i].set(i+1.0f, height, 1.0f);
             max_height = std::max(max_height, height);
         }
@@ -80,6 +75,7 @@ namespace illumina { namespace interop { namespace logic { namespace plot {
                                 throw(model::index_out_of_bounds_exception)
     {
         typedef model::plot::series<model::plot::bar_point> bar_series_t;
+        util::scoped_trace trace("plot_sample_qc", "plot");
         data.clear();
         if(metrics.is_group_empty(constants::Tile) ||
                 metrics.is_group_empty(constants::Index)) return;
@@ -0,0 +1,272 @@
+/** Summary logic for a batch of run folders
+ *
+ *  @file
+ *  @date  10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include "interop/logic/summary/batch_summary.h"
+
+#include <algorithm>
+#include "interop/logic/summary/run_summary.h"
+#include "interop/logic/summary/index_summary.h"
+#include "interop/util/thread_pool.h"
+#include "interop/util/trace.h"
+#ifdef INTEROP_HAS_STD_THREAD
+#include <mutex>
+#endif
+
+
+namespace illumina { namespace interop { namespace logic { namespace summary
+{
+    /** List the metrics required by the requested summaries
+     *
+     * @param options batch options
+     * @param valid_to_load destination list of metrics to load
+     */
+    static void list_batch_metrics_to_load(const batch_summary_options& options,
+                                           std::vector<unsigned char>& valid_to_load)
+    {
+        valid_to_load.clear();
+        std::vector<unsigned char> index_to_load;
+        if(options.summarize_runs) utils::list_summary_metrics_to_load(valid_to_load);
+        if(options.summarize_index) utils::list_index_metrics_to_load(index_to_load);
+        if(index_to_load.size() > valid_to_load.size()) valid_to_load.resize(index_to_load.size(), 0);
+        for(size_t i=0;i<index_to_load.size();++i)
+            if(index_to_load[i]) valid_to_load[i] = 1;
+    }
+
+    /** Load and summarize a single run of the batch
+     *
+     * The run metrics are released before this function returns.
+     *
+     * @param valid_to_load list of metrics to load
+     * @param pool pool of the batch, which loads the InterOp files with nested tasks
+     * @param options batch options
+     * @param result destination result
+     */
+    static void summarize_batch_run(const std::vector<unsigned char>& valid_to_load,
+                                    util::thread_pool& pool,
+                                    const batch_summary_options& options,
+                                    batch_summary_result& result)
+    {
+        try
+        {
+            model::metrics::run_metrics run;
+            run.read(result.run_folder, valid_to_load, pool);
+            if(options.check_empty && run.empty())
+            {
+                result.error_type = BatchEmptyInterOp;
+                result.error_message = "No InterOp files found";
+                return;
+            }
+            if(options.summarize_runs)
+                summarize_run_metrics(run, result.run_summary, options.skip_median);
+            if(options.summarize_index)
+            {
+                summarize_index_metrics(run, result.index_summary);
+                result.index_summary.sort();
+            }
+        }
+        catch(const xml::xml_file_not_found_exception& ex)
+        {
+            result.error_type = BatchMissingRunInfo;
+            result.error_message = ex.what();
+        }
+        catch(const xml::xml_parse_exception& ex)
+        {
+            result.error_type = BatchMalformedXml;
+            result.error_message = ex.what();
+        }
+        catch(const io::bad_format_exception& ex)
+        {
+            result.error_type = BatchBadFormat;
+            result.error_message = ex.what();
+        }
+        catch(const std::exception& ex)
+        {
+            result.error_type = BatchUnexpectedError;
+            result.error_message = ex.what();
+        }
+        catch(...)
+        {
+            result.error_type = BatchUnexpectedError;
+            result.error_message = "Unknown error";
+        }
+    }
+
+    /** Shared state of a batch: the next run to summarize, and the next run to report
+     */
+    class batch_state
+    {
+    public:
+        /** Constructor
+         *
+         * @param valid_to_load list of metrics to load
+         * @param options batch options
+         * @param results destination results, one per run folder
+         * @param listener receives each result in order, may be null
+         */
+        batch_state(const std::vector<unsigned char>& valid_to_load,
+                    const batch_summary_options& options,
+                    batch_summary_result_vector& results,
+                    batch_summary_listener* listener) :
+                m_valid_to_load(valid_to_load),
+                m_options(options),
+                m_results(results),
+                m_listener(listener),
+                m_next_run(0),
+                m_next_report(0),
+                m_finished(results.size(), 0)
+        {}
+        /** Take the next run to summarize
+         *
+         * @return index of the run, or the number of runs if every run was taken
+         */
+        size_t take_run()
+        {
+            size_t run;
+#if defined(INTEROP_HAS_STD_THREAD)
+            std::lock_guard<std::mutex> lock(m_mutex);
+#elif defined(_OPENMP)
+#           pragma omp critical(InterOpBatchSummary)
+#endif
+            {
+                run = m_next_run;
+                if(m_next_run < m_results.size()) ++m_next_run;
+            }
+            return run;
+        }
+        /** Load and summarize a run
+         *
+         * @param run index of the run
+         * @param pool pool of the batch
+         */
+        void summarize(const size_t run, util::thread_pool& pool)
+        {
+            summarize_batch_run(m_valid_to_load, pool, m_options, m_results[run]);
+        }
+        /** Mark a run as summarized, and report every run that is now ready, in order
+         *
+         * @param run index of the run
+         */
+        void finish(const size_t run)
+        {
+#if defined(INTEROP_HAS_STD_THREAD)
+            std::lock_guard<std::mutex> lock(m_mutex);
+#elif defined(_OPENMP)
+#           pragma omp critical(InterOpBatchSummary)
+#endif
+            {
+                m_finished[run] = 1;
+                while(m_next_report < m_results.size() && m_finished[m_next_report])
+                {
+                    if(m_listener != 0) m_listener->run_summarized(m_results[m_next_report]);
+                    ++m_next_report;
+                }
+            }
+        }
+        /** Get the number of runs
+         *
+         * @return number of runs
+         */
+        size_t size()const
+        {
+            return m_results.size();
+        }
+
+    private:
+        const std::vector<unsigned char>& m_valid_to_load;
+        const batch_summary_options& m_options;
+        batch_summary_result_vector& m_results;
+        batch_summary_listener* m_listener;
+        size_t m_next_run;
+        size_t m_next_report;
+        std::vector<unsigned char> m_finished;
+#ifdef INTEROP_HAS_STD_THREAD
+        std::mutex m_mutex;
+#endif
+    };
+
+    /** Summarize runs of the batch one at a time, until every run was taken
+     *
+     * One task runs per run held in memory, so the number of these tasks bounds the resident runs.
+     */
+    class summarize_batch_slot_task
+    {
+    public:
+        /** Constructor
+         *
+         * @param state shared state of the batch
+         * @param pool pool of the batch
+         */
+        summarize_batch_slot_task(batch_state& state, util::thread_pool& pool) : m_state(&state), m_pool(&pool){}
+        /** Load and summarize runs until none are left
+         */
+        void operator()()const
+        {
+            for(size_t run = m_state->take_run(); run < m_state->size(); run = m_state->take_run())
+            {
+                m_state->summarize(run, *m_pool);
+                m_state->finish(run);
+            }
+        }
+
+    private:
+        batch_state* m_state;
+        util::thread_pool* m_pool;
+    };
+
+    /** Get the number of worker threads used for a batch
+     *
+     * @param run_count number of runs in the batch
+     * @param options batch options
+     * @return number of runs loaded concurrently
+     */
+    size_t batch_worker_count(const size_t run_count, const batch_summary_options& options)
+    {
+        size_t worker_count = std::max(options.thread_count, static_cast<size_t>(1));
+        if(options.max_resident_runs > 0) worker_count = std::min(worker_count, options.max_resident_runs);
+        return std::max(std::min(worker_count, run_count), static_cast<size_t>(1));
+    }
+
+    /** Load and summarize a batch of run folders
+     *
+     * A fixed number of slot tasks, `batch_worker_count`, each load, summarize and release one run at a time, so at
+     * most that many runs are in memory. Runs are handed out dynamically, since run sizes vary widely, and each result
+     * is written into the slot of its run folder to keep the output order deterministic. Every run loads its InterOp
+     * files with nested tasks on the one pool of the batch, so the batch never uses more than `thread_count` threads.
+     *
+     * @param run_folders list of run folders
+     * @param results destination results, one per run folder
+     * @param options batch options
+     * @param listener receives each result in order as soon as it is ready, may be null
+     */
+    void summarize_run_batch(const std::vector<std::string>& run_folders,
+                             batch_summary_result_vector& results,
+                             const batch_summary_options& options,
+                             batch_summary_listener* listener)
+    {
+        util::scoped_trace trace("summarize_run_batch", "summary");
+        results.clear();
+        results.reserve(run_folders.size());
+        for(size_t i=0;i<run_folders.size();++i)
+            results.push_back(batch_summary_result(run_folders[i]));
+        if(run_folders.empty()) return;
+
+        std::vector<unsigned char> valid_to_load;
+        list_batch_metrics_to_load(options, valid_to_load);
+        const size_t worker_count = batch_worker_count(run_folders.size(), options);
+        util::thread_pool pool(std::max(options.thread_count, static_cast<size_t>(1)));
+        batch_state state(valid_to_load, options, results, listener);
+        {
+            util::task_group tasks(pool);
+            for(size_t i=0;i<worker_count;++i)
+                tasks.run(summarize_batch_slot_task(state, pool));
+            tasks.wait();
+        }
+        trace.add_records(results.size());
+    }
+
+}}}}
+
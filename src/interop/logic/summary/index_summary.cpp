@@ -7,85 +7,131 @@
  */
 #include "interop/logic/summary/index_summary.h"
 
+#include <algorithm>
+#include <limits>
+#include "interop/util/map.h"
 #include "interop/util/statistics.h"
+#include "interop/util/string_pool.h"
+#include "interop/util/thread_pool.h"
+#include "interop/util/trace.h"
 
 
 namespace illumina { namespace interop { namespace logic { namespace summary {
 
-    /** Summarize a index metrics for a specific lane
+    /** Running totals of the index metrics of a single lane
      *
-     * @param beg iterator to start of source collection of index metrics
-     * @param end iterator to end of source collection of index metrics
-     * @param tile_metrics source collection of tile metrics
-     * @param lane lane number
-     * @param summary destination index flowcell summary
+     * Indexes are aggregated by the id of their sequence in the string pool, so no string is hashed per record.
      */
-    template<typename I>
-    void summarize_index_metrics(I beg,
-                                 I end,
-                                 const model::metric_base::metric_set<model::metrics::tile_metric>& tile_metrics,
-                                 const size_t lane,
-                                 model::summary::index_lane_summary &summary)
-    throw(model::index_out_of_bounds_exception)
+    struct index_lane_accumulator
     {
-        typedef typename model::summary::index_lane_summary::read_count_t read_count_t;
-        typedef typename model::metrics::index_metric::const_iterator const_index_iterator;
+        /** Define a read count type */
+        typedef model::summary::index_lane_summary::read_count_t read_count_t;
+        /** Define a vector of index count summaries */
+        typedef std::vector<model::summary::index_count_summary> index_count_vector_t;
+        /** Define a map from the id of a sequence to its offset in the index counts */
+        typedef INTEROP_UNORDERED_MAP(::uint32_t, size_t) sequence_offset_map_t;
+
+        /** Constructor
+         */
+        index_lane_accumulator() :
+                total_mapped_reads(0),
+                pf_cluster_count_total(0),
+                cluster_count_total(0)
+        {}
+        /** Sentinel for a sequence not yet found in the lane
+         *
+         * @return sentinel offset
+         */
+        static size_t missing()
+        {
+            return std::numeric_limits<size_t>::max();
+        }
+        /** Get the offset of an index in the index counts
+         *
+         * @param info index information
+         * @return offset of its sequence, missing() if not yet found in the lane
+         */
+        size_t& offset_of(const model::metrics::index_info& info)
+        {
+            return offset_of_sequence.insert(std::make_pair(info.index_seq_id(), missing())).first->second;
+        }
+        /** Offset of each index sequence in the index counts, by sequence id */
+        sequence_offset_map_t offset_of_sequence;
+        /** Count summary of each index sequence found in the lane */
+        index_count_vector_t index_counts;
+        /** Total number of clusters mapped to an index */
+        ::uint64_t total_mapped_reads;
+        /** Total number of clusters passing filter */
+        read_count_t pf_cluster_count_total;
+        /** Total number of clusters */
+        read_count_t cluster_count_total;
+    };
+
+    /** Add an index metric and its tile metric to the totals of its lane
+     *
+     * @param index_metric source index metric
+     * @param tile_metric tile metric of the same tile
+     * @param lane destination totals of the lane
+     */
+    static void accumulate_index_metric(const model::metrics::index_metric& index_metric,
+                                        const model::metrics::tile_metric& tile_metric,
+                                        index_lane_accumulator& lane)
+    {
+        typedef index_lane_accumulator::read_count_t read_count_t;
+        typedef model::metrics::index_metric::const_iterator const_index_iterator;
         typedef model::summary::index_count_summary index_count_summary;
-        typedef INTEROP_UNORDERED_MAP(std::string, index_count_summary) index_count_map_t;
-        typedef typename index_count_map_t::iterator map_iterator;
-
-        if(beg == end || tile_metrics.empty()) return;
-        index_count_map_t index_count_map;
-        ::uint64_t total_mapped_reads = 0;
-        read_count_t pf_cluster_count_total = 0;
-        read_count_t cluster_count_total = 0;
-        for(;beg != end;++beg)
+
+        lane.pf_cluster_count_total += static_cast<read_count_t>(tile_metric.cluster_count_pf());
+        lane.cluster_count_total += static_cast<read_count_t>(tile_metric.cluster_count());
+        for(const_index_iterator ib = index_metric.indices().begin(), ie = index_metric.indices().end();ib != ie;++ib)
         {
-            if(beg->lane() != lane) continue;
-            try
+            size_t& offset = lane.offset_of(*ib);
+            if(offset == index_lane_accumulator::missing())
+            {
+                offset = lane.index_counts.size();
+                lane.index_counts.push_back(index_count_summary(lane.index_counts.size()+1,// TODO: get correspondance with plot
+                                                                ib->index1(),
+                                                                ib->index2(),
+                                                                ib->sample_id(),
+                                                                ib->sample_proj(),
+                                                                ib->cluster_count()));
+            }
+            else
             {
-                const model::metrics::tile_metric &tile_metric = tile_metrics.get_metric(beg->lane(), beg->tile());
-                pf_cluster_count_total += static_cast<read_count_t>(tile_metric.cluster_count_pf());
-                cluster_count_total += static_cast<read_count_t>(tile_metric.cluster_count());
-
-                for(const_index_iterator ib = beg->indices().begin(), ie =  beg->indices().end();ib != ie;++ib)
-                {
-                    map_iterator found_index = index_count_map.find(ib->index_seq());
-                    if(found_index == index_count_map.end())
-                    {
-                        index_count_map[ib->index_seq()] = index_count_summary(index_count_map.size()+1,// TODO: get correspondance with plot
-                                                                               ib->index1(),
-                                                                               ib->index2(),
-                                                                               ib->sample_id(),
-                                                                               ib->sample_proj(),
-                                                                               ib->cluster_count());
-                    }
-                    else
-                    {
-                        found_index->second += ib->cluster_count();
-                    }
-                    total_mapped_reads += ib->cluster_count();
-                }
+                lane.index_counts[offset] += ib->cluster_count();
             }
-            catch(const model::index_out_of_bounds_exception&){continue;} // TODO: check better
+            lane.total_mapped_reads += ib->cluster_count();
         }
+    }
+
+    /** Summarize the totals of a single lane
+     *
+     * @param lane source totals of the lane
+     * @param summary destination index lane summary
+     */
+    static void summarize_index_lane(index_lane_accumulator& lane, model::summary::index_lane_summary &summary)
+    throw(model::index_out_of_bounds_exception)
+    {
+        typedef model::summary::index_count_summary index_count_summary;
+        typedef std::pair<std::string, size_t> sequence_offset_t;
 
         float max_fraction_mapped = -std::numeric_limits<float>::max();
         float min_fraction_mapped = std::numeric_limits<float>::max();
-        summary.reserve(index_count_map.size());
+        summary.reserve(lane.index_counts.size());
 
 
-        std::vector<std::string> keys;
-        keys.reserve(index_count_map.size());
-        for(map_iterator b = index_count_map.begin(), e = index_count_map.end();b != e;++b)
-            keys.push_back(b->first);
-        std::stable_sort(keys.begin(), keys.end());
+        std::vector<sequence_offset_t> keys;
+        keys.reserve(lane.index_counts.size());
+        for(index_lane_accumulator::sequence_offset_map_t::const_iterator it = lane.offset_of_sequence.begin();
+            it != lane.offset_of_sequence.end();++it)
+            keys.push_back(sequence_offset_t(util::string_pool::at(it->first), it->second));
+        std::sort(keys.begin(), keys.end());
 
-        for(typename std::vector<std::string>::const_iterator kcurr = keys.begin(), kbeg=kcurr;kcurr != keys.end();++kcurr)
+        for(std::vector<sequence_offset_t>::const_iterator kcurr = keys.begin(), kbeg=kcurr;kcurr != keys.end();++kcurr)
         {
-            index_count_summary& count_summary = index_count_map[*kcurr];
+            index_count_summary& count_summary = lane.index_counts[kcurr->second];
             count_summary.id(static_cast<size_t>(std::distance(kbeg, kcurr)+1));
-            count_summary.update_fraction_mapped(static_cast<double>(pf_cluster_count_total));
+            count_summary.update_fraction_mapped(static_cast<double>(lane.pf_cluster_count_total));
             const float fraction_mapped = count_summary.fraction_mapped();
             summary.push_back(count_summary);
             max_fraction_mapped = std::max(max_fraction_mapped, fraction_mapped);
@@ -100,13 +146,14 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
                                                           summary.end(),
                                                           avg_fraction_mapped,
                                                           util::op::const_member_function(&index_count_summary::fraction_mapped)));
-        summary.set(total_mapped_reads,
-                    pf_cluster_count_total,
-                    cluster_count_total,
+        summary.set(lane.total_mapped_reads,
+                    lane.pf_cluster_count_total,
+                    lane.cluster_count_total,
                     min_fraction_mapped,
                     max_fraction_mapped,
                     std_fraction_mapped/avg_fraction_mapped);
     }
+
     /** Summarize a collection index metrics for a specific lane
      *
      * @param metrics source run metrics
@@ -118,31 +165,142 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
                                         model::summary::index_lane_summary &summary)
     throw(model::index_out_of_bounds_exception)
     {
-        summarize_index_metrics(metrics.get<model::metrics::index_metric>().begin(),
-                                metrics.get<model::metrics::index_metric>().end(),
-                                metrics.get<model::metrics::tile_metric>(), lane,
-                                summary);
+        typedef model::metric_base::metric_set<model::metrics::index_metric> index_metric_set_t;
+        typedef model::metric_base::metric_set<model::metrics::tile_metric> tile_metric_set_t;
+        const index_metric_set_t& index_metrics = metrics.get<model::metrics::index_metric>();
+        const tile_metric_set_t& tile_metrics = metrics.get<model::metrics::tile_metric>();
+
+        if(index_metrics.empty() || tile_metrics.empty()) return;
+        index_lane_accumulator totals;
+        for(index_metric_set_t::const_iterator beg = index_metrics.begin(), end = index_metrics.end();beg != end;++beg)
+        {
+            if(beg->lane() != lane) continue;
+            const size_t tile_offset = tile_metrics.find(beg->lane(), beg->tile());
+            if(tile_offset >= tile_metrics.size()) continue;
+            accumulate_index_metric(*beg, tile_metrics.at_unchecked(tile_offset), totals);
+        }
+        summarize_index_lane(totals, summary);
+    }
+    /** Offsets of an index metric and its tile metric */
+    typedef std::pair<size_t, size_t> index_record_offset_t;
+    /** Offsets of the index metrics of a lane and their tile metrics */
+    typedef std::vector<index_record_offset_t> index_record_offset_vector_t;
+
+    /** Summarize the index metrics of a single lane
+     *
+     * @param index_metrics source collection of index metrics
+     * @param tile_metrics source collection of tile metrics
+     * @param records offsets of the index metrics of the lane and their tile metrics
+     * @param summary destination index lane summary
+     */
+    static void summarize_index_lane_records(
+            const model::metric_base::metric_set<model::metrics::index_metric>& index_metrics,
+            const model::metric_base::metric_set<model::metrics::tile_metric>& tile_metrics,
+            const index_record_offset_vector_t& records,
+            model::summary::index_lane_summary& summary)
+    {
+        index_lane_accumulator totals;
+        for(size_t i=0;i<records.size();++i)
+            accumulate_index_metric(index_metrics.at_unchecked(records[i].first),
+                                    tile_metrics.at_unchecked(records[i].second),
+                                    totals);
+        summarize_index_lane(totals, summary);
     }
+
+    /** Summarize the index metrics of a single lane on a pool
+     */
+    class summarize_index_lane_task
+    {
+    public:
+        /** Constructor
+         *
+         * @param index_metrics source collection of index metrics
+         * @param tile_metrics source collection of tile metrics
+         * @param records offsets of the index metrics of the lane and their tile metrics
+         * @param summary destination index lane summary
+         */
+        summarize_index_lane_task(const model::metric_base::metric_set<model::metrics::index_metric>& index_metrics,
+                                  const model::metric_base::metric_set<model::metrics::tile_metric>& tile_metrics,
+                                  const index_record_offset_vector_t& records,
+                                  model::summary::index_lane_summary& summary) :
+                m_index_metrics(&index_metrics),
+                m_tile_metrics(&tile_metrics),
+                m_records(&records),
+                m_summary(&summary){}
+        /** Summarize the lane
+         */
+        void operator()()const
+        {
+            summarize_index_lane_records(*m_index_metrics, *m_tile_metrics, *m_records, *m_summary);
+        }
+
+    private:
+        const model::metric_base::metric_set<model::metrics::index_metric>* m_index_metrics;
+        const model::metric_base::metric_set<model::metrics::tile_metric>* m_tile_metrics;
+        const index_record_offset_vector_t* m_records;
+        model::summary::index_lane_summary* m_summary;
+    };
+
     /** Summarize a collection index metrics
+     *
+     * Each record is routed to its lane in a single pass over the index metrics, then each lane is summarized,
+     * in parallel if more than one thread is requested.
      *
      * @ingroup summary_logic
      * @param index_metrics source collection of index metrics
      * @param tile_metrics source collection of tile metrics
      * @param lane_count number of lanes
      * @param summary destination index flowcell summary
+     * @param thread_count number of threads used to summarize lanes
      */
     void summarize_index_metrics(const model::metric_base::metric_set<model::metrics::index_metric>& index_metrics,
                                         const model::metric_base::metric_set<model::metrics::tile_metric>& tile_metrics,
                                         const size_t lane_count,
-                                        model::summary::index_flowcell_summary &summary)
+                                        model::summary::index_flowcell_summary &summary,
+                                        const size_t thread_count)
     throw(model::index_out_of_bounds_exception)
     {
+        typedef model::metric_base::metric_set<model::metrics::index_metric> index_metric_set_t;
+
+        util::scoped_trace trace("summarize_index_metrics", "summary");
+        trace.add_records(index_metrics.size());
         if(index_metrics.empty() || tile_metrics.empty()) return;
         summary.resize(lane_count);
-        for(size_t lane=1;lane <= lane_count;++lane)
+
+        // Offsets of each index metric and its tile metric, by lane
+        std::vector<index_record_offset_vector_t> records_of_lane(lane_count);
+        size_t index_offset = 0;
+        for(index_metric_set_t::const_iterator beg = index_metrics.begin(), end = index_metrics.end();
+            beg != end;++beg,++index_offset)
+        {
+            if(beg->lane() < 1 || beg->lane() > lane_count) continue;
+            const size_t tile_offset = tile_metrics.find(beg->lane(), beg->tile());
+            if(tile_offset >= tile_metrics.size()) continue;
+            records_of_lane[beg->lane()-1].push_back(index_record_offset_t(index_offset, tile_offset));
+        }
+
+        if(thread_count > 1 && lane_count > 1)
         {
-            summarize_index_metrics(index_metrics.begin(), index_metrics.end(), tile_metrics, lane, summary[lane-1]);
+            util::thread_pool pool(thread_count);
+            util::task_group tasks(pool);
+            for(size_t lane=0;lane<lane_count;++lane)
+                tasks.run(summarize_index_lane_task(index_metrics, tile_metrics, records_of_lane[lane], summary[lane]));
+            try
+            {
+                tasks.wait();
+            }
+            catch(const model::index_out_of_bounds_exception&)
+            {
+                throw;
+            }
+            catch(const std::exception& ex)
+            {
+                throw model::index_out_of_bounds_exception(ex.what());
+            }
+            return;
         }
+        for(size_t lane=0;lane<lane_count;++lane)
+            summarize_index_lane_records(index_metrics, tile_metrics, records_of_lane[lane], summary[lane]);
     }
 
     /** Summarize index metrics from run metrics
@@ -150,16 +308,19 @@ namespace illumina { namespace interop { namespace logic { namespace summary {
      * @ingroup summary_logic
      * @param metrics source collection of all metrics
      * @param summary destination index flowcell summary
+     * @param thread_count number of threads used to summarize lanes
      */
     void summarize_index_metrics(const model::metrics::run_metrics &metrics,
-                                        model::summary::index_flowcell_summary &summary)
+                                        model::summary::index_flowcell_summary &summary,
+                                        const size_t thread_count)
     throw(model::index_out_of_bounds_exception)
     {
         const size_t lane_count = metrics.run_info().flowcell().lane_count();
         summarize_index_metrics(metrics.get<model::metrics::index_metric>(),
                                 metrics.get<model::metrics::tile_metric>(),
                                 lane_count,
-                                summary);
+                                summary,
+                                thread_count);
     }
 
 }}}}
@@ -12,12 +12,25 @@
 #include "interop/logic/summary/quality_summary.h"
 #include "interop/logic/utils/channel.h"
 #include "interop/logic/metric/q_metric.h"
+#include "interop/logic/metric/derived_metrics.h"
 #include "interop/logic/summary/phasing_summary.h"
 #include "interop/logic/metric/dynamic_phasing_metric.h"
+#include "interop/util/progress.h"
+#include "interop/util/trace.h"
 
 
 namespace illumina { namespace interop { namespace logic { namespace summary
 {
+    /** Report a summarized metric set to an optional progress token, then check whether the summary was cancelled
+     *
+     * @param progress progress token, may be null
+     * @param metrics metric set that was summarized
+     */
+    template<class MetricSet>
+    static void report_summary_progress(util::progress_token* progress, const MetricSet& metrics)
+    {
+        util::update_progress(progress, static_cast<constants::metric_group>(MetricSet::TYPE), 0, metrics.size());
+    }
     /** Determine maximum number of tiles among all metrics for each lane
      *
      * @param metrics run metrics
@@ -103,16 +116,21 @@ namespace illumina { namespace interop { namespace logic { namespace summary
      * @param metrics source collection of all metrics
      * @param summary destination run summary
      * @param skip_median skip the median calculation
+     * @param trim flag indicating whether to trim the summary model
+     * @param progress progress token updated and checked after each metric set, may be null
      */
-    void summarize_run_metrics(model::metrics::run_metrics& metrics,
+    void summarize_run_metrics(const model::metrics::run_metrics& metrics,
                                model::summary::run_summary& summary,
                                const bool skip_median,
-                               const bool trim)
+                               const bool trim,
+                               util::progress_token* progress)
     throw( model::index_out_of_bounds_exception,
     model::invalid_channel_exception,
-    model::invalid_run_info_exception )
+    model::invalid_run_info_exception,
+    util::operation_cancelled_exception )
     {
         using namespace model::metrics;
+        util::scoped_trace trace("summarize_run_metrics", "summary");
         if(metrics.empty())
         {
             summary.clear();
@@ -127,12 +145,14 @@ namespace illumina { namespace interop { namespace logic { namespace summary
                                metrics.get<tile_metric>().end(),
                                naming_method,
                                summary);
+        report_summary_progress(progress, metrics.get<tile_metric>());
         summarize_error_metrics(metrics.get<error_metric>().begin(),
                                 metrics.get<error_metric>().end(),
                                 cycle_to_read,
                                 naming_method,
                                 summary,
                                 skip_median);
+        report_summary_progress(progress, metrics.get<error_metric>());
         INTEROP_ASSERT(metrics.run_info().channels().size()>0);
         const size_t intensity_channel = utils::expected2actual_map(metrics.run_info().channels())[0];
         summarize_extraction_metrics(metrics.get<extraction_metric>().begin(),
@@ -142,16 +162,19 @@ namespace illumina { namespace interop { namespace logic { namespace summary
                                      naming_method,
                                      summary,
                                      skip_median);
+        report_summary_progress(progress, metrics.get<extraction_metric>());
 
-        if(0 == metrics.get<q_collapsed_metric>().size())
-            logic::metric::create_collapse_q_metrics(metrics.get<q_metric>(),
-                                                     metrics.get<q_collapsed_metric>());
-        summarize_collapsed_quality_metrics(metrics.get<q_collapsed_metric>().begin(),
-                                            metrics.get<q_collapsed_metric>().end(),
+        model::metric_base::metric_set<q_collapsed_metric> collapsed_scratch;
+        const model::metric_base::metric_set<q_collapsed_metric>& collapsed_metrics =
+                logic::metric::collapsed_q_metrics(metrics, collapsed_scratch);
+        summarize_collapsed_quality_metrics(collapsed_metrics.begin(),
+                                            collapsed_metrics.end(),
                                             cycle_to_read,
                                             naming_method,
                                             summary);
+        report_summary_progress(progress, collapsed_metrics);
         summarize_tile_count(metrics, summary);
+        util::check_progress(progress);
 
         summarize_cycle_state(metrics.get<tile_metric>(),
                               metrics.get<error_metric>(),
@@ -174,16 +197,16 @@ namespace illumina { namespace interop { namespace logic { namespace summary
                               cycle_to_read,
                               &model::summary::cycle_state_summary::called_cycle_range,
                               summary);
-        if(0 == metrics.get<dynamic_phasing_metric>().size())
-            logic::metric::populate_dynamic_phasing_metrics(metrics.get<model::metrics::phasing_metric>(),
-                                                            cycle_to_read,
-                                                            metrics.get<model::metrics::dynamic_phasing_metric>(),
-                                                            metrics.get<model::metrics::tile_metric>());
-        summarize_phasing_metrics(metrics.get<dynamic_phasing_metric>().begin(),
-                                  metrics.get<dynamic_phasing_metric>().end(),
+        util::check_progress(progress);
+        model::metric_base::metric_set<dynamic_phasing_metric> dynamic_phasing_scratch;
+        const model::metric_base::metric_set<dynamic_phasing_metric>& dynamic_phasing_metrics =
+                logic::metric::dynamic_phasing_metrics(metrics, cycle_to_read, dynamic_phasing_scratch);
+        summarize_phasing_metrics(dynamic_phasing_metrics.begin(),
+                                  dynamic_phasing_metrics.end(),
                                   summary,
                                   naming_method,
                                   skip_median);
+        report_summary_progress(progress, dynamic_phasing_metrics);
 
         if(trim)
         {
@@ -202,5 +225,45 @@ namespace illumina { namespace interop { namespace logic { namespace summary
         }
     }
 
+    /** Summarize a collection run metrics
+     *
+     * Collapsed q-metrics and dynamic phasing metrics missing from the run are derived into the run, as they were
+     * before the read-only overload existed.
+     *
+     * @ingroup summary_logic
+     * @param metrics source collection of all metrics
+     * @param summary destination run summary
+     * @param skip_median skip the median calculation
+     * @param trim flag indicating whether to trim the summary model
+     * @param progress progress token updated and checked after each metric set, may be null
+     */
+    void summarize_run_metrics(model::metrics::run_metrics& metrics,
+                               model::summary::run_summary& summary,
+                               const bool skip_median,
+                               const bool trim,
+                               util::progress_token* progress)
+    throw( model::index_out_of_bounds_exception,
+    model::invalid_channel_exception,
+    model::invalid_run_info_exception,
+    util::operation_cancelled_exception )
+    {
+        using namespace model::metrics;
+        if(!metrics.empty() && 0 == metrics.get<q_collapsed_metric>().size())
+            logic::metric::create_collapse_q_metrics(metrics.get<q_metric>(), metrics.get<q_collapsed_metric>());
+        summarize_run_metrics(static_cast<const run_metrics&>(metrics), summary, skip_median, trim, progress);
+        // The tile metrics are summarized before the phasing derivation fills in their missing phasing slopes
+        if(!metrics.empty() && 0 == metrics.get<dynamic_phasing_metric>().size())
+        {
+            read_cycle_vector_t cycle_to_read;
+            map_read_to_cycle_number(metrics.run_info().reads().begin(),
+                                     metrics.run_info().reads().end(),
+                                     cycle_to_read);
+            logic::metric::populate_dynamic_phasing_metrics(metrics.get<phasing_metric>(),
+                                                            cycle_to_read,
+                                                            metrics.get<dynamic_phasing_metric>(),
+                                                            metrics.get<tile_metric>());
+        }
+    }
+
 }}}}
 
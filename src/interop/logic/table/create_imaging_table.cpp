@@ -11,7 +11,10 @@
 #include "interop/logic/table/create_imaging_table_columns.h"
 #include "interop/logic/table/table_populator.h"
 #include "interop/logic/metric/q_metric.h"
+#include "interop/logic/metric/derived_metrics.h"
 #include "interop/logic/utils/metric_type_ext.h"
+#include "interop/util/progress.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace logic { namespace table
 {
@@ -28,6 +31,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param column_count number of data columns including sub columns
      * @param data_beg iterator to start of table data
      * @param data_end iterator to end of table data
+     * @param group metric group reported to the progress token
+     * @param progress progress token updated and checked between chunks of records, may be null
      */
     template<typename InputIterator, typename OutputIterator>
     void populate_imaging_table_data_by_cycle(InputIterator beg,
@@ -40,11 +45,19 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                               const row_offset_map_t& row_offset,
                                               const size_t column_count,
                                               OutputIterator data_beg,
-                                              OutputIterator data_end)
+                                              OutputIterator data_end,
+                                              const constants::metric_group group,
+                                              util::progress_token* progress)
     {
         typedef model::metric_base::base_metric::id_t id_t;
+        size_t chunk = 0;
         for(;beg != end;++beg)
         {
+            if(progress != 0 && ++chunk == util::progress_token::RecordChunk)
+            {
+                progress->update(group, 0, chunk);
+                chunk = 0;
+            }
             const id_t id = beg->cycle_hash();
             typename row_offset_map_t::const_iterator row_it = row_offset.find(id);
             const ::uint64_t row = row_it->second;
@@ -83,6 +96,7 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                       data_beg+row*column_count,
                                       data_end);
         }
+        util::update_progress(progress, group, 0, chunk);
     }
     /** Populate the imaging table with a by cycle InterOp metric set
      *
@@ -96,6 +110,7 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param column_count number of data columns including sub columns
      * @param data_beg iterator to start of table data
      * @param data_end iterator to end of table data
+     * @param progress progress token updated and checked between chunks of records, may be null
      */
     template<class MetricSet, typename OutputIterator>
     void populate_imaging_table_data_by_cycle(const MetricSet& metrics,
@@ -106,7 +121,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                               const std::vector<size_t>& columns,
                                               const row_offset_map_t& row_offset,
                                               const size_t column_count,
-                                              OutputIterator data_beg, OutputIterator data_end)
+                                              OutputIterator data_beg, OutputIterator data_end,
+                                              util::progress_token* progress)
     {
         populate_imaging_table_data_by_cycle(metrics.begin(),
                                              metrics.end(),
@@ -117,7 +133,9 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              columns,
                                              row_offset,
                                              column_count,
-                                             data_beg, data_end);
+                                             data_beg, data_end,
+                                             static_cast<constants::metric_group>(MetricSet::TYPE),
+                                             progress);
     }
     /** Zero out first column of every row
      *
@@ -137,13 +155,15 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param row_offset offset for each metric into the sorted table
      * @param data_beg iterator to start of table data
      * @param data_end iterator to end of table data
+     * @param progress progress token updated and checked between chunks of records, may be null
      */
     template<typename I>
     void create_imaging_table_data(const model::metrics::run_metrics& metrics,
                                    const std::vector<model::table::imaging_column>& columns,
                                    const row_offset_map_t& row_offset,
                                    I data_beg,
-                                   I data_end)
+                                   I data_end,
+                                   util::progress_token* progress=0)
     {
         typedef typename model::metrics::run_metrics::id_t id_t;
         typedef model::metric_base::metric_set< model::metrics::tile_metric > tile_metric_set_t;
@@ -173,7 +193,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              cmap,
                                              row_offset,
                                              column_count,
-                                             data_beg, data_end);
+                                             data_beg, data_end,
+                                             progress);
         populate_imaging_table_data_by_cycle(metrics.get<model::metrics::error_metric>(),
                                              q20_idx,
                                              q30_idx,
@@ -182,7 +203,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              cmap,
                                              row_offset,
                                              column_count,
-                                             data_beg, data_end);
+                                             data_beg, data_end,
+                                             progress);
         populate_imaging_table_data_by_cycle(metrics.get<model::metrics::image_metric>(),
                                              q20_idx,
                                              q30_idx,
@@ -191,7 +213,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              cmap,
                                              row_offset,
                                              column_count,
-                                             data_beg, data_end);
+                                             data_beg, data_end,
+                                             progress);
         populate_imaging_table_data_by_cycle(metrics.get<model::metrics::corrected_intensity_metric>(),
                                              q20_idx,
                                              q30_idx,
@@ -200,7 +223,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              cmap,
                                              row_offset,
                                              column_count,
-                                             data_beg, data_end);
+                                             data_beg, data_end,
+                                             progress);
         populate_imaging_table_data_by_cycle(metrics.get<model::metrics::q_metric>(),
                                              q20_idx,
                                              q30_idx,
@@ -209,7 +233,8 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              cmap,
                                              row_offset,
                                              column_count,
-                                             data_beg, data_end);
+                                             data_beg, data_end,
+                                             progress);
         populate_imaging_table_data_by_cycle(metrics.get<model::metrics::phasing_metric>(),
                                              q20_idx,
                                              q30_idx,
@@ -218,20 +243,24 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                              cmap,
                                              row_offset,
                                              column_count,
-                                             data_beg, data_end);
+                                             data_beg, data_end,
+                                             progress);
 
         const tile_metric_set_t& tile_metrics = metrics.get<model::metrics::tile_metric>();
+        size_t chunk = 0;
         for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it)
         {
+            if(progress != 0 && ++chunk % util::progress_token::RecordChunk == 0) progress->check();
             const id_t tid = model::metric_base::base_cycle_metric::tile_hash_from_id(it->first);
-            if (!tile_metrics.has_metric(tid)) continue;
+            const model::metrics::tile_metric* tile_metric = tile_metrics.try_get(tid);
+            if (tile_metric == 0) continue;
             const id_t cycle = model::metric_base::base_cycle_metric::cycle_from_id(it->first);
             const ::uint64_t row = it->second;
             INTEROP_ASSERTMSG(cycle <= cycle_to_read.size(),
                               cycle << " <= " << cycle_to_read.size()
                                     <<  " tile: " << model::metric_base::base_cycle_metric::tile_from_id(it->first));
             const summary::read_cycle& read = cycle_to_read[static_cast<size_t>(cycle-1)];
-            table_populator::populate(tile_metrics.get_metric(tid),
+            table_populator::populate(*tile_metric,
                                       read.number,
                                       q20_idx,
                                       q30_idx,
@@ -241,17 +270,23 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                       data_beg+row*column_count,
                                       data_end);
         }
+        dynamic_phasing_metric_set_t scratch;
         const dynamic_phasing_metric_set_t& dynamic_phasing_metrics =
-                metrics.get<model::metrics::dynamic_phasing_metric>();
+                metric::dynamic_phasing_metrics(metrics, cycle_to_read, scratch);
         for(typename row_offset_map_t::const_iterator it = row_offset.begin();it != row_offset.end();++it)
         {
+            if(progress != 0 && ++chunk % util::progress_token::RecordChunk == 0) progress->check();
             const id_t lane = model::metric_base::base_read_metric::lane_from_id(it->first);
             const id_t tile = model::metric_base::base_read_metric::tile_from_id(it->first);
             const id_t cycle = model::metric_base::base_cycle_metric::cycle_from_id(it->first);
             const ::uint64_t row = it->second;
             const summary::read_cycle& read = cycle_to_read[static_cast<size_t>(cycle-1)];
-            if (!dynamic_phasing_metrics.has_metric(static_cast<uint32_t>(lane), static_cast<uint32_t>(tile), static_cast<uint32_t>(read.number))) continue;
-            table_populator::populate(dynamic_phasing_metrics.get_metric(static_cast<uint32_t>(lane), static_cast<uint32_t>(tile), static_cast<uint32_t>(read.number)),
+            const model::metrics::dynamic_phasing_metric* dynamic_phasing_metric =
+                    dynamic_phasing_metrics.try_get(static_cast<uint32_t>(lane),
+                                                    static_cast<uint32_t>(tile),
+                                                    static_cast<uint32_t>(read.number));
+            if (dynamic_phasing_metric == 0) continue;
+            table_populator::populate(*dynamic_phasing_metric,
                                       read.number,
                                       q20_idx,
                                       q30_idx,
@@ -325,22 +360,49 @@ namespace illumina { namespace interop { namespace logic { namespace table
      *
      * @param metrics source run metrics
      * @param table destination imaging table
+     * @param progress progress token updated and checked between chunks of records, may be null
      */
-    void create_imaging_table(model::metrics::run_metrics& metrics, model::table::imaging_table& table)
-                                        throw(model::invalid_column_type, model::index_out_of_bounds_exception)
+    void create_imaging_table(const model::metrics::run_metrics& metrics,
+                              model::table::imaging_table& table,
+                              util::progress_token* progress)
+                                        throw(model::invalid_column_type,
+                                              model::index_out_of_bounds_exception,
+                                              util::operation_cancelled_exception)
     {
         typedef model::table::imaging_table::column_vector_t column_vector_t;
         typedef model::table::imaging_table::data_vector_t data_vector_t;
 
+        util::scoped_trace trace("create_imaging_table", "table");
         row_offset_map_t row_offset;
         column_vector_t columns;
         create_imaging_table_columns(metrics, columns);
         if(columns.empty())return;
         count_table_rows(metrics, row_offset);
+        util::check_progress(progress);
         data_vector_t data(row_offset.size()*count_table_columns(columns), std::numeric_limits<float>::quiet_NaN());
-        create_imaging_table_data(metrics, columns, row_offset, data.begin(), data.end());
+        trace.add_records(row_offset.size());
+        trace.add_allocation(data.size() * sizeof(float));
+        create_imaging_table_data(metrics, columns, row_offset, data.begin(), data.end(), progress);
         table.set_data(row_offset.size(), columns, data);
     }
+    /** Create an imaging table from run metrics
+     *
+     * Dynamic phasing metrics missing from the run are derived into the run.
+     *
+     * @param metrics source run metrics
+     * @param table destination imaging table
+     * @param progress progress token updated and checked between chunks of records, may be null
+     */
+    void create_imaging_table(model::metrics::run_metrics& metrics,
+                              model::table::imaging_table& table,
+                              util::progress_token* progress)
+                                        throw(model::invalid_column_type,
+                                              model::index_out_of_bounds_exception,
+                                              util::operation_cancelled_exception)
+    {
+        populate_dynamic_phasing_if_missing(metrics);
+        create_imaging_table(static_cast<const model::metrics::run_metrics&>(metrics), table, progress);
+    }
 
 
     /** Convert metric type to metric group
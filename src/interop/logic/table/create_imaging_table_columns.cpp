@@ -12,6 +12,7 @@
 #include "interop/logic/table/check_imaging_table_column.h"
 #include "interop/logic/metric/q_metric.h"
 #include "interop/logic/metric/dynamic_phasing_metric.h"
+#include "interop/logic/metric/derived_metrics.h"
 
 namespace illumina { namespace interop { namespace logic { namespace table
 {
@@ -21,7 +22,7 @@ namespace illumina { namespace interop { namespace logic { namespace table
      * @param tile_hash map between the tile has and base metric
      * @param filled destination array that indicates whether a column should be filled
      */
-    void determine_filled_columns(model::metrics::run_metrics& metrics,
+    void determine_filled_columns(const model::metrics::run_metrics& metrics,
                                          const model::metrics::run_metrics::tile_metric_map_t& tile_hash,
                                          std::vector< bool >& filled)
     {
@@ -41,10 +42,11 @@ namespace illumina { namespace interop { namespace logic { namespace table
         const size_t q30_idx = metric::index_for_q_value(metrics.get<model::metrics::q_metric>(), 30);
         for(tile_metric_map_t::const_iterator it = tile_hash.begin();it != tile_hash.end();++it)
         {
-            if(!tile_metrics.has_metric(it->first)) continue;
+            const model::metrics::tile_metric* tile_metric = tile_metrics.try_get(it->first);
+            if(tile_metric == 0) continue;
             for(model::run::info::const_read_iterator read_it = metrics.run_info().reads().begin();read_it != metrics.run_info().reads().end();++read_it)
             {
-                check_imaging_table_column::set_filled_for_metric(tile_metrics.get_metric(it->first),
+                check_imaging_table_column::set_filled_for_metric(*tile_metric,
                                                                   read_it->number(),
                                                                   q20_idx,
                                                                   q30_idx,
@@ -59,22 +61,18 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                           metrics.run_info().reads().end(),
                                           cycle_to_read);
 
-        if(metrics.get<model::metrics::dynamic_phasing_metric>().empty())
-        {
-            logic::metric::populate_dynamic_phasing_metrics(metrics.get<model::metrics::phasing_metric>(),
-                                                            cycle_to_read,
-                                                            metrics.get<model::metrics::dynamic_phasing_metric>(),
-                                                            metrics.get<model::metrics::tile_metric>());
-        }
+        model::metric_base::metric_set<model::metrics::dynamic_phasing_metric> scratch;
         const model::metric_base::metric_set<model::metrics::dynamic_phasing_metric>& dynamic_phasing_metrics =
-                metrics.get<model::metrics::dynamic_phasing_metric>();
+                logic::metric::dynamic_phasing_metrics(metrics, cycle_to_read, scratch);
         for(tile_metric_map_t::const_iterator it = tile_hash.begin();it != tile_hash.end();++it)
         {
             for(model::run::info::const_read_iterator read_it = metrics.run_info().reads().begin();read_it != metrics.run_info().reads().end();++read_it)
             {
                 const ::uint64_t tile_read_index = model::metric_base::base_read_metric::create_id(it->second.lane(), it->second.tile(), read_it->number());
-                if(!dynamic_phasing_metrics.has_metric(tile_read_index)) continue;
-                check_imaging_table_column::set_filled_for_metric(dynamic_phasing_metrics.get_metric(tile_read_index),
+                const model::metrics::dynamic_phasing_metric* dynamic_phasing_metric =
+                        dynamic_phasing_metrics.try_get(tile_read_index);
+                if(dynamic_phasing_metric == 0) continue;
+                check_imaging_table_column::set_filled_for_metric(*dynamic_phasing_metric,
                                                                   read_it->number(),
                                                                   q20_idx,
                                                                   q30_idx,
@@ -185,12 +183,28 @@ namespace illumina { namespace interop { namespace logic { namespace table
         }
     }
 
+    /** Derive the dynamic phasing metrics of the run, if they are missing
+     *
+     * @param metrics run metrics
+     */
+    void populate_dynamic_phasing_if_missing(model::metrics::run_metrics& metrics)
+    {
+        if(!metrics.get<model::metrics::dynamic_phasing_metric>().empty()) return;
+        summary::read_cycle_vector_t cycle_to_read;
+        summary::map_read_to_cycle_number(metrics.run_info().reads().begin(),
+                                          metrics.run_info().reads().end(),
+                                          cycle_to_read);
+        logic::metric::populate_dynamic_phasing_metrics(metrics.get<model::metrics::phasing_metric>(),
+                                                        cycle_to_read,
+                                                        metrics.get<model::metrics::dynamic_phasing_metric>(),
+                                                        metrics.get<model::metrics::tile_metric>());
+    }
     /** Create a vector of column descriptors
      *
      * @param metrics source collection of InterOp metrics from the run
      * @param columns destination vector of column descriptors
      */
-    void create_imaging_table_columns(model::metrics::run_metrics& metrics,
+    void create_imaging_table_columns(const model::metrics::run_metrics& metrics,
                                       std::vector< model::table::imaging_column >& columns)
                                       throw(model::invalid_column_type,
                                       model::index_out_of_bounds_exception,
@@ -205,6 +219,22 @@ namespace illumina { namespace interop { namespace logic { namespace table
                                      filled,
                                      columns);
     }
+    /** Create a vector of column descriptors
+     *
+     * Dynamic phasing metrics missing from the run are derived into the run.
+     *
+     * @param metrics source collection of InterOp metrics from the run
+     * @param columns destination vector of column descriptors
+     */
+    void create_imaging_table_columns(model::metrics::run_metrics& metrics,
+                                      std::vector< model::table::imaging_column >& columns)
+                                      throw(model::invalid_column_type,
+                                      model::index_out_of_bounds_exception,
+                                      model::invalid_channel_exception)
+    {
+        populate_dynamic_phasing_if_missing(metrics);
+        create_imaging_table_columns(static_cast<const model::metrics::run_metrics&>(metrics), columns);
+    }
 
 
     /** Get the maximum number of digits to round
@@ -139,6 +139,9 @@ namespace illumina { namespace interop { namespace io
         {
             // We do not support writing this date/time in C# format from C++
         }
+        static void convert_datetime(output_cursor &, const extraction_metric &)
+        {
+        }
         static void convert_datetime(const char*, extraction_metric& metric)
         {
             metric.m_date_time = metric.m_date_time_csharp.to_unix();
@@ -149,17 +152,20 @@ namespace illumina { namespace interop { namespace io
             if (in.fail()) return;
             metric.m_date_time = metric.m_date_time_csharp.to_unix();
         }
-        static void set_nan_to_zero(const char*, std::vector<float>& vals)
+        static void set_nan_to_zero(const char*, extraction_metric::float_channel_array_t& vals)
         {
             for(size_t i=0;i<vals.size();++i)
                 if(std::isnan(vals[i])) vals[i] = 0;
         }
 
-        static void set_nan_to_zero(std::ostream &, const std::vector<float> &) // TODO: Remove and rebaseline
+        static void set_nan_to_zero(std::ostream &, const extraction_metric::float_channel_array_t &) // TODO: Remove and rebaseline
         {
 
         }
-        static void set_nan_to_zero(std::istream&, std::vector<float>& vals)
+        static void set_nan_to_zero(output_cursor &, const extraction_metric::float_channel_array_t &)
+        {
+        }
+        static void set_nan_to_zero(std::istream&, extraction_metric::float_channel_array_t& vals)
         {
             for(size_t i=0;i<vals.size();++i)
                 if(std::isnan(vals[i])) vals[i] = 0;
@@ -270,6 +276,8 @@ namespace illumina { namespace interop { namespace io
             if(stream.fail())return count;
             if(0==count)
                 INTEROP_THROW(bad_format_exception, "Format does not support 0 channels for extraction metric");
+            if(header.m_channel_count > extraction_metric::MAX_CHANNELS)
+                INTEROP_THROW(bad_format_exception, "Channel count exceeds the limit of " << extraction_metric::MAX_CHANNELS);
             return count;
         }
 
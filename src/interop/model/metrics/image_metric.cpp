@@ -264,6 +264,8 @@ namespace illumina { namespace interop { namespace io
             if (stream.fail())return count;
             if (header.m_channel_count == 0)
                 INTEROP_THROW(bad_format_exception, "Cannot write data where channel count is 0");
+            if (header.m_channel_count > image_metric::MAX_CHANNELS)
+                INTEROP_THROW(bad_format_exception, "Channel count exceeds the limit of " << image_metric::MAX_CHANNELS);
             return count;
         }
 
@@ -378,6 +380,8 @@ namespace illumina { namespace interop { namespace io
             if (stream.fail())return count;
             if (header.m_channel_count == 0)
                 INTEROP_THROW(bad_format_exception, "Cannot write data where channel count is 0");
+            if (header.m_channel_count > image_metric::MAX_CHANNELS)
+                INTEROP_THROW(bad_format_exception, "Channel count exceeds the limit of " << image_metric::MAX_CHANNELS);
             return count;
         }
 
@@ -173,6 +173,7 @@ namespace illumina{ namespace interop{ namespace io {
         static bool is_output(const char*){return false;}
         static bool is_output(std::istream&){return false;}
         static bool is_output(std::ostream&){return true;}
+        static bool is_output(output_cursor&){return true;}
         static void test_incomplete(const char*, const std::streamsize extra)
         {
             if(static_cast<size_t>(extra) != sizeof(median_t) )
@@ -188,6 +189,7 @@ namespace illumina{ namespace interop{ namespace io {
                                                           sizeof(median_t) );
         }
         static void test_incomplete(std::ostream&, const std::streamsize ){}
+        static void test_incomplete(output_cursor&, const std::streamsize ){}
         template<class Header>
         static void set_record_size(std::istream&, Header& header, const record_size_t record_size)
         {
@@ -483,6 +485,7 @@ namespace illumina{ namespace interop{ namespace io {
         static bool is_output(const char*){return false;}
         static bool is_output(std::istream&){return false;}
         static bool is_output(std::ostream&){return true;}
+        static bool is_output(output_cursor&){return true;}
         static void test_incomplete(const char*, const std::streamsize extra)
         {
             if(static_cast<size_t>(extra) != sizeof(median_t) )
@@ -498,6 +501,7 @@ namespace illumina{ namespace interop{ namespace io {
                                                 sizeof(median_t) );
         }
         static void test_incomplete(std::ostream&, const std::streamsize ){}
+        static void test_incomplete(output_cursor&, const std::streamsize ){}
         template<class Header>
         static void set_record_size(const char*, Header& header, const record_size_t record_size)
         {
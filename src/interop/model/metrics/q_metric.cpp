@@ -111,14 +111,18 @@ namespace illumina { namespace interop { namespace io
         static void resize_accumulated(const char*, q_metric& metric)
         {
             metric.m_qscore_hist_cumulative.resize(metric.m_qscore_hist.size(), 0);
+            metric.m_qscore_suffix.clear();
         }
         static void resize_accumulated(std::istream &, q_metric &metric)
         {
             metric.m_qscore_hist_cumulative.resize(metric.m_qscore_hist.size(), 0);
+            metric.m_qscore_suffix.clear();
         }
 
         static void resize_accumulated(std::ostream &, const q_metric &)
         { }
+        static void resize_accumulated(output_cursor &, const q_metric &)
+        { }
     };
 
     /** Q-score Metric Record Layout Version 5
@@ -226,6 +230,30 @@ namespace illumina { namespace interop { namespace io
          */
         template<class Metric, class Header>
         static std::streamsize map_stream(std::ostream &stream, Metric &metric, Header &header, const bool)
+        {
+            return write_histogram(stream, metric, header);
+        }
+        /** Write metric to a memory buffer
+         *
+         * @param out output cursor
+         * @param metric source metric
+         * @param header metric header
+         * @return number of bytes written
+         */
+        template<class Metric, class Header>
+        static std::streamsize map_stream(output_cursor &out, Metric &metric, Header &header, const bool)
+        {
+            return write_histogram(out, metric, header);
+        }
+        /** Write the histogram of a metric, expanding binned counts to the full histogram
+         *
+         * @param stream output stream or cursor
+         * @param metric source metric
+         * @param header metric header
+         * @return number of bytes written
+         */
+        template<class OutputStream, class Metric, class Header>
+        static std::streamsize write_histogram(OutputStream &stream, Metric &metric, Header &header)
         {
             if (header.m_qscore_bins.size() > 0)
             {
@@ -382,14 +410,18 @@ namespace illumina { namespace interop { namespace io
         static void resize_accumulated(const char*, q_metric& metric)
         {
             metric.m_qscore_hist_cumulative.resize(metric.m_qscore_hist.size(), 0);
+            metric.m_qscore_suffix.clear();
         }
         static void resize_accumulated(std::istream &, q_metric &metric)
         {
             metric.m_qscore_hist_cumulative.resize(metric.m_qscore_hist.size(), 0);
+            metric.m_qscore_suffix.clear();
         }
 
         static void resize_accumulated(std::ostream &, const q_metric &)
         { }
+        static void resize_accumulated(output_cursor &, const q_metric &)
+        { }
     };
 
     /** Q-score Metric Record Layout Version 6
@@ -610,14 +642,18 @@ namespace illumina { namespace interop { namespace io
         static void resize_accumulated(const char*, q_metric& metric)
         {
             metric.m_qscore_hist_cumulative.resize(metric.m_qscore_hist.size(), 0);
+            metric.m_qscore_suffix.clear();
         }
         static void resize_accumulated(std::istream &, q_metric &metric)
         {
             metric.m_qscore_hist_cumulative.resize(metric.m_qscore_hist.size(), 0);
+            metric.m_qscore_suffix.clear();
         }
 
         static void resize_accumulated(std::ostream &, const q_metric &)
         { }
+        static void resize_accumulated(output_cursor &, const q_metric &)
+        { }
     };
 
     /** Packed layout of a q-score bin
@@ -20,6 +20,66 @@ using namespace illumina::interop::model::metrics;
 
 namespace illumina { namespace interop { namespace io
 {
+    /** Decode a buffer of whole tile metric records into a metric set
+     *
+     * Records are applied in file order, as read_metrics would apply them one at a time, so control lanes and the
+     * order in which tiles first appear are unchanged. The records of a tile are usually adjacent, so the offset of the
+     * previous tile is reused rather than looked up in the offset map for every record.
+     *
+     * @param in buffer of records, advanced past the decoded records
+     * @param record_count number of records in the buffer
+     * @param metric_set destination set of metrics
+     * @param offset_map map from a metric id to its offset in the metric set
+     */
+    template<class Layout, class MetricSet, class OffsetMap>
+    static void decode_tile_records(char*& in,
+                                    const size_t record_count,
+                                    MetricSet& metric_set,
+                                    OffsetMap& offset_map)
+    {
+        typedef typename Layout::metric_id_t metric_id_t;
+        typedef typename OffsetMap::iterator offset_iterator;
+        typedef model::metric_base::base_metric::id_t id_t;
+        tile_metric invalid_metric;
+        id_t last_id = 0;
+        size_t last_offset = 0;
+        for(size_t i=0;i<record_count;++i)
+        {
+            metric_id_t layout_id;
+            read_binary(in, layout_id);
+            if (!Layout::is_valid(layout_id))
+            {
+                Layout::decode_record(in, invalid_metric, metric_set, true);
+                continue;
+            }
+            const id_t id = model::metric_base::base_metric::create_id(layout_id.lane, layout_id.tile);
+            if (id != last_id)
+            {
+                const offset_iterator offset_it = offset_map.find(id);
+                if (offset_it == offset_map.end())
+                {
+                    const size_t offset = offset_map.size();
+                    if(offset >= metric_set.size()) metric_set.resize(offset+1);
+                    tile_metric& metric = metric_set.at_unchecked(offset);
+                    metric.set_base(layout_id);
+                    Layout::decode_record(in, metric, metric_set, true);
+                    if(Layout::skip_metric(metric))//Avoid adding control lanes in tile metrics
+                    {
+                        metric_set.resize(offset);
+                        continue;
+                    }
+                    offset_map[id] = offset;
+                    last_id = id;
+                    last_offset = offset;
+                    continue;
+                }
+                last_id = id;
+                last_offset = offset_it->second;
+            }
+            Layout::decode_record(in, metric_set.at_unchecked(last_offset), metric_set, false);
+        }
+    }
+
 #pragma pack(1)
 
     /** Tile Metric Record Layout Version 2
@@ -36,6 +96,11 @@ namespace illumina { namespace interop { namespace io
     template<>
     struct generic_layout<tile_metric, 2> : public default_layout<2, 1 /* Multi record */>
     {
+        enum
+        {
+            /** Tile metric files are decoded a whole file at once */
+            BULK_DECODE=1
+        };
         /** @page tile_v2 Tile Version 2
          *
          * This class provides an interface to reading the tile metric file:
@@ -102,49 +167,34 @@ namespace illumina { namespace interop { namespace io
             record_t rec;
             std::streamsize count = stream_map<record_t>(stream, rec);
             if (stream.fail()) return count;
-            float val = rec.value;
-            switch (rec.code)
-            {
-                case ControlLane:
-                    if (is_new) metric.set_base(metric_id_t());
-                    break;
-                case ClusterDensity:
-                    metric.m_cluster_density = val;
-                    break;
-                case ClusterDensityPf:
-                    metric.m_cluster_density_pf = val;
-                    break;
-                case ClusterCount:
-                    metric.m_cluster_count = val;
-                    break;
-                case ClusterCountPf:
-                    metric.m_cluster_count_pf = val;
-                    break;
-                default:
-                    if (rec.code % Phasing < 100)
-                    {
-                        //code = Prephasing+read*2;
-                        int code_offset = rec.code % Phasing;
-                        if (code_offset % 2 == 0)
-                        {
-                            get_read(metric, (code_offset / 2) + 1)->percent_phasing(val * 100);
-                        }
-                        else
-                        {
-                            get_read(metric, (code_offset + 1) / 2)->percent_prephasing(val * 100);
-                        }
-                    }
-                    else if (rec.code % PercentAligned < 100)
-                    {
-                        int code_offset = rec.code % PercentAligned;
-                        get_read(metric, code_offset + 1)->percent_aligned(val);
-                    }
-                    else
-                        INTEROP_THROW(bad_format_exception, "Unexpected tile code");
-            };
-
+            apply_record(metric, rec, is_new);
             return count;
         }
+        /** Read a metric from a buffer of whole records
+         *
+         * @param in input buffer, advanced past the record
+         * @param metric destination metric
+         * @param is_new true if metric is new
+         */
+        template<class Metric, class Header>
+        static void decode_record(char*& in, Metric &metric, Header &, const bool is_new)
+        {
+            record_t rec;
+            read_binary(in, rec);
+            apply_record(metric, rec, is_new);
+        }
+        /** Decode a buffer of whole records into a metric set
+         *
+         * @param in input buffer, advanced past the records
+         * @param record_count number of records in the buffer
+         * @param metric_set destination set of metrics
+         * @param offset_map map from a metric id to its offset in the metric set
+         */
+        template<class MetricSet, class OffsetMap>
+        static void decode_records(char*& in, const size_t record_count, MetricSet& metric_set, OffsetMap& offset_map)
+        {
+            decode_tile_records<record_t>(in, record_count, metric_set, offset_map);
+        }
 
         /** Write metric to the output stream
          *
@@ -286,6 +336,50 @@ namespace illumina { namespace interop { namespace io
         }
 
     private:
+        template<class Metric>
+        static void apply_record(Metric &metric, const record_t& rec, const bool is_new)
+        {
+            const float val = rec.value;
+            switch (rec.code)
+            {
+                case ControlLane:
+                    if (is_new) metric.set_base(metric_id_t());
+                    break;
+                case ClusterDensity:
+                    metric.m_cluster_density = val;
+                    break;
+                case ClusterDensityPf:
+                    metric.m_cluster_density_pf = val;
+                    break;
+                case ClusterCount:
+                    metric.m_cluster_count = val;
+                    break;
+                case ClusterCountPf:
+                    metric.m_cluster_count_pf = val;
+                    break;
+                default:
+                    if (rec.code % Phasing < 100)
+                    {
+                        //code = Prephasing+read*2;
+                        int code_offset = rec.code % Phasing;
+                        if (code_offset % 2 == 0)
+                        {
+                            get_read(metric, (code_offset / 2) + 1)->percent_phasing(val * 100);
+                        }
+                        else
+                        {
+                            get_read(metric, (code_offset + 1) / 2)->percent_prephasing(val * 100);
+                        }
+                    }
+                    else if (rec.code % PercentAligned < 100)
+                    {
+                        int code_offset = rec.code % PercentAligned;
+                        get_read(metric, code_offset + 1)->percent_aligned(val);
+                    }
+                    else
+                        INTEROP_THROW(bad_format_exception, "Unexpected tile code");
+            };
+        }
         static tile_metric::read_metric_vector::iterator get_read(tile_metric &metric,
                                                                   tile_metric::read_metric_type::uint_t read)
         {
@@ -311,6 +405,11 @@ namespace illumina { namespace interop { namespace io
     template<>
     struct generic_layout<tile_metric, 3> : public default_layout<3, 1 /*Multi record */>
     {
+        enum
+        {
+            /** Tile metric files are decoded a whole file at once */
+            BULK_DECODE=1
+        };
         /** @page tile_v3 Image Version 3
          *
          * This class provides an interface to reading the tile metric file:
@@ -377,17 +476,7 @@ namespace illumina { namespace interop { namespace io
             else if (code == 't')
             {
                 count += map_stream_tile(stream, metric);
-                if (header.m_density == 0 || std::isnan(header.m_density))
-                {
-                    const float NaN = std::numeric_limits<float>::quiet_NaN();
-                    metric.m_cluster_density = NaN;
-                    metric.m_cluster_density_pf = NaN;
-                }
-                else
-                {
-                    metric.m_cluster_density = metric.m_cluster_count / header.m_density;
-                    metric.m_cluster_density_pf = metric.m_cluster_count_pf / header.m_density;
-                }
+                update_density(metric, header);
             }
             else if(code == '\0') // Empty record, everything inside the record should be zero
             {
@@ -405,6 +494,51 @@ namespace illumina { namespace interop { namespace io
                                            util::lexical_cast<std::string>(int(count)));
             return count;
         }
+        /** Read a metric from a buffer of whole records
+         *
+         * @param in input buffer, advanced past the record
+         * @param metric destination metric
+         * @param header metric header layout
+         */
+        template<class Metric, class Header>
+        static void decode_record(char*& in, Metric &metric, Header &header, const bool)
+        {
+            ::uint8_t code = '\0';
+            const std::streamsize count = stream_map< ::uint8_t >(in, code);
+            if (code == 'r')
+            {
+                model::metrics::read_metric read_metric;
+                map_stream_read(in, read_metric);
+                metric.m_read_metrics.push_back(read_metric);
+            }
+            else if (code == 't')
+            {
+                map_stream_tile(in, metric);
+                update_density(metric, header);
+            }
+            else if(code == '\0') // Empty record, everything inside the record should be zero
+            {
+                const size_t skip_size = compute_size(header) - 1 - sizeof(metric_id_t);
+                for(size_t i=0;i<skip_size;++i, ++in)
+                    if (*in != '\0') INTEROP_THROW(bad_format_exception, "Skipped byte not zero");
+            }
+            else
+                INTEROP_THROW(bad_format_exception, std::string("Unexpected code: ") +
+                                           util::lexical_cast<std::string>(int(code)) + " -> " +
+                                           util::lexical_cast<std::string>(int(count)));
+        }
+        /** Decode a buffer of whole records into a metric set
+         *
+         * @param in input buffer, advanced past the records
+         * @param record_count number of records in the buffer
+         * @param metric_set destination set of metrics
+         * @param offset_map map from a metric id to its offset in the metric set
+         */
+        template<class MetricSet, class OffsetMap>
+        static void decode_records(char*& in, const size_t record_count, MetricSet& metric_set, OffsetMap& offset_map)
+        {
+            decode_tile_records<generic_layout<tile_metric, 3> >(in, record_count, metric_set, offset_map);
+        }
 
         /** Map reading/writing a metric to a stream
          *
@@ -526,6 +660,22 @@ namespace illumina { namespace interop { namespace io
             count += stream_map<float>(stream, metric.m_cluster_count_pf);
             return count;
         }
+
+        template<class Metric, class Header>
+        static void update_density(Metric &metric, const Header &header)
+        {
+            if (header.m_density == 0 || std::isnan(header.m_density))
+            {
+                const float NaN = std::numeric_limits<float>::quiet_NaN();
+                metric.m_cluster_density = NaN;
+                metric.m_cluster_density_pf = NaN;
+            }
+            else
+            {
+                metric.m_cluster_density = metric.m_cluster_count / header.m_density;
+                metric.m_cluster_density_pf = metric.m_cluster_count_pf / header.m_density;
+            }
+        }
     };
 
 #pragma pack()
@@ -5,16 +5,16 @@
  *  @version 1.0
  *  @copyright GNU Public License.
  */
-#ifdef _OPENMP
-#include <omp.h>
-#endif
-
 #include "interop/model/run_metrics.h"
 
+#include <fstream>
+
 #include "interop/logic/metric/q_metric.h"
 #include "interop/logic/metric/tile_metric.h"
 #include "interop/logic/utils/channel.h"
 #include "interop/logic/metric/dynamic_phasing_metric.h"
+#include "interop/util/thread_pool.h"
+#include "interop/util/trace.h"
 
 namespace illumina { namespace interop { namespace model { namespace metrics
 {
@@ -106,19 +106,76 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         }
     };
 
+    struct build_metric_views
+    {
+        template<class MetricSet>
+        void operator()(const MetricSet &metrics)const
+        {
+            metrics.build_views();
+        }
+    };
+
+    /** Flag the metric sets that hold metrics before a load
+     */
+    class flag_loaded_metric_sets
+    {
+    public:
+        flag_loaded_metric_sets(const bool keep_loaded) :
+                m_keep_loaded(keep_loaded), m_flags(constants::MetricCount, 0)
+        {}
+
+        template<class MetricSet>
+        void operator()(const MetricSet &metrics)
+        {
+            m_flags[MetricSet::TYPE] = static_cast<unsigned char>(m_keep_loaded && !metrics.empty());
+        }
+
+        const std::vector<unsigned char>& flags()const
+        {
+            return m_flags;
+        }
+
+    private:
+        bool m_keep_loaded;
+        std::vector<unsigned char> m_flags;
+    };
+    /** Clear the metric sets that are not flagged, and release their memory
+     */
+    class clear_unflagged_metric_sets
+    {
+    public:
+        clear_unflagged_metric_sets(const std::vector<unsigned char>& flags) : m_flags(flags){}
+
+        template<class MetricSet>
+        void operator()(MetricSet &metrics)const
+        {
+            if(m_flags[MetricSet::TYPE] == 0) metrics.release();
+        }
+
+    private:
+        const std::vector<unsigned char>& m_flags;
+    };
+
     struct read_func
     {
         typedef const unsigned char* bool_pointer;
-        read_func(const std::string &f, bool_pointer load_metric_check=0, const bool skip_loaded=false) :
+        read_func(const std::string &f,
+                  bool_pointer load_metric_check=0,
+                  const bool skip_loaded=false,
+                  const int group=-1,
+                  util::progress_token* progress=0) :
                 m_run_folder(f),
                 m_load_metric_check(load_metric_check),
                 m_are_all_files_missing(true),
-                m_skip_loaded(skip_loaded)
+                m_skip_loaded(skip_loaded),
+                m_group(group),
+                m_progress(progress)
         {}
 
         template<class MetricSet>
         int operator()(MetricSet &metrics) const
         {
+            if(m_group >= 0 && m_group != static_cast<int>(MetricSet::TYPE)) return 0;
             // If the m_load_metric_check is not set, read in the metric
             // Otherwise, check if the metric should be read and that it is not empty
             // This logic is for SAV OnDemand (TM) loading
@@ -137,7 +194,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             }
             try
             {
-                io::read_interop(m_run_folder, metrics);
+                io::read_interop(m_run_folder, metrics, true, m_progress);
                 if(m_are_all_files_missing && !is_index_metrics) m_are_all_files_missing=false;
             }
             catch (const io::file_not_found_exception &)
@@ -161,20 +218,24 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         bool_pointer m_load_metric_check;
         mutable bool m_are_all_files_missing;
         bool m_skip_loaded;
+        int m_group;
+        util::progress_token* m_progress;
     };
 
     struct write_func
     {
-        write_func(const std::string &f) : m_run_folder(f)
+        write_func(const std::string &f, const int group=-1) : m_run_folder(f), m_group(group)
         {}
 
         template<class MetricSet>
         void operator()(const MetricSet &metrics) const
         {
-            io::write_interop(m_run_folder, metrics);
+            if(m_group >= 0 && m_group != static_cast<int>(MetricSet::TYPE)) return;
+            io::write_interop_mapped(m_run_folder, metrics);
         }
 
         std::string m_run_folder;
+        int m_group;
     };
 
     struct check_if_groupid_is_empty
@@ -226,17 +287,16 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 
     struct sort_by_lane_tile_cycle
     {
+        sort_by_lane_tile_cycle(const size_t thread_count) : m_thread_count(thread_count)
+        {}
         template<class MetricSet>
         void operator()(MetricSet &metrics) const
         {
-            typedef typename MetricSet::metric_type metric_type;
-            std::sort(metrics.begin(), metrics.end(), is_less<metric_type>);
-        }
-        template<class T>
-        static bool is_less(const T& lhs, const T& rhs)
-        {
-            return lhs.id() < rhs.id();
+            metrics.sort(m_thread_count);
         }
+
+    private:
+        size_t m_thread_count;
     };
 
 
@@ -322,17 +382,57 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         size_t m_last_cycle;
     };
 
+    template<class MetricSet>
+    struct read_cycle_file_task
+    {
+        read_cycle_file_task(const std::string &file_name,
+                             MetricSet &metrics,
+                             std::string &incomplete_message,
+                             util::progress_token* progress) :
+                m_file_name(file_name), m_metrics(&metrics), m_incomplete_message(&incomplete_message),
+                m_progress(progress)
+        {}
+
+        void operator()() const
+        {
+            const ::int64_t file_size_in_bytes = io::file_size(m_file_name);
+            std::ifstream fin(m_file_name.c_str(), std::ios::binary);
+            if(!fin.good()) return;
+            util::check_progress(m_progress);
+            try
+            {
+                io::read_metrics(fin, *m_metrics, static_cast<size_t>(file_size_in_bytes), false, m_progress);
+            }
+            catch(const io::incomplete_file_exception& ex)
+            {
+                *m_incomplete_message = ex.what();
+            }
+        }
+
+        std::string m_file_name;
+        MetricSet* m_metrics;
+        std::string* m_incomplete_message;
+        util::progress_token* m_progress;
+    };
+
     struct read_by_cycle_func
     {
         typedef const unsigned char* bool_pointer;
 
-        read_by_cycle_func(const std::string &f, const size_t last_cycle, bool_pointer load_metric_check=0) :
-                m_run_folder(f), m_last_cycle(last_cycle), m_load_metric_check(load_metric_check)
+        read_by_cycle_func(const std::string &f,
+                           const size_t last_cycle,
+                           bool_pointer load_metric_check=0,
+                           util::thread_pool* pool=0,
+                           const int group=-1,
+                           util::progress_token* progress=0) :
+                m_run_folder(f), m_last_cycle(last_cycle), m_load_metric_check(load_metric_check), m_pool(pool),
+                m_group(group), m_progress(progress)
         {}
 
         template<class MetricSet>
         int operator()(MetricSet &metrics) const
         {
+            if(m_group >= 0 && m_group != static_cast<int>(MetricSet::TYPE)) return 0;
             // If the m_load_metric_check is not set, read in the metric
             // Otherwise, check if the metric should be read and that it is not empty
             // This logic is for SAV OnDemand (TM) loading
@@ -340,15 +440,345 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             {
                 return 0;
             }
-            io::read_interop_by_cycle(m_run_folder, metrics, m_last_cycle);
+            if(m_pool == 0 || m_pool->thread_count() < 2)
+            {
+                io::read_interop_by_cycle(m_run_folder, metrics, m_last_cycle, true, m_progress);
+                return 0;
+            }
+            read_cycles(metrics);
             return 0;
         }
 
+    private:
+        /** Read each cycle file into its own metric set on the pool, then append the sets in cycle order
+         */
+        template<class MetricSet>
+        void read_cycles(MetricSet &metrics) const
+        {
+            typedef typename MetricSet::header_type header_type;
+            util::scoped_trace trace("read_interop_by_cycle", "io", MetricSet::prefix(), MetricSet::suffix());
+            std::vector<MetricSet> cycles(m_last_cycle);
+            std::vector<std::string> incomplete_messages(m_last_cycle);
+            std::vector<unsigned char> cycle_read(m_last_cycle, 0);
+            {
+                util::task_group tasks(*m_pool);
+                for(size_t cycle=1;cycle <= m_last_cycle;++cycle)
+                {
+                    const std::string file_name = io::interop_filename<MetricSet>(m_run_folder, cycle);
+                    const ::int64_t file_size_in_bytes = io::file_size(file_name);
+                    if(file_size_in_bytes < 0) continue;
+                    trace.add_bytes(static_cast< ::uint64_t >(file_size_in_bytes));
+                    cycle_read[cycle-1] = 1;
+                    tasks.run(read_cycle_file_task<MetricSet>(file_name,
+                                                              cycles[cycle-1],
+                                                              incomplete_messages[cycle-1],
+                                                              m_progress));
+                }
+                tasks.wait();
+            }
+            std::string incomplete_file_message;
+            for(size_t cycle=0;cycle<m_last_cycle;++cycle)
+            {
+                if(!cycle_read[cycle]) continue;
+                static_cast<header_type&>(metrics) = static_cast<const header_type&>(cycles[cycle]);
+                metrics.set_version(cycles[cycle].version());
+                for(typename MetricSet::const_iterator it = cycles[cycle].begin();it != cycles[cycle].end();++it)
+                    metrics.insert(*it);
+                if(incomplete_messages[cycle] != "") incomplete_file_message = incomplete_messages[cycle];
+                cycles[cycle] = MetricSet();
+            }
+            {
+                util::scoped_trace rebuild_trace("rebuild_index", "io", MetricSet::prefix(), MetricSet::suffix());
+                metrics.rebuild_index();
+                rebuild_trace.add_records(metrics.size());
+            }
+            trace.add_records(metrics.size());
+            if(incomplete_file_message != "")
+                throw io::incomplete_file_exception(incomplete_file_message);
+        }
+
+    private:
         std::string m_run_folder;
         size_t m_last_cycle;
         bool_pointer m_load_metric_check;
+        util::thread_pool* m_pool;
+        int m_group;
+        util::progress_token* m_progress;
     };
 
+    /** Read a single metric group, either from its aggregate file or its cycle files
+     */
+    template<class MetricList>
+    class read_group_task
+    {
+    public:
+        read_group_task(MetricList &metrics,
+                        const std::string &run_folder,
+                        const unsigned char* load_metric_check,
+                        const bool skip_loaded,
+                        const int group,
+                        unsigned char* files_missing,
+                        util::progress_token* progress) :
+                m_metrics(&metrics),
+                m_run_folder(run_folder),
+                m_load_metric_check(load_metric_check),
+                m_skip_loaded(skip_loaded),
+                m_group(group),
+                m_files_missing(files_missing),
+                m_progress(progress)
+        {}
+
+        void operator()() const
+        {
+            read_func read_functor(m_run_folder, m_load_metric_check, m_skip_loaded, m_group, m_progress);
+            m_metrics->apply(read_functor);
+            *m_files_missing = static_cast<unsigned char>(read_functor.are_all_files_missing());
+        }
+
+    private:
+        MetricList* m_metrics;
+        std::string m_run_folder;
+        const unsigned char* m_load_metric_check;
+        bool m_skip_loaded;
+        int m_group;
+        unsigned char* m_files_missing;
+        util::progress_token* m_progress;
+    };
+
+    /** Read the cycle files of a single metric group, with a nested task for each cycle
+     */
+    template<class MetricList>
+    class read_group_by_cycle_task
+    {
+    public:
+        read_group_by_cycle_task(MetricList &metrics,
+                                 const std::string &run_folder,
+                                 const size_t last_cycle,
+                                 const unsigned char* load_metric_check,
+                                 util::thread_pool &pool,
+                                 const int group,
+                                 util::progress_token* progress) :
+                m_metrics(&metrics),
+                m_run_folder(run_folder),
+                m_last_cycle(last_cycle),
+                m_load_metric_check(load_metric_check),
+                m_pool(&pool),
+                m_group(group),
+                m_progress(progress)
+        {}
+
+        void operator()() const
+        {
+            m_metrics->apply(read_by_cycle_func(m_run_folder,
+                                                m_last_cycle,
+                                                m_load_metric_check,
+                                                m_pool,
+                                                m_group,
+                                                m_progress));
+        }
+
+    private:
+        MetricList* m_metrics;
+        std::string m_run_folder;
+        size_t m_last_cycle;
+        const unsigned char* m_load_metric_check;
+        util::thread_pool* m_pool;
+        int m_group;
+        util::progress_token* m_progress;
+    };
+
+    /** Write a single metric group
+     */
+    template<class MetricList>
+    class write_group_task
+    {
+    public:
+        write_group_task(const MetricList &metrics, const std::string &run_folder, const int group) :
+                m_metrics(&metrics), m_run_folder(run_folder), m_group(group)
+        {}
+
+        void operator()() const
+        {
+            m_metrics->apply(write_func(m_run_folder, m_group));
+        }
+
+    private:
+        const MetricList* m_metrics;
+        std::string m_run_folder;
+        int m_group;
+    };
+
+    /** Wait on the tasks writing metric groups
+     *
+     * Exceptions outside of the exception specification of `write_metrics` are reported as a bad format.
+     *
+     * @param tasks tasks to wait on
+     */
+    static void wait_for_writer_tasks(util::task_group& tasks)
+    throw(io::file_not_found_exception,
+    io::bad_format_exception)
+    {
+        try
+        {
+            tasks.wait();
+        }
+        catch(const io::file_not_found_exception&)
+        {
+            throw;
+        }
+        catch(const io::bad_format_exception&)
+        {
+            throw;
+        }
+        catch(const std::exception& ex)
+        {
+            throw io::bad_format_exception(ex.what());
+        }
+    }
+
+    /** Derive the collapsed and by lane q-metrics from the q-metrics
+     */
+    class derive_q_metrics_task
+    {
+    public:
+        derive_q_metrics_task(run_metrics &metrics) : m_metrics(&metrics){}
+
+        void operator()() const
+        {
+            run_metrics& metrics = *m_metrics;
+            if (metrics.get<q_metric>().size() > 0 && metrics.get<q_collapsed_metric>().size() == 0)
+            {
+                util::scoped_trace collapse_trace("create_collapse_q_metrics", "finalize");
+                logic::metric::create_collapse_q_metrics(metrics.get<q_metric>(), metrics.get<q_collapsed_metric>());
+                collapse_trace.add_records(metrics.get<q_collapsed_metric>().size());
+                collapse_trace.add_allocation(metrics.get<q_collapsed_metric>().capacity() * sizeof(q_collapsed_metric));
+            }
+            INTEROP_ASSERTMSG(
+                    metrics.get<q_metric>().size() == 0 ||
+                    metrics.get<q_metric>().size() == metrics.get<q_collapsed_metric>().size(),
+                    metrics.get<q_metric>().size() << " == " << metrics.get<q_collapsed_metric>().size());
+            if (metrics.get<q_metric>().size() > 0 && metrics.get<q_by_lane_metric>().size() == 0)
+            {
+                util::scoped_trace by_lane_trace("create_q_metrics_by_lane", "finalize");
+                logic::metric::create_q_metrics_by_lane(metrics.get<q_metric>(), metrics.get<q_by_lane_metric>());
+                by_lane_trace.add_records(metrics.get<q_by_lane_metric>().size());
+                by_lane_trace.add_allocation(metrics.get<q_by_lane_metric>().capacity() * sizeof(q_by_lane_metric));
+            }
+        }
+
+    private:
+        run_metrics* m_metrics;
+    };
+
+    /** Derive the dynamic phasing metrics from the phasing metrics
+     */
+    class derive_dynamic_phasing_task
+    {
+    public:
+        derive_dynamic_phasing_task(run_metrics &metrics) : m_metrics(&metrics){}
+
+        void operator()() const
+        {
+            run_metrics& metrics = *m_metrics;
+            // Derived only once, so a partial reload does not append duplicate records
+            if(metrics.get<phasing_metric>().empty() || !metrics.get<dynamic_phasing_metric>().empty()) return;
+            util::scoped_trace phasing_trace("populate_dynamic_phasing_metrics", "finalize");
+            logic::summary::read_cycle_vector_t cycle_to_read;
+            logic::summary::map_read_to_cycle_number(metrics.run_info().reads().begin(),
+                                                     metrics.run_info().reads().end(),
+                                                     cycle_to_read);
+            logic::metric::populate_dynamic_phasing_metrics(metrics.get<phasing_metric>(),
+                                                            cycle_to_read,
+                                                            metrics.get<dynamic_phasing_metric>(),
+                                                            metrics.get<tile_metric>());
+            phasing_trace.add_records(metrics.get<dynamic_phasing_metric>().size());
+        }
+
+    private:
+        run_metrics* m_metrics;
+    };
+
+    /** Compute the q-score suffix sums of the q-metrics
+     *
+     * @param metrics q-metric set
+     */
+    static void populate_suffix_sums(metric_base::metric_set<q_metric>& metrics)
+    {
+        logic::metric::populate_qscore_suffix_sums(metrics);
+    }
+    /** Compute the q-score suffix sums of the by lane q-metrics
+     *
+     * @param metrics by lane q-metric set
+     */
+    static void populate_suffix_sums(metric_base::metric_set<q_by_lane_metric>& metrics)
+    {
+        logic::metric::populate_qscore_suffix_sums(metrics);
+    }
+    /** Collapsed q-metrics do not keep suffix sums
+     */
+    static void populate_suffix_sums(metric_base::metric_set<q_collapsed_metric>&)
+    {
+    }
+
+    /** Populate the cumulative q-score distribution of a single metric set, then its suffix sums
+     */
+    template<class MetricSet>
+    class populate_cumulative_task
+    {
+    public:
+        populate_cumulative_task(MetricSet &metrics) : m_metrics(&metrics){}
+
+        void operator()() const
+        {
+            util::scoped_trace cumulative_trace("populate_cumulative_distribution", "finalize",
+                                                MetricSet::prefix(), MetricSet::suffix());
+            logic::metric::populate_cumulative_distribution(*m_metrics);
+            populate_suffix_sums(*m_metrics);
+            cumulative_trace.add_records(m_metrics->size());
+        }
+
+    private:
+        MetricSet* m_metrics;
+    };
+
+    /** Wait on the tasks of a loader
+     *
+     * Exceptions outside of the exception specification of the loaders are reported as a bad format.
+     *
+     * @param tasks tasks to wait on
+     */
+    static void wait_for_loader_tasks(util::task_group& tasks)
+    throw(io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    util::operation_cancelled_exception)
+    {
+        try
+        {
+            tasks.wait();
+        }
+        catch(const io::file_not_found_exception&)
+        {
+            throw;
+        }
+        catch(const io::bad_format_exception&)
+        {
+            throw;
+        }
+        catch(const io::incomplete_file_exception&)
+        {
+            throw;
+        }
+        catch(const util::operation_cancelled_exception&)
+        {
+            throw;
+        }
+        catch(const std::exception& ex)
+        {
+            throw io::bad_format_exception(ex.what());
+        }
+    }
+
     class read_metric_set_from_binary_buffer
     {
     public:
@@ -450,8 +880,9 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      *
      * @param run_folder run folder path
      * @param thread_count number of threads to use for network loading
+     * @param progress progress token updated and checked while loading, may be null
      */
-    void run_metrics::read(const std::string &run_folder, const size_t thread_count)
+    void run_metrics::read(const std::string &run_folder, const size_t thread_count, util::progress_token* progress)
     throw(xml::xml_file_not_found_exception,
     xml::bad_xml_format_exception,
     xml::empty_xml_format_exception,
@@ -463,12 +894,16 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     model::invalid_channel_exception,
     model::index_out_of_bounds_exception,
     model::invalid_tile_naming_method,
-    model::invalid_run_info_exception)
+    model::invalid_run_info_exception,
+    util::operation_cancelled_exception)
     {
+        util::scoped_trace trace("read", "run_metrics");
         clear();
         const size_t count = read_xml(run_folder);
-        read_metrics(run_folder, run_info().total_cycles(), thread_count);
-        finalize_after_load(count);
+        util::thread_pool pool(thread_count);
+        read_metrics(run_folder, run_info().total_cycles(), 0, pool, false, progress);
+        util::check_progress(progress);
+        finalize_after_load(count, pool);
     }
     /** Read binary metrics and XML files from the run folder
      *
@@ -477,11 +912,45 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      * @param valid_to_load list of metrics to load
      * @param thread_count number of threads to use for network loading
      * @param skip_loaded skip metrics that are already loaded
+     * @param progress progress token updated and checked while loading, may be null
      */
     void run_metrics::read(const std::string &run_folder,
                            const std::vector<unsigned char>& valid_to_load,
                            const size_t thread_count,
-                           const bool skip_loaded)
+                           const bool skip_loaded,
+                           util::progress_token* progress)
+    throw(xml::xml_file_not_found_exception,
+    xml::bad_xml_format_exception,
+    xml::empty_xml_format_exception,
+    xml::missing_xml_element_exception,
+    xml::xml_parse_exception,
+    io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    model::invalid_channel_exception,
+    model::index_out_of_bounds_exception,
+    model::invalid_tile_naming_method,
+    model::invalid_run_info_exception,
+    invalid_parameter,
+    util::operation_cancelled_exception)
+    {
+        util::thread_pool pool(thread_count);
+        read(run_folder, valid_to_load, pool, skip_loaded, progress);
+    }
+    /** Read binary metrics and XML files from the run folder, using the threads of an existing pool
+     *
+     * @note This function does not clear
+     * @param run_folder run folder path
+     * @param valid_to_load list of metrics to load
+     * @param pool pool of threads used to load and finalize the metrics
+     * @param skip_loaded skip metrics that are already loaded
+     * @param progress progress token updated and checked while loading, may be null
+     */
+    void run_metrics::read(const std::string &run_folder,
+                           const std::vector<unsigned char>& valid_to_load,
+                           util::thread_pool& pool,
+                           const bool skip_loaded,
+                           util::progress_token* progress)
     throw(xml::xml_file_not_found_exception,
     xml::bad_xml_format_exception,
     xml::empty_xml_format_exception,
@@ -494,12 +963,19 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     model::index_out_of_bounds_exception,
     model::invalid_tile_naming_method,
     model::invalid_run_info_exception,
-    invalid_parameter)
+    invalid_parameter,
+    util::operation_cancelled_exception)
     {
+        util::scoped_trace trace("read", "run_metrics");
         read_run_info(run_folder);
-        read_metrics(run_folder, run_info().total_cycles(), valid_to_load, thread_count, skip_loaded);
+        if(!valid_to_load.empty() && valid_to_load.size() != constants::MetricCount)
+            INTEROP_THROW(invalid_parameter, "Boolean array valid_to_load does not match expected number of metrics: "
+                    << valid_to_load.size() << " != " << constants::MetricCount);
+        if(!valid_to_load.empty())
+            read_metrics(run_folder, run_info().total_cycles(), &valid_to_load.front(), pool, skip_loaded, progress);
+        util::check_progress(progress);
         const size_t count = read_run_parameters(run_folder);
-        finalize_after_load(count);
+        finalize_after_load(count, pool);
         check_for_data_sources(run_folder, run_info().total_cycles());
     }
 
@@ -530,6 +1006,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     xml::missing_xml_element_exception,
     xml::xml_parse_exception)
     {
+        util::scoped_trace trace("read_run_info", "xml");
         m_run_info.read(run_folder);
     }
 
@@ -550,6 +1027,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         {
             try
             {
+                util::scoped_trace trace("read_run_parameters", "xml");
                 m_run_parameters.read(run_folder);
             }
             catch (const xml::xml_file_not_found_exception &)
@@ -604,6 +1082,24 @@ namespace illumina { namespace interop { namespace model { namespace metrics
     model::index_out_of_bounds_exception,
     model::invalid_run_info_exception)
     {
+        util::thread_pool pool;
+        finalize_after_load(count, pool);
+    }
+
+    /** Finalize the metric sets after loading from disk
+     *
+     * Independent derivations run as tasks on the pool.
+     *
+     * @param count number of bins for legacy q-metrics
+     * @param pool pool of threads that derive metric sets
+     */
+    void run_metrics::finalize_after_load(size_t count, util::thread_pool& pool)
+    throw(model::invalid_channel_exception,
+    model::invalid_tile_naming_method,
+    model::index_out_of_bounds_exception,
+    model::invalid_run_info_exception)
+    {
+        util::scoped_trace trace("finalize_after_load", "finalize");
         if (m_run_info.flowcell().naming_method() == constants::UnknownTileNamingMethod)
         {
             determine_tile_naming_method naming_method_determinator;
@@ -616,6 +1112,7 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         }
         if(logic::metric::requires_legacy_bins(count))
         {
+            util::scoped_trace legacy_trace("compress_q_metrics", "finalize");
             logic::metric::populate_legacy_q_score_bins(get<q_metric>().bins(), m_run_parameters.instrument_type(),
                                                         count);
             logic::metric::populate_legacy_q_score_bins(get<q_by_lane_metric>().bins(),
@@ -624,30 +1121,20 @@ namespace illumina { namespace interop { namespace model { namespace metrics
             logic::metric::compress_q_metrics(get<q_metric>());
             logic::metric::compress_q_metrics(get<q_by_lane_metric>());
         }
-        if (get<q_metric>().size() > 0 && get<q_collapsed_metric>().size() == 0)
         {
-            logic::metric::create_collapse_q_metrics(get<q_metric>(), get<q_collapsed_metric>());
+            // The q-metric derivations and the phasing derivation touch disjoint metric sets
+            util::task_group tasks(pool);
+            tasks.run(derive_q_metrics_task(*this));
+            tasks.run(derive_dynamic_phasing_task(*this));
+            tasks.wait();
         }
-        INTEROP_ASSERTMSG(
-                get<q_metric>().size() == 0 ||
-                get<q_metric>().size() == get<q_collapsed_metric>().size(),
-                get<q_metric>().size() << " == " << get<q_collapsed_metric>().size());
-        if (get<q_metric>().size() > 0 && get<q_by_lane_metric>().size() == 0)
-            logic::metric::create_q_metrics_by_lane(get<q_metric>(), get<q_by_lane_metric>());
-        logic::metric::populate_cumulative_distribution(get<q_metric>());
-        logic::metric::populate_cumulative_distribution(get<q_by_lane_metric>());
-        logic::metric::populate_cumulative_distribution(get<q_collapsed_metric>());
-
-        if(!get<model::metrics::phasing_metric>().empty())
         {
-            logic::summary::read_cycle_vector_t cycle_to_read;
-            logic::summary::map_read_to_cycle_number(run_info().reads().begin(),
-                                                     run_info().reads().end(),
-                                                     cycle_to_read);
-            logic::metric::populate_dynamic_phasing_metrics(get<model::metrics::phasing_metric>(),
-                                                            cycle_to_read,
-                                                            get<model::metrics::dynamic_phasing_metric>(),
-                                                            get<model::metrics::tile_metric>());
+            util::task_group tasks(pool);
+            tasks.run(populate_cumulative_task< metric_base::metric_set<q_metric> >(get<q_metric>()));
+            tasks.run(populate_cumulative_task< metric_base::metric_set<q_by_lane_metric> >(get<q_by_lane_metric>()));
+            tasks.run(populate_cumulative_task< metric_base::metric_set<q_collapsed_metric> >(
+                    get<q_collapsed_metric>()));
+            tasks.wait();
         }
 
         if (m_run_info.channels().empty())
@@ -680,6 +1167,33 @@ namespace illumina { namespace interop { namespace model { namespace metrics
         }
     }
 
+    /** Derive every lazily computed metric set and view, and return a read-only snapshot of the run
+     *
+     * @param thread_count number of threads used to derive the metric sets
+     * @return read-only snapshot of the run
+     */
+    const run_metrics& run_metrics::freeze(const size_t thread_count) throw(model::index_out_of_bounds_exception)
+    {
+        util::scoped_trace trace("freeze", "finalize");
+        util::thread_pool pool(thread_count);
+        {
+            util::task_group tasks(pool);
+            tasks.run(derive_q_metrics_task(*this));
+            tasks.run(derive_dynamic_phasing_task(*this));
+            tasks.wait();
+        }
+        {
+            util::task_group tasks(pool);
+            tasks.run(populate_cumulative_task< metric_base::metric_set<q_metric> >(get<q_metric>()));
+            tasks.run(populate_cumulative_task< metric_base::metric_set<q_by_lane_metric> >(get<q_by_lane_metric>()));
+            tasks.run(populate_cumulative_task< metric_base::metric_set<q_collapsed_metric> >(
+                    get<q_collapsed_metric>()));
+            tasks.wait();
+        }
+        m_metrics.apply(build_metric_views());
+        return *this;
+    }
+
     /** Test if all metrics are empty
      *
      * @return true if all metrics are empty
@@ -727,30 +1241,20 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      * @param run_folder run folder path
      * @param last_cycle last cycle to search for by cycle interops
      * @param thread_count number of threads to use for network loading
+     * @param progress progress token updated and checked while loading, may be null
      */
-    void run_metrics::read_metrics(const std::string &run_folder, const size_t last_cycle, const size_t thread_count)
+    void run_metrics::read_metrics(const std::string &run_folder,
+                                   const size_t last_cycle,
+                                   const size_t thread_count,
+                                   util::progress_token* progress)
     throw(
     io::file_not_found_exception,
     io::bad_format_exception,
-    io::incomplete_file_exception)
+    io::incomplete_file_exception,
+    util::operation_cancelled_exception)
     {
-#ifdef _OPENMP
-        if(thread_count > 1)
-        {
-            std::vector<unsigned char> valid_to_load(constants::MetricCount, 1);
-            read_metrics(run_folder, last_cycle, valid_to_load, thread_count);
-        }
-        else{
-#endif
-            read_func read_functor(run_folder);
-            m_metrics.apply(read_functor);
-            if (read_functor.are_all_files_missing())
-            {
-                m_metrics.apply(read_by_cycle_func(run_folder, last_cycle));
-            }
-#ifdef _OPENMP
-        }
-#endif
+        util::thread_pool pool(thread_count);
+        read_metrics(run_folder, last_cycle, 0, pool, false, progress);
     }
 
     /** Read binary metrics from the run folder
@@ -765,108 +1269,103 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      * @param valid_to_load list of metrics to load
      * @param thread_count number of threads to use for network loading
      * @param skip_loaded skip metrics that are already loaded
+     * @param progress progress token updated and checked while loading, may be null
      */
     void run_metrics::read_metrics(const std::string &run_folder,
                                    const size_t last_cycle,
                                    const std::vector<unsigned char>& valid_to_load,
                                    const size_t thread_count,
-                                   const bool skip_loaded)
+                                   const bool skip_loaded,
+                                   util::progress_token* progress)
     throw(io::file_not_found_exception,
     io::bad_format_exception,
     io::incomplete_file_exception,
-    invalid_parameter)
+    invalid_parameter,
+    util::operation_cancelled_exception)
     {
         if(valid_to_load.empty())return;
         if(valid_to_load.size() != constants::MetricCount)
             INTEROP_THROW(invalid_parameter, "Boolean array valid_to_load does not match expected number of metrics: "
                     << valid_to_load.size() << " != " << constants::MetricCount);
+        util::thread_pool pool(thread_count);
+        read_metrics(run_folder, last_cycle, &valid_to_load.front(), pool, skip_loaded, progress);
+    }
 
-        bool all_files_are_missing = true;
-#ifdef _OPENMP
-        if(thread_count > 1)
+    /** Read binary metrics from the run folder
+     *
+     * Each metric group is read by a task on the pool. If no aggregate file is found, the cycle files of each group
+     * are read by nested tasks on the same pool.
+     *
+     * @param run_folder run folder path
+     * @param last_cycle last cycle to search for by cycle interops
+     * @param valid_to_load flag for each metric group to load, or null to load every group
+     * @param pool pool of threads that read the files
+     * @param skip_loaded skip metrics that are already loaded
+     * @param progress progress token updated and checked while loading, may be null
+     */
+    void run_metrics::read_metrics(const std::string &run_folder,
+                                   const size_t last_cycle,
+                                   const unsigned char* valid_to_load,
+                                   util::thread_pool& pool,
+                                   const bool skip_loaded,
+                                   util::progress_token* progress)
+    throw(io::file_not_found_exception,
+    io::bad_format_exception,
+    io::incomplete_file_exception,
+    util::operation_cancelled_exception)
+    {
+        util::scoped_trace trace("read_metrics", "run_metrics");
+        // The sets the loader does not clear are kept if the load is cancelled
+        flag_loaded_metric_sets loaded(valid_to_load != 0 || skip_loaded);
+        m_metrics.apply(loaded);
+        try
         {
-            std::vector<bool> local_files_missing(thread_count, true);
-            std::vector<size_t> offset;
-            offset.reserve(valid_to_load.size());
-            for(size_t i=0;i<valid_to_load.size();++i)
-                if(valid_to_load[i]) offset.push_back(i);
-            std::vector< std::vector<unsigned char> > valid_to_load_local(thread_count, std::vector<unsigned char>(valid_to_load.size(), 0));
-            bool exception_thrown = false;
-            std::string exception_msg;
-#           pragma omp parallel for default(shared) num_threads(static_cast<int>(thread_count)) schedule(dynamic)
-            for(int i=0;i<static_cast<int>(offset.size());++i)
-            {
-#               pragma omp flush(exception_thrown)
-                if(exception_thrown) continue;
-                valid_to_load_local[ omp_get_thread_num() ][offset[i]] = 1;
-                read_func read_functor_l(run_folder, &valid_to_load_local[ omp_get_thread_num() ].front(), skip_loaded);
-                try{
-                    m_metrics.apply(read_functor_l);
-                }
-                catch(const std::exception& ex)
-                {
-#pragma             omp critical(SaveMessage)
-                    exception_msg = ex.what();
-
-                    exception_thrown = true;
-#pragma             omp flush(exception_thrown)
-                }
-                valid_to_load_local[ omp_get_thread_num() ][offset[i]] = 0;
-                local_files_missing[omp_get_thread_num()] = local_files_missing[omp_get_thread_num()] && read_functor_l.are_all_files_missing();
-            }
-            if(exception_thrown)
-                throw io::bad_format_exception(exception_msg);
-            for(size_t i=0;i<local_files_missing.size();++i)
-                all_files_are_missing = all_files_are_missing && local_files_missing[i];
-        }
-        else{
-#endif
-            read_func read_functor(run_folder, &valid_to_load.front(), skip_loaded);
-            m_metrics.apply(read_functor);
-            all_files_are_missing = read_functor.are_all_files_missing();
-#ifdef _OPENMP
-        }
-#endif
-        if (all_files_are_missing)
-        {
-#ifdef _OPENMP
-            if(thread_count > 1)
+            if(pool.thread_count() < 2)
             {
-                std::vector<size_t> offset;
-                offset.reserve(valid_to_load.size());
-                for(size_t i=0;i<valid_to_load.size();++i)
-                    if(valid_to_load[i]) offset.push_back(i);
-                std::vector< std::vector<unsigned char> > valid_to_load_local(thread_count, std::vector<unsigned char>(valid_to_load.size(), 0));
-                bool exception_thrown = false;
-                std::string exception_msg;
-#               pragma omp parallel for default(shared) num_threads(static_cast<int>(thread_count)) schedule(dynamic)
-                for(int i=0;i<static_cast<int>(offset.size());++i)
-                {
-#               pragma omp flush(exception_thrown)
-                    valid_to_load_local[ omp_get_thread_num() ][offset[i]] = 1;
-                    try{
-                        m_metrics.apply(read_by_cycle_func(run_folder, last_cycle, &valid_to_load_local[ omp_get_thread_num() ].front()));
-                    }
-                    catch(const std::exception& ex)
-                    {
-#pragma                 omp critical(SaveMessage)
-                        exception_msg = ex.what();
-
-                        exception_thrown = true;
-#pragma                 omp flush(exception_thrown)
-                    }
-                    valid_to_load_local[ omp_get_thread_num() ][offset[i]] = 0;
-                }
-                if(exception_thrown)
-                    throw io::bad_format_exception(exception_msg);
+                read_func read_functor(run_folder, valid_to_load, skip_loaded, -1, progress);
+                m_metrics.apply(read_functor);
+                if (read_functor.are_all_files_missing())
+                    m_metrics.apply(read_by_cycle_func(run_folder, last_cycle, valid_to_load, 0, -1, progress));
+                return;
             }
-            else
+            std::vector<int> groups;
+            groups.reserve(constants::MetricCount);
+            for(size_t group=0;group<static_cast<size_t>(constants::MetricCount);++group)
+                if(valid_to_load == 0 || valid_to_load[group]) groups.push_back(static_cast<int>(group));
+
+            std::vector<unsigned char> files_missing(groups.size(), 1);
             {
-#endif
-                m_metrics.apply(read_by_cycle_func(run_folder, last_cycle, &valid_to_load.front()));
-#ifdef _OPENMP
+                util::task_group tasks(pool);
+                for(size_t i=0;i<groups.size();++i)
+                    tasks.run(read_group_task<metric_list_t>(m_metrics,
+                                                             run_folder,
+                                                             valid_to_load,
+                                                             skip_loaded,
+                                                             groups[i],
+                                                             &files_missing[i],
+                                                             progress));
+                wait_for_loader_tasks(tasks);
             }
-#endif
+            bool all_files_are_missing = true;
+            for(size_t i=0;i<files_missing.size();++i)
+                all_files_are_missing = all_files_are_missing && files_missing[i] != 0;
+            if (!all_files_are_missing) return;
+
+            util::task_group tasks(pool);
+            for(size_t i=0;i<groups.size();++i)
+                tasks.run(read_group_by_cycle_task<metric_list_t>(m_metrics,
+                                                                  run_folder,
+                                                                  last_cycle,
+                                                                  valid_to_load,
+                                                                  pool,
+                                                                  groups[i],
+                                                                  progress));
+            wait_for_loader_tasks(tasks);
+        }
+        catch(const util::operation_cancelled_exception&)
+        {
+            m_metrics.apply(clear_unflagged_metric_sets(loaded.flags()));
+            throw;
         }
     }
 
@@ -874,10 +1373,20 @@ namespace illumina { namespace interop { namespace model { namespace metrics
      *
      * @param run_folder run folder path
      */
-    void run_metrics::write_metrics(const std::string &run_folder) const
+    void run_metrics::write_metrics(const std::string &run_folder, const size_t thread_count) const
     throw(io::file_not_found_exception,
     io::bad_format_exception)
     {
+        util::scoped_trace trace("write_metrics", "run_metrics");
+        if(thread_count > 1)
+        {
+            util::thread_pool pool(thread_count);
+            util::task_group tasks(pool);
+            for(int group=0;group<static_cast<int>(constants::MetricCount);++group)
+                tasks.run(write_group_task<metric_list_t>(m_metrics, run_folder, group));
+            wait_for_writer_tasks(tasks);
+            return;
+        }
         m_metrics.apply(write_func(run_folder));
     }
 
@@ -984,10 +1493,11 @@ namespace illumina { namespace interop { namespace model { namespace metrics
 
     /** Sort the metrics by lane, then tile, then cycle
      *
+     * @param thread_count number of threads used to sort large metric sets
      */
-    void run_metrics::sort()
+    void run_metrics::sort(const size_t thread_count)
     {
-        m_metrics.apply(sort_by_lane_tile_cycle());
+        m_metrics.apply(sort_by_lane_tile_cycle(thread_count));
     }
 
     /** Check if the InterOp file for each metric set exists
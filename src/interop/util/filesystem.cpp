@@ -166,6 +166,32 @@ namespace illumina { namespace interop { namespace io
 #       endif
 
     }
+    /** Get the last modification time of a file
+     *
+     * @param path path to the target file
+     * @return modification time in nanoseconds since the epoch or -1 if the operation failed
+     */
+    ::int64_t file_modification_time(const std::string& path)
+    {
+        const ::int64_t nanoseconds_per_second = 1000000000;
+#       ifdef WIN32
+            struct __stat64 buf;
+            if (_stat64(path.c_str(), &buf) != 0)return -1;
+            return static_cast< ::int64_t >(buf.st_mtime) * nanoseconds_per_second;
+#       else
+            struct stat buf;
+            if (stat(path.c_str(), &buf) != 0)return -1;
+#           if defined(__APPLE__)
+                return static_cast< ::int64_t >(buf.st_mtimespec.tv_sec) * nanoseconds_per_second +
+                       static_cast< ::int64_t >(buf.st_mtimespec.tv_nsec);
+#           elif defined(__linux__)
+                return static_cast< ::int64_t >(buf.st_mtim.tv_sec) * nanoseconds_per_second +
+                       static_cast< ::int64_t >(buf.st_mtim.tv_nsec);
+#           else
+                return static_cast< ::int64_t >(buf.st_mtime) * nanoseconds_per_second;
+#           endif
+#       endif
+    }
 }}}
 
 
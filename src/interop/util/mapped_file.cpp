@@ -0,0 +1,86 @@
+/** Output file mapped into memory
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/mapped_file.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace illumina { namespace interop { namespace io
+{
+#ifndef WIN32
+    mapped_output_file::mapped_output_file(const std::string& filename, const size_t size) :
+            m_data(0),
+            m_size(0),
+            m_file(-1)
+    {
+        if(size == 0) return;
+        m_file = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(m_file < 0) return;
+        // Reserve the blocks up front, writing to a mapped page past the end of a full disk raises SIGBUS
+#ifdef __APPLE__
+        const bool reserved = false; // No posix_fallocate, let the caller write through a stream
+#else
+        const bool reserved = ::posix_fallocate(m_file, 0, static_cast<off_t>(size)) == 0;
+#endif
+        if(!reserved)
+        {
+            ::close(m_file);
+            m_file = -1;
+            return;
+        }
+        void* data = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+        if(data == MAP_FAILED)
+        {
+            ::close(m_file);
+            m_file = -1;
+            return;
+        }
+        m_data = static_cast< ::uint8_t* >(data);
+        m_size = size;
+    }
+
+    mapped_output_file::~mapped_output_file()
+    {
+        close(m_size);
+    }
+
+    bool mapped_output_file::close(const size_t size)
+    {
+        bool success = true;
+        if(m_data != 0)
+        {
+            success = ::munmap(m_data, m_size) == 0;
+            if(size < m_size) success = ::ftruncate(m_file, static_cast<off_t>(size)) == 0 && success;
+            m_data = 0;
+            m_size = 0;
+        }
+        if(m_file >= 0)
+        {
+            success = ::close(m_file) == 0 && success;
+            m_file = -1;
+        }
+        return success;
+    }
+#else
+    mapped_output_file::mapped_output_file(const std::string&, const size_t) : m_data(0), m_size(0), m_file(-1)
+    {}
+
+    mapped_output_file::~mapped_output_file()
+    {}
+
+    bool mapped_output_file::close(const size_t)
+    {
+        return true;
+    }
+#endif
+}}}
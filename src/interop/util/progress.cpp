@@ -0,0 +1,160 @@
+/** Progress reporting and cancellation for long running loads and reports
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/progress.h"
+
+#include "interop/util/exception.h"
+#include "interop/util/thread_pool.h"
+#ifdef INTEROP_HAS_STD_THREAD
+#   include <atomic>
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+#ifdef INTEROP_HAS_STD_THREAD
+    /** Counter that may be updated from any thread */
+    typedef std::atomic< ::uint64_t > progress_counter_t;
+    /** Flag that may be updated from any thread */
+    typedef std::atomic<bool> progress_flag_t;
+#else
+    /** Counter guarded by the InterOpProgress critical section under OpenMP */
+    typedef ::uint64_t progress_counter_t;
+    /** Flag guarded by the InterOpProgress critical section under OpenMP */
+    typedef bool progress_flag_t;
+#endif
+
+    /** Counts of each metric group and the cancellation flag
+     */
+    class progress_token_impl
+    {
+    public:
+        /** Constructor */
+        progress_token_impl()
+        {
+            reset();
+        }
+
+    public:
+        /** Zero the counts and clear the cancellation flag */
+        void reset()
+        {
+            for(size_t i=0;i<GroupCount;++i)
+            {
+                bytes[i] = 0;
+                records[i] = 0;
+            }
+            cancelled = false;
+        }
+
+    public:
+        enum
+        {
+            /** Number of metric groups, with one extra slot for unknown groups */
+            GroupCount = constants::MetricCount+1
+        };
+        /** Bytes processed for each metric group */
+        progress_counter_t bytes[GroupCount];
+        /** Records processed for each metric group */
+        progress_counter_t records[GroupCount];
+        /** Flag set when the operation is cancelled */
+        progress_flag_t cancelled;
+    };
+
+    /** Get the slot of a metric group
+     *
+     * @param group metric group
+     * @return slot of the group
+     */
+    static size_t slot_of(const constants::metric_group group)
+    {
+        const size_t slot = static_cast<size_t>(group);
+        return slot < static_cast<size_t>(constants::MetricCount) ? slot : static_cast<size_t>(constants::MetricCount);
+    }
+
+    progress_token::progress_token() : m_impl(new progress_token_impl){}
+    progress_token::~progress_token()
+    {
+        delete m_impl;
+    }
+    void progress_token::cancel()
+    {
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        m_impl->cancelled = true;
+    }
+    bool progress_token::is_cancelled()const
+    {
+        bool cancelled;
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        cancelled = m_impl->cancelled;
+        return cancelled;
+    }
+    void progress_token::check()const throw(operation_cancelled_exception)
+    {
+        if(is_cancelled()) INTEROP_THROW(operation_cancelled_exception, "Operation cancelled");
+    }
+    void progress_token::update(const constants::metric_group group, const ::uint64_t bytes, const ::uint64_t records)
+    throw(operation_cancelled_exception)
+    {
+        const size_t slot = slot_of(group);
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        {
+            m_impl->bytes[slot] += bytes;
+            m_impl->records[slot] += records;
+        }
+        check();
+    }
+    ::uint64_t progress_token::bytes(const constants::metric_group group)const
+    {
+        ::uint64_t count;
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        count = m_impl->bytes[slot_of(group)];
+        return count;
+    }
+    ::uint64_t progress_token::records(const constants::metric_group group)const
+    {
+        ::uint64_t count;
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        count = m_impl->records[slot_of(group)];
+        return count;
+    }
+    ::uint64_t progress_token::total_bytes()const
+    {
+        ::uint64_t total = 0;
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        for(size_t i=0;i<progress_token_impl::GroupCount;++i) total += m_impl->bytes[i];
+        return total;
+    }
+    ::uint64_t progress_token::total_records()const
+    {
+        ::uint64_t total = 0;
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        for(size_t i=0;i<progress_token_impl::GroupCount;++i) total += m_impl->records[i];
+        return total;
+    }
+    void progress_token::reset()
+    {
+#if !defined(INTEROP_HAS_STD_THREAD) && defined(_OPENMP)
+#       pragma omp critical(InterOpProgress)
+#endif
+        m_impl->reset();
+    }
+}}}
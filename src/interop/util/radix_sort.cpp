@@ -0,0 +1,165 @@
+/** Radix sort on 64-bit keys
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/radix_sort.h"
+
+#include <algorithm>
+#include "interop/util/thread_pool.h"
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Number of buckets for a single byte */
+    static const size_t RADIX_BUCKET_COUNT = 256;
+    /** Minimum number of keys per thread before a pass is split over threads */
+    static const size_t RADIX_MIN_KEYS_PER_THREAD = 1 << 15;
+
+    /** Count the keys of a chunk in each bucket of a single byte
+     */
+    struct radix_count_task
+    {
+        /** Constructor
+         *
+         * @param source keys to sort
+         * @param first offset of the first key of the chunk
+         * @param last offset one past the last key of the chunk
+         * @param shift bit shift to the byte sorted on
+         * @param counts count of keys in each bucket
+         */
+        radix_count_task(const radix_key_t* source,
+                         const size_t first,
+                         const size_t last,
+                         const size_t shift,
+                         size_t* counts) :
+                m_source(source), m_first(first), m_last(last), m_shift(shift), m_counts(counts){}
+        /** Count the keys of the chunk
+         */
+        void operator()()const
+        {
+            for(size_t i=m_first;i<m_last;++i)
+                ++m_counts[(m_source[i].first >> m_shift) & 0xff];
+        }
+        const radix_key_t* m_source;
+        size_t m_first;
+        size_t m_last;
+        size_t m_shift;
+        size_t* m_counts;
+    };
+    /** Copy the keys of a chunk to the next offset of their bucket
+     */
+    struct radix_scatter_task
+    {
+        /** Constructor
+         *
+         * @param source keys to sort
+         * @param destination destination of the sorted keys
+         * @param first offset of the first key of the chunk
+         * @param last offset one past the last key of the chunk
+         * @param shift bit shift to the byte sorted on
+         * @param next next offset of each bucket
+         */
+        radix_scatter_task(const radix_key_t* source,
+                           radix_key_t* destination,
+                           const size_t first,
+                           const size_t last,
+                           const size_t shift,
+                           size_t* next) :
+                m_source(source), m_destination(destination), m_first(first), m_last(last), m_shift(shift),
+                m_next(next){}
+        /** Copy the keys of the chunk
+         */
+        void operator()()const
+        {
+            for(size_t i=m_first;i<m_last;++i)
+                m_destination[m_next[(m_source[i].first >> m_shift) & 0xff]++] = m_source[i];
+        }
+        const radix_key_t* m_source;
+        radix_key_t* m_destination;
+        size_t m_first;
+        size_t m_last;
+        size_t m_shift;
+        size_t* m_next;
+    };
+
+    /** Scatter keys into buckets of a single byte
+     *
+     * Each chunk of the source is counted, then copied, independently. The bucket offsets of a chunk follow the
+     * offsets of all chunks before it, so the scatter stays stable.
+     *
+     * @param source keys to sort
+     * @param destination destination of the sorted keys
+     * @param count number of keys
+     * @param shift bit shift to the byte sorted on
+     * @param chunk_count number of chunks
+     * @param pool pool that runs the chunks
+     */
+    static void radix_pass(const radix_key_t* source,
+                           radix_key_t* destination,
+                           const size_t count,
+                           const size_t shift,
+                           const size_t chunk_count,
+                           thread_pool& pool)
+    {
+        const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+        std::vector<size_t> offsets(chunk_count*RADIX_BUCKET_COUNT, 0);
+        {
+            task_group tasks(pool);
+            for(size_t c=0;c<chunk_count;++c)
+                tasks.run(radix_count_task(source,
+                                           c*chunk_size,
+                                           std::min(count, (c+1)*chunk_size),
+                                           shift,
+                                           &offsets[c*RADIX_BUCKET_COUNT]));
+            tasks.wait();
+        }
+        size_t sum = 0;
+        for(size_t b=0;b<RADIX_BUCKET_COUNT;++b)
+        {
+            for(size_t c=0;c<chunk_count;++c)
+            {
+                const size_t n = offsets[c*RADIX_BUCKET_COUNT+b];
+                offsets[c*RADIX_BUCKET_COUNT+b] = sum;
+                sum += n;
+            }
+        }
+
+        task_group tasks(pool);
+        for(size_t c=0;c<chunk_count;++c)
+            tasks.run(radix_scatter_task(source,
+                                         destination,
+                                         c*chunk_size,
+                                         std::min(count, (c+1)*chunk_size),
+                                         shift,
+                                         &offsets[c*RADIX_BUCKET_COUNT]));
+        tasks.wait();
+    }
+
+    void radix_sort(radix_key_vector_t& keys, const size_t thread_count)
+    {
+        if(keys.size() < 2) return;
+        ::uint64_t varying_bits = 0;
+        for(size_t i=1;i<keys.size();++i)
+            varying_bits |= keys[i].first ^ keys[0].first;
+        if(varying_bits == 0) return;
+
+        size_t chunk_count = 1;
+        if(thread_pool::supports_threads())
+            chunk_count = std::max(static_cast<size_t>(1),
+                                   std::min(thread_count, keys.size() / RADIX_MIN_KEYS_PER_THREAD));
+        thread_pool pool(chunk_count);
+        radix_key_vector_t buffer(keys.size());
+        radix_key_t* source = &keys.front();
+        radix_key_t* destination = &buffer.front();
+        for(size_t shift=0;shift<64;shift+=8)
+        {
+            if(((varying_bits >> shift) & 0xff) == 0) continue;
+            radix_pass(source, destination, keys.size(), shift, chunk_count, pool);
+            std::swap(source, destination);
+        }
+        if(source != &keys.front()) keys.swap(buffer);
+    }
+}}}
@@ -0,0 +1,147 @@
+/** Process-wide pool of interned strings
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/string_pool.h"
+
+#include <stdexcept>
+#include "interop/util/assert.h"
+#include "interop/util/map.h"
+#include "interop/util/thread_pool.h"
+#ifdef INTEROP_HAS_STD_THREAD
+#include <mutex>
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Shared state of the string pool
+     *
+     * The strings are stored in fixed size chunks, so adding a string never moves the others.
+     */
+    class string_pool_state
+    {
+    public:
+        /** Define a map from a string to its id */
+        typedef INTEROP_UNORDERED_MAP(std::string, string_pool::id_t) string_id_map_t;
+        enum
+        {
+            /** Number of bits of an id that select the string in its chunk */
+            CHUNK_BITS = 12,
+            /** Number of strings in a chunk */
+            CHUNK_SIZE = 1 << CHUNK_BITS,
+            /** Maximum number of chunks */
+            MAX_CHUNKS = 1 << 14
+        };
+
+    public:
+        /** Constructor, adds the empty string as id 0 */
+        string_pool_state() : count(0)
+        {
+            for(size_t i=0;i<MAX_CHUNKS;++i) chunks[i] = 0;
+            add(std::string());
+        }
+        /** Destructor */
+        ~string_pool_state()
+        {
+            for(size_t i=0;i<MAX_CHUNKS;++i) delete[] chunks[i];
+        }
+        /** Add a string that is not in the pool
+         *
+         * @param str string
+         * @return id of the string, or full() if the pool is full
+         */
+        string_pool::id_t add(const std::string& str)
+        {
+            if(count >= static_cast<size_t>(CHUNK_SIZE) * MAX_CHUNKS) return full();
+            const size_t chunk = count >> CHUNK_BITS;
+            if(chunks[chunk] == 0) chunks[chunk] = new std::string[CHUNK_SIZE];
+            chunks[chunk][count & (CHUNK_SIZE-1)] = str;
+            const string_pool::id_t id = static_cast<string_pool::id_t>(count);
+            ids.insert(std::make_pair(str, id));
+            ++count;
+            return id;
+        }
+        /** Sentinel returned when the pool is full
+         *
+         * @return sentinel id
+         */
+        static string_pool::id_t full()
+        {
+            return static_cast<string_pool::id_t>(CHUNK_SIZE) * MAX_CHUNKS;
+        }
+
+    public:
+        /** Chunks of strings */
+        std::string* chunks[MAX_CHUNKS];
+        /** Number of strings */
+        size_t count;
+        /** Id of each string */
+        string_id_map_t ids;
+
+    private:
+        string_pool_state(const string_pool_state&);
+        string_pool_state& operator=(const string_pool_state&);
+    };
+
+    /** Get the shared state of the string pool
+     *
+     * @return pool state
+     */
+    static string_pool_state& global_string_pool()
+    {
+        static string_pool_state state;
+        return state;
+    }
+
+#ifdef INTEROP_HAS_STD_THREAD
+    /** Get the lock guarding the addition of strings
+     *
+     * @return lock for the string pool
+     */
+    static std::mutex& string_pool_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+#endif
+
+    string_pool::id_t string_pool::intern(const std::string& str)
+    {
+        if(str.empty()) return 0;
+        string_pool_state& state = global_string_pool();
+        id_t id;
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(string_pool_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpStringPool)
+#endif
+        {
+            const string_pool_state::string_id_map_t::const_iterator it = state.ids.find(str);
+            id = it == state.ids.end() ? state.add(str) : it->second;
+        }
+        if(id == string_pool_state::full()) throw std::length_error("Too many distinct strings in the string pool");
+        return id;
+    }
+    const std::string& string_pool::at(const id_t id)
+    {
+        const string_pool_state& state = global_string_pool();
+        INTEROP_ASSERT(state.chunks[id >> string_pool_state::CHUNK_BITS] != 0);
+        return state.chunks[id >> string_pool_state::CHUNK_BITS][id & (string_pool_state::CHUNK_SIZE-1)];
+    }
+    size_t string_pool::size()
+    {
+        string_pool_state& state = global_string_pool();
+        size_t count;
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(string_pool_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpStringPool)
+#endif
+        count = state.count;
+        return count;
+    }
+}}}
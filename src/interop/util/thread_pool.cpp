@@ -0,0 +1,512 @@
+/** Work-stealing thread pool with task groups
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/thread_pool.h"
+
+#include <deque>
+#include <vector>
+
+#ifdef INTEROP_HAS_STD_THREAD
+#   include <atomic>
+#   include <condition_variable>
+#   include <exception>
+#   include <memory>
+#   include <mutex>
+#   include <thread>
+#else
+#   include <new>
+#   include <stdexcept>
+#   include "interop/util/progress.h"
+#   include "interop/util/xml_exceptions.h"
+#   include "interop/io/stream_exceptions.h"
+#   include "interop/model/model_exceptions.h"
+#   ifdef _OPENMP
+#       include <omp.h>
+#   endif
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+#ifdef INTEROP_HAS_STD_THREAD
+
+    /** State shared by the tasks of a group
+     */
+    class task_group_state
+    {
+    public:
+        /** Constructor */
+        task_group_state() : pending(0), failed(false){}
+
+    public:
+        /** Number of tasks queued or running */
+        std::atomic<size_t> pending;
+        /** Set when a task of the group throws */
+        std::atomic<bool> failed;
+        /** Guards the error */
+        std::mutex mutex;
+        /** First exception thrown by a task of the group */
+        std::exception_ptr error;
+    };
+
+    /** Task paired with its group
+     */
+    struct queued_task
+    {
+        /** Task to run */
+        pool_task* task;
+        /** Group of the task */
+        task_group_state* group;
+    };
+
+    /** Queue of tasks owned by one thread
+     */
+    struct task_queue
+    {
+        /** Guards the tasks */
+        std::mutex mutex;
+        /** Tasks in the order they were queued */
+        std::deque<queued_task> tasks;
+    };
+
+    /** Pool the current thread works for, if any */
+    static thread_local thread_pool_impl* t_current_pool = 0;
+    /** Queue owned by the current thread */
+    static thread_local size_t t_current_queue = 0;
+
+    /** Worker threads and their task queues
+     *
+     * Queue 0 is shared by every thread outside the pool, and queue i is owned by worker i.
+     */
+    class thread_pool_impl
+    {
+    public:
+        /** Constructor
+         *
+         * @param thread_count number of threads that run tasks
+         */
+        explicit thread_pool_impl(const size_t thread_count) :
+                m_thread_count(thread_count < 1 ? 1 : thread_count),
+                m_queued(0),
+                m_stop(false)
+        {
+            for(size_t i=0;i<m_thread_count;++i) m_queues.push_back(std::unique_ptr<task_queue>(new task_queue));
+            for(size_t i=1;i<m_thread_count;++i) m_threads.push_back(std::thread(&thread_pool_impl::work, this, i));
+        }
+        /** Destructor */
+        ~thread_pool_impl()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_wake_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for(size_t i=0;i<m_threads.size();++i) m_threads[i].join();
+        }
+
+    public:
+        /** Get the number of threads that run tasks
+         *
+         * @return number of threads
+         */
+        size_t thread_count()const
+        {
+            return m_thread_count;
+        }
+        /** Queue a task on the queue of the current thread
+         *
+         * @param task task paired with its group
+         */
+        void push(const queued_task& task)
+        {
+            task_queue& queue = *m_queues[t_current_pool == this ? t_current_queue : 0];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(task);
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_wake_mutex);
+                ++m_queued;
+            }
+            m_wake.notify_all();
+        }
+        /** Run tasks until every task of the group has finished
+         *
+         * @param group group to wait on
+         */
+        void wait(task_group_state& group)
+        {
+            while(group.pending > 0)
+            {
+                if(run_one()) continue;
+                std::unique_lock<std::mutex> lock(m_wake_mutex);
+                while(group.pending > 0 && m_queued == 0) m_wake.wait(lock);
+            }
+        }
+
+    private:
+        void work(const size_t index)
+        {
+            t_current_pool = this;
+            t_current_queue = index;
+            for(;;)
+            {
+                if(run_one()) continue;
+                std::unique_lock<std::mutex> lock(m_wake_mutex);
+                while(!m_stop && m_queued == 0) m_wake.wait(lock);
+                if(m_stop && m_queued == 0) return;
+            }
+        }
+        bool run_one()
+        {
+            queued_task task = {0, 0};
+            if(!pop(task)) return false;
+            {
+                std::lock_guard<std::mutex> lock(m_wake_mutex);
+                --m_queued;
+            }
+            task_group_state& group = *task.group;
+            if(!group.failed)
+            {
+                try
+                {
+                    task.task->run();
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> lock(group.mutex);
+                    if(!group.error) group.error = std::current_exception();
+                    group.failed = true;
+                }
+            }
+            delete task.task;
+            if(--group.pending == 0)
+            {
+                std::lock_guard<std::mutex> lock(m_wake_mutex);
+                m_wake.notify_all();
+            }
+            return true;
+        }
+        bool pop(queued_task& task)
+        {
+            const size_t own = t_current_pool == this ? t_current_queue : 0;
+            {
+                // The newest task of the own queue is most likely to share data still in cache
+                task_queue& queue = *m_queues[own];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if(!queue.tasks.empty())
+                {
+                    task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                    return true;
+                }
+            }
+            for(size_t i=1;i<m_queues.size();++i)
+            {
+                // Steal the oldest task, which is most likely to spawn more work
+                task_queue& queue = *m_queues[(own+i) % m_queues.size()];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if(!queue.tasks.empty())
+                {
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        size_t m_thread_count;
+        std::vector< std::unique_ptr<task_queue> > m_queues;
+        std::vector<std::thread> m_threads;
+        std::mutex m_wake_mutex;
+        std::condition_variable m_wake;
+        size_t m_queued;
+        bool m_stop;
+    };
+
+    thread_pool::thread_pool(const size_t thread_count) : m_impl(new thread_pool_impl(thread_count)){}
+    thread_pool::~thread_pool()
+    {
+        delete m_impl;
+    }
+    size_t thread_pool::thread_count()const
+    {
+        return m_impl->thread_count();
+    }
+    bool thread_pool::supports_threads()
+    {
+        return true;
+    }
+    size_t thread_pool::current_worker()
+    {
+        return t_current_pool == 0 ? 0 : t_current_queue;
+    }
+
+    task_group::task_group(thread_pool& pool) : m_pool(pool), m_state(new task_group_state){}
+    task_group::~task_group()
+    {
+        m_pool.m_impl->wait(*m_state);
+        delete m_state;
+    }
+    void task_group::submit(pool_task* task)
+    {
+        queued_task queued;
+        queued.task = task;
+        queued.group = m_state;
+        ++m_state->pending;
+        m_pool.m_impl->push(queued);
+    }
+    void task_group::wait()
+    {
+        m_pool.m_impl->wait(*m_state);
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            error = m_state->error;
+            m_state->error = std::exception_ptr();
+            m_state->failed = false;
+        }
+        if(error) std::rethrow_exception(error);
+    }
+
+#else
+
+    /** Copy of an exception thrown by a task, rethrown by the thread that waits on the group
+     */
+    class stored_exception
+    {
+    public:
+        /** Destructor */
+        virtual ~stored_exception(){}
+        /** Throw a copy of the stored exception
+         */
+        virtual void rethrow()const = 0;
+    };
+
+    /** Copy of an exception of a known type
+     */
+    template<class Exception>
+    class typed_exception : public stored_exception
+    {
+    public:
+        /** Constructor
+         *
+         * @param ex exception to copy
+         */
+        typed_exception(const Exception& ex) : m_exception(ex){}
+        /** Throw a copy of the stored exception
+         */
+        void rethrow()const
+        {
+            throw m_exception;
+        }
+
+    private:
+        Exception m_exception;
+    };
+
+    /** Copy the exception being handled
+     *
+     * Without std::exception_ptr, an exception can only be moved to another thread as a copy of a known type. The
+     * exceptions of the library and the standard library keep their type, any other exception is copied as a
+     * std::runtime_error with the same message.
+     *
+     * @note must be called from a catch block
+     * @return copy of the exception being handled
+     */
+    static stored_exception* store_current_exception()
+    {
+        try
+        {
+            throw;
+        }
+        catch(const operation_cancelled_exception& ex){return new typed_exception<operation_cancelled_exception>(ex);}
+        catch(const io::file_not_found_exception& ex){return new typed_exception<io::file_not_found_exception>(ex);}
+        catch(const io::bad_format_exception& ex){return new typed_exception<io::bad_format_exception>(ex);}
+        catch(const io::incomplete_file_exception& ex){return new typed_exception<io::incomplete_file_exception>(ex);}
+        catch(const model::index_out_of_bounds_exception& ex)
+        {return new typed_exception<model::index_out_of_bounds_exception>(ex);}
+        catch(const model::invalid_channel_exception& ex)
+        {return new typed_exception<model::invalid_channel_exception>(ex);}
+        catch(const model::invalid_read_exception& ex){return new typed_exception<model::invalid_read_exception>(ex);}
+        catch(const model::invalid_run_info_exception& ex)
+        {return new typed_exception<model::invalid_run_info_exception>(ex);}
+        catch(const model::invalid_parameter& ex){return new typed_exception<model::invalid_parameter>(ex);}
+        catch(const xml::xml_file_not_found_exception& ex)
+        {return new typed_exception<xml::xml_file_not_found_exception>(ex);}
+        catch(const xml::bad_xml_format_exception& ex)
+        {return new typed_exception<xml::bad_xml_format_exception>(ex);}
+        catch(const xml::xml_format_exception& ex){return new typed_exception<xml::xml_format_exception>(ex);}
+        catch(const std::out_of_range& ex){return new typed_exception<std::out_of_range>(ex);}
+        catch(const std::invalid_argument& ex){return new typed_exception<std::invalid_argument>(ex);}
+        catch(const std::bad_alloc& ex){return new typed_exception<std::bad_alloc>(ex);}
+        catch(const std::exception& ex){return new typed_exception<std::runtime_error>(std::runtime_error(ex.what()));}
+        catch(...){return new typed_exception<std::runtime_error>(std::runtime_error("Unknown exception in task"));}
+    }
+
+    /** Tasks of a group waiting to run
+     */
+    class task_group_state
+    {
+    public:
+        /** Tasks in the order they were queued */
+        std::deque<pool_task*> tasks;
+    };
+
+    /** Number of threads requested for the pool
+     */
+    class thread_pool_impl
+    {
+    public:
+        /** Constructor
+         *
+         * @param thread_count number of threads requested
+         */
+        explicit thread_pool_impl(const size_t thread_count) : m_thread_count(thread_count < 1 ? 1 : thread_count){}
+        /** Number of threads requested */
+        size_t m_thread_count;
+    };
+
+    thread_pool::thread_pool(const size_t thread_count) : m_impl(new thread_pool_impl(thread_count)){}
+    thread_pool::~thread_pool()
+    {
+        delete m_impl;
+    }
+    size_t thread_pool::thread_count()const
+    {
+        return m_impl->m_thread_count;
+    }
+    bool thread_pool::supports_threads()
+    {
+#ifdef _OPENMP
+        return true;
+#else
+        return false;
+#endif
+    }
+    size_t thread_pool::current_worker()
+    {
+#ifdef _OPENMP
+        return static_cast<size_t>(omp_get_thread_num());
+#else
+        return 0;
+#endif
+    }
+
+    /** Delete the tasks that have not run
+     *
+     * @param state tasks of a group
+     */
+    static void discard_tasks(task_group_state& state)
+    {
+        for(size_t i=0;i<state.tasks.size();++i) delete state.tasks[i];
+        state.tasks.clear();
+    }
+
+#ifdef _OPENMP
+    /** Run the queued tasks of a group on OpenMP threads
+     *
+     * Tasks queued while the tasks run are picked up by the next pass. Once a task throws, tasks that have not
+     * started are skipped.
+     *
+     * @param state tasks of a group
+     * @param thread_count number of threads that run tasks
+     */
+    static void run_parallel(task_group_state& state, const size_t thread_count)
+    {
+        while(!state.tasks.empty())
+        {
+            std::vector<pool_task*> tasks(state.tasks.begin(), state.tasks.end());
+            state.tasks.clear();
+            stored_exception* error = 0;
+            bool exception_thrown = false;
+#           pragma omp parallel for default(shared) num_threads(static_cast<int>(thread_count)) schedule(dynamic)
+            for(int i=0;i<static_cast<int>(tasks.size());++i)
+            {
+#               pragma omp flush(exception_thrown)
+                if(!exception_thrown)
+                {
+                    try
+                    {
+                        tasks[i]->run();
+                    }
+                    catch(...)
+                    {
+#                       pragma omp critical(InterOpTaskError)
+                        {
+                            if(error == 0) error = store_current_exception();
+                        }
+                        exception_thrown = true;
+#                       pragma omp flush(exception_thrown)
+                    }
+                }
+                delete tasks[i];
+            }
+            if(error != 0)
+            {
+                discard_tasks(state);
+                try
+                {
+                    error->rethrow();
+                }
+                catch(...)
+                {
+                    delete error;
+                    throw;
+                }
+            }
+        }
+    }
+#endif
+
+    task_group::task_group(thread_pool& pool) : m_pool(pool), m_state(new task_group_state){}
+    task_group::~task_group()
+    {
+        try
+        {
+            wait();
+        }
+        catch(...){}
+        discard_tasks(*m_state);
+        delete m_state;
+    }
+    void task_group::submit(pool_task* task)
+    {
+        m_state->tasks.push_back(task);
+    }
+    void task_group::wait()
+    {
+#ifdef _OPENMP
+        // Nested groups run in the thread of the task that waits on them
+        if(m_pool.thread_count() > 1 && !omp_in_parallel())
+        {
+            run_parallel(*m_state, m_pool.thread_count());
+            return;
+        }
+#endif
+        while(!m_state->tasks.empty())
+        {
+            pool_task* task = m_state->tasks.front();
+            m_state->tasks.pop_front();
+            try
+            {
+                task->run();
+            }
+            catch(...)
+            {
+                delete task;
+                discard_tasks(*m_state);
+                throw;
+            }
+            delete task;
+        }
+    }
+
+#endif
+}}}
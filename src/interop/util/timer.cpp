@@ -0,0 +1,43 @@
+/** Wall clock timer
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include "interop/util/timer.h"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+    /** Get the elapsed wall clock time in seconds from an arbitrary, fixed starting point
+     *
+     * @return time in seconds
+     */
+    double wall_time()
+    {
+#if defined(WIN32)
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&counter);
+        return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+#else
+        struct timeval now;
+        gettimeofday(&now, 0);
+        return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_usec) * 1e-6;
+#endif
+    }
+}}}
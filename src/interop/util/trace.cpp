@@ -0,0 +1,256 @@
+/** Opt-in wall clock instrumentation of named stages
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "interop/util/trace.h"
+
+#include <iomanip>
+#include <sstream>
+#include "interop/util/json.h"
+#include "interop/util/thread_pool.h"
+#ifdef INTEROP_HAS_STD_THREAD
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace illumina { namespace interop { namespace util
+{
+#ifdef INTEROP_HAS_STD_THREAD
+    /** Flag that may be read from any thread without taking the lock */
+    typedef std::atomic<bool> trace_flag_t;
+#else
+    /** Flag written under the InterOpTrace critical section under OpenMP, and read without it */
+    typedef volatile bool trace_flag_t;
+#endif
+
+    /** Shared state of the trace recorder
+     *
+     * The time origin and the events are guarded by a mutex when built with C++11, and by an OpenMP critical section
+     * when built with OpenMP alone. Without either, the library runs on a single thread, and tracing must only be
+     * used from that thread.
+     */
+    struct trace_state
+    {
+        /** Constructor */
+        trace_state() : enabled(false), origin(0){}
+        /** Flag indicating whether events are recorded */
+        trace_flag_t enabled;
+        /** Time origin of the events */
+        double origin;
+        /** Recorded events */
+        trace_event_vector events;
+    };
+
+    /** Get the shared state of the trace recorder
+     *
+     * @return trace state
+     */
+    static trace_state& global_trace_state()
+    {
+        static trace_state state;
+        return state;
+    }
+
+#ifdef INTEROP_HAS_STD_THREAD
+    /** Get the lock guarding the recorded events
+     *
+     * Events are recorded from both OpenMP threads and thread pool workers.
+     *
+     * @return lock for the recorded events
+     */
+    static std::mutex& trace_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+#endif
+
+    /** Enable or disable tracing
+     *
+     * @param enable true to record events
+     */
+    void enable_tracing(const bool enable)
+    {
+        trace_state& state = global_trace_state();
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(trace_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpTrace)
+#endif
+        {
+            if(enable && !state.enabled) state.origin = wall_time();
+            state.enabled = enable;
+        }
+    }
+    /** Test if tracing is enabled
+     *
+     * @return true if events are being recorded
+     */
+    bool is_tracing_enabled()
+    {
+        return global_trace_state().enabled;
+    }
+    /** Get the id of the current thread in the trace
+     *
+     * With C++11, each thread is numbered in the order it first records an event, so pool workers, OpenMP threads
+     * and the calling thread all get distinct ids. With OpenMP alone, the id is the OpenMP thread number, where the
+     * master thread is 0.
+     *
+     * @return id of the current thread
+     */
+    static size_t trace_thread_id()
+    {
+#if defined(INTEROP_HAS_STD_THREAD)
+        static std::atomic<size_t> next_id(0);
+        static thread_local size_t id = next_id++;
+        return id;
+#elif defined(_OPENMP)
+        return static_cast<size_t>(omp_get_thread_num());
+#else
+        return 0;
+#endif
+    }
+    /** Get the time origin of new events
+     *
+     * @return time origin in seconds
+     */
+    static double trace_origin()
+    {
+        trace_state& state = global_trace_state();
+        double origin;
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(trace_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpTrace)
+#endif
+        origin = state.origin;
+        return origin;
+    }
+    /** Remove all recorded events
+     */
+    void clear_trace()
+    {
+        trace_state& state = global_trace_state();
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(trace_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpTrace)
+#endif
+        state.events.clear();
+    }
+    /** Get the number of recorded events
+     *
+     * @return number of events
+     */
+    size_t trace_event_count()
+    {
+        trace_state& state = global_trace_state();
+        size_t count;
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(trace_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpTrace)
+#endif
+        count = state.events.size();
+        return count;
+    }
+    /** Copy the recorded events
+     *
+     * @param events destination vector
+     */
+    void copy_trace_events(trace_event_vector& events)
+    {
+        trace_state& state = global_trace_state();
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(trace_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpTrace)
+#endif
+        events.assign(state.events.begin(), state.events.end());
+    }
+    /** Record an event
+     *
+     * @param event trace event
+     */
+    void record_trace_event(const trace_event& event)
+    {
+        trace_state& state = global_trace_state();
+#if defined(INTEROP_HAS_STD_THREAD)
+        std::lock_guard<std::mutex> lock(trace_mutex());
+#elif defined(_OPENMP)
+#       pragma omp critical(InterOpTrace)
+#endif
+        state.events.push_back(event);
+    }
+    /** Write the recorded events in the Chrome trace event format
+     *
+     * Each stage is a complete ("X") event with times in microseconds. The bytes, records and allocations are
+     * reported as event arguments.
+     *
+     * @param out output stream
+     */
+    void write_chrome_trace(std::ostream& out)
+    {
+        trace_event_vector events;
+        copy_trace_events(events);
+        const std::streamsize precision = out.precision();
+        const std::ios_base::fmtflags flags = out.flags();
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\": [";
+        for(size_t i=0;i<events.size();++i)
+        {
+            const trace_event& event = events[i];
+            out << (i == 0 ? "\n" : ",\n") << "{\"name\": ";
+            write_json_string(out, event.name);
+            out << ", \"cat\": ";
+            write_json_string(out, event.category);
+            out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread_id
+                << ", \"ts\": " << event.start_seconds * 1e6
+                << ", \"dur\": " << event.duration_seconds * 1e6
+                << ", \"args\": {\"bytes\": " << event.bytes
+                << ", \"records\": " << event.records
+                << ", \"allocations\": " << event.allocations
+                << ", \"allocated_bytes\": " << event.allocated_bytes << "}}";
+        }
+        out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+        out.precision(precision);
+        out.flags(flags);
+    }
+    /** Get the recorded events in the Chrome trace event format
+     *
+     * @return JSON string
+     */
+    std::string chrome_trace()
+    {
+        std::ostringstream sout;
+        write_chrome_trace(sout);
+        return sout.str();
+    }
+
+    /** Record the span
+     */
+    void scoped_trace::finish()
+    {
+        const double end = wall_time();
+        std::string name = m_name;
+        if(m_detail != 0)
+        {
+            name += ":";
+            name += m_detail;
+            if(m_detail_suffix != 0) name += m_detail_suffix;
+        }
+        trace_event event(name, m_category, trace_thread_id(), m_start - trace_origin(), end - m_start);
+        event.bytes = m_bytes;
+        event.records = m_records;
+        event.allocations = m_allocations;
+        event.allocated_bytes = m_allocated_bytes;
+        record_trace_event(event);
+    }
+}}}
@@ -0,0 +1,650 @@
+/** @page apps Applications
+ *
+ * This developer application benchmarks the library on a synthetic run of configurable scale. It generates a run
+ * folder, then times loading, summarizing, tabulating, plotting and writing the run. The results, including wall time,
+ * throughput, the change in resident memory of each stage and the peak memory usage of the run, are written as JSON
+ * so they can be compared between releases.
+ *
+ * Running the Program
+ * -------------------
+ *
+ * The program runs as follows:
+ *
+ *      $ interop_benchmarks --lanes=8 --tiles=50 --cycles=318 --output=benchmarks.json /tmp/synthetic_run
+ *
+ * Each stage is run `--iterations` times and both the fastest and mean wall time are reported. Use `--trace=trace.json`
+ * to also record the library stages (file reads, decoding, finalization, summaries, plots and tables) as a Chrome
+ * trace.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <streambuf>
+#include "interop/util/timer.h"
+#include "interop/util/trace.h"
+#include "interop/util/option_parser.h"
+#include "interop/io/metric_file_stream.h"
+#include "interop/io/metric_stream.h"
+#include "interop/logic/summary/run_summary.h"
+#include "interop/logic/summary/index_summary.h"
+#include "interop/logic/plot/plot_by_cycle.h"
+#include "interop/logic/plot/plot_by_lane.h"
+#include "interop/logic/plot/plot_flowcell_map.h"
+#include "interop/logic/plot/plot_qscore_heatmap.h"
+#include "interop/logic/plot/plot_qscore_histogram.h"
+#include "interop/logic/plot/plot_sample_qc.h"
+#include "interop/logic/table/create_imaging_table.h"
+#include "interop/logic/utils/metric_type_ext.h"
+#include "interop/io/synthetic_run.h"
+#include "interop/version.h"
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop;
+
+/** Exit codes that can be produced by the application
+ */
+enum exit_codes
+{
+    /** The program exited cleanly, 0 */
+    SUCCESS,
+    /** Invalid arguments were given to the application*/
+    INVALID_ARGUMENTS,
+    /** Failed to generate the synthetic run */
+    GENERATION_FAILED,
+    /** Unknown error has occurred*/
+    UNEXPECTED_EXCEPTION
+};
+
+/** Peak resident memory of this process
+ *
+ * @return peak resident set size in bytes, 0 if not supported on this platform
+ */
+size_t peak_rss_bytes()
+{
+#ifdef WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#   ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#   else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#   endif
+#endif
+}
+
+/** Current resident memory of this process
+ *
+ * @return resident set size in bytes, 0 if not supported on this platform
+ */
+size_t current_rss_bytes()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    if(!(statm >> total_pages >> resident_pages)) return 0;
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+    return page_size > 0 ? resident_pages * static_cast<size_t>(page_size) : 0;
+#else
+    return 0;
+#endif
+}
+
+/** Stream buffer that discards its output but counts the number of characters written
+ */
+class counting_buffer : public std::streambuf
+{
+public:
+    /** Constructor */
+    counting_buffer() : m_count(0){}
+    /** Number of characters written
+     *
+     * @return character count
+     */
+    size_t count()const{return m_count;}
+
+protected:
+    int_type overflow(int_type ch)
+    {
+        if(!traits_type::eq_int_type(ch, traits_type::eof())) ++m_count;
+        return traits_type::not_eof(ch);
+    }
+    std::streamsize xsputn(const char*, std::streamsize n)
+    {
+        m_count += static_cast<size_t>(n);
+        return n;
+    }
+
+private:
+    size_t m_count;
+};
+
+/** Timing results for a single benchmark
+ */
+class benchmark_result
+{
+public:
+    /** Constructor
+     *
+     * @param name name of the benchmark
+     * @param unit unit of work processed per iteration
+     * @param items amount of work processed per iteration
+     */
+    benchmark_result(const std::string& name, const std::string& unit, const double items) :
+            m_name(name), m_unit(unit), m_items(items), m_rss_supported(current_rss_bytes() > 0), m_rss_delta(0){}
+
+public:
+    /** Start a new iteration
+     *
+     * @return destination for the wall time of the iteration
+     */
+    double& next()
+    {
+        m_seconds.push_back(0);
+        return m_seconds.back();
+    }
+    /** Record the change in resident memory over an iteration, keeping the largest
+     *
+     * @param before resident memory in bytes when the iteration started
+     * @param after resident memory in bytes when the iteration ended
+     */
+    void add_rss_change(const size_t before, const size_t after)
+    {
+        const ::int64_t delta = static_cast< ::int64_t >(after) - static_cast< ::int64_t >(before);
+        if(m_seconds.size() == 1 || delta > m_rss_delta) m_rss_delta = delta;
+    }
+    /** Set the amount of work processed per iteration
+     *
+     * @param items amount of work processed per iteration
+     */
+    void set_items(const double items)
+    {
+        m_items = items;
+    }
+    /** Write the result as a JSON object
+     *
+     * @param out output stream
+     */
+    void write_json(std::ostream& out)const
+    {
+        double best = 0;
+        double total = 0;
+        for(size_t i=0;i<m_seconds.size();++i)
+        {
+            if(i == 0 || m_seconds[i] < best) best = m_seconds[i];
+            total += m_seconds[i];
+        }
+        const double mean = m_seconds.empty() ? 0 : total / static_cast<double>(m_seconds.size());
+        out << "{\"name\": \"" << m_name << "\""
+            << ", \"iterations\": " << m_seconds.size()
+            << ", \"wall_seconds_min\": " << best
+            << ", \"wall_seconds_mean\": " << mean
+            << ", \"items\": " << m_items
+            << ", \"unit\": \"" << m_unit << "\""
+            << ", \"throughput_per_second\": " << (best > 0 ? m_items / best : 0)
+            << ", \"rss_delta_bytes\": ";
+        if(m_rss_supported) out << m_rss_delta;
+        else out << "null";
+        out << "}";
+    }
+
+private:
+    std::string m_name;
+    std::string m_unit;
+    double m_items;
+    bool m_rss_supported;
+    ::int64_t m_rss_delta;
+    std::vector<double> m_seconds;
+};
+
+/** Time a single iteration of a benchmark and record its change in resident memory
+ *
+ * The change is measured from /proc/self/statm, so it counts memory the stage still holds when it finishes, not memory
+ * it allocated and released.
+ */
+class scoped_iteration
+{
+public:
+    /** Constructor
+     *
+     * @param result benchmark that owns the iteration
+     */
+    scoped_iteration(benchmark_result& result) :
+            m_result(result), m_seconds(result.next()), m_rss(current_rss_bytes()), m_start(util::wall_time()){}
+    /** Destructor, records the wall time and the change in resident memory */
+    ~scoped_iteration()
+    {
+        m_seconds = util::wall_time() - m_start;
+        m_result.add_rss_change(m_rss, current_rss_bytes());
+    }
+
+private:
+    scoped_iteration(const scoped_iteration&);
+    scoped_iteration& operator=(const scoped_iteration&);
+
+private:
+    benchmark_result& m_result;
+    double& m_seconds;
+    size_t m_rss;
+    double m_start;
+};
+
+/** Call back functor that counts the records of each metric set
+ */
+struct record_counter
+{
+    /** Constructor
+     *
+     * @param records number of records
+     */
+    record_counter(size_t& records) : m_records(records){}
+    /** Count the records of a metric set
+     *
+     * @param metrics set of metrics
+     */
+    template<class MetricSet>
+    void operator()(const MetricSet& metrics)const
+    {
+        m_records += metrics.size();
+    }
+private:
+    size_t& m_records;
+};
+
+/** Call back functor that writes each metric set as text
+ */
+struct text_writer
+{
+    /** Constructor
+     *
+     * @param out output stream
+     * @param channels list of channel names
+     */
+    text_writer(std::ostream& out, const std::vector<std::string>& channels) : m_out(out), m_channel_names(channels){}
+    /** Write a metric set as text
+     *
+     * @param metrics set of metrics
+     */
+    template<class MetricSet>
+    void operator()(const MetricSet& metrics)const
+    {
+        if(metrics.empty()) return;
+        io::write_text(m_out, metrics, m_channel_names);
+    }
+private:
+    std::ostream& m_out;
+    const std::vector<std::string>& m_channel_names;
+};
+
+/** Create the plot filter options for a metric type
+ *
+ * Channel and base metrics select the first channel or base. When `single_cycle` is true, cycle and read metrics
+ * select the first cycle or read, as required by the flowcell map and the per read lane plots.
+ *
+ * @param run run metrics
+ * @param type metric type
+ * @param single_cycle select a single cycle and read
+ * @return filter options
+ */
+model::plot::filter_options plot_options(const run_metrics& run,
+                                         const constants::metric_type type,
+                                         const bool single_cycle)
+{
+    typedef model::plot::filter_options filter_options;
+    const filter_options::id_t all_ids = filter_options::ALL_IDS;
+    return filter_options(run.run_info().flowcell().naming_method(),
+                          all_ids,
+                          logic::utils::is_channel_metric(type) ? 0 : filter_options::ALL_CHANNELS,
+                          logic::utils::is_base_metric(type) ? constants::A :
+                          static_cast<filter_options::dna_base_t>(filter_options::ALL_BASES),
+                          all_ids,
+                          single_cycle && logic::utils::is_read_metric(type) ? 1 : all_ids,
+                          single_cycle && logic::utils::is_cycle_metric(type) ? 1 : all_ids);
+}
+
+/** Keep only the metric types that can be plotted for this run
+ *
+ * @param run run metrics
+ * @param types metric types, those that cannot be plotted are removed
+ * @param plot_type 0: by cycle, 1: by lane, 2: flowcell
+ */
+void keep_valid_plot_types(run_metrics& run,
+                           std::vector<logic::utils::metric_type_description_t>& types,
+                           const int plot_type)
+{
+    std::vector<logic::utils::metric_type_description_t> valid;
+    for(size_t i=0;i<types.size();++i)
+    {
+        const constants::metric_type type = types[i].value();
+        try
+        {
+            if(plot_type == 0)
+            {
+                model::plot::plot_data<model::plot::candle_stick_point> data;
+                logic::plot::plot_by_cycle(run, type, plot_options(run, type, false), data);
+            }
+            else if(plot_type == 1)
+            {
+                model::plot::plot_data<model::plot::candle_stick_point> data;
+                logic::plot::plot_by_lane(run, type, plot_options(run, type, true), data);
+            }
+            else
+            {
+                model::plot::flowcell_data data;
+                logic::plot::plot_flowcell_map(run, type, plot_options(run, type, true), data);
+            }
+            valid.push_back(types[i]);
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << "Skipping " << constants::to_string(type) << ": " << ex.what() << std::endl;
+        }
+    }
+    types.swap(valid);
+}
+
+int main(int argc, const char** argv)
+{
+    size_t lane_count = 4;
+    size_t surface_count = 2;
+    size_t swath_count = 2;
+    size_t tile_count = 12;
+    size_t cycle_count = 100;
+    size_t channel_count = 2;
+    io::synthetic_run_options options;
+    size_t iterations = 3;
+    size_t thread_count = 1;
+    std::string output;
+    std::string trace_output;
+    util::option_parser description;
+    description
+            (lane_count, "lanes", "Number of lanes")
+            (surface_count, "surfaces", "Number of surfaces (1 or 2)")
+            (swath_count, "swaths", "Number of swaths per surface")
+            (tile_count, "tiles", "Number of tiles per swath")
+            (cycle_count, "cycles", "Total number of cycles")
+            (channel_count, "channels", "Number of image channels")
+            (options.bin_count, "bins", "Number of q-score bins, 0 for unbinned")
+            (options.sample_count, "samples", "Number of samples in the index metrics")
+            (options.seed, "seed", "Seed for the random number generator")
+            (iterations, "iterations", "Number of times to run each benchmark")
+            (thread_count, "threads", "Number of threads to use for generating and loading")
+            (output, "output", "Write the JSON report to this file instead of the console")
+            (trace_output, "trace", "Write a Chrome trace of the stages after generation to this file");
+    if(description.is_help_requested(argc, argv))
+    {
+        std::cout << "Usage: " << io::basename(argv[0]) << " run_folder [--option1=value1] [--option2=value2]" << std::endl;
+        description.display_help(std::cout);
+        return SUCCESS;
+    }
+    try
+    {
+        description.parse(argc, argv);
+        description.check_for_unknown_options(argc, argv);
+    }
+    catch(const util::option_exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    if(argc != 2)
+    {
+        std::cerr << "Expected a single run folder to generate" << std::endl;
+        return INVALID_ARGUMENTS;
+    }
+    if(iterations == 0) iterations = 1;
+    const std::string run_folder = argv[1];
+
+    std::vector<benchmark_result> results;
+    size_t record_count = 0;
+    size_t byte_count = 0;
+    model::run::info run_info;
+    options.thread_count = thread_count;
+    try
+    {
+        run_info = io::synthetic_run_info(lane_count, surface_count, swath_count, tile_count, cycle_count, channel_count);
+        std::cerr << "Generating " << lane_count*surface_count*swath_count*tile_count << " tiles x " << cycle_count
+                  << " cycles in " << run_folder << std::endl;
+        benchmark_result result("write_synthetic_run", "bytes", 0);
+        for(size_t i=0;i<iterations;++i)
+        {
+            scoped_iteration iteration(result);
+            byte_count = static_cast<size_t>(io::write_synthetic_run(run_folder, run_info, options));
+        }
+        result.set_items(static_cast<double>(byte_count));
+        results.push_back(result);
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return GENERATION_FAILED;
+    }
+
+    if(trace_output != "") util::enable_tracing();
+    try
+    {
+        run_metrics run;
+        {
+            benchmark_result read("read", "bytes", static_cast<double>(byte_count));
+            benchmark_result finalize("finalize_after_load", "records", static_cast<double>(record_count));
+            for(size_t i=0;i<iterations;++i)
+            {
+                run.clear();
+                size_t count;
+                {
+                    scoped_iteration iteration(read);
+                    count = run.read_xml(run_folder);
+                    run.read_metrics(run_folder, run.run_info().total_cycles(), thread_count);
+                }
+                scoped_iteration iteration(finalize);
+                run.finalize_after_load(count);
+            }
+            record_counter counter(record_count);
+            run.metrics_callback(counter);
+            finalize.set_items(static_cast<double>(record_count));
+            results.push_back(read);
+            results.push_back(finalize);
+        }
+        {
+            benchmark_result result("summarize_run_metrics", "records", static_cast<double>(record_count));
+            for(size_t i=0;i<iterations;++i)
+            {
+                model::summary::run_summary summary;
+                scoped_iteration iteration(result);
+                logic::summary::summarize_run_metrics(run, summary);
+            }
+            results.push_back(result);
+        }
+        {
+            const double index_records = static_cast<double>(run.get<index_metric>().size());
+            benchmark_result result("summarize_index_metrics", "records", index_records);
+            for(size_t i=0;i<iterations;++i)
+            {
+                model::summary::index_flowcell_summary summary;
+                scoped_iteration iteration(result);
+                logic::summary::summarize_index_metrics(run, summary);
+            }
+            results.push_back(result);
+        }
+        {
+            model::table::imaging_table table;
+            logic::table::create_imaging_table(run, table);
+            benchmark_result result("create_imaging_table", "cells",
+                                    static_cast<double>(table.row_count()*table.total_column_count()));
+            for(size_t i=0;i<iterations;++i)
+            {
+                scoped_iteration iteration(result);
+                logic::table::create_imaging_table(run, table);
+            }
+            results.push_back(result);
+        }
+        {
+            std::vector<logic::utils::metric_type_description_t> types;
+            logic::plot::list_by_cycle_metrics(types);
+            keep_valid_plot_types(run, types, 0);
+            benchmark_result result("plot_by_cycle", "plots", static_cast<double>(types.size()));
+            for(size_t i=0;i<iterations;++i)
+            {
+                scoped_iteration iteration(result);
+                for(size_t j=0;j<types.size();++j)
+                {
+                    model::plot::plot_data<model::plot::candle_stick_point> data;
+                    logic::plot::plot_by_cycle(run, types[j].value(), plot_options(run, types[j].value(), false), data);
+                }
+            }
+            results.push_back(result);
+        }
+        {
+            std::vector<logic::utils::metric_type_description_t> types;
+            logic::plot::list_by_lane_metrics(types);
+            keep_valid_plot_types(run, types, 1);
+            benchmark_result result("plot_by_lane", "plots", static_cast<double>(types.size()));
+            for(size_t i=0;i<iterations;++i)
+            {
+                scoped_iteration iteration(result);
+                for(size_t j=0;j<types.size();++j)
+                {
+                    model::plot::plot_data<model::plot::candle_stick_point> data;
+                    logic::plot::plot_by_lane(run, types[j].value(), plot_options(run, types[j].value(), true), data);
+                }
+            }
+            results.push_back(result);
+        }
+        {
+            std::vector<logic::utils::metric_type_description_t> types;
+            logic::plot::list_flowcell_metrics(types);
+            keep_valid_plot_types(run, types, 2);
+            benchmark_result result("plot_flowcell_map", "plots", static_cast<double>(types.size()));
+            for(size_t i=0;i<iterations;++i)
+            {
+                scoped_iteration iteration(result);
+                for(size_t j=0;j<types.size();++j)
+                {
+                    model::plot::flowcell_data data;
+                    logic::plot::plot_flowcell_map(run, types[j].value(), plot_options(run, types[j].value(), true), data);
+                }
+            }
+            results.push_back(result);
+        }
+        {
+            benchmark_result result("plot_qscore_histogram", "plots", 1);
+            for(size_t i=0;i<iterations;++i)
+            {
+                model::plot::plot_data<model::plot::bar_point> data;
+                scoped_iteration iteration(result);
+                logic::plot::plot_qscore_histogram(run,
+                                                   model::plot::filter_options(run.run_info().flowcell().naming_method()),
+                                                   data);
+            }
+            results.push_back(result);
+        }
+        {
+            benchmark_result result("plot_qscore_heatmap", "plots", 1);
+            for(size_t i=0;i<iterations;++i)
+            {
+                model::plot::heatmap_data data;
+                scoped_iteration iteration(result);
+                logic::plot::plot_qscore_heatmap(run,
+                                                 model::plot::filter_options(run.run_info().flowcell().naming_method()),
+                                                 data);
+            }
+            results.push_back(result);
+        }
+        {
+            const size_t lane_count = run.run_info().flowcell().lane_count();
+            benchmark_result result("plot_sample_qc", "plots", static_cast<double>(lane_count));
+            for(size_t i=0;i<iterations;++i)
+            {
+                scoped_iteration iteration(result);
+                for(size_t lane=1;lane<=lane_count;++lane)
+                {
+                    model::plot::plot_data<model::plot::bar_point> data;
+                    logic::plot::plot_sample_qc(run, lane, data);
+                }
+            }
+            results.push_back(result);
+        }
+        {
+            counting_buffer buffer;
+            std::ostream out(&buffer);
+            text_writer writer(out, run.run_info().channels());
+            run.metrics_callback(writer);
+            benchmark_result result("write_text", "bytes", static_cast<double>(buffer.count()));
+            for(size_t i=0;i<iterations;++i)
+            {
+                scoped_iteration iteration(result);
+                run.metrics_callback(writer);
+            }
+            results.push_back(result);
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return UNEXPECTED_EXCEPTION;
+    }
+
+    if(trace_output != "")
+    {
+        util::enable_tracing(false);
+        std::ofstream trace_out(trace_output.c_str());
+        if(!trace_out.good())
+        {
+            std::cerr << "Cannot open " << trace_output << std::endl;
+            return INVALID_ARGUMENTS;
+        }
+        util::write_chrome_trace(trace_out);
+    }
+
+    std::ofstream fout;
+    if(output != "")
+    {
+        fout.open(output.c_str());
+        if(!fout.good())
+        {
+            std::cerr << "Cannot open " << output << std::endl;
+            return INVALID_ARGUMENTS;
+        }
+    }
+    std::ostream& out = output != "" ? fout : std::cout;
+    out << std::setprecision(9);
+    out << "{\n";
+    out << "  \"version\": \"" << INTEROP_VERSION << "\",\n";
+    out << "  \"scale\": {\"lanes\": " << lane_count
+        << ", \"surfaces\": " << surface_count
+        << ", \"swaths\": " << swath_count
+        << ", \"tiles_per_swath\": " << tile_count
+        << ", \"tiles\": " << lane_count*surface_count*swath_count*tile_count
+        << ", \"cycles\": " << cycle_count
+        << ", \"channels\": " << channel_count
+        << ", \"q_bins\": " << options.bin_count
+        << ", \"samples\": " << options.sample_count
+        << ", \"seed\": " << options.seed
+        << ", \"threads\": " << thread_count << "},\n";
+    out << "  \"records\": " << record_count << ",\n";
+    out << "  \"interop_bytes\": " << byte_count << ",\n";
+    out << "  \"benchmarks\": [\n";
+    for(size_t i=0;i<results.size();++i)
+    {
+        out << "    ";
+        results[i].write_json(out);
+        out << (i+1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ],\n";
+    const size_t peak = peak_rss_bytes();
+    out << "  \"peak_rss_bytes\": ";
+    if(peak > 0) out << peak;
+    else out << "null";
+    out << "\n}" << std::endl;
+    return SUCCESS;
+}
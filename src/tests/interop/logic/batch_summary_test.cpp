@@ -0,0 +1,111 @@
+/** Unit tests for the batch summary logic
+ *
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <gtest/gtest.h>
+#include "interop/logic/summary/batch_summary.h"
+#include "interop/logic/summary/run_summary.h"
+#include "interop/logic/summary/index_summary.h"
+#include "interop/io/synthetic_run.h"
+#include "interop/util/lexical_cast.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::logic::summary;
+
+namespace
+{
+    /** Write a small synthetic run
+     *
+     * @param run_folder destination run folder
+     * @param seed seed of the random number generator
+     * @param tile_count number of tiles per swath
+     */
+    void write_batch_run(const std::string& run_folder, const size_t seed, const size_t tile_count)
+    {
+        const model::run::info run_info = io::synthetic_run_info(2, 1, 1, tile_count, 44, 2);
+        io::write_synthetic_run(run_folder, run_info, io::synthetic_run_options(seed));
+    }
+    /** Record the run folder of each reported result */
+    class recording_listener : public batch_summary_listener
+    {
+    public:
+        /** Record the run folder of a result
+         *
+         * @param result result of the run
+         */
+        void run_summarized(const batch_summary_result& result)
+        {
+            run_folders.push_back(result.run_folder);
+        }
+        /** Run folder of each reported result */
+        std::vector<std::string> run_folders;
+    };
+}
+
+TEST(batch_summary_test, worker_count)
+{
+    EXPECT_EQ(batch_worker_count(10, batch_summary_options(8)), 8u);
+    EXPECT_EQ(batch_worker_count(10, batch_summary_options(8, 3)), 3u);
+    EXPECT_EQ(batch_worker_count(2, batch_summary_options(8)), 2u);
+    EXPECT_EQ(batch_worker_count(0, batch_summary_options(0)), 1u);
+}
+
+TEST(batch_summary_test, results_in_order_with_bad_folder)
+{
+    write_batch_run("synthetic_run_test_batch1", 11, 2);
+    write_batch_run("synthetic_run_test_batch2", 12, 5);
+    std::vector<std::string> run_folders;
+    run_folders.push_back("synthetic_run_test_batch2");
+    run_folders.push_back("synthetic_run_test_batch_missing");
+    run_folders.push_back("synthetic_run_test_batch1");
+
+    batch_summary_options options(4, 2);
+    options.summarize_index = true;
+    batch_summary_result_vector results;
+    summarize_run_batch(run_folders, results, options);
+    ASSERT_EQ(results.size(), run_folders.size());
+    for(size_t i=0;i<run_folders.size();++i)
+        EXPECT_EQ(results[i].run_folder, run_folders[i]);
+    EXPECT_FALSE(results[1].is_valid());
+    EXPECT_EQ(results[1].error_type, BatchMissingRunInfo);
+    EXPECT_FALSE(results[1].error_message.empty());
+
+    for(size_t i=0;i<run_folders.size();i+=2)
+    {
+        ASSERT_TRUE(results[i].is_valid()) << results[i].error_message;
+        model::metrics::run_metrics run;
+        run.read(run_folders[i]);
+        model::summary::run_summary expected;
+        summarize_run_metrics(run, expected);
+        model::summary::index_flowcell_summary expected_index;
+        summarize_index_metrics(run, expected_index);
+        EXPECT_EQ(results[i].run_summary.size(), expected.size());
+        EXPECT_NEAR(results[i].run_summary.total_summary().yield_g(), expected.total_summary().yield_g(), 1e-5);
+        ASSERT_EQ(results[i].index_summary.size(), expected_index.size());
+        EXPECT_EQ(results[i].index_summary[0].total_reads(), expected_index[0].total_reads());
+    }
+    EXPECT_NE(results[0].run_summary.total_summary().yield_g(), results[2].run_summary.total_summary().yield_g());
+}
+
+
+TEST(batch_summary_test, listener_reports_each_run_in_order)
+{
+    std::vector<std::string> run_folders;
+    for(size_t i=0;i<4;++i)
+    {
+        run_folders.push_back("synthetic_run_test_listener"+util::lexical_cast<std::string>(i));
+        write_batch_run(run_folders.back(), 20+i, 1+(3-i)*2);
+    }
+    run_folders.push_back("synthetic_run_test_listener_missing");
+
+    recording_listener listener;
+    batch_summary_result_vector results;
+    summarize_run_batch(run_folders, results, batch_summary_options(4, 3), &listener);
+    EXPECT_EQ(listener.run_folders, run_folders);
+    for(size_t i=0;i+1<results.size();++i)
+        EXPECT_TRUE(results[i].is_valid()) << results[i].error_message;
+}
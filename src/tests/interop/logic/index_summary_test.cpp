@@ -141,6 +141,110 @@ TEST(index_summary_test, lane_summary_cluster_count)
     EXPECT_EQ(cluster_count*2u, summary[0].cluster_count());
 }
 
+TEST(index_summary_test, flowcell_summary_matches_lane_summary)
+{
+    model::metrics::run_metrics metrics(model::run::info(model::run::flowcell_layout(2)));
+    std::vector< model::metrics::index_info > indices1;
+    indices1.push_back(model::metrics::index_info("TTGC", "1", "Project", 300));
+    indices1.push_back(model::metrics::index_info("AATG", "2", "Project", 500));
+    std::vector< model::metrics::index_info > indices2;
+    indices2.push_back(model::metrics::index_info("GGCA", "3", "Project", 700));
+    indices2.push_back(model::metrics::index_info("AATG", "2", "Project", 200));
+
+    metrics.get<model::metrics::index_metric>().insert(model::metrics::index_metric(1, 1114, 1, indices1));
+    metrics.get<model::metrics::index_metric>().insert(model::metrics::index_metric(2, 1114, 1, indices2));
+    metrics.get<model::metrics::index_metric>().insert(model::metrics::index_metric(2, 1115, 1, indices1));
+    metrics.get<model::metrics::index_metric>().insert(model::metrics::index_metric(2, 1116, 1, indices2));// No tile metric
+    metrics.get<model::metrics::tile_metric>().insert(model::metrics::tile_metric(1, 1114, 10000, 10000, 9000, 9000));
+    metrics.get<model::metrics::tile_metric>().insert(model::metrics::tile_metric(2, 1114, 10000, 10000, 8000, 8000));
+    metrics.get<model::metrics::tile_metric>().insert(model::metrics::tile_metric(2, 1115, 10000, 10000, 7000, 7000));
+
+    index_flowcell_summary actual;
+    logic::summary::summarize_index_metrics(metrics, actual, 2);
+    ASSERT_EQ(2u, actual.size());
+    for(size_t lane=1;lane<=actual.size();++lane)
+    {
+        index_lane_summary expected;
+        logic::summary::summarize_index_metrics(metrics, lane, expected);
+        const index_lane_summary& actual_lane = actual[lane-1];
+        EXPECT_EQ(expected.total_reads(), actual_lane.total_reads());
+        EXPECT_EQ(expected.total_pf_reads(), actual_lane.total_pf_reads());
+        EXPECT_EQ(expected.max_mapped_reads(), actual_lane.max_mapped_reads());
+        ASSERT_EQ(expected.size(), actual_lane.size());
+        for(size_t index=0;index<expected.size();++index)
+        {
+            EXPECT_EQ(expected[index].id(), actual_lane[index].id());
+            EXPECT_EQ(expected[index].index1(), actual_lane[index].index1());
+            EXPECT_EQ(expected[index].cluster_count(), actual_lane[index].cluster_count());
+        }
+    }
+    EXPECT_EQ(700u, actual[1][0].cluster_count());
+    EXPECT_EQ("AATG", actual[1][0].index1());
+    EXPECT_EQ(8000u+7000u, actual[1].total_pf_reads());
+}
+
+/** Expect two index flowcell summaries to hold the same index counts
+ *
+ * @param expected expected summary
+ * @param actual actual summary
+ */
+static void expect_same_index_counts(const index_flowcell_summary& expected, const index_flowcell_summary& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for(size_t lane=0;lane<expected.size();++lane)
+    {
+        EXPECT_FLOAT_EQ(expected[lane].total_fraction_mapped_reads(), actual[lane].total_fraction_mapped_reads());
+        ASSERT_EQ(expected[lane].size(), actual[lane].size());
+        for(size_t index=0;index<expected[lane].size();++index)
+        {
+            EXPECT_EQ(expected[lane][index].index1(), actual[lane][index].index1());
+            EXPECT_EQ(expected[lane][index].sample_id(), actual[lane][index].sample_id());
+            EXPECT_EQ(expected[lane][index].cluster_count(), actual[lane][index].cluster_count());
+        }
+    }
+}
+
+TEST(index_summary_test, flowcell_summary_filled_in_place)
+{
+    std::vector< model::metrics::index_info > indices1;
+    indices1.push_back(model::metrics::index_info("TTGC", "1", "Project", 300));
+    indices1.push_back(model::metrics::index_info("AATG", "2", "Project", 500));
+    std::vector< model::metrics::index_info > indices2;
+    indices2.push_back(model::metrics::index_info("GGCA", "3", "Project", 700));
+    indices2.push_back(model::metrics::index_info("AATG", "2", "Project", 200));
+
+    model::metrics::run_metrics expected_metrics(model::run::info(model::run::flowcell_layout(2)));
+    expected_metrics.get<model::metrics::index_metric>().insert(model::metrics::index_metric(1, 1114, 1, indices1));
+    expected_metrics.get<model::metrics::index_metric>().insert(model::metrics::index_metric(2, 1114, 1, indices2));
+    expected_metrics.get<model::metrics::tile_metric>().insert(model::metrics::tile_metric(1, 1114, 10000, 10000, 9000, 9000));
+    expected_metrics.get<model::metrics::tile_metric>().insert(model::metrics::tile_metric(2, 1114, 10000, 10000, 8000, 8000));
+    index_flowcell_summary expected;
+    logic::summary::summarize_index_metrics(expected_metrics, expected);
+
+    // Filled in place
+    model::metrics::run_metrics filled(expected_metrics.run_info());
+    filled.get<model::metrics::tile_metric>() = expected_metrics.get<model::metrics::tile_metric>();
+    filled.get<model::metrics::index_metric>().resize(2);
+    filled.get<model::metrics::index_metric>()[0] = model::metrics::index_metric(1, 1114, 1, indices1);
+    filled.get<model::metrics::index_metric>()[1] = model::metrics::index_metric(2, 1114, 1, indices2);
+    index_flowcell_summary actual;
+    logic::summary::summarize_index_metrics(filled, actual);
+    expect_same_index_counts(expected, actual);
+    index_flowcell_summary actual_parallel;
+    logic::summary::summarize_index_metrics(filled, actual_parallel, 2);
+    expect_same_index_counts(expected, actual_parallel);
+
+    // Edited in place
+    model::metrics::run_metrics edited(expected_metrics.run_info());
+    edited.get<model::metrics::tile_metric>() = expected_metrics.get<model::metrics::tile_metric>();
+    edited.get<model::metrics::index_metric>().insert(model::metrics::index_metric(1, 1114, 1, indices2));
+    edited.get<model::metrics::index_metric>().insert(model::metrics::index_metric(2, 1114, 1, indices2));
+    edited.get<model::metrics::index_metric>()[0] = model::metrics::index_metric(1, 1114, 1, indices1);
+    index_flowcell_summary actual_edited;
+    logic::summary::summarize_index_metrics(edited, actual_edited);
+    expect_same_index_counts(expected, actual_edited);
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 // Unit test section
 //---------------------------------------------------------------------------------------------------------------------
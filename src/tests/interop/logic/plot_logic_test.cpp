@@ -7,6 +7,7 @@
  */
 #include <gtest/gtest.h>
 #include "interop/model/plot/filter_options.h"
+#include "interop/model/plot/tile_filter.h"
 #include "interop/logic/plot/plot_by_cycle.h"
 #include "interop/logic/plot/plot_by_lane.h"
 #include "interop/logic/plot/plot_qscore_histogram.h"
@@ -33,6 +34,32 @@ TEST(plot_logic, failure_mode_bad_metric_plot_by_cycle)
     EXPECT_THROW(logic::plot::plot_by_cycle(metrics, "NoSuchMetric", options, data), model::invalid_metric_type);
 }
 
+/** @test Confirm the compiled tile filter agrees with the filter options for every tile id */
+TEST(plot_logic, tile_filter_matches_filter_options)
+{
+    const model::run::flowcell_layout layout(2, 2, 4, 12, 3, 1, std::vector<std::string>(), constants::FiveDigit);
+    model::plot::filter_options options(constants::FiveDigit);
+    options.lane(2);
+    options.surface(2);
+    options.swath(3);
+    options.section(2);
+    options.cycle(5);
+    const model::plot::tile_filter filter(options, layout);
+    for(model::metrics::error_metric::uint_t lane=1;lane<=2;++lane)
+    {
+        for(model::metrics::error_metric::uint_t tile=0;tile<40000;tile+=7)
+        {
+            for(model::metrics::error_metric::uint_t cycle=4;cycle<=5;++cycle)
+            {
+                const model::metrics::error_metric metric(lane, tile, cycle, 0.5f);
+                EXPECT_EQ(filter.valid_tile(metric), options.valid_tile(metric)) << lane << " " << tile;
+                EXPECT_EQ(filter.valid_tile_cycle(metric), options.valid_tile_cycle(metric)) << lane << " " << tile;
+            }
+        }
+    }
+    EXPECT_TRUE(filter.valid_tile(model::metrics::error_metric(2, 23211, 5, 0.5f)));
+}
+
 //Check that reading in an interop and then plotting by cycle graph works
 TEST(plot_logic, intensity_by_cycle)
 {
@@ -453,6 +480,39 @@ TEST(plot_logic, sample_qc)
     EXPECT_NEAR(data.y_axis().max(), 5, tol);
 }
 
+//Test to ensure that plot_sample_qc handles index metrics filled in place
+TEST(plot_logic, sample_qc_filled_in_place)
+{
+    const float tol = 1e-3f;
+    model::metrics::run_metrics expected_metrics;
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    expected_metrics.run_info(run_info);
+    unittest::index_metric_v1::create_expected(expected_metrics.get<model::metrics::index_metric>());
+    unittest::tile_metric_v2::create_expected(expected_metrics.get<model::metrics::tile_metric>());
+
+    model::metrics::run_metrics metrics;
+    metrics.run_info(run_info);
+    metrics.get<model::metrics::tile_metric>() = expected_metrics.get<model::metrics::tile_metric>();
+    const model::metric_base::metric_set<model::metrics::index_metric>& expected_index_metrics =
+            expected_metrics.get<model::metrics::index_metric>();
+    metrics.get<model::metrics::index_metric>().resize(expected_index_metrics.size());
+    for(size_t i=0;i<expected_index_metrics.size();++i)
+        metrics.get<model::metrics::index_metric>()[i] = model::metrics::index_metric(expected_index_metrics.at(i).lane(),
+                                                                                      expected_index_metrics.at(i).tile(),
+                                                                                      expected_index_metrics.at(i).read(),
+                                                                                      expected_index_metrics.at(i).indices());
+
+    model::plot::plot_data<model::plot::bar_point> expected;
+    logic::plot::plot_sample_qc(expected_metrics, 7, expected);
+    model::plot::plot_data<model::plot::bar_point> data;
+    logic::plot::plot_sample_qc(metrics, 7, data);
+    ASSERT_EQ(data.size(), 1u);
+    ASSERT_EQ(data[0].size(), expected[0].size());
+    for(size_t i=0;i<data[0].size();++i)
+        EXPECT_NEAR(data[0][i].y(), expected[0][i].y(), tol);
+}
+
 //Test to make sure that plot_sample_qc stores 0's for axis values with no interop being read
 TEST(plot_logic, sample_qc_empty_interop)
 {
@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 #include "interop/util/math.h"
 #include "interop/logic/summary/run_summary.h"
+#include "interop/logic/summary/cycle_rollup.h"
 #include "interop/logic/utils/channel.h"
 #include "src/tests/interop/metrics/inc/corrected_intensity_metrics_test.h"
 #include "src/tests/interop/metrics/inc/error_metrics_test.h"
@@ -454,6 +455,38 @@ TEST(summary_metrics_test, empty_run_metrics)
     EXPECT_EQ(summary.size(), 0u);
 }
 
+TEST(summary_metrics_test, cycle_rollup_sums_cycle_ranges)
+{
+    typedef model::metrics::error_metric::uint_t uint_t;
+    model::metric_base::metric_set<model::metrics::error_metric> metrics;
+    for (uint_t cycle_number = 1; cycle_number <= 10; ++cycle_number)
+    {
+        metrics.insert(error_metric(1, 1101, cycle_number, static_cast<float>(cycle_number)));
+        if(cycle_number != 4)
+            metrics.insert(error_metric(2, 1102, cycle_number, cycle_number == 6 ? std::numeric_limits<float>::quiet_NaN() : 1.0f));
+    }
+    logic::summary::cycle_rollup rollup;
+    rollup.assign(metrics.begin(), metrics.end(), 10, logic::summary::error_rate_value());
+    ASSERT_EQ(rollup.tile_count(), 2u);
+    EXPECT_EQ(rollup.lane(1), 2u);
+    EXPECT_EQ(rollup.tile(1), 1102u);
+    EXPECT_EQ(rollup.index_of(2, 1102), 1u);
+    EXPECT_EQ(rollup.index_of(1, 1102), rollup.tile_count());
+
+    const float tol = 1e-6f;
+    INTEROP_EXPECT_NEAR(rollup.sum(0, 3, 5), 12.0, tol);
+    INTEROP_EXPECT_NEAR(rollup.mean(0, 1, 10), 5.5f, tol);
+    EXPECT_EQ(rollup.record_count(1, 3, 7), 4u);
+    EXPECT_EQ(rollup.value_count(1, 3, 7), 3u);
+    INTEROP_EXPECT_NEAR(rollup.mean(1, 3, 7), 1.0f, tol);
+    EXPECT_EQ(rollup.value_count(1, 4, 4), 0u);
+    EXPECT_EQ(rollup.value_count(1, 8, 20), 3u);
+
+    metrics.insert(error_metric(1, 1101, 11, 1.0f));
+    EXPECT_THROW(rollup.assign(metrics.begin(), metrics.end(), 10, logic::summary::error_rate_value()),
+                 model::index_out_of_bounds_exception);
+}
+
 //---------------------------------------------------------------------------------------------------------------------
 // Unit test section
 //---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,385 @@
+/** Unit tests for the Arrow C data interface export
+ *
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include "interop/io/table/arrow_export.h"
+#include "interop/util/lexical_cast.h"
+#include "interop/logic/table/create_imaging_table.h"
+#include "src/tests/interop/metrics/inc/error_metrics_test.h"
+#include "src/tests/interop/metrics/inc/index_metrics_test.h"
+#include "src/tests/interop/metrics/inc/extraction_metrics_test.h"
+#include "src/tests/interop/metrics/inc/image_metrics_test.h"
+#include "src/tests/interop/metrics/inc/q_metrics_test.h"
+#include "src/tests/interop/run/info_test.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::unittest;
+
+namespace
+{
+    /** Column imported by a minimal Arrow consumer */
+    struct imported_column
+    {
+        /** Field name */
+        std::string name;
+        /** Format string */
+        std::string format;
+        /** Numeric values, converted to double */
+        std::vector<double> values;
+        /** String values */
+        std::vector<std::string> strings;
+        /** Validity of each value */
+        std::vector<bool> valid;
+        /** Number of null values */
+        ::int64_t null_count;
+    };
+
+    /** Read a fixed width value from an Arrow buffer and convert to double
+     *
+     * @param buffer data buffer
+     * @param index index of the value
+     * @return value as double
+     */
+    template<typename T>
+    double read_value(const void* buffer, const size_t index)
+    {
+        T val;
+        std::memcpy(&val, static_cast<const char*>(buffer)+index*sizeof(T), sizeof(T));
+        return static_cast<double>(val);
+    }
+
+    /** Import a struct array the way an Arrow consumer would, then release it
+     *
+     * The first child is moved out of the parent before release, to ensure children can be released independently.
+     *
+     * @param schema exported schema
+     * @param array exported array
+     * @param columns destination columns
+     * @return number of rows
+     */
+    size_t import_struct(ArrowSchema& schema, ArrowArray& array, std::vector<imported_column>& columns)
+    {
+        EXPECT_EQ(std::string(schema.format), "+s");
+        EXPECT_EQ(schema.n_children, array.n_children);
+        EXPECT_EQ(array.n_buffers, 1);
+        const size_t row_count = static_cast<size_t>(array.length);
+        columns.resize(static_cast<size_t>(array.n_children));
+        ArrowSchema moved_schema;
+        ArrowArray moved_array;
+        std::memset(&moved_schema, 0, sizeof(ArrowSchema));
+        std::memset(&moved_array, 0, sizeof(ArrowArray));
+        for(size_t i=0;i<columns.size();++i)
+        {
+            const ArrowSchema& child_schema = *schema.children[i];
+            const ArrowArray& child = *array.children[i];
+            imported_column& column = columns[i];
+            column.name = child_schema.name;
+            column.format = child_schema.format;
+            column.null_count = child.null_count;
+            EXPECT_EQ(static_cast<size_t>(child.length), row_count);
+            for(size_t row=0;row<row_count;++row)
+            {
+                if(column.format == "n")
+                {
+                    column.valid.push_back(false);
+                    continue;
+                }
+                const ::uint8_t* validity = static_cast<const ::uint8_t*>(child.buffers[0]);
+                column.valid.push_back(validity == 0 || ((validity[row/8] >> (row%8)) & 1) != 0);
+                if(column.format == "u")
+                {
+                    const ::int32_t* offsets = static_cast<const ::int32_t*>(child.buffers[1]);
+                    const char* data = static_cast<const char*>(child.buffers[2]);
+                    column.strings.push_back(std::string(data+offsets[row], data+offsets[row+1]));
+                    continue;
+                }
+                const void* data = child.buffers[1];
+                switch(column.format[0])
+                {
+                    case 'S':
+                        column.values.push_back(read_value< ::uint16_t >(data, row));
+                        break;
+                    case 'I':
+                        column.values.push_back(read_value< ::uint32_t >(data, row));
+                        break;
+                    case 'L':
+                        column.values.push_back(read_value< ::uint64_t >(data, row));
+                        break;
+                    case 'f':
+                        column.values.push_back(read_value< float >(data, row));
+                        break;
+                    case 'g':
+                        column.values.push_back(read_value< double >(data, row));
+                        break;
+                    default:
+                        ADD_FAILURE() << "Unexpected format: " << column.format;
+                }
+            }
+        }
+        if(!columns.empty())
+        {
+            // Move the first child out of the parent, as permitted by the C data interface
+            moved_schema = *schema.children[0];
+            moved_array = *array.children[0];
+            schema.children[0]->release = 0;
+            array.children[0]->release = 0;
+        }
+        schema.release(&schema);
+        array.release(&array);
+        EXPECT_TRUE(schema.release == 0);
+        EXPECT_TRUE(array.release == 0);
+        if(moved_schema.release != 0) moved_schema.release(&moved_schema);
+        if(moved_array.release != 0) moved_array.release(&moved_array);
+        EXPECT_TRUE(moved_schema.release == 0);
+        EXPECT_TRUE(moved_array.release == 0);
+        return row_count;
+    }
+}
+
+/**
+ * @test Confirm an error metric set round trips through the Arrow C data interface
+ */
+TEST(arrow_export, error_metric_round_trip)
+{
+    model::metric_base::metric_set<model::metrics::error_metric> metrics;
+    error_metric_v3::create_expected(metrics);
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(metrics, &schema, &array);
+    EXPECT_EQ(std::string(schema.name), "Error");
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), metrics.size());
+    ASSERT_EQ(columns.size(), 4u);
+    EXPECT_EQ(columns[0].name, "Lane");
+    EXPECT_EQ(columns[1].name, "Tile");
+    EXPECT_EQ(columns[2].name, "Cycle");
+    EXPECT_EQ(columns[3].name, "ErrorRate");
+    EXPECT_EQ(columns[0].format, "I");
+    EXPECT_EQ(columns[3].format, "f");
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        EXPECT_EQ(columns[0].values[i], metrics[i].lane());
+        EXPECT_EQ(columns[1].values[i], metrics[i].tile());
+        EXPECT_EQ(columns[2].values[i], metrics[i].cycle());
+        EXPECT_EQ(columns[3].values[i], metrics[i].error_rate());
+        EXPECT_EQ(columns[0].null_count, 0);
+    }
+}
+
+/**
+ * @test Confirm channel columns and 64-bit time stamps are exported from an extraction metric set
+ */
+TEST(arrow_export, extraction_metric_channels)
+{
+    model::metric_base::metric_set<model::metrics::extraction_metric> metrics;
+    extraction_metric_v3::create_expected(metrics);
+    std::vector<std::string> channels;
+    for(size_t i=0;i<static_cast<size_t>(metrics.channel_count());++i) channels.push_back(util::lexical_cast<std::string>(i));
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(metrics, &schema, &array, channels);
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), metrics.size());
+    ASSERT_EQ(columns.size(), 4u+channels.size()*2);
+    EXPECT_EQ(columns[3].name, "TimeStamp");
+    EXPECT_EQ(columns[3].format, "L");
+    EXPECT_EQ(columns[4].name, "MaxIntensity_0");
+    EXPECT_EQ(columns[4].format, "S");
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        EXPECT_EQ(columns[4].values[i], metrics[i].max_intensity(0));
+        EXPECT_EQ(columns[4+channels.size()].values[i], metrics[i].focus_score(0));
+    }
+}
+
+/**
+ * @test Confirm channel columns are exported from an image metric set
+ */
+TEST(arrow_export, image_metric_channels)
+{
+    model::metric_base::metric_set<model::metrics::image_metric> metrics;
+    image_metric_v2::create_expected(metrics);
+    std::vector<std::string> channels;
+    for(size_t i=0;i<static_cast<size_t>(metrics.channel_count());++i) channels.push_back(util::lexical_cast<std::string>(i));
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(metrics, &schema, &array, channels);
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), metrics.size());
+    ASSERT_EQ(columns.size(), 3u+channels.size()*2);
+    EXPECT_EQ(columns[3].name, "MinContrast_0");
+    EXPECT_EQ(columns[3+channels.size()].name, "MaxContrast_0");
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        EXPECT_EQ(columns[2].values[i], metrics[i].cycle());
+        EXPECT_EQ(columns[3].values[i], metrics[i].min_contrast(0));
+        EXPECT_EQ(columns[3+channels.size()].values[i], metrics[i].max_contrast(0));
+    }
+}
+
+/**
+ * @test Confirm a mismatch between the channel names and the header is rejected
+ */
+TEST(arrow_export, channel_names_mismatch)
+{
+    model::metric_base::metric_set<model::metrics::image_metric> metrics;
+    image_metric_v2::create_expected(metrics);
+
+    ArrowSchema schema;
+    ArrowArray array;
+    EXPECT_THROW(io::export_to_arrow(metrics, &schema, &array), io::bad_format_exception);
+}
+
+/**
+ * @test Confirm the q-score histogram is exported with one column per bin
+ */
+TEST(arrow_export, q_metric_histogram)
+{
+    model::metric_base::metric_set<model::metrics::q_metric> metrics;
+    q_metric_v6::create_expected(metrics);
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(metrics, &schema, &array);
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), metrics.size());
+    ASSERT_EQ(columns.size(), 3u+metrics.q_val_count());
+    EXPECT_EQ(columns[3].name, "Bin_1");
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        for(size_t bin=0;bin<metrics.q_val_count();++bin)
+            EXPECT_EQ(columns[3+bin].values[i], metrics[i].qscore_hist()[bin]);
+    }
+}
+
+/**
+ * @test Confirm string columns are exported from an index metric set
+ */
+TEST(arrow_export, index_metric_strings)
+{
+    model::metric_base::metric_set<model::metrics::index_metric> metrics;
+    index_metric_v1::create_expected(metrics);
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(metrics, &schema, &array);
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), metrics.size());
+    ASSERT_EQ(columns.size(), 7u);
+    EXPECT_EQ(columns[3].name, "Sequence");
+    EXPECT_EQ(columns[3].format, "u");
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        EXPECT_EQ(columns[3].strings[i], metrics[i].indices()[0].index_seq());
+        EXPECT_EQ(columns[4].strings[i], metrics[i].indices()[0].sample_id());
+        EXPECT_EQ(columns[6].values[i], metrics[i].indices()[0].cluster_count());
+    }
+}
+
+/**
+ * @test Confirm a dynamic phasing metric set is exported with one row per tile and read
+ */
+TEST(arrow_export, dynamic_phasing_metric_read_rows)
+{
+    typedef model::metrics::dynamic_phasing_metric metric_t;
+    model::metric_base::metric_set<metric_t> metrics;
+    metrics.insert(metric_t(1, 1101, 1, 0.1f, 0.2f, 0.3f, 0.4f));
+    metrics.insert(metric_t(1, 1101, 2, 0.5f, 0.6f, 0.7f, 0.8f));
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(metrics, &schema, &array);
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), metrics.size());
+    ASSERT_EQ(columns.size(), 7u);
+    EXPECT_EQ(columns[2].name, "Read");
+    EXPECT_EQ(columns[3].name, "PhasingSlope");
+    EXPECT_EQ(columns[6].name, "PrephasingOffset");
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        EXPECT_EQ(columns[2].values[i], metrics[i].read());
+        EXPECT_EQ(columns[3].values[i], metrics[i].phasing_slope());
+        EXPECT_EQ(columns[4].values[i], metrics[i].phasing_offset());
+        EXPECT_EQ(columns[5].values[i], metrics[i].prephasing_slope());
+        EXPECT_EQ(columns[6].values[i], metrics[i].prephasing_offset());
+    }
+}
+
+/**
+ * @test Confirm missing values are exported as nulls
+ */
+TEST(arrow_export, tile_metric_missing_read)
+{
+    typedef model::metrics::tile_metric metric_t;
+    model::metric_base::metric_set<metric_t> metrics(2);
+    metrics.insert(metric_t(7, 1114, 2355119.25f, 1158081.50f, 6470949, 3181956, metric_t::read_metric_vector()));
+    metrics.insert(metric_t(7, 1214, 2355119.25f, 1174757.75f, 6470949, 3227776,
+                            metric_t::read_metric_vector(1, metric_t::read_metric_type(1, 2.62f, 0.13f, 0.14f))));
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(metrics, &schema, &array);
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), 2u);
+    ASSERT_EQ(columns.size(), 10u);
+    EXPECT_EQ(columns[2].name, "Read");
+    EXPECT_EQ(columns[2].null_count, 1);
+    EXPECT_FALSE(columns[2].valid[0]);
+    EXPECT_TRUE(columns[2].valid[1]);
+    EXPECT_EQ(columns[2].values[1], 1);
+    EXPECT_EQ(columns[7].null_count, 1);
+    EXPECT_FLOAT_EQ(static_cast<float>(columns[7].values[1]), 2.62f);
+}
+
+/**
+ * @test Confirm the imaging table round trips through the Arrow C data interface
+ */
+TEST(arrow_export, imaging_table_round_trip)
+{
+    model::metrics::run_metrics metrics;
+    model::run::info run_info;
+    hiseq4k_run_info::create_expected(run_info);
+    metrics.run_info(run_info);
+    error_metric_v3::create_expected(metrics.get<model::metrics::error_metric>());
+    model::table::imaging_table table;
+    logic::table::create_imaging_table(metrics, table);
+    ASSERT_GT(table.row_count(), 0u);
+
+    ArrowSchema schema;
+    ArrowArray array;
+    io::export_to_arrow(table, &schema, &array);
+
+    std::vector<imported_column> columns;
+    ASSERT_EQ(import_struct(schema, array, columns), table.row_count());
+    ASSERT_EQ(columns.size(), table.total_column_count());
+    for(size_t col=0, index=0;col<table.column_count();++col)
+    {
+        for(size_t sub=0;sub<table.columns()[col].size();++sub, ++index)
+        {
+            EXPECT_EQ(columns[index].name, table.columns()[col].full_name(sub));
+            for(size_t row=0;row<table.row_count();++row)
+            {
+                if(columns[index].valid[row]) EXPECT_EQ(columns[index].values[row], table(row, col, sub));
+                else EXPECT_TRUE(std::isnan(table(row, col, sub)));
+            }
+        }
+    }
+}
+
@@ -10,6 +10,8 @@
 #include "interop/model/metric_base/base_metric.h"
 #include "interop/model/metric_base/base_cycle_metric.h"
 #include "interop/model/metric_base/base_read_metric.h"
+#include "interop/model/metric_base/metric_set.h"
+#include "interop/model/metrics/error_metric.h"
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -90,5 +92,130 @@ TEST(base_read_metric_test, tile_hash_from_id)
     EXPECT_EQ(base_read_metric::tile_hash_from_id(id), base_metric::create_id(8, 1323));
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST(metric_set_test, sort_rebuilds_index)
+{
+    typedef metrics::error_metric metric_t;
+    metric_set<metric_t> metrics;
+    const metric_t::uint_t lanes[] = {2, 1, 2, 1, 1};
+    const metric_t::uint_t tiles[] = {1101, 1102, 1101, 1101, 1101};
+    const metric_t::uint_t cycles[] = {2, 1, 1, 2, 1};
+    for(size_t i=0;i<5;++i)
+        metrics.insert(metric_t(lanes[i], tiles[i], cycles[i], 0.5f));
+    EXPECT_FALSE(metrics.is_sorted());
+    EXPECT_THROW(metrics.lane_range(1), invalid_parameter);
+
+    metrics.sort(2);
+    EXPECT_TRUE(metrics.is_sorted());
+    for(size_t i=1;i<metrics.size();++i)
+        EXPECT_LT(metrics[i-1].id(), metrics[i].id());
+    for(size_t i=0;i<metrics.size();++i)
+        EXPECT_EQ(metrics.find(metrics[i].lane(), metrics[i].tile(), metrics[i].cycle()), i);
+
+    metric_set<metric_t>::const_range_t tile = metrics.tile_range(1, 1101);
+    ASSERT_EQ(std::distance(tile.first, tile.second), 2);
+    EXPECT_EQ(tile.first->cycle(), 1u);
+    metric_set<metric_t>::const_range_t lane = metrics.lane_range(2);
+    EXPECT_EQ(std::distance(lane.first, lane.second), 2);
+    EXPECT_EQ(metrics.metrics_for_lane(1).size(), 3u);
+    EXPECT_EQ(metrics.tile_numbers_for_lane(1).size(), 2u);
+    lane = metrics.lane_range(3);
+    EXPECT_TRUE(lane.first == lane.second);
+
+    metrics.insert(metric_t(3, 1101, 1, 0.5f));
+    EXPECT_TRUE(metrics.is_sorted());
+    metrics.insert(metric_t(1, 1101, 3, 0.5f));
+    EXPECT_FALSE(metrics.is_sorted());
+}
 
+TEST(metric_set_test, lane_and_cycle_views)
+{
+    typedef metrics::error_metric metric_t;
+    metric_set<metric_t> metrics;
+    const metric_t::uint_t lanes[] = {2, 1, 2, 1, 1};
+    const metric_t::uint_t tiles[] = {1101, 1102, 1101, 1101, 1103};
+    const metric_t::uint_t cycles[] = {2, 1, 1, 2, 1};
+    for(size_t i=0;i<5;++i)
+        metrics.insert(metric_t(lanes[i], tiles[i], cycles[i], static_cast<float>(i)));
+
+    metric_set<metric_t>::view_t lane = metrics.lane_view(1);
+    ASSERT_EQ(lane.size(), 3u);
+    EXPECT_EQ(lane[0].tile(), 1102u);
+    EXPECT_EQ(lane.offset_at(2), 4u);
+    EXPECT_EQ(&lane.at(1), &metrics[3]);
+    EXPECT_THROW(lane.at(3), index_out_of_bounds_exception);
+    EXPECT_TRUE(metrics.lane_view(3).empty());
+    EXPECT_EQ(metrics.lanes().size(), 2u);
+    EXPECT_EQ(metrics.tile_numbers_for_lane(1).size(), 3u);
+
+    metric_set<metric_t>::view_t cycle = metrics.cycle_view(1);
+    ASSERT_EQ(cycle.size(), 3u);
+    size_t count = 0;
+    for(metric_set<metric_t>::view_t::const_iterator it = cycle.begin();it != cycle.end();++it, ++count)
+        EXPECT_EQ(it->cycle(), 1u);
+    EXPECT_EQ(count, 3u);
+    EXPECT_EQ(metrics.metrics_for_cycle(2).size(), 2u);
 
+    metrics.insert(metric_t(1, 1104, 3, 0.5f));
+    EXPECT_EQ(metrics.lane_view(1).size(), 4u);
+    EXPECT_EQ(metrics.cycles().size(), 3u);
+}
+
+TEST(metric_set_test, invalidate_views_after_in_place_change)
+{
+    typedef metrics::error_metric metric_t;
+    metric_set<metric_t> metrics;
+    metrics.insert(metric_t(1, 1101, 1, 0.5f));
+    metrics.insert(metric_t(1, 1102, 1, 0.25f));
+    EXPECT_EQ(metrics.lane_view(1).size(), 2u);
+
+    metrics[1].set_base(2, 1102, 1);
+    metrics.invalidate_views();
+    EXPECT_EQ(metrics.lane_view(1).size(), 1u);
+    ASSERT_EQ(metrics.lane_view(2).size(), 1u);
+    EXPECT_EQ(metrics.lane_view(2)[0].tile(), 1102u);
+}
+
+TEST(metric_set_test, try_get_missing_metric)
+{
+    typedef metrics::error_metric metric_t;
+    metric_set<metric_t> metrics;
+    metrics.insert(metric_t(1, 1101, 1, 0.5f));
+    metrics.insert(metric_t(1, 1102, 1, 0.25f));
+
+    const metric_set<metric_t>& const_metrics = metrics;
+    ASSERT_TRUE(const_metrics.try_get(1, 1102, 1) != 0);
+    EXPECT_EQ(const_metrics.try_get(1, 1102, 1), &metrics[1]);
+    EXPECT_EQ(const_metrics.try_get(metric_t::create_id(1, 1101, 1)), &metrics[0]);
+    EXPECT_TRUE(const_metrics.try_get(1, 1103, 1) == 0);
+    EXPECT_TRUE(const_metrics.try_get(2, 1101, 1) == 0);
+    EXPECT_THROW(const_metrics.get_metric(1, 1103, 1), index_out_of_bounds_exception);
+
+    metric_t* metric = metrics.try_get(1, 1101, 1);
+    ASSERT_TRUE(metric != 0);
+    EXPECT_EQ(&metrics.at_unchecked(0), metric);
+    EXPECT_EQ(&const_metrics.at_unchecked(1), &metrics.get_metric(1, 1102, 1));
+}
+
+TEST(metric_set_test, sort_keeps_each_metric_whole)
+{
+    typedef metrics::error_metric metric_t;
+    metric_set<metric_t> metrics;
+    const metric_t::uint_t cycle_count = 97;
+    for(metric_t::uint_t i=0;i<cycle_count;++i)
+    {
+        const metric_t::uint_t cycle = 1 + (i * 37) % cycle_count;
+        metrics.insert(metric_t(1 + cycle % 3, 1101, cycle, static_cast<float>(cycle)));
+    }
+    EXPECT_FALSE(metrics.is_sorted());
+
+    metrics.sort();
+    ASSERT_EQ(metrics.size(), static_cast<size_t>(cycle_count));
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        EXPECT_EQ(metrics[i].error_rate(), static_cast<float>(metrics[i].cycle())) << i;
+        EXPECT_EQ(metrics.find(metrics[i].lane(), metrics[i].tile(), metrics[i].cycle()), i);
+    }
+    for(size_t i=1;i<metrics.size();++i)
+        EXPECT_LT(metrics[i-1].id(), metrics[i].id());
+}
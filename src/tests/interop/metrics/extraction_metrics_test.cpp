@@ -80,6 +80,41 @@ TEST_P(extraction_metrics_tests, test_read_write)
 }
 
 
+/**
+ * @test Confirm the array accessors still return values that bind to a const std::vector reference
+ */
+TEST(extraction_metrics_test, array_accessors_return_vectors)
+{
+    extraction_metric_set metrics;
+    std::string data;
+    extraction_metric_v3::create_binary_data(data);
+    io::read_interop_from_string(data, metrics);
+    ASSERT_FALSE(metrics.empty());
+    const extraction_metric& metric = metrics.at(0);
+    const std::vector<float>& focus_scores = metric.focus_scores();
+    const std::vector< ::uint16_t >& max_intensity_values = metric.max_intensity_values();
+    ASSERT_EQ(metric.channel_count(), focus_scores.size());
+    ASSERT_EQ(metric.channel_count(), max_intensity_values.size());
+    for(size_t i=0;i<metric.channel_count();++i)
+    {
+        EXPECT_EQ(metric.focus_score_channels()[i], focus_scores[i]);
+        EXPECT_EQ(metric.max_intensity_channels()[i], max_intensity_values[i]);
+    }
+}
+
+/**
+ * @test Confirm a file with more channels than a record can hold is rejected as a bad format
+ */
+TEST(extraction_metrics_test, too_many_channels_is_bad_format)
+{
+    extraction_metric_set metrics;
+    std::string data;
+    extraction_metric_v3::create_binary_data(data);
+    data[2] = static_cast<char>(extraction_metric::MAX_CHANNELS+1);
+    EXPECT_THROW(io::read_interop_from_string(data, metrics), io::bad_format_exception);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Setup regression test
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
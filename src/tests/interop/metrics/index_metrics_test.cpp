@@ -65,10 +65,34 @@ TEST_P(index_metrics_tests, test_read_write)
             EXPECT_EQ(it_expected->indices(i).sample_id(), it_actual->indices(i).sample_id());
             EXPECT_EQ(it_expected->indices(i).sample_proj(), it_actual->indices(i).sample_proj());
             EXPECT_EQ(it_expected->indices(i).cluster_count(), it_actual->indices(i).cluster_count());
+            EXPECT_EQ(it_expected->indices(i).index_seq_id(), it_actual->indices(i).index_seq_id());
         }
     }
 }
 
+/**
+ * @test Confirm indexes repeated across tiles share the same string ids
+ */
+TEST(index_metrics_test, intern_strings)
+{
+    index_metric::index_array_t indices1;
+    indices1.push_back(index_info("ATCACGAC-AAGGTTCA", "1", "TSCAIndexes", 4570));
+    indices1.push_back(index_info("ACAGTGGT-AAGGTTCA", "2", "TSCAIndexes", 4477));
+    index_metric::index_array_t indices2;
+    indices2.push_back(index_info("ACAGTGGT-AAGGTTCA", "2", "TSCAIndexes", 4578));
+    index_metric_set metrics(static_cast< ::int16_t >(2));
+    metrics.insert(index_metric(1, 1101, 1, indices1));
+    metrics.insert(index_metric(1, 1102, 1, indices2));
+
+    EXPECT_EQ(metrics.at(0).indices(1).index_seq_id(), metrics.at(1).indices(0).index_seq_id());
+    EXPECT_EQ(metrics.at(0).indices(0).sample_proj_id(), metrics.at(1).indices(0).sample_proj_id());
+    EXPECT_NE(metrics.at(0).indices(0).index_seq_id(), metrics.at(0).indices(1).index_seq_id());
+    EXPECT_EQ(util::string_pool::at(metrics.at(1).indices(0).sample_id_id()), "2");
+    EXPECT_EQ(metrics.at(1).indices(0).index_seq(), "ACAGTGGT-AAGGTTCA");
+    EXPECT_EQ(index_info().index_seq(), "");
+    EXPECT_EQ(index_info().index_seq_id(), 0u);
+    EXPECT_LT(sizeof(index_info), 3*sizeof(std::string));
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Setup regression test
@@ -124,6 +124,126 @@ TEST(metric_stream_error_test, image_metric_out_of_bounds)
     EXPECT_THROW(io::write_metrics(fout, metric_set), io::bad_format_exception);
 }
 
+/** Confirm that records are decoded across chunk boundaries, and that a truncated last record is reported
+ */
+TEST(metric_stream_error_test, error_metric_chunked_read)
+{
+    typedef model::metrics::error_metric metric_t;
+    const size_t record_count = 2*util::progress_token::RecordChunk+3;
+    model::metric_base::metric_set<metric_t> expected;
+    expected.set_version(3);
+    for(size_t i=0;i<record_count;++i)
+    {
+        expected.insert(metric_t(1,
+                                 static_cast<metric_t::uint_t>(1101+i/100),
+                                 static_cast<metric_t::uint_t>(1+i%100),
+                                 static_cast<float>(i)));
+    }
+    std::ostringstream fout;
+    io::write_metrics(fout, expected);
+    const std::string buffer = fout.str();
+
+    model::metric_base::metric_set<metric_t> actual;
+    io::read_interop_from_string(buffer, actual);
+    ASSERT_EQ(actual.size(), record_count);
+    for(size_t i=0;i<record_count;++i)
+    {
+        EXPECT_EQ(actual[i].id(), expected[i].id());
+        EXPECT_EQ(actual[i].error_rate(), expected[i].error_rate());
+    }
+
+    model::metric_base::metric_set<metric_t> truncated;
+    EXPECT_THROW(io::read_interop_from_string(buffer.substr(0, buffer.size()-1), truncated),
+                 io::incomplete_file_exception);
+    EXPECT_EQ(truncated.size(), record_count-1);
+}
+
+/** Confirm that records out of id order are indexed, and that a repeated id overwrites the earlier record
+ */
+TEST(metric_stream_error_test, error_metric_read_out_of_order)
+{
+    typedef model::metrics::error_metric metric_t;
+    model::metric_base::metric_set<metric_t> first;
+    first.set_version(3);
+    first.insert(metric_t(1, 1101, 1, 0.25f));
+    first.insert(metric_t(1, 1102, 1, 0.5f));
+    model::metric_base::metric_set<metric_t> second;
+    second.set_version(3);
+    second.insert(metric_t(1, 1101, 2, 0.125f));
+    second.insert(metric_t(1, 1102, 1, 0.75f));
+    std::ostringstream first_out;
+    io::write_metrics(first_out, first);
+    std::ostringstream second_out;
+    io::write_metrics(second_out, second);
+    const size_t header_size = io::header_size(second);
+    const std::string buffer = first_out.str() + second_out.str().substr(header_size);
+
+    model::metric_base::metric_set<metric_t> actual;
+    io::read_interop_from_string(buffer, actual);
+    ASSERT_EQ(actual.size(), 3u);
+    EXPECT_EQ(actual.get_metric(1, 1101, 1).error_rate(), 0.25f);
+    EXPECT_EQ(actual.get_metric(1, 1101, 2).error_rate(), 0.125f);
+    EXPECT_EQ(actual.get_metric(1, 1102, 1).error_rate(), 0.75f);
+}
+
+/** Confirm that tile metric files decoded in bulk match the metrics written, for both multi-record versions
+ */
+TEST(metric_stream_error_test, tile_metric_bulk_read)
+{
+    typedef model::metrics::tile_metric metric_t;
+    const size_t tile_count = util::progress_token::RecordChunk/4;
+    for(::int16_t version=2;version<=3;++version)
+    {
+        model::metric_base::metric_set<metric_t> expected(metric_t::header_type(2.0f), version);
+        for(size_t i=0;i<tile_count;++i)
+        {
+            metric_t::read_metric_vector reads;
+            reads.push_back(model::metrics::read_metric(1, static_cast<float>(i%100)));
+            reads.push_back(model::metrics::read_metric(2, static_cast<float>(i%50)));
+            const float count = static_cast<float>(1000+i);
+            expected.insert(metric_t(static_cast<metric_t::uint_t>(1+i%2),
+                                     static_cast<metric_t::uint_t>(1101+i/2),
+                                     count/2.0f,
+                                     count/4.0f,
+                                     count,
+                                     count/2.0f,
+                                     reads));
+        }
+        std::ostringstream fout;
+        io::write_metrics(fout, expected);
+        std::string buffer = fout.str();
+        if(version == 2)
+        {
+            // Control lane record: lane 1, tile 5000, code 400
+            const char control_lane[] = {1, 0, char(0x88), 0x13, char(0x90), 1, 0, 0, 0, 0};
+            buffer.append(control_lane, sizeof(control_lane));
+        }
+
+        model::metric_base::metric_set<metric_t> actual;
+        io::read_interop_from_string(buffer, actual);
+        ASSERT_EQ(actual.size(), tile_count) << "Version: " << version;
+        for(size_t i=0;i<tile_count;++i)
+        {
+            EXPECT_EQ(actual[i].id(), expected[i].id());
+            EXPECT_EQ(actual[i].cluster_count(), expected[i].cluster_count());
+            EXPECT_EQ(actual[i].cluster_count_pf(), expected[i].cluster_count_pf());
+            EXPECT_EQ(actual[i].cluster_density(), expected[i].cluster_density());
+            EXPECT_EQ(actual[i].cluster_density_pf(), expected[i].cluster_density_pf());
+            ASSERT_EQ(actual[i].read_metrics().size(), expected[i].read_metrics().size());
+            for(size_t r=0;r<actual[i].read_metrics().size();++r)
+            {
+                EXPECT_EQ(actual[i].read_metrics()[r].read(), expected[i].read_metrics()[r].read());
+                EXPECT_EQ(actual[i].read_metrics()[r].percent_aligned(),
+                          expected[i].read_metrics()[r].percent_aligned());
+            }
+        }
+
+        model::metric_base::metric_set<metric_t> truncated;
+        EXPECT_THROW(io::read_interop_from_string(buffer.substr(0, buffer.size()-1), truncated),
+                     io::incomplete_file_exception);
+    }
+}
+
 REGISTER_TYPED_TEST_CASE_P(metric_stream_error_test,
         test_hardcoded_bad_format_exception,
         test_hardcoded_incomplete_file_exception,
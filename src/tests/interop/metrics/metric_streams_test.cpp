@@ -14,12 +14,44 @@
 #include <gtest/gtest.h>
 #include "interop/io/metric_stream.h"
 #include "interop/io/metric_file_stream.h"
+#include "interop/io/record_reader.h"
 #include "src/tests/interop/metrics/inc/metric_format_fixtures.h"
 
 using namespace illumina::interop;
 using namespace illumina::interop::unittest;
 
 
+namespace
+{
+    /** Get the number of channel names required to write a header as text
+     *
+     * @return 4 for headers without a channel count
+     */
+    template<class Header>
+    size_t channel_count(const Header&)
+    {
+        return 4;
+    }
+    /** Get the number of channel names required to write a header as text
+     *
+     * @param header extraction metric header
+     * @return number of channels
+     */
+    size_t channel_count(const model::metrics::extraction_metric::header_type& header)
+    {
+        return header.channel_count();
+    }
+    /** Get the number of channel names required to write a header as text
+     *
+     * @param header image metric header
+     * @return number of channels
+     */
+    size_t channel_count(const model::metrics::image_metric::header_type& header)
+    {
+        return header.channel_count();
+    }
+}
+
 /** Fixture for expected vs actual binary data */
 template<typename TestSetup>
 struct metric_stream_test : public ::testing::Test, public TestSetup
@@ -95,6 +127,121 @@ TYPED_TEST_P(metric_stream_test, test_write_data_size)
     EXPECT_NO_THROW(io::write_interop_to_buffer(metrics, &buffer.front(), buffer.size()));
 }
 
+/** Confirm encoding directly into a buffer or a mapped file matches the stream writer
+ */
+TYPED_TEST_P(metric_stream_test, test_write_direct)
+{
+    typename TypeParam::metric_set_t metrics;
+    TypeParam::create_expected(metrics);
+    std::vector< ::uint8_t > buffer(TestFixture::actual.size());
+    ASSERT_EQ(io::write_interop_to_buffer(metrics, &buffer.front(), buffer.size()), buffer.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), TestFixture::actual);
+    EXPECT_THROW(io::write_interop_to_buffer(metrics, &buffer.front(), buffer.size()-1), io::invalid_argument);
+
+    const std::string run_folder = "metric_stream_test_mapped";
+    io::mkdir(run_folder);
+    io::mkdir(io::combine(run_folder, "InterOp"));
+    EXPECT_TRUE(io::write_interop_mapped(run_folder, metrics));
+    const std::string file_name = io::paths::interop_filename<typename TypeParam::metric_set_t>(run_folder);
+    std::ifstream fin(file_name.c_str(), std::ios::binary);
+    std::ostringstream sout;
+    sout << fin.rdbuf();
+    EXPECT_EQ(sout.str(), TestFixture::actual);
+}
+
+/** Confirm streaming text one record at a time matches writing the loaded metric set as text
+ */
+TYPED_TEST_P(metric_stream_test, test_stream_text)
+{
+    typename TypeParam::metric_set_t metrics;
+    io::read_interop_from_string(TestFixture::expected, metrics);
+    typedef typename TypeParam::metric_set_t::header_type header_t;
+    std::vector<std::string> channels(channel_count(static_cast<const header_t&>(metrics)), "Channel");
+    std::ostringstream expected_out;
+    if(!metrics.empty()) io::write_text(expected_out, metrics, channels);
+
+    typename TypeParam::metric_set_t scratch;
+    std::istringstream in(TestFixture::expected);
+    std::ostringstream actual_out;
+    const size_t record_count = io::stream_text(in, actual_out, scratch, channels);
+    EXPECT_EQ(record_count, metrics.size());
+    EXPECT_TRUE(scratch.empty());
+    EXPECT_EQ(actual_out.str(), expected_out.str());
+}
+
+/** Confirm the record reader yields the same metrics as reading the whole buffer
+ */
+TYPED_TEST_P(metric_stream_test, test_record_reader)
+{
+    typedef typename TestFixture::metric_t metric_t;
+    typename TypeParam::metric_set_t metrics;
+    io::read_interop_from_string(TestFixture::expected, metrics);
+
+    const ::uint8_t* buffer = reinterpret_cast<const ::uint8_t*>(TestFixture::expected.c_str());
+    io::record_reader<typename TypeParam::metric_set_t> reader(buffer, TestFixture::expected.size());
+    EXPECT_EQ(reader.version(), metrics.version());
+    for(size_t i=0;i<metrics.size();++i)
+    {
+        ASSERT_TRUE(reader.next()) << "i= " << i;
+        EXPECT_EQ(reader.record().id(), metrics[i].id());
+        std::ostringstream expected_out;
+        std::ostringstream actual_out;
+        io::write_metric(expected_out, metrics[i], metrics, metrics.version());
+        io::write_metric<metric_t>(actual_out, reader.record(), reader.header(), reader.version());
+        EXPECT_EQ(actual_out.str(), expected_out.str()) << "i= " << i;
+    }
+    EXPECT_FALSE(reader.next());
+    EXPECT_EQ(reader.record_count(), metrics.size());
+}
+
+TEST(metric_stream_test, record_reader_missing_file)
+{
+    io::record_reader<model::metric_base::metric_set<model::metrics::error_metric> > reader;
+    EXPECT_FALSE(reader.next());
+    EXPECT_THROW(reader.open(io::combine("missing_run_folder", "ErrorMetricsOut.bin")), io::file_not_found_exception);
+}
+
+TEST(metric_stream_test, record_reader_truncated_record)
+{
+    typedef model::metric_base::metric_set<model::metrics::error_metric> error_metric_set_t;
+    std::string data;
+    error_metric_v3::create_binary_data(data);
+    error_metric_set_t metrics;
+    io::read_interop_from_string(data, metrics);
+    ASSERT_GT(metrics.size(), 1u);
+    data.resize(data.size()-1);
+
+    io::record_reader<error_metric_set_t> reader(reinterpret_cast<const ::uint8_t*>(data.c_str()), data.size());
+    for(size_t i=0;i+1<metrics.size();++i)
+    {
+        ASSERT_TRUE(reader.next()) << "i= " << i;
+        EXPECT_EQ(reader.record().id(), metrics[i].id());
+    }
+    EXPECT_THROW(reader.next(), io::incomplete_file_exception);
+}
+
+/** Confirm consecutive records of a multi-record metric are merged into a single metric
+ */
+TEST(metric_stream_test, record_reader_multi_record_runs)
+{
+    typedef model::metric_base::metric_set<model::metrics::tile_metric> tile_metric_set_t;
+    std::string data;
+    tile_metric_v2::create_binary_data(data);
+    tile_metric_set_t metrics;
+    io::read_interop_from_string(data, metrics);
+
+    io::record_reader<tile_metric_set_t> reader(reinterpret_cast<const ::uint8_t*>(data.c_str()), data.size());
+    size_t record_count = 0;
+    while(reader.next())
+    {
+        ASSERT_LT(record_count, metrics.size());
+        EXPECT_EQ(reader.record().id(), metrics[record_count].id());
+        EXPECT_EQ(reader.record().cluster_count(), metrics[record_count].cluster_count());
+        ++record_count;
+    }
+    EXPECT_EQ(record_count, metrics.size());
+}
+
 TEST(metric_stream_test, list_filenames)
 {
     std::vector<std::string> error_metric_files;
@@ -112,7 +259,10 @@ REGISTER_TYPED_TEST_CASE_P(metric_stream_test,
                            test_read_data_size,
                            test_header_size,
                            test_write_read_binary_data,
-                           test_write_data_size
+                           test_write_data_size,
+                           test_stream_text,
+                           test_record_reader,
+                           test_write_direct
 );
 
 
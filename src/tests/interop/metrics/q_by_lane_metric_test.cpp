@@ -105,3 +105,26 @@ TEST(run_metrics_q_by_lane_test, try_write_binned_as_unbinned)
                  io::bad_format_exception);
 
 }
+
+// Test that finalizing a run computes the q-score suffix sums used by threshold queries
+TEST(run_metrics_q_by_lane_test, finalize_computes_suffix_sums)
+{
+    run_metrics metrics;
+    model::run::info run_info;
+    const model::run::read_info read_array[]={
+            model::run::read_info(1, 1, 4, false)
+    };
+    hiseq4k_run_info::create_expected(run_info, util::to_vector(read_array));
+    q_metric_v6::create_expected(metrics.get<q_metric>());
+    metrics.run_info(run_info);
+    metrics.finalize_after_load();
+
+    ASSERT_GT(metrics.get<q_metric>().size(), 0u);
+    ASSERT_GT(metrics.get<q_by_lane_metric>().size(), 0u);
+    const q_metric& metric = metrics.get<q_metric>().at(0);
+    EXPECT_TRUE(metric.has_suffix_sums());
+    EXPECT_TRUE(metrics.get<q_by_lane_metric>().at(0).has_suffix_sums());
+    const q_metric unsummed(metric.lane(), metric.tile(), metric.cycle(), metric.qscore_hist());
+    EXPECT_FALSE(unsummed.has_suffix_sums());
+    EXPECT_EQ(metric.total_over_qscore(2), unsummed.total_over_qscore(2));
+}
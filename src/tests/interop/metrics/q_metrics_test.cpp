@@ -171,6 +171,42 @@ TEST(q_metrics_test, test_percent_over_q30_binned)
     EXPECT_EQ(metric.percent_over_qscore(header.index_for_q_value(30)), 50);
 }
 
+TEST(q_metrics_test, test_suffix_sums_match_histogram)
+{
+    q_metric::uint32_vector data1(50), data2(50);
+    for(size_t i=0;i<data1.size();++i)
+    {
+        data1[i] = static_cast< ::uint32_t >(i % 7);
+        data2[i] = static_cast< ::uint32_t >((i * 3) % 11);
+    }
+    const q_metric expected1(1, 1101, 1, data1);
+    const q_metric expected2(1, 1101, 2, data2);
+    std::vector<q_metric> q_metric_vec;
+    q_metric_vec.push_back(expected1);
+    q_metric_vec.push_back(expected2);
+    metric_set<q_metric> q_metric_set(q_metric_vec, 6, q_metric::header_type());
+    logic::metric::populate_cumulative_distribution(q_metric_set);
+    EXPECT_FALSE(q_metric_set.get_metric(1, 1101, 2).has_suffix_sums());
+    const ::uint64_t cumulative_q30 = q_metric_set.get_metric(1, 1101, 2).total_over_qscore_cumulative(29);
+    logic::metric::populate_qscore_suffix_sums(q_metric_set);
+    const q_metric& actual1 = q_metric_set.get_metric(1, 1101, 1);
+    const q_metric& actual2 = q_metric_set.get_metric(1, 1101, 2);
+    ASSERT_TRUE(actual2.has_suffix_sums());
+    EXPECT_EQ(actual2.total_over_qscore_cumulative(29), cumulative_q30);
+
+    EXPECT_EQ(actual2.sum_qscore(), expected2.sum_qscore());
+    for(size_t index=0;index<=data2.size();++index)
+    {
+        EXPECT_EQ(actual2.total_over_qscore(index), expected2.total_over_qscore(index));
+        EXPECT_EQ(actual2.total_over_qscore_cumulative(index),
+                  static_cast< ::uint64_t >(expected1.total_over_qscore(index) + expected2.total_over_qscore(index)));
+    }
+    q_metric::qscore_bin_vector_type bins;
+    for(size_t i=0;i<data2.size();++i) bins.push_back(q_score_bin(0, 0, static_cast<q_score_bin::bin_type>(i+1)));
+    EXPECT_EQ(actual2.total_over_qscore_cumulative(30, bins), actual2.total_over_qscore_cumulative(29));
+    EXPECT_EQ(actual1.total_over_qscore_cumulative(29), expected1.total_over_qscore(29));
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Setup regression test
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
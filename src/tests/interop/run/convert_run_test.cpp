@@ -0,0 +1,138 @@
+/** Unit tests for the run converter
+ *
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include "interop/io/convert_run.h"
+#include "interop/io/metric_file_stream.h"
+#include "interop/io/synthetic_run.h"
+#include "interop/logic/summary/run_summary.h"
+#include "interop/model/run_metrics.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::model::metrics;
+
+namespace
+{
+    /** Find a file in the list of converted files
+     *
+     * @param converted list of converted files
+     * @param filename path to the file
+     * @return pointer to the file description, or null if not found
+     */
+    const io::converted_interop* find_file(const io::converted_interop_vector& converted, const std::string& filename)
+    {
+        for(size_t i=0;i<converted.size();++i)
+            if(converted[i].filename == filename) return &converted[i];
+        return 0;
+    }
+    /** Summarize a run folder
+     *
+     * @param run_folder run folder path
+     * @param summary destination run summary
+     */
+    void summarize_run(const std::string& run_folder, model::summary::run_summary& summary)
+    {
+        run_metrics run;
+        run.read(run_folder);
+        logic::summary::summarize_run_metrics(run, summary);
+    }
+    /** Rewrite the q-metrics of a run as legacy version 4 q-metrics without bins in the header
+     *
+     * @param run_folder run folder path
+     */
+    void write_legacy_q_metrics(const std::string& run_folder)
+    {
+        run_metrics run;
+        run.read(run_folder);
+        const model::metric_base::metric_set<q_metric>& binned = run.get<q_metric>();
+        model::metric_base::metric_set<q_metric> legacy(static_cast< ::int16_t >(4));
+        for(size_t i=0;i<binned.size();++i)
+        {
+            std::vector< ::uint32_t > hist(q_metric::MAX_Q_BINS, 0);
+            for(size_t b=0;b<binned.bin_count();++b)
+                hist[binned.bin_at(b).value()-1] = binned.at(i).qscore_hist(b);
+            legacy.insert(q_metric(binned.at(i).lane(), binned.at(i).tile(), binned.at(i).cycle(), hist));
+        }
+        io::write_interop(run_folder, legacy, true, 4);
+        std::ofstream fout(io::combine(run_folder, "RunParameters.xml").c_str());
+        fout << "<?xml version=\"1.0\"?>\n<RunParameters><Setup><ApplicationName>MiSeq Control Software"
+                "</ApplicationName></Setup></RunParameters>\n";
+    }
+}
+
+TEST(convert_run_test, lossless_versions)
+{
+    const std::string run_folder = "synthetic_run_test_convert";
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 12, 2);
+    io::write_synthetic_run(run_folder, run_info, io::synthetic_run_options(31));
+    size_t error_count;
+    {
+        run_metrics run;
+        run.read(run_folder);
+        error_count = run.get<error_metric>().size();
+        io::write_interop(run_folder, run.get<error_metric>(), true, 3);
+        io::write_interop(run_folder, run.get<image_metric>(), true, 1);
+        io::write_interop(run_folder, run.get<extraction_metric>(), true, 2);
+    }
+    model::summary::run_summary expected;
+    summarize_run(run_folder, expected);
+
+    io::converted_interop_vector converted;
+    io::convert_run(run_folder, converted, 2);
+    const io::converted_interop* error_file = find_file(converted, io::paths::interop_filename<error_metric>(run_folder));
+    ASSERT_TRUE(error_file != 0);
+    EXPECT_EQ(error_file->source_version, 3);
+    EXPECT_EQ(error_file->target_version, io::latest_version<error_metric>());
+    EXPECT_EQ(error_file->record_count, error_count);
+    const io::converted_interop* image_file = find_file(converted, io::paths::interop_filename<image_metric>(run_folder));
+    ASSERT_TRUE(image_file != 0);
+    EXPECT_TRUE(image_file->is_rewritten());
+    const io::converted_interop* extraction_file =
+            find_file(converted, io::paths::interop_filename<extraction_metric>(run_folder));
+    ASSERT_TRUE(extraction_file != 0);
+    EXPECT_FALSE(extraction_file->is_rewritten());
+    EXPECT_FALSE(io::is_file_readable(io::paths::interop_filename<error_metric>(run_folder)+".tmp"));
+
+    run_metrics run;
+    run.read(run_folder);
+    EXPECT_EQ(run.get<error_metric>().version(), io::latest_version<error_metric>());
+    EXPECT_EQ(run.get<extraction_metric>().version(), 2);
+    model::summary::run_summary actual;
+    logic::summary::summarize_run_metrics(run, actual);
+    EXPECT_NEAR(actual.total_summary().error_rate(), expected.total_summary().error_rate(), 1e-5);
+    EXPECT_NEAR(actual.total_summary().first_cycle_intensity(), expected.total_summary().first_cycle_intensity(), 1e-5);
+    EXPECT_NEAR(actual.total_summary().percent_gt_q30(), expected.total_summary().percent_gt_q30(), 1e-5);
+}
+
+TEST(convert_run_test, legacy_q_metrics_binned)
+{
+    const std::string run_folder = "synthetic_run_test_convert_legacy";
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 12, 2);
+    io::write_synthetic_run(run_folder, run_info, io::synthetic_run_options(32));
+    write_legacy_q_metrics(run_folder);
+    model::summary::run_summary expected;
+    summarize_run(run_folder, expected);
+
+    io::converted_interop_vector converted;
+    io::convert_run(run_folder, converted);
+    const io::converted_interop* q_file = find_file(converted, io::paths::interop_filename<q_metric>(run_folder));
+    ASSERT_TRUE(q_file != 0);
+    EXPECT_EQ(q_file->source_version, 4);
+    EXPECT_EQ(q_file->target_version, io::latest_version<q_metric>());
+
+    run_metrics run;
+    run.read(run_folder);
+    EXPECT_EQ(run.get<q_metric>().version(), io::latest_version<q_metric>());
+    EXPECT_EQ(run.get<q_metric>().bin_count(), 7u);
+    model::summary::run_summary actual;
+    logic::summary::summarize_run_metrics(run, actual);
+    EXPECT_NEAR(actual.total_summary().percent_gt_q30(), expected.total_summary().percent_gt_q30(), 1e-5);
+    EXPECT_NEAR(actual.total_summary().yield_g(), expected.total_summary().yield_g(), 1e-5);
+}
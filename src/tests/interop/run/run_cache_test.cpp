@@ -0,0 +1,150 @@
+/** Unit tests for the run cache
+ *
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "interop/io/run_cache.h"
+#include "interop/io/paths.h"
+#include "interop/io/synthetic_run.h"
+#include "interop/logic/summary/run_summary.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::model::metrics;
+
+namespace
+{
+    /** Copy the content of one file over another
+     *
+     * @param source source file
+     * @param destination destination file
+     */
+    void copy_file(const std::string& source, const std::string& destination)
+    {
+        std::ifstream fin(source.c_str(), std::ios::binary);
+        std::ostringstream sout;
+        sout << fin.rdbuf();
+        std::ofstream fout(destination.c_str(), std::ios::binary);
+        fout << sout.str();
+    }
+    /** Write a small synthetic run
+     *
+     * @param run_folder destination run folder
+     * @param seed seed of the random number generator
+     */
+    void write_cache_run(const std::string& run_folder, const size_t seed)
+    {
+        const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 44, 2);
+        io::write_synthetic_run(run_folder, run_info, io::synthetic_run_options(seed));
+    }
+}
+
+TEST(run_cache_test, hits_and_loads)
+{
+    write_cache_run("synthetic_run_test_cache1", 21);
+    io::run_cache cache(0, 1, 1000);
+    const run_metrics& run = cache.get("synthetic_run_test_cache1");
+    EXPECT_FALSE(run.empty());
+    EXPECT_EQ(&cache.get("synthetic_run_test_cache1/"), &run);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_GT(cache.resident_bytes(), 0u);
+    EXPECT_EQ(cache.statistics().load_count, 1u);
+    EXPECT_EQ(cache.statistics().hit_count, 1u);
+    EXPECT_FALSE(cache.refresh("synthetic_run_test_cache1"));
+    EXPECT_TRUE(cache.evict("synthetic_run_test_cache1"));
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.resident_bytes(), 0u);
+}
+
+TEST(run_cache_test, failed_load_not_cached)
+{
+    io::run_cache cache;
+    EXPECT_THROW(cache.get("synthetic_run_test_cache_missing"), xml::xml_file_not_found_exception);
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(cache.contains("synthetic_run_test_cache_missing"));
+}
+
+TEST(run_cache_test, refresh_reloads_changed_group)
+{
+    write_cache_run("synthetic_run_test_cache2", 22);
+    write_cache_run("synthetic_run_test_cache3", 23);
+    io::run_cache cache(0, 1, 1000);
+    model::summary::run_summary before;
+    logic::summary::summarize_run_metrics(cache.get("synthetic_run_test_cache2"), before);
+
+    copy_file(io::paths::interop_filename<q_metric>("synthetic_run_test_cache3"),
+              io::paths::interop_filename<q_metric>("synthetic_run_test_cache2"));
+    EXPECT_TRUE(cache.refresh("synthetic_run_test_cache2"));
+    EXPECT_EQ(cache.statistics().refresh_count, 1u);
+
+    run_metrics expected;
+    expected.read("synthetic_run_test_cache2");
+    const run_metrics& actual = cache.get("synthetic_run_test_cache2");
+    ASSERT_EQ(actual.get<q_metric>().size(), expected.get<q_metric>().size());
+    EXPECT_EQ(actual.get<q_collapsed_metric>().size(), expected.get<q_collapsed_metric>().size());
+    EXPECT_EQ(actual.get<q_by_lane_metric>().size(), expected.get<q_by_lane_metric>().size());
+    for(size_t i=0;i<expected.get<q_metric>().size();++i)
+        EXPECT_EQ(actual.get<q_metric>().at(i).qscore_hist(), expected.get<q_metric>().at(i).qscore_hist());
+    model::summary::run_summary after;
+    logic::summary::summarize_run_metrics(actual, after);
+    model::summary::run_summary expected_summary;
+    logic::summary::summarize_run_metrics(expected, expected_summary);
+    EXPECT_NEAR(after.total_summary().percent_gt_q30(), expected_summary.total_summary().percent_gt_q30(), 1e-4);
+    EXPECT_NE(after.total_summary().percent_gt_q30(), before.total_summary().percent_gt_q30());
+}
+
+TEST(run_cache_test, least_recently_used_evicted)
+{
+    write_cache_run("synthetic_run_test_cache4", 24);
+    write_cache_run("synthetic_run_test_cache5", 25);
+    io::run_cache unlimited;
+    unlimited.get("synthetic_run_test_cache4");
+    const ::uint64_t run_bytes = unlimited.resident_bytes();
+
+    io::run_cache cache(run_bytes + run_bytes/2);
+    cache.get("synthetic_run_test_cache4");
+    cache.get("synthetic_run_test_cache5");
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_FALSE(cache.contains("synthetic_run_test_cache4"));
+    EXPECT_TRUE(cache.contains("synthetic_run_test_cache5"));
+    EXPECT_EQ(cache.statistics().eviction_count, 1u);
+
+    io::run_cache::string_vector runs;
+    unlimited.get("synthetic_run_test_cache5");
+    unlimited.get("synthetic_run_test_cache4");
+    unlimited.list_runs(runs);
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0], "synthetic_run_test_cache4");
+    unlimited.memory_budget(run_bytes + run_bytes/2);
+    EXPECT_EQ(unlimited.size(), 1u);
+    EXPECT_TRUE(unlimited.contains("synthetic_run_test_cache4"));
+}
+
+
+TEST(run_cache_test, refresh_keeps_derived_phasing)
+{
+    // Dynamic phasing is only derived for reads of at least 25 cycles
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 70, 2);
+    io::write_synthetic_run("synthetic_run_test_cache6", run_info, io::synthetic_run_options(26));
+    io::write_synthetic_run("synthetic_run_test_cache7", run_info, io::synthetic_run_options(27));
+    io::run_cache cache(0, 1, 1000);
+    const size_t dynamic_phasing_count = cache.get("synthetic_run_test_cache6").get<dynamic_phasing_metric>().size();
+    ASSERT_GT(dynamic_phasing_count, 0u);
+
+    copy_file(io::paths::interop_filename<error_metric>("synthetic_run_test_cache7"),
+              io::paths::interop_filename<error_metric>("synthetic_run_test_cache6"));
+    EXPECT_TRUE(cache.refresh("synthetic_run_test_cache6"));
+    const run_metrics& actual = cache.get("synthetic_run_test_cache6");
+    EXPECT_EQ(actual.get<dynamic_phasing_metric>().size(), dynamic_phasing_count);
+
+    run_metrics expected;
+    expected.read("synthetic_run_test_cache6");
+    EXPECT_EQ(actual.get<error_metric>().size(), expected.get<error_metric>().size());
+    EXPECT_EQ(actual.get<dynamic_phasing_metric>().size(), expected.get<dynamic_phasing_metric>().size());
+}
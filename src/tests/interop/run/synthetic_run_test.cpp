@@ -0,0 +1,296 @@
+/** Unit tests for the synthetic run generator
+ *
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "interop/io/synthetic_run.h"
+#include "interop/io/paths.h"
+#include "interop/util/filesystem.h"
+#include "interop/model/run_metrics.h"
+#include "interop/logic/summary/run_summary.h"
+#include "interop/logic/table/create_imaging_table.h"
+#include "interop/logic/plot/plot_flowcell_map.h"
+#include "interop/util/thread_pool.h"
+
+using namespace illumina::interop;
+using namespace illumina::interop::model::metrics;
+
+namespace
+{
+    /** Read the content of a binary file
+     *
+     * @param filename name of the file
+     * @return content of the file
+     */
+    std::string read_file(const std::string& filename)
+    {
+        std::ifstream fin(filename.c_str(), std::ios::binary);
+        std::ostringstream sout;
+        sout << fin.rdbuf();
+        return sout.str();
+    }
+}
+
+TEST(synthetic_run_test, run_info_layout)
+{
+    const model::run::info run_info = io::synthetic_run_info(2, 2, 3, 4, 60, 4);
+    EXPECT_EQ(run_info.flowcell().lane_count(), 2u);
+    EXPECT_EQ(run_info.flowcell().surface_count(), 2u);
+    EXPECT_EQ(run_info.flowcell().swath_count(), 3u);
+    EXPECT_EQ(run_info.flowcell().tile_count(), 4u);
+    EXPECT_EQ(run_info.total_cycles(), 60u);
+    EXPECT_EQ(run_info.channels().size(), 4u);
+    EXPECT_TRUE(run_info.is_indexed());
+    EXPECT_THROW(io::synthetic_run_info(1, 3, 1, 1, 10, 2), model::invalid_parameter);
+}
+
+TEST(synthetic_run_test, write_and_read_back)
+{
+    const model::run::info run_info = io::synthetic_run_info(2, 1, 2, 3, 44, 2);
+    const size_t tile_count = 2*1*2*3;
+    const std::string run_folder = "synthetic_run_test";
+    io::synthetic_run_options options(7);
+    options.thread_count = 2;
+    const ::uint64_t byte_count = io::write_synthetic_run(run_folder, run_info, options);
+    EXPECT_GT(byte_count, 0u);
+
+    run_metrics run;
+    run.read(run_folder);
+    EXPECT_EQ(run.run_info().total_cycles(), 44u);
+    EXPECT_EQ(run.get<tile_metric>().size(), tile_count);
+    EXPECT_EQ(run.get<extraction_metric>().size(), tile_count*44);
+    EXPECT_EQ(run.get<image_metric>().size(), tile_count*44);
+    EXPECT_EQ(run.get<corrected_intensity_metric>().size(), tile_count*44);
+    EXPECT_EQ(run.get<q_metric>().size(), tile_count*44);
+    EXPECT_EQ(run.get<phasing_metric>().size(), tile_count*44);
+    EXPECT_EQ(run.get<error_metric>().size(), tile_count*(44-8));
+    EXPECT_EQ(run.get<index_metric>().size(), tile_count);
+    EXPECT_EQ(run.get<index_metric>().at(0).indices().size(), options.sample_count);
+    EXPECT_EQ(run.get<q_metric>().bin_count(), options.bin_count);
+}
+
+TEST(synthetic_run_test, parallel_write_keeps_exception_type)
+{
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 10, 2);
+    const std::string run_folder = "synthetic_run_test_blocked";
+    io::mkdir(run_folder);
+    io::mkdir(io::dirname(io::paths::interop_filename<extraction_metric>(run_folder)));
+    // A directory in place of the file makes the extraction task fail to open it
+    io::mkdir(io::paths::interop_filename<extraction_metric>(run_folder));
+    io::synthetic_run_options options(7);
+    options.thread_count = 2;
+    EXPECT_THROW(io::write_synthetic_run(run_folder, run_info, options), io::file_not_found_exception);
+}
+
+TEST(synthetic_run_test, same_seed_same_files)
+{
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 12, 2);
+    io::synthetic_run_options options(3);
+    options.thread_count = 1;
+    io::write_synthetic_run("synthetic_run_test_serial", run_info, options);
+    options.thread_count = 4;
+    io::write_synthetic_run("synthetic_run_test_parallel", run_info, options);
+    EXPECT_EQ(read_file(io::paths::interop_filename<q_metric>("synthetic_run_test_serial")),
+              read_file(io::paths::interop_filename<q_metric>("synthetic_run_test_parallel")));
+    EXPECT_EQ(read_file(io::paths::interop_filename<extraction_metric>("synthetic_run_test_serial")),
+              read_file(io::paths::interop_filename<extraction_metric>("synthetic_run_test_parallel")));
+}
+
+TEST(synthetic_run_test, by_cycle_matches_aggregate)
+{
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 12, 2);
+    io::synthetic_run_options options(5);
+    io::write_synthetic_run("synthetic_run_test_aggregate", run_info, options);
+    options.by_cycle = true;
+    io::write_synthetic_run("synthetic_run_test_by_cycle", run_info, options);
+    EXPECT_TRUE(io::is_file_readable(io::paths::interop_filename<q_metric>("synthetic_run_test_by_cycle", static_cast<size_t>(12))));
+
+    run_metrics aggregate;
+    aggregate.read("synthetic_run_test_aggregate");
+    run_metrics by_cycle;
+    by_cycle.read("synthetic_run_test_by_cycle");
+    ASSERT_EQ(aggregate.get<q_metric>().size(), by_cycle.get<q_metric>().size());
+    ASSERT_EQ(aggregate.get<tile_metric>().size(), by_cycle.get<tile_metric>().size());
+    for(size_t i=0;i<aggregate.get<q_metric>().size();++i)
+    {
+        const q_metric& expected = aggregate.get<q_metric>().at(i);
+        const q_metric& actual = by_cycle.get<q_metric>().get_metric(expected.lane(), expected.tile(), expected.cycle());
+        EXPECT_EQ(expected.qscore_hist(), actual.qscore_hist());
+    }
+}
+TEST(synthetic_run_test, parallel_read_matches_serial)
+{
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 12, 2);
+    io::synthetic_run_options options(7);
+    options.by_cycle = true;
+    io::write_synthetic_run("synthetic_run_test_read_by_cycle", run_info, options);
+
+    run_metrics serial;
+    serial.read("synthetic_run_test_read_by_cycle", 1);
+    run_metrics parallel;
+    parallel.read("synthetic_run_test_read_by_cycle", 4);
+    ASSERT_EQ(serial.get<q_metric>().size(), parallel.get<q_metric>().size());
+    ASSERT_EQ(serial.get<q_collapsed_metric>().size(), parallel.get<q_collapsed_metric>().size());
+    ASSERT_EQ(serial.get<extraction_metric>().size(), parallel.get<extraction_metric>().size());
+    for(size_t i=0;i<serial.get<q_metric>().size();++i)
+    {
+        const q_metric& expected = serial.get<q_metric>().at(i);
+        const q_metric& actual = parallel.get<q_metric>().at(i);
+        EXPECT_EQ(expected.id(), actual.id());
+        EXPECT_EQ(expected.qscore_hist(), actual.qscore_hist());
+        EXPECT_EQ(expected.sum_qscore_cumulative(), actual.sum_qscore_cumulative());
+    }
+}
+TEST(synthetic_run_test, parallel_write_matches_serial)
+{
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 1, 2, 12, 2);
+    io::write_synthetic_run("synthetic_run_test_source", run_info, io::synthetic_run_options(9));
+    run_metrics run;
+    run.read("synthetic_run_test_source");
+
+    const std::string serial = "synthetic_run_test_write_serial";
+    const std::string parallel = "synthetic_run_test_write_parallel";
+    io::mkdir(serial);
+    io::mkdir(io::combine(serial, "InterOp"));
+    io::mkdir(parallel);
+    io::mkdir(io::combine(parallel, "InterOp"));
+    run.write_metrics(serial, 1);
+    run.write_metrics(parallel, 4);
+    EXPECT_EQ(read_file(io::paths::interop_filename<q_metric>(serial)),
+              read_file(io::paths::interop_filename<q_metric>(parallel)));
+    EXPECT_EQ(read_file(io::paths::interop_filename<tile_metric>(serial)),
+              read_file(io::paths::interop_filename<tile_metric>(parallel)));
+    EXPECT_EQ(read_file(io::paths::interop_filename<index_metric>(serial)),
+              read_file(io::paths::interop_filename<index_metric>(parallel)));
+    EXPECT_EQ(read_file(io::paths::interop_filename<extraction_metric>("synthetic_run_test_source")),
+              read_file(io::paths::interop_filename<extraction_metric>(parallel)));
+}
+
+TEST(synthetic_run_test, progress_counts_bytes_and_records)
+{
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 2, 2, 12, 2);
+    io::write_synthetic_run("synthetic_run_test_progress", run_info, io::synthetic_run_options(3));
+    for(size_t thread_count=1;thread_count<=4;thread_count+=3)
+    {
+        util::progress_token progress;
+        run_metrics run;
+        run.read("synthetic_run_test_progress", thread_count, &progress);
+        const std::string q_file = io::paths::interop_filename<q_metric>("synthetic_run_test_progress");
+        EXPECT_EQ(progress.records(constants::Q), run.get<q_metric>().size());
+        EXPECT_EQ(progress.bytes(constants::Q), static_cast< ::uint64_t >(io::file_size(q_file)));
+        EXPECT_EQ(progress.records(constants::Extraction), run.get<extraction_metric>().size());
+        EXPECT_GT(progress.total_bytes(), progress.bytes(constants::Q));
+
+        progress.reset();
+        EXPECT_EQ(progress.total_records(), 0u);
+        model::summary::run_summary summary;
+        logic::summary::summarize_run_metrics(run, summary, false, true, &progress);
+        EXPECT_EQ(progress.records(constants::Error), run.get<error_metric>().size());
+    }
+}
+
+TEST(synthetic_run_test, cancelled_read_releases_metrics)
+{
+    const model::run::info run_info = io::synthetic_run_info(1, 1, 2, 2, 12, 2);
+    io::write_synthetic_run("synthetic_run_test_cancel", run_info, io::synthetic_run_options(5));
+    for(size_t thread_count=1;thread_count<=4;thread_count+=3)
+    {
+        util::progress_token progress;
+        progress.cancel();
+        run_metrics run;
+        EXPECT_THROW(run.read("synthetic_run_test_cancel", thread_count, &progress),
+                     util::operation_cancelled_exception);
+        EXPECT_TRUE(run.empty());
+        EXPECT_EQ(run.get<q_metric>().capacity(), 0u);
+    }
+
+    run_metrics run;
+    run.read("synthetic_run_test_cancel");
+    util::progress_token progress;
+    progress.cancel();
+    model::summary::run_summary summary;
+    EXPECT_THROW(logic::summary::summarize_run_metrics(run, summary, false, true, &progress),
+                 util::operation_cancelled_exception);
+    model::table::imaging_table table;
+    EXPECT_THROW(logic::table::create_imaging_table(run, table, &progress), util::operation_cancelled_exception);
+}
+
+namespace
+{
+    /** Summarize a run and plot its Q30 flowcell map without modifying the run
+     */
+    class query_frozen_run
+    {
+    public:
+        query_frozen_run(const run_metrics& metrics, model::summary::run_summary& summary, model::plot::flowcell_data& map) :
+                m_metrics(&metrics), m_summary(&summary), m_map(&map){}
+
+        void operator()() const
+        {
+            logic::summary::summarize_run_metrics(*m_metrics, *m_summary);
+            const model::plot::filter_options options(m_metrics->run_info().flowcell().naming_method(),
+                                                      model::plot::filter_options::ALL_IDS,
+                                                      model::plot::filter_options::ALL_CHANNELS,
+                                                      static_cast<constants::dna_bases>(
+                                                              model::plot::filter_options::ALL_BASES),
+                                                      model::plot::filter_options::ALL_IDS,
+                                                      model::plot::filter_options::ALL_IDS,
+                                                      3);
+            logic::plot::plot_flowcell_map(*m_metrics, constants::AccumPercentQ30, options, *m_map);
+        }
+
+    private:
+        const run_metrics* m_metrics;
+        model::summary::run_summary* m_summary;
+        model::plot::flowcell_data* m_map;
+    };
+}
+
+TEST(synthetic_run_test, const_queries_do_not_modify_run)
+{
+    const model::run::info run_info = io::synthetic_run_info(2, 1, 2, 2, 12, 2);
+    io::write_synthetic_run("synthetic_run_test_freeze", run_info, io::synthetic_run_options(9));
+    run_metrics loaded;
+    loaded.read("synthetic_run_test_freeze");
+    model::summary::run_summary expected_summary;
+    model::plot::flowcell_data expected_map;
+    query_frozen_run(loaded, expected_summary, expected_map)();
+
+    run_metrics run = loaded;
+    run.get<q_collapsed_metric>().clear();
+    run.get<q_by_lane_metric>().clear();
+    model::summary::run_summary summary;
+    model::plot::flowcell_data map;
+    query_frozen_run(run, summary, map)();
+    EXPECT_TRUE(run.get<q_collapsed_metric>().empty());
+    EXPECT_TRUE(run.get<q_by_lane_metric>().empty());
+    EXPECT_EQ(summary.total_summary().percent_gt_q30(), expected_summary.total_summary().percent_gt_q30());
+    ASSERT_EQ(map.length(), expected_map.length());
+    for(size_t i=0;i<map.length();++i) EXPECT_EQ(map.at(i), expected_map.at(i)) << i;
+
+    const run_metrics& frozen = run.freeze(4);
+    EXPECT_EQ(frozen.get<q_collapsed_metric>().size(), loaded.get<q_collapsed_metric>().size());
+    EXPECT_EQ(frozen.get<q_by_lane_metric>().size(), loaded.get<q_by_lane_metric>().size());
+    const size_t query_count = 8;
+    std::vector<model::summary::run_summary> summaries(query_count);
+    std::vector<model::plot::flowcell_data> maps(query_count);
+    {
+        util::thread_pool pool(4);
+        util::task_group tasks(pool);
+        for(size_t i=0;i<query_count;++i) tasks.run(query_frozen_run(frozen, summaries[i], maps[i]));
+        tasks.wait();
+    }
+    for(size_t i=0;i<query_count;++i)
+    {
+        EXPECT_EQ(summaries[i].total_summary().percent_gt_q30(), expected_summary.total_summary().percent_gt_q30());
+        ASSERT_EQ(maps[i].length(), expected_map.length());
+        for(size_t j=0;j<maps[i].length();++j) EXPECT_EQ(maps[i].at(j), expected_map.at(j)) << i << " " << j;
+    }
+}
@@ -0,0 +1,51 @@
+/** Unit tests for the fixed capacity vector
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <sstream>
+#include <gtest/gtest.h>
+#include "interop/util/fixed_vector.h"
+#include "interop/io/format/map_io.h"
+
+using namespace illumina::interop;
+
+
+TEST(fixed_vector_test, resize_within_capacity)
+{
+    util::fixed_vector<float, 4> values(2, 1.5f);
+    EXPECT_EQ(values.size(), 2u);
+    EXPECT_EQ(values[1], 1.5f);
+    values.resize(4);
+    EXPECT_EQ(values.size(), 4u);
+    EXPECT_EQ(values[3], 0.0f);
+    EXPECT_THROW(values.resize(5), std::length_error);
+}
+
+TEST(fixed_vector_test, assign_from_vector)
+{
+    std::vector< ::uint16_t > expected;
+    expected.push_back(3);
+    expected.push_back(7);
+    expected.push_back(11);
+    util::fixed_vector< ::uint16_t, 4> values(expected);
+    EXPECT_EQ(values.to_vector(), expected);
+    typedef util::fixed_vector< ::uint16_t, 4> ushort_array_t;
+    EXPECT_TRUE(values == ushort_array_t(&expected.front(), &expected.front()+expected.size()));
+    expected.push_back(1);
+    expected.push_back(2);
+    EXPECT_THROW(values.assign(expected.begin(), expected.end()), std::length_error);
+}
+
+TEST(fixed_vector_test, read_more_than_capacity_is_bad_format)
+{
+    const ::uint16_t buffer[] = {1, 2, 3, 4, 5};
+    std::istringstream fin(std::string(reinterpret_cast<const char*>(buffer), sizeof(buffer)));
+    util::fixed_vector< ::uint16_t, 4> values;
+    EXPECT_THROW(io::stream_map< ::uint16_t >(fin, values, 5), io::bad_format_exception);
+    io::stream_map< ::uint16_t >(fin, values, 4);
+    EXPECT_EQ(values.size(), 4u);
+    EXPECT_EQ(values[3], 4u);
+}
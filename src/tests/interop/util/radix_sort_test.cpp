@@ -0,0 +1,53 @@
+/** Unit tests for the radix sort
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "interop/util/radix_sort.h"
+
+using namespace illumina::interop;
+
+namespace
+{
+    /** Build keys with duplicates, where the offset records the original order
+     *
+     * @param count number of keys
+     * @param keys destination keys
+     */
+    void random_keys(const size_t count, util::radix_key_vector_t& keys)
+    {
+        ::uint64_t state = 88172645463325252ull;
+        keys.resize(count);
+        for(size_t i=0;i<count;++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            keys[i] = util::radix_key_t(state % (count/4+1) << 40, i);
+        }
+    }
+}
+
+TEST(radix_sort_test, matches_stable_sort)
+{
+    util::radix_key_vector_t actual;
+    random_keys(1000, actual);
+    util::radix_key_vector_t expected(actual);
+    std::sort(expected.begin(), expected.end());
+    util::radix_sort(actual);
+    EXPECT_TRUE(actual == expected);
+}
+
+TEST(radix_sort_test, parallel_matches_stable_sort)
+{
+    util::radix_key_vector_t actual;
+    random_keys(200000, actual);
+    util::radix_key_vector_t expected(actual);
+    std::sort(expected.begin(), expected.end());
+    util::radix_sort(actual, 4);
+    EXPECT_TRUE(actual == expected);
+}
@@ -0,0 +1,83 @@
+/** Unit tests for the thread pool
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "interop/util/thread_pool.h"
+
+using namespace illumina::interop;
+
+namespace
+{
+    /** Mark a single slot as visited */
+    struct mark_task
+    {
+        mark_task(std::vector<int>& slots, const size_t index) : m_slots(&slots), m_index(index){}
+        void operator()()const
+        {
+            (*m_slots)[m_index] += 1;
+        }
+        std::vector<int>* m_slots;
+        size_t m_index;
+    };
+    /** Mark a range of slots with a nested group for each slot */
+    struct nested_task
+    {
+        nested_task(util::thread_pool& pool, std::vector<int>& slots, const size_t first, const size_t count) :
+                m_pool(&pool), m_slots(&slots), m_first(first), m_count(count){}
+        void operator()()const
+        {
+            util::task_group tasks(*m_pool);
+            for(size_t i=0;i<m_count;++i) tasks.run(mark_task(*m_slots, m_first+i));
+            tasks.wait();
+        }
+        util::thread_pool* m_pool;
+        std::vector<int>* m_slots;
+        size_t m_first;
+        size_t m_count;
+    };
+    /** Throw an exception */
+    struct throw_task
+    {
+        void operator()()const
+        {
+            throw std::out_of_range("task failed");
+        }
+    };
+}
+
+TEST(thread_pool_test, nested_groups_run_every_task)
+{
+    const size_t group_count = 16;
+    const size_t group_size = 64;
+    for(size_t thread_count=1;thread_count<=4;thread_count+=3)
+    {
+        util::thread_pool pool(thread_count);
+        EXPECT_EQ(pool.thread_count(), thread_count);
+        std::vector<int> slots(group_count*group_size, 0);
+        util::task_group tasks(pool);
+        for(size_t i=0;i<group_count;++i) tasks.run(nested_task(pool, slots, i*group_size, group_size));
+        tasks.wait();
+        for(size_t i=0;i<slots.size();++i) EXPECT_EQ(slots[i], 1) << i;
+    }
+}
+
+TEST(thread_pool_test, wait_rethrows_task_exception)
+{
+    util::thread_pool pool(3);
+    std::vector<int> slots(8, 0);
+    util::task_group tasks(pool);
+    tasks.run(throw_task());
+    for(size_t i=0;i<slots.size();++i) tasks.run(mark_task(slots, i));
+    EXPECT_THROW(tasks.wait(), std::out_of_range);
+
+    // The group can be reused after the exception is reported
+    tasks.run(mark_task(slots, 0));
+    EXPECT_NO_THROW(tasks.wait());
+    EXPECT_GE(slots[0], 1);
+}
@@ -0,0 +1,131 @@
+/** Unit tests for the stage instrumentation
+ *
+ *
+ *  @file
+ *  @date 10/18/26
+ *  @version 1.0
+ *  @copyright GNU Public License.
+ */
+#include <gtest/gtest.h>
+#include "interop/util/trace.h"
+#include "interop/io/metric_file_stream.h"
+#include "src/tests/interop/metrics/inc/error_metrics_test.h"
+#ifdef INTEROP_HAS_STD_THREAD
+#include <thread>
+#endif
+
+using namespace illumina::interop::model::metrics;
+using namespace illumina::interop;
+using namespace illumina::interop::unittest;
+
+namespace
+{
+    /** Find an event by name
+     *
+     * @param events recorded events
+     * @param name name of the event
+     * @return pointer to the event or null
+     */
+    const util::trace_event* find_event(const util::trace_event_vector& events, const std::string& name)
+    {
+        for(size_t i=0;i<events.size();++i)
+            if(events[i].name == name) return &events[i];
+        return 0;
+    }
+    /** Record a single span on the calling thread */
+    void record_thread_stage()
+    {
+        util::scoped_trace trace("thread_stage", "test");
+    }
+}
+
+TEST(trace_test, disabled_records_nothing)
+{
+    util::enable_tracing(false);
+    util::clear_trace();
+    {
+        util::scoped_trace trace("stage", "test");
+        EXPECT_FALSE(trace.is_active());
+    }
+    EXPECT_EQ(util::trace_event_count(), 0u);
+}
+
+TEST(trace_test, scoped_trace_counters)
+{
+    util::clear_trace();
+    util::enable_tracing();
+    {
+        util::scoped_trace trace("stage", "test", "Detail", "Suffix");
+        trace.add_bytes(10);
+        trace.add_records(3);
+        trace.add_allocation(64);
+        trace.add_allocation(0);
+    }
+    util::enable_tracing(false);
+    util::trace_event_vector events;
+    util::copy_trace_events(events);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].name, "stage:DetailSuffix");
+    EXPECT_EQ(events[0].category, "test");
+    EXPECT_EQ(events[0].bytes, 10u);
+    EXPECT_EQ(events[0].records, 3u);
+    EXPECT_EQ(events[0].allocations, 1u);
+    EXPECT_EQ(events[0].allocated_bytes, 64u);
+    EXPECT_GE(events[0].duration_seconds, 0.0);
+    util::clear_trace();
+}
+
+TEST(trace_test, read_records_decode_and_index)
+{
+    std::string buffer;
+    error_metric_v3::create_binary_data(buffer);
+    util::clear_trace();
+    util::enable_tracing();
+    model::metric_base::metric_set<error_metric> metrics;
+    io::read_interop_from_string(buffer, metrics);
+    util::enable_tracing(false);
+
+    util::trace_event_vector events;
+    util::copy_trace_events(events);
+    const util::trace_event* decode = find_event(events, "decode:Error");
+    ASSERT_TRUE(decode != 0);
+    EXPECT_EQ(decode->category, "io");
+    EXPECT_EQ(decode->records, metrics.size());
+    EXPECT_EQ(decode->bytes, buffer.size());
+    const util::trace_event* rebuild = find_event(events, "rebuild_index:Error");
+    ASSERT_TRUE(rebuild != 0);
+    EXPECT_EQ(rebuild->records, metrics.size());
+
+    const std::string json = util::chrome_trace();
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"decode:Error\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\": \"X\""), std::string::npos);
+    util::clear_trace();
+}
+
+#ifdef INTEROP_HAS_STD_THREAD
+TEST(trace_test, threads_have_distinct_ids)
+{
+    util::clear_trace();
+    util::enable_tracing();
+    record_thread_stage();
+    std::thread worker(record_thread_stage);
+    worker.join();
+    util::enable_tracing(false);
+
+    util::trace_event_vector events;
+    util::copy_trace_events(events);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_NE(events[0].thread_id, events[1].thread_id);
+    util::clear_trace();
+}
+#endif
+
+TEST(trace_test, chrome_trace_escapes_names)
+{
+    util::clear_trace();
+    util::record_trace_event(util::trace_event("a\"b\\c\nd\x01", "test"));
+    const std::string json = util::chrome_trace();
+    EXPECT_NE(json.find("\"name\": \"a\\\"b\\\\c\\nd\\u0001\""), std::string::npos) << json;
+    util::clear_trace();
+}
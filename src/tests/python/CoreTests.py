@@ -2,12 +2,17 @@
 Unit tests for core functionality for the SWIG binding
 """
 import unittest
+import os
+import shutil
+import tempfile
+import threading
 import numpy
 import py_interop_run
 import py_interop_metrics
 import py_interop_plot
 import py_interop_comm
 import py_interop_table
+import py_interop_summary
 import py_interop_run_metrics
 
 class CoreTests(unittest.TestCase):
@@ -121,6 +126,63 @@ class CoreTests(unittest.TestCase):
         py_interop_table.populate_imaging_table_data(run, columns, row_offsets, data.ravel())
         self.assertEqual(data[0, 0], 7)
 
+    def test_concurrent_read_and_summarize(self):
+        """
+        Test that several runs can be loaded and summarized concurrently from Python threads
+        """
+
+        tmp = numpy.asarray([2,38
+            ,7,0,90,4,1,0,-12,-56,15,64,-98,35,12,64,0,0,0,0,0,0,0,0,46,1,17,1,0,0,0,0,96,-41,-104,36,122,-86,-46,-120
+            ,7,0,-66,4,1,0,96,-43,14,64,-63,49,13,64,0,0,0,0,0,0,0,0,56,1,17,1,0,0,0,0,112,125,77,38,122,-86,-46,-120
+            ,7,0,66,8,1,0,74,-68,6,64,-118,-7,8,64,0,0,0,0,0,0,0,0,93,1,46,1,0,0,0,0,-47,-104,2,40,122,-86,-46,-120],
+                            dtype=numpy.uint8)
+        run = py_interop_run_metrics.run_metrics()
+        py_interop_comm.read_interop_from_buffer(tmp, run.extraction_metric_set())
+        reads = py_interop_run.read_info_vector()
+        reads.append(py_interop_run.read_info(1, 1, 26))
+        reads.append(py_interop_run.read_info(2, 27, 76))
+        run.run_info(py_interop_run.info(
+            py_interop_run.flowcell_layout(8, 2, 2, 16),
+            reads
+        ))
+        run.legacy_channel_update(py_interop_run.HiSeq)
+
+        run_count = 8
+        temp_dir = tempfile.mkdtemp()
+        try:
+            run_folders = []
+            for i in range(run_count):
+                run_folder = os.path.join(temp_dir, "run%d"%i)
+                os.makedirs(os.path.join(run_folder, "InterOp"))
+                run.write_metrics(run_folder)
+                run.run_info().write(os.path.join(run_folder, "RunInfo.xml"))
+                run_folders.append(run_folder)
+
+            results = [None] * run_count
+            errors = []
+
+            def load_and_summarize(index):
+                try:
+                    loaded = py_interop_run_metrics.run_metrics()
+                    loaded.read(run_folders[index])
+                    summary = py_interop_summary.run_summary()
+                    py_interop_summary.summarize_run_metrics(loaded, summary)
+                    results[index] = (loaded.extraction_metric_set().size(), summary.size())
+                except Exception as ex:
+                    errors.append(str(ex))
+
+            threads = [threading.Thread(target=load_and_summarize, args=(i,)) for i in range(run_count)]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+        finally:
+            shutil.rmtree(temp_dir)
+
+        self.assertEqual(errors, [])
+        for result in results:
+            self.assertEqual(result, (3, 2))
+
     def test_count_imaging_table_columns(self):
         """
         Test if imaging logic is properly wrapped